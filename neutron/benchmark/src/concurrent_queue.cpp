@@ -0,0 +1,128 @@
+// Benchmarks for neutron::mpmc_queue and neutron::spsc_ring vs a locked queue
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <span>
+#include <thread>
+#include <benchmark/benchmark.h>
+#include <neutron/concurrent_queue.hpp>
+
+using namespace neutron;
+
+namespace {
+
+class locked_queue {
+public:
+    explicit locked_queue(size_t capacity) : capacity_(capacity) {}
+
+    bool try_push(uint64_t value) {
+        std::unique_lock guard{ mutex_ };
+        if (queue_.size() == capacity_) {
+            return false;
+        }
+        queue_.push(value);
+        return true;
+    }
+
+    bool try_pop(uint64_t& out) {
+        std::unique_lock guard{ mutex_ };
+        if (queue_.empty()) {
+            return false;
+        }
+        out = queue_.front();
+        queue_.pop();
+        return true;
+    }
+
+private:
+    size_t capacity_;
+    std::mutex mutex_;
+    std::queue<uint64_t> queue_;
+};
+
+} // namespace
+
+// the queues are shared by the threads of a run and empty again after it, as
+// every thread runs the same number of iterations
+
+// throughput, even threads produce and odd threads consume
+template <typename Queue>
+static void BM_mpmc_throughput(benchmark::State& st) {
+    static Queue queue{ 1024 };
+    const bool producer = st.thread_index() % 2 == 0;
+    uint64_t value      = 0;
+    for (auto _ : st) {
+        if (producer) {
+            while (!queue.try_push(value)) {
+                std::this_thread::yield();
+            }
+            ++value;
+        } else {
+            while (!queue.try_pop(value)) {
+                std::this_thread::yield();
+            }
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    st.SetItemsProcessed(st.iterations());
+}
+
+// throughput with one producer and one consumer, batched through spans
+static void BM_spsc_batch_throughput(benchmark::State& st) {
+    static spsc_ring<uint64_t> ring{ 1024 };
+    const auto batch = static_cast<size_t>(st.range(0));
+    std::array<uint64_t, 256> items{};
+    for (auto _ : st) {
+        size_t done = 0;
+        while (done != batch) {
+            const auto count =
+                st.thread_index() == 0
+                    ? ring.push(std::span<const uint64_t>{ items.data() + done,
+                                                            batch - done })
+                    : ring.pop(std::span<uint64_t>{ items.data() + done,
+                                                     batch - done });
+            done += count;
+            if (count == 0) {
+                std::this_thread::yield();
+            }
+        }
+        benchmark::DoNotOptimize(items.data());
+    }
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+// round trip latency, thread 0 pings and thread 1 echoes
+static void BM_spsc_ping_pong(benchmark::State& st) {
+    static spsc_ring<uint64_t> ping{ 16 };
+    static spsc_ring<uint64_t> pong{ 16 };
+    auto& in       = st.thread_index() == 0 ? pong : ping;
+    auto& out      = st.thread_index() == 0 ? ping : pong;
+    uint64_t value = 0;
+    for (auto _ : st) {
+        if (st.thread_index() == 0) {
+            out.try_push(value);
+        }
+        while (!in.try_pop(value)) {
+            std::this_thread::yield();
+        }
+        if (st.thread_index() == 1) {
+            out.try_push(value + 1);
+        }
+    }
+}
+
+BENCHMARK(BM_mpmc_throughput<mpmc_queue<uint64_t>>)
+    ->ThreadRange(2, 64)
+    ->UseRealTime();
+BENCHMARK(BM_mpmc_throughput<locked_queue>)->ThreadRange(2, 64)->UseRealTime();
+BENCHMARK(BM_spsc_batch_throughput)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256)
+    ->Threads(2)
+    ->UseRealTime();
+BENCHMARK(BM_spsc_ping_pong)->Threads(2)->UseRealTime();
+
+BENCHMARK_MAIN();
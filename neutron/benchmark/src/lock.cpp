@@ -0,0 +1,57 @@
+// Benchmarks for the locks of neutron vs std::mutex and std::shared_mutex
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <benchmark/benchmark.h>
+#include <neutron/lock.hpp>
+
+using namespace neutron;
+
+// a short critical section on a shared counter, as a system bumping a
+// resource
+template <typename Mutex>
+void BM_exclusive(benchmark::State& state) {
+    static Mutex mutex;
+    static uint64_t counter = 0;
+    for (auto _ : state) {
+        std::unique_lock guard{ mutex };
+        benchmark::DoNotOptimize(++counter);
+    }
+}
+
+// readers of a resource, with a write every `state.range()` reads
+template <typename Mutex>
+void BM_read_mostly(benchmark::State& state) {
+    static Mutex mutex;
+    static uint64_t value = 0;
+    const auto period     = state.range();
+    int64_t i             = 0;
+    for (auto _ : state) {
+        if (period != 0 && ++i % period == 0 && state.thread_index() == 0) {
+            std::unique_lock guard{ mutex };
+            benchmark::DoNotOptimize(++value);
+        } else {
+            std::shared_lock guard{ mutex };
+            benchmark::DoNotOptimize(value);
+        }
+    }
+}
+
+BENCHMARK(BM_exclusive<std::mutex>)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_exclusive<spinlock>)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_exclusive<hybrid_spinlock>)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_exclusive<adaptive_mutex>)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK(BM_read_mostly<std::shared_mutex>)
+    ->Arg(0)
+    ->Arg(1000)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+BENCHMARK(BM_read_mostly<per_core_shared_mutex>)
+    ->Arg(0)
+    ->Arg(1000)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
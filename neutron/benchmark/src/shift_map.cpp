@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <random>
 #include <unordered_map>
+#include <vector>
 #include <benchmark/benchmark.h>
 #include <neutron/shift_map.hpp>
 
@@ -24,6 +27,40 @@ void BM_shift_map(benchmark::State& state) {
     }
 }
 
+// random lookups over a map larger than the caches
+std::vector<uint64_t> _lookup_keys(shift_map<uint64_t, uint64_t>& map, int n) {
+    for (auto i = 0; i < n; ++i) {
+        map.emplace(i, i);
+    }
+    std::vector<uint64_t> keys(4096);
+    std::mt19937_64 engine{ 42 };
+    std::uniform_int_distribution<uint64_t> dist(0, n - 1);
+    std::ranges::generate(keys, [&] { return dist(engine); });
+    return keys;
+}
+
+void BM_shift_map_find(benchmark::State& state) {
+    shift_map<uint64_t, uint64_t> map;
+    const auto keys = _lookup_keys(map, static_cast<int>(state.range()));
+    std::vector<shift_map<uint64_t, uint64_t>::iterator> found(keys.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            found[i] = map.find(keys[i]);
+        }
+        benchmark::DoNotOptimize(found.data());
+    }
+}
+
+void BM_shift_map_find_batch(benchmark::State& state) {
+    shift_map<uint64_t, uint64_t> map;
+    const auto keys = _lookup_keys(map, static_cast<int>(state.range()));
+    std::vector<shift_map<uint64_t, uint64_t>::iterator> found(keys.size());
+    for (auto _ : state) {
+        map.find_batch(keys, found.begin());
+        benchmark::DoNotOptimize(found.data());
+    }
+}
+
 BENCHMARK(BM_unordered_map)
     ->RangeMultiplier(10)
     ->Range(1000, 100000000)
@@ -34,4 +71,14 @@ BENCHMARK(BM_shift_map)
     ->Range(1000, 100000000)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK(BM_shift_map_find)
+    ->RangeMultiplier(10)
+    ->Range(10000, 10000000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_shift_map_find_batch)
+    ->RangeMultiplier(10)
+    ->Range(10000, 10000000)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_MAIN();
@@ -1,22 +1,43 @@
 #pragma once
+#include <algorithm>
+#include <cassert>
 #include <compare>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <ranges>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include "neutron/detail/concepts/trivially_relocatable.hpp"
 #include "neutron/detail/iterator/iter_wrapper.hpp"
 #include "neutron/detail/macros.hpp"
-#include "neutron/detail/ranges/concepts.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
+#include "neutron/detail/utility/exception_guard.hpp"
 
 namespace neutron {
 
-template <typename Ty>
+template <typename Ty, std::unsigned_integral SizeType = uint32_t>
 class bare_vector;
 
-template <typename Ty>
+/**
+ * @class bare_vector
+ * @brief A vector that does not hold its allocator.
+ * @details Every function allocating, constructing or freeing takes the
+ * allocator as its first parameter, rebound to `Ty` if needed, so a container
+ * made of several of them keeps a single allocator for all. The size and the
+ * capacity are `SizeType`, 32 bits by default, so the vector takes 16 bytes
+ * instead of the 24 of a `std::vector` and its (empty) allocator.
+ * @warning The owner must give back the memory through `reset(alloc)` before
+ * the vector is destroyed, with an allocator equal to the one it was
+ * allocated by.
+ */
+template <typename Ty, std::unsigned_integral SizeType>
 class bare_vector {
 public:
     static_assert(sizeof(Ty));
@@ -34,11 +55,14 @@ public:
     using reverse_iterator       = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-    using size_type              = size_t;
+    using size_type              = SizeType;
     using difference_type        = std::ptrdiff_t;
 
     template <typename Alloc>
-    using _allocator_traits = typename std::allocator_traits<Alloc>::template rebind_alloc<Ty>;
+    using _alloc_t               = rebind_alloc_t<Alloc, Ty>;
+
+    template <typename Alloc>
+    using _alloc_traits          = std::allocator_traits<_alloc_t<Alloc>>;
 
     // clang-format on
 
@@ -46,22 +70,29 @@ public:
 
     template <typename Alloc>
     constexpr bare_vector(size_type n, Alloc& alloc) {
-        auto guard = make_exception_guard([this, &alloc] { _destroy(alloc); });
-        if (n > 0) [[likely]] {
-            data_ = _allocator_traits<Alloc>::allocate(alloc, n);
-            std::uninitialized_construct_using_allocator(data_, alloc);
-        }
-        guard.mark_complete();
+        resize(alloc, n);
+    }
+
+    template <typename Alloc>
+    constexpr bare_vector(size_type n, const_reference val, Alloc& alloc) {
+        resize(alloc, n, val);
     }
 
     template <std::input_iterator Iter, typename Sentinel, typename Alloc>
     constexpr bare_vector(Iter first, Sentinel last, Alloc& alloc) {
-        _init_with_sentinel(alloc, first, last);
+        if constexpr (std::forward_iterator<Iter>) {
+            _init_with_size(
+                alloc, first, last,
+                static_cast<size_type>(std::ranges::distance(first, last)));
+        } else {
+            _init_with_sentinel(alloc, first, last);
+        }
     }
 
     template <typename T, typename Alloc>
     constexpr bare_vector(std::initializer_list<T> il, Alloc& alloc) {
-        _init_with_size(alloc, il.begin(), il.end(), il.size());
+        _init_with_size(
+            alloc, il.begin(), il.end(), static_cast<size_type>(il.size()));
     }
 
 #if ATOM_HAS_CXX23
@@ -83,15 +114,20 @@ public:
 
     template <typename Alloc>
     constexpr bare_vector(const bare_vector& that, Alloc& alloc) {
-        _init_with_size(that.begin(), that.end(), alloc);
+        _init_with_size(alloc, that.begin(), that.end(), that.size_);
     }
 
     constexpr bare_vector(bare_vector&& that) noexcept
-        : data_(std::exchange(that.data_, nullptr)), size_(that.size_),
-          capacity_(that.capacity_) {}
+        : data_(std::exchange(that.data_, nullptr)),
+          size_(std::exchange(that.size_, 0)),
+          capacity_(std::exchange(that.capacity_, 0)) {}
 
     constexpr bare_vector& operator=(const bare_vector& that) = delete;
 
+    /**
+     * @warning Swaps the contents, the memory held by `*this` before must have
+     * been given back already or still be given back through `that`.
+     */
     constexpr bare_vector& operator=(bare_vector&& that) noexcept {
         if (this != &that) [[likely]] {
             swap(that);
@@ -99,92 +135,230 @@ public:
         return *this;
     }
 
-    constexpr ~bare_vector() noexcept(std::is_nothrow_destructible_v<Ty>) {
-        // assert(data_ != nullptr);
+    constexpr ~bare_vector() noexcept {
+        assert(data_ == nullptr && "bare_vector destroyed before reset");
     }
 
+    /**
+     * @brief Destroys the elements and frees the memory.
+     */
     template <typename Alloc>
-    constexpr iterator insert(const_iterator pos, const_reference val);
+    constexpr void
+        reset(Alloc& alloc) noexcept(std::is_nothrow_destructible_v<Ty>) {
+        if (data_ != nullptr) {
+            clear();
+            auto&& al = _rebind(alloc);
+            _alloc_traits<Alloc>::deallocate(al, data_, capacity_);
+            data_     = nullptr;
+            capacity_ = 0;
+        }
+    }
 
     template <typename Alloc>
-    constexpr iterator insert(const_iterator pos, value_type&& val);
+    constexpr iterator
+        insert(Alloc& alloc, const_iterator pos, const_reference val) {
+        return emplace(alloc, pos, val);
+    }
 
-    template <typename Alloc, std::input_iterator Iter, typename Sentinel>
-    requires(!std::forward_iterator<Iter>) // for better candidate matching
+    template <typename Alloc>
     constexpr iterator
-        insert(Alloc& alloc, const_iterator pos, Iter first, Sentinel last) {
-        _insert_with_sentinel(alloc, pos, first, last);
+        insert(Alloc& alloc, const_iterator pos, value_type&& val) {
+        return emplace(alloc, pos, std::move(val));
     }
 
-    template <typename Alloc, std::forward_iterator Iter, typename Sentinel>
+    template <typename Alloc, std::input_iterator Iter, typename Sentinel>
     constexpr iterator
         insert(Alloc& alloc, const_iterator pos, Iter first, Sentinel last) {
-        _insert_with_size(alloc, pos, first, last, std::distance(first, last));
+        const auto index = _index_of(pos);
+        const auto tail  = size_;
+        if constexpr (std::forward_iterator<Iter>) {
+            _append_with_size(
+                alloc, first, last,
+                static_cast<size_type>(std::ranges::distance(first, last)));
+        } else {
+            _append_with_sentinel(alloc, first, last);
+        }
+        return _rotate_from(index, tail);
     }
 
     template <typename Alloc, typename Val = value_type>
     constexpr iterator insert(
         Alloc& alloc, const_iterator pos, std::initializer_list<Val> il) {
-        _insert_with_size(alloc, pos, il.begin(), il.end(), il.size());
+        return insert(alloc, pos, il.begin(), il.end());
     }
 
-    template <typename Alloc, compatible_range<value_type> Rng>
+    template <typename Alloc, std::ranges::input_range Rng>
+    requires std::constructible_from<Ty, std::ranges::range_reference_t<Rng>>
     constexpr iterator
         insert_range(Alloc& alloc, const_iterator pos, Rng&& range) {
+        const auto index = _index_of(pos);
+        const auto tail  = size_;
+        append_range(alloc, std::forward<Rng>(range));
+        return _rotate_from(index, tail);
+    }
+
+    template <typename Alloc, std::ranges::input_range Rng>
+    requires std::constructible_from<Ty, std::ranges::range_reference_t<Rng>>
+    constexpr void append_range(Alloc& alloc, Rng&& range) {
         if constexpr (
             std::ranges::forward_range<Rng> || std::ranges::sized_range<Rng>) {
             const auto n = static_cast<size_type>(std::ranges::distance(range));
-            return _insert_with_size(
+            _append_with_size(
                 alloc, std::ranges::begin(range), std::ranges::end(range), n);
         } else {
-            return _insert_with_sentinel(
+            _append_with_sentinel(
                 alloc, std::ranges::begin(range), std::ranges::end(range));
         }
     }
 
-    template <typename Alloc, compatible_range<value_type> Rng>
-    constexpr void append_range(Rng&& range) {
-        insert_range(end(), std::forward<Rng>(range));
-    }
-
     template <typename Alloc, typename... Args>
-    constexpr auto emplace(Alloc& alloc, const_iterator pos, Args&&... args);
+    constexpr iterator
+        emplace(Alloc& alloc, const_iterator pos, Args&&... args) {
+        const auto index = _index_of(pos);
+        emplace_back(alloc, std::forward<Args>(args)...);
+        return _rotate_from(index, size_ - 1);
+    }
 
     template <typename Alloc>
-    constexpr auto push_back(Alloc& alloc, const_reference val);
+    constexpr void push_back(Alloc& alloc, const_reference val) {
+        emplace_back(alloc, val);
+    }
 
     template <typename Alloc>
-    constexpr auto push_back(Alloc& alloc, value_type&& val);
+    constexpr void push_back(Alloc& alloc, value_type&& val) {
+        emplace_back(alloc, std::move(val));
+    }
 
     template <typename Alloc, typename... Args>
-    constexpr auto emplace_back(Alloc& alloc, Args&&... args) {}
+    constexpr reference emplace_back(Alloc& alloc, Args&&... args) {
+        auto&& al = _rebind(alloc);
+        if (size_ == capacity_) [[unlikely]] {
+            // the arguments may refer to an element, construct it first
+            const auto capacity = _next_capacity(size_ + 1);
+            auto* const ptr = _alloc_traits<Alloc>::allocate(al, capacity);
+            bool constructed = false;
+            auto guard       = make_exception_guard(
+                [this, &al, ptr, capacity, &constructed] {
+                    if (constructed) {
+                        std::destroy_at(ptr + size_);
+                    }
+                    _alloc_traits<Alloc>::deallocate(al, ptr, capacity);
+                });
+            _alloc_traits<Alloc>::construct(
+                al, ptr + size_, std::forward<Args>(args)...);
+            constructed = true;
+            _relocate_to(al, ptr, capacity);
+            guard.mark_complete();
+        } else {
+            _alloc_traits<Alloc>::construct(
+                al, data_ + size_, std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
 
-    constexpr void pop_back() noexcept(std::is_nothrow_destructible_v<Ty>);
+    constexpr void pop_back() noexcept(std::is_nothrow_destructible_v<Ty>) {
+        assert(size_ != 0);
+        std::destroy_at(data_ + --size_);
+    }
 
-    constexpr auto erase(const_iterator where) noexcept(
-        std::is_nothrow_destructible_v<Ty>);
+    constexpr iterator erase(const_iterator where) noexcept(
+        std::is_nothrow_move_assignable_v<Ty> &&
+        std::is_nothrow_destructible_v<Ty>) {
+        const auto index = _index_of(where);
+        std::move(data_ + index + 1, data_ + size_, data_ + index);
+        pop_back();
+        return iterator{ data_ + index };
+    }
 
-    template <typename Alloc>
-    constexpr void resize(Alloc& alloc, size_type n);
+    constexpr iterator
+        erase(const_iterator first, const_iterator last) noexcept(
+            std::is_nothrow_move_assignable_v<Ty> &&
+            std::is_nothrow_destructible_v<Ty>) {
+        const auto index = _index_of(first);
+        const auto count = static_cast<size_type>(last - first);
+        std::move(data_ + index + count, data_ + size_, data_ + index);
+        std::destroy_n(data_ + size_ - count, count);
+        size_ -= count;
+        return iterator{ data_ + index };
+    }
 
+    /**
+     * @throw std::length_error If `n` does not fit in `size_type`.
+     */
     template <typename Alloc>
-    constexpr void resize(Alloc& alloc, size_type n, const_reference val);
+    constexpr void reserve(Alloc& alloc, size_t n) {
+        if (n > max_size()) [[unlikely]] {
+            throw std::length_error("neutron::bare_vector: too many elements");
+        }
+        if (n > capacity_) {
+            _reallocate(alloc, static_cast<size_type>(n));
+        }
+    }
 
-    constexpr auto clear() noexcept(std::is_nothrow_destructible_v<Ty>) {
-        if constexpr (std::is_trivially_destructible_v<Ty>) {
-            std::destroy_n(data_, size_);
+    template <typename Alloc>
+    constexpr void shrink_to_fit(Alloc& alloc) {
+        if (size_ == capacity_) {
+            return;
         }
+        if (size_ == 0) {
+            reset(alloc);
+            return;
+        }
+        _reallocate(alloc, size_);
+    }
+
+    template <typename Alloc>
+    constexpr void resize(Alloc& alloc, size_type n) {
+        _resize(alloc, n);
+    }
+
+    template <typename Alloc>
+    constexpr void resize(Alloc& alloc, size_type n, const_reference val) {
+        _resize(alloc, n, val);
+    }
+
+    constexpr void clear() noexcept(std::is_nothrow_destructible_v<Ty>) {
+        std::destroy_n(data_, size_);
         size_ = 0;
     }
 
     ATOM_NODISCARD constexpr size_type size() const noexcept { return size_; }
 
-    ATOM_NODISCARD constexpr bool empty() const noexcept { return size_ != 0; }
+    ATOM_NODISCARD constexpr bool empty() const noexcept { return size_ == 0; }
 
     ATOM_NODISCARD constexpr size_type capacity() const noexcept {
         return capacity_;
     }
 
+    ATOM_NODISCARD static constexpr size_type max_size() noexcept {
+        return (std::min<size_t>)(
+            (std::numeric_limits<size_type>::max)(),
+            (std::numeric_limits<difference_type>::max)() / sizeof(Ty));
+    }
+
+    ATOM_NODISCARD constexpr reference operator[](size_type index) noexcept {
+        return data_[index];
+    }
+
+    ATOM_NODISCARD constexpr const_reference
+        operator[](size_type index) const noexcept {
+        return data_[index];
+    }
+
+    ATOM_NODISCARD constexpr reference front() noexcept { return data_[0]; }
+
+    ATOM_NODISCARD constexpr const_reference front() const noexcept {
+        return data_[0];
+    }
+
+    ATOM_NODISCARD constexpr reference back() noexcept {
+        return data_[size_ - 1];
+    }
+
+    ATOM_NODISCARD constexpr const_reference back() const noexcept {
+        return data_[size_ - 1];
+    }
+
     ATOM_NODISCARD constexpr value_type* data() noexcept { return data_; }
 
     ATOM_NODISCARD constexpr const value_type* data() const noexcept {
@@ -192,51 +366,51 @@ public:
     }
 
     ATOM_NODISCARD constexpr iterator begin() noexcept {
-        return _iter_wrapper{ data_ };
+        return iterator{ data_ };
     }
 
     ATOM_NODISCARD constexpr const_iterator begin() const noexcept {
-        return _iter_wrapper{ data_ };
+        return const_iterator{ data_ };
     }
 
     ATOM_NODISCARD constexpr const_iterator cbegin() const noexcept {
-        return _iter_wrapper{ data_ };
+        return const_iterator{ data_ };
     }
 
     ATOM_NODISCARD constexpr iterator end() noexcept {
-        return _iter_wrapper{ data_ + size_ };
+        return iterator{ data_ + size_ };
     }
 
     ATOM_NODISCARD constexpr const_iterator end() const noexcept {
-        return _iter_wrapper{ data_ + size_ };
+        return const_iterator{ data_ + size_ };
     }
 
     ATOM_NODISCARD constexpr const_iterator cend() const noexcept {
-        return _iter_wrapper{ data_ + size_ };
+        return const_iterator{ data_ + size_ };
     }
 
     ATOM_NODISCARD constexpr reverse_iterator rbegin() noexcept {
-        return std::make_reverse_iterator(_iter_wrapper{ data_ });
+        return reverse_iterator{ end() };
     }
 
     ATOM_NODISCARD constexpr const_reverse_iterator rbegin() const noexcept {
-        return std::make_reverse_iterator(_iter_wrapper{ data_ });
+        return const_reverse_iterator{ end() };
     }
 
     ATOM_NODISCARD constexpr const_reverse_iterator crbegin() const noexcept {
-        return std::make_reverse_iterator(_iter_wrapper{ data_ });
+        return const_reverse_iterator{ end() };
     }
 
     ATOM_NODISCARD constexpr reverse_iterator rend() noexcept {
-        return std::make_reverse_iterator(_iter_wrapper{ data_ + size_ });
+        return reverse_iterator{ begin() };
     }
 
     ATOM_NODISCARD constexpr const_reverse_iterator rend() const noexcept {
-        return std::make_reverse_iterator(_iter_wrapper{ data_ + size_ });
+        return const_reverse_iterator{ begin() };
     }
 
     ATOM_NODISCARD constexpr const_reverse_iterator crend() const noexcept {
-        return std::make_reverse_iterator(_iter_wrapper{ data_ + size_ });
+        return const_reverse_iterator{ begin() };
     }
 
     constexpr void swap(bare_vector& that) noexcept {
@@ -246,47 +420,153 @@ public:
     }
 
 private:
+    /// `alloc` itself when it allocates `Ty` already, a rebound copy otherwise
     template <typename Alloc>
-    constexpr void
-        _destroy(Alloc& alloc) noexcept(std::is_nothrow_destructible_v<Ty>) {
-        clear();
-        using alloc_traits =
-            std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
-        alloc_traits::deallocate(alloc, data_, capacity_);
-        data_ = nullptr;
+    ATOM_NODISCARD static constexpr decltype(auto)
+        _rebind(Alloc& alloc) noexcept {
+        if constexpr (std::same_as<Alloc, _alloc_t<Alloc>>) {
+            return (alloc);
+        } else {
+            return _alloc_t<Alloc>(alloc);
+        }
+    }
+
+    ATOM_NODISCARD constexpr size_type
+        _index_of(const_iterator pos) const noexcept {
+        return static_cast<size_type>(pos.base() - data_);
+    }
+
+    ATOM_NODISCARD constexpr size_type _next_capacity(size_t required) const {
+        if (required > max_size()) [[unlikely]] {
+            throw std::length_error("neutron::bare_vector: too many elements");
+        }
+        const auto doubled = static_cast<size_t>(capacity_) * 2;
+        return static_cast<size_type>((std::min<size_t>)(
+            (std::max)({ doubled, required, size_t{ 4 } }), max_size()));
+    }
+
+    template <typename Alloc>
+    constexpr void _reallocate(Alloc& alloc, size_type capacity) {
+        auto&& al       = _rebind(alloc);
+        auto* const ptr = _alloc_traits<Alloc>::allocate(al, capacity);
+        auto guard      = make_exception_guard([&al, ptr, capacity] {
+            _alloc_traits<Alloc>::deallocate(al, ptr, capacity);
+        });
+        _relocate_to(al, ptr, capacity);
+        guard.mark_complete();
+    }
+
+    /// Moves the elements to `ptr`, `capacity` elements large, then frees the
+    /// current memory. `ptr` is left to the caller if a move throws.
+    template <typename Al>
+    constexpr void _relocate_to(Al& al, pointer ptr, size_type capacity) {
+        using traits = std::allocator_traits<Al>;
+        if constexpr (trivially_relocatable<Ty>) {
+            if (std::is_constant_evaluated()) {
+                for (size_type i = 0; i < size_; ++i) {
+                    traits::construct(al, ptr + i, std::move(data_[i]));
+                    traits::destroy(al, data_ + i);
+                }
+            } else if (size_ != 0) {
+                std::memcpy(
+                    static_cast<void*>(ptr), static_cast<const void*>(data_),
+                    sizeof(Ty) * size_);
+            }
+        } else {
+            size_type count = 0;
+            auto guard      = make_exception_guard(
+                [ptr, &count] { std::destroy_n(ptr, count); });
+            for (; count < size_; ++count) {
+                traits::construct(
+                    al, ptr + count, std::move_if_noexcept(data_[count]));
+            }
+            guard.mark_complete();
+            std::destroy_n(data_, size_);
+        }
+        if (data_ != nullptr) {
+            traits::deallocate(al, data_, capacity_);
+        }
+        data_     = ptr;
+        capacity_ = capacity;
+    }
+
+    template <typename Alloc, typename... Args>
+    constexpr void _resize(Alloc& alloc, size_type n, const Args&... args) {
+        if (n <= size_) {
+            std::destroy_n(data_ + n, size_ - n);
+            size_ = n;
+            return;
+        }
+        reserve(alloc, n);
+        auto&& al        = _rebind(alloc);
+        const auto begin = size_;
+        auto guard       = make_exception_guard([this, begin] {
+            std::destroy_n(data_ + begin, size_ - begin);
+            size_ = begin;
+        });
+        for (; size_ < n; ++size_) {
+            _alloc_traits<Alloc>::construct(al, data_ + size_, args...);
+        }
+        guard.mark_complete();
+    }
+
+    /// Moves the elements from `from` to the end in front of `index`.
+    constexpr iterator _rotate_from(size_type index, size_type from) {
+        std::rotate(data_ + index, data_ + from, data_ + size_);
+        return iterator{ data_ + index };
     }
 
     template <typename Alloc, std::input_iterator Iter, typename Sentinel>
     constexpr void
-        _init_with_sentinel(Alloc& alloc, Iter first, Sentinel last) {
-        auto guard = make_exception_guard([this, &alloc] { _destroy(alloc); });
+        _append_with_sentinel(Alloc& alloc, Iter first, Sentinel last) {
+        const auto begin = size_;
+        auto guard       = make_exception_guard([this, begin] {
+            std::destroy_n(data_ + begin, size_ - begin);
+            size_ = begin;
+        });
         for (; first != last; ++first) {
-            emplace_back(*first);
+            emplace_back(alloc, *first);
         }
         guard.mark_complete();
     }
 
     template <typename Alloc, std::input_iterator Iter, typename Sentinel>
-    constexpr void
-        _init_with_size(Alloc& alloc, Iter first, Sentinel last, size_type n) {
-        auto guard = make_exception_guard([this, &alloc] { _destroy(alloc); });
-        for (; first != last; ++first) {
-            emplace_back(*first);
+    constexpr void _append_with_size(
+        Alloc& alloc, Iter first, Sentinel last, size_type n) {
+        if (static_cast<size_t>(size_) + n > capacity_) {
+            reserve(alloc, _next_capacity(static_cast<size_t>(size_) + n));
+        }
+        auto&& al        = _rebind(alloc);
+        const auto begin = size_;
+        auto guard       = make_exception_guard([this, begin] {
+            std::destroy_n(data_ + begin, size_ - begin);
+            size_ = begin;
+        });
+        for (; first != last; ++first, ++size_) {
+            _alloc_traits<Alloc>::construct(al, data_ + size_, *first);
         }
         guard.mark_complete();
     }
 
     template <typename Alloc, std::input_iterator Iter, typename Sentinel>
     constexpr void
-        _insert_with_sentinel(Alloc& alloc, Iter first, Sentinel last);
+        _init_with_sentinel(Alloc& alloc, Iter first, Sentinel last) {
+        auto guard = make_exception_guard([this, &alloc] { reset(alloc); });
+        _append_with_sentinel(alloc, first, last);
+        guard.mark_complete();
+    }
 
     template <typename Alloc, std::input_iterator Iter, typename Sentinel>
-    constexpr void _insert_with_size(
-        Alloc& alloc, Iter first, Sentinel last, size_type n) {}
+    constexpr void
+        _init_with_size(Alloc& alloc, Iter first, Sentinel last, size_type n) {
+        auto guard = make_exception_guard([this, &alloc] { reset(alloc); });
+        _append_with_size(alloc, first, last, n);
+        guard.mark_complete();
+    }
 
     Ty* data_{};
-    size_t size_{};
-    size_t capacity_{};
+    size_type size_{};
+    size_type capacity_{};
 };
 
 } // namespace neutron
@@ -0,0 +1,726 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource> // IWYU pragma: keep
+#include <mutex>
+#include <new>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "neutron/detail/concepts/allocator.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
+#include "neutron/epoch.hpp"
+#include "neutron/flat_hash_map.hpp"
+
+namespace neutron {
+
+/**
+ * @class concurrent_flat_hash_map
+ * @brief A hash map read from any number of threads and written rarely, such
+ * as the asset or name registries every worker looks up each frame.
+ * @details Keys are spread over shards by hash, each of them a robin hood
+ * table laid out as the sherwood_v3 one of `flat_hash_map`, guarded by a
+ * sequence lock. Writers lock their shard only. Readers of trivially copyable
+ * keys and values take no lock: they copy what they found and retry if a
+ * writer ran meanwhile, falling back to the lock of the shard after a few
+ * attempts. Other maps cannot be read while a writer may move their elements,
+ * their readers share the lock of the shard instead.
+ *
+ * A table is never resized in place. A growing shard allocates a table twice
+ * as large and every following write to the shard moves a few elements to
+ * it, so no write pays for a whole rehash. Lookups meanwhile search both.
+ * Tables left behind are freed through an epoch domain once no reader could
+ * still be inside them.
+ * @tparam Key Nothrow movable type of the keys.
+ * @tparam Value Nothrow movable type of the values.
+ */
+template <
+    typename Key, typename Value, typename Hash = std::hash<Key>,
+    typename Equal     = std::equal_to<Key>,
+    std_simple_allocator Alloc = std::allocator<std::pair<Key, Value>>>
+class concurrent_flat_hash_map {
+    static_assert(
+        std::is_nothrow_move_constructible_v<Key> &&
+        std::is_nothrow_move_assignable_v<Key>);
+    static_assert(
+        std::is_nothrow_move_constructible_v<Value> &&
+        std::is_nothrow_move_assignable_v<Value>);
+
+    static constexpr size_t _cacheline =
+        std::hardware_destructive_interference_size;
+
+    using _pair  = std::pair<Key, Value>;
+    using _entry = detailv3::sherwood_v3_entry<_pair>;
+
+    // elements copied racily must not own anything
+    static constexpr bool _optimistic = std::is_trivially_copyable_v<Key> &&
+                                        std::is_trivially_copyable_v<Value>;
+
+    static constexpr int _optimistic_tries = 4;
+    static constexpr size_t _min_slots     = 16;
+    static constexpr size_t _npos          = static_cast<size_t>(-1);
+
+    struct _table;
+
+    using _entry_alloc  = rebind_alloc_t<Alloc, _entry>;
+    using _entry_traits = std::allocator_traits<_entry_alloc>;
+    using _table_alloc  = rebind_alloc_t<Alloc, _table>;
+    using _table_traits = std::allocator_traits<_table_alloc>;
+
+    // the geometry of a table never changes, a growing shard moves to another
+    struct _table {
+        ATOM_NO_UNIQUE_ADDR _entry_alloc alloc;
+        _entry* entries = nullptr;
+        size_t slots    = 0;
+        size_t size     = 0;
+        fibonacci_hash_policy policy;
+        int8_t max_lookups = detailv3::min_lookups;
+
+        /// Number of entries, the last one being the end marker.
+        ATOM_NODISCARD size_t extent() const noexcept {
+            return slots + static_cast<size_t>(max_lookups);
+        }
+
+        ATOM_NODISCARD size_t index_for(size_t hash) const noexcept {
+            return policy.index_for_hash(hash, slots - 1);
+        }
+    };
+
+    // written under `mutex`, `sequence` is odd while a writer is inside
+    struct alignas(_cacheline) _shard {
+        std::atomic<uint64_t> sequence{ 0 };
+        std::atomic<_table*> current{ nullptr };
+        std::atomic<_table*> next{ nullptr }; // set while migrating
+        std::atomic<size_t> cursor{ 0 };      // slots below are migrated
+        std::atomic<size_t> size{ 0 };
+        std::shared_mutex mutex;
+    };
+
+    using _shard_alloc  = rebind_alloc_t<Alloc, _shard>;
+    using _shard_traits = std::allocator_traits<_shard_alloc>;
+    using _domain       = basic_epoch_domain<rebind_alloc_t<Alloc, std::byte>>;
+
+public:
+    using key_type       = Key;
+    using mapped_type    = Value;
+    using value_type     = std::pair<Key, Value>;
+    using size_type      = size_t;
+    using hasher         = Hash;
+    using key_equal      = Equal;
+    using allocator_type = Alloc;
+
+    /// Elements moved to the new table of a growing shard per write.
+    static constexpr size_t migration_step = 32;
+
+    /**
+     * @param shards Number of shards, rounded up to a power of two, 4 per
+     * hardware thread by default.
+     */
+    explicit concurrent_flat_hash_map(
+        size_t shards = 4 * std::thread::hardware_concurrency(),
+        const Hash& hash = Hash{}, const Equal& equal = Equal{},
+        const Alloc& alloc = Alloc{})
+        : hash_(hash), equal_(equal), alloc_(alloc), shard_alloc_(alloc),
+          shard_mask_(std::bit_ceil(std::max<size_t>(shards, 1)) - 1),
+          domain_(
+              2 * std::thread::hardware_concurrency(), 1,
+              rebind_alloc_t<Alloc, std::byte>{ alloc }) {
+        shards_ = _shard_traits::allocate(shard_alloc_, shard_mask_ + 1);
+        for (size_t i = 0; i <= shard_mask_; ++i) {
+            ::new (shards_ + i) _shard{};
+        }
+    }
+
+    concurrent_flat_hash_map(const concurrent_flat_hash_map&) = delete;
+    concurrent_flat_hash_map&
+        operator=(const concurrent_flat_hash_map&)              = delete;
+    concurrent_flat_hash_map(concurrent_flat_hash_map&&)        = delete;
+    concurrent_flat_hash_map& operator=(concurrent_flat_hash_map&&) = delete;
+
+    /**
+     * @warning No thread may still be reading or writing the map.
+     */
+    ~concurrent_flat_hash_map() {
+        for (size_t i = 0; i <= shard_mask_; ++i) {
+            _free_table(shards_[i].current.load(std::memory_order_relaxed));
+            _free_table(shards_[i].next.load(std::memory_order_relaxed));
+            shards_[i].~_shard();
+        }
+        _shard_traits::deallocate(shard_alloc_, shards_, shard_mask_ + 1);
+    }
+
+    /**
+     * @brief A copy of the value mapped to `key`, if any.
+     */
+    ATOM_NODISCARD std::optional<Value> find(const Key& key) const {
+        return _find(key);
+    }
+
+    /**
+     * @brief Heterogeneous lookup, with a transparent hasher and key equal,
+     * such as `std::string_view` for `std::string` keys.
+     */
+    template <typename Ty>
+    requires detailv3::transparent_lookup<Hash, Equal>
+    ATOM_NODISCARD std::optional<Value> find(const Ty& key) const {
+        return _find(key);
+    }
+
+    ATOM_NODISCARD bool contains(const Key& key) const {
+        return _visit(key, [](const Value&) {});
+    }
+
+    template <typename Ty>
+    requires detailv3::transparent_lookup<Hash, Equal>
+    ATOM_NODISCARD bool contains(const Ty& key) const {
+        return _visit(key, [](const Value&) {});
+    }
+
+    /**
+     * @brief Calls `fn(value)` with the value mapped to `key`, if any.
+     * @details `fn` runs under the shared lock of the shard, or on a private
+     * copy of the value when the map is read optimistically. It must not
+     * write to the map.
+     * @return Whether `key` was found.
+     */
+    template <typename Fn>
+    bool visit(const Key& key, Fn&& fn) const {
+        return _visit(key, std::forward<Fn>(fn));
+    }
+
+    template <typename Ty, typename Fn>
+    requires detailv3::transparent_lookup<Hash, Equal>
+    bool visit(const Ty& key, Fn&& fn) const {
+        return _visit(key, std::forward<Fn>(fn));
+    }
+
+    /**
+     * @brief Inserts `(key, Value(args...))` unless `key` is already mapped.
+     * @return Whether it was inserted.
+     */
+    template <typename... Args>
+    bool try_emplace(const Key& key, Args&&... args) {
+        return _emplace(false, key, std::forward<Args>(args)...);
+    }
+
+    bool insert(const value_type& value) {
+        return _emplace(false, value.first, value.second);
+    }
+
+    /**
+     * @brief Maps `key` to `value`, replacing the value mapped so far.
+     * @return Whether `key` was not mapped yet.
+     */
+    template <typename Ty>
+    bool insert_or_assign(const Key& key, Ty&& value) {
+        return _emplace(true, key, std::forward<Ty>(value));
+    }
+
+    /**
+     * @return Whether `key` was mapped.
+     */
+    bool erase(const Key& key) {
+        const auto hash = static_cast<size_t>(hash_(key));
+        auto& shard     = _shard_of(hash);
+        return _write(shard, [&] {
+            if (shard.next.load(std::memory_order_relaxed) != nullptr) {
+                _migrate(shard);
+            }
+            // looked up after the migration step, which may move the key
+            auto* const next  = shard.next.load(std::memory_order_relaxed);
+            auto* const table = shard.current.load(std::memory_order_relaxed);
+            if (next != nullptr) {
+                if (const auto index = _probe(*next, key, hash, 0);
+                    index != _npos) {
+                    _erase_at(*next, index);
+                    shard.size.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            if (table != nullptr) {
+                const auto from =
+                    next != nullptr
+                        ? shard.cursor.load(std::memory_order_relaxed)
+                        : 0;
+                if (const auto index = _probe(*table, key, hash, from);
+                    index != _npos) {
+                    _erase_at(*table, index);
+                    shard.size.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    /**
+     * @brief Erases every element.
+     */
+    void clear() {
+        for (size_t i = 0; i <= shard_mask_; ++i) {
+            auto& shard = shards_[i];
+            _write(shard, [&] {
+                _retire(shard.next.exchange(nullptr));
+                _retire(shard.current.exchange(nullptr));
+                shard.cursor.store(0, std::memory_order_relaxed);
+                shard.size.store(0, std::memory_order_relaxed);
+            });
+        }
+    }
+
+    /**
+     * @brief Calls `fn(key, value)` for every element, one shard at a time
+     * under its shared lock. `fn` must not write to the map.
+     */
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (size_t i = 0; i <= shard_mask_; ++i) {
+            auto& shard = shards_[i];
+            std::shared_lock guard{ shard.mutex };
+            auto* const next = shard.next.load(std::memory_order_relaxed);
+            if (next != nullptr) {
+                _for_each(*next, 0, fn);
+            }
+            if (auto* const current =
+                    shard.current.load(std::memory_order_relaxed)) {
+                _for_each(
+                    *current,
+                    next != nullptr
+                        ? shard.cursor.load(std::memory_order_relaxed)
+                        : 0,
+                    fn);
+            }
+        }
+    }
+
+    /**
+     * @brief Number of elements, only exact while no thread writes.
+     */
+    ATOM_NODISCARD size_t size() const noexcept {
+        size_t count = 0;
+        for (size_t i = 0; i <= shard_mask_; ++i) {
+            count += shards_[i].size.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    ATOM_NODISCARD bool empty() const noexcept { return size() == 0; }
+
+    ATOM_NODISCARD size_t shard_count() const noexcept {
+        return shard_mask_ + 1;
+    }
+
+    /**
+     * @brief Whether a shard is moving its elements to a larger table.
+     */
+    ATOM_NODISCARD bool migrating() const noexcept {
+        for (size_t i = 0; i <= shard_mask_; ++i) {
+            if (shards_[i].next.load(std::memory_order_relaxed) != nullptr) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Frees the tables left behind by grown shards that no reader
+     * could still see, see `basic_epoch_domain::quiescent`.
+     * @return Number of tables freed.
+     */
+    size_t quiescent() { return domain_.quiescent(); }
+
+    ATOM_NODISCARD hasher hash_function() const { return hash_; }
+
+    ATOM_NODISCARD key_equal key_eq() const { return equal_; }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return allocator_type{ alloc_ };
+    }
+
+private:
+    template <typename Ty>
+    std::optional<Value> _find(const Ty& key) const {
+        std::optional<Value> result;
+        _visit(key, [&result](const Value& value) { result.emplace(value); });
+        return result;
+    }
+
+    template <typename Ty, typename Fn>
+    bool _visit(const Ty& key, Fn&& fn) const {
+        const auto hash = static_cast<size_t>(hash_(key));
+        auto& shard     = _shard_of(hash);
+        if constexpr (_optimistic) {
+            auto guard = domain_.pin();
+            for (int attempt = 0; attempt < _optimistic_tries; ++attempt) {
+                const auto sequence =
+                    shard.sequence.load(std::memory_order_acquire);
+                if ((sequence & 1U) != 0) {
+                    std::this_thread::yield(); // a writer is inside
+                    continue;
+                }
+                std::optional<Value> copy;
+                _lookup(shard, key, hash, [&copy](const _pair& pair) {
+                    copy.emplace(pair.second);
+                });
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (shard.sequence.load(std::memory_order_relaxed) ==
+                    sequence) {
+                    if (copy.has_value()) {
+                        std::invoke(fn, std::as_const(*copy));
+                        return true;
+                    }
+                    return false;
+                }
+            }
+        }
+        std::shared_lock guard{ shard.mutex };
+        return _lookup(shard, key, hash, [&fn](const _pair& pair) {
+            std::invoke(fn, pair.second);
+        });
+    }
+
+    ATOM_NODISCARD _shard& _shard_of(size_t hash) const noexcept {
+        return shards_[hash & shard_mask_];
+    }
+
+    template <typename Fn>
+    auto _write(_shard& shard, Fn&& fn) {
+        std::unique_lock guard{ shard.mutex };
+        struct _publish {
+            _shard& shard;
+            uint64_t sequence;
+
+            ~_publish() {
+                shard.sequence.store(sequence + 2, std::memory_order_release);
+            }
+        } publish{ shard, shard.sequence.load(std::memory_order_relaxed) };
+        shard.sequence.store(publish.sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return fn();
+    }
+
+    /// Slot holding `key` at or after `from`, skipping migrated ones.
+    template <typename Ty>
+    ATOM_NODISCARD size_t _probe(
+        const _table& table, const Ty& key, size_t hash,
+        size_t from) const {
+        auto index = table.index_for(hash);
+        for (int8_t distance = 0;
+             table.entries[index].distance_from_desired >= distance;
+             ++distance, ++index) {
+            if (index >= from && equal_(table.entries[index].value.first, key)) {
+                return index;
+            }
+        }
+        return _npos;
+    }
+
+    template <typename Ty, typename Fn>
+    bool _lookup(
+        const _shard& shard, const Ty& key, size_t hash, Fn&& fn) const {
+        auto* const next  = shard.next.load(std::memory_order_acquire);
+        auto* const table = shard.current.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            if (const auto index = _probe(*next, key, hash, 0);
+                index != _npos) {
+                fn(next->entries[index].value);
+                return true;
+            }
+        }
+        if (table != nullptr) {
+            const auto from =
+                next != nullptr ? shard.cursor.load(std::memory_order_relaxed)
+                                : 0;
+            if (const auto index = _probe(*table, key, hash, from);
+                index != _npos) {
+                fn(table->entries[index].value);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename... Args>
+    bool _emplace(bool assign, const Key& key, Args&&... args) {
+        const auto hash = static_cast<size_t>(hash_(key));
+        auto& shard     = _shard_of(hash);
+        return _write(shard, [&] {
+            if (shard.next.load(std::memory_order_relaxed) != nullptr) {
+                _migrate(shard);
+            }
+            auto* const next  = shard.next.load(std::memory_order_relaxed);
+            auto* const table = shard.current.load(std::memory_order_relaxed);
+            _entry* found     = nullptr;
+            if (next != nullptr) {
+                if (const auto index = _probe(*next, key, hash, 0);
+                    index != _npos) {
+                    found = next->entries + index;
+                }
+            }
+            if (found == nullptr && table != nullptr) {
+                const auto from =
+                    next != nullptr
+                        ? shard.cursor.load(std::memory_order_relaxed)
+                        : 0;
+                if (const auto index = _probe(*table, key, hash, from);
+                    index != _npos) {
+                    found = table->entries + index;
+                }
+            }
+            if (found != nullptr) {
+                if (assign) {
+                    if constexpr (sizeof...(Args) == 1) {
+                        found->value.second = Value(std::forward<Args>(args)...);
+                    }
+                }
+                return false;
+            }
+
+            _pair pair(
+                std::piecewise_construct, std::forward_as_tuple(key),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+            auto* const target = _writable(shard, hash);
+            _place(*target, target->index_for(hash), std::move(pair));
+            shard.size.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        });
+    }
+
+    /// The table the shard inserts into, with room for `hash`.
+    _table* _writable(_shard& shard, size_t hash) {
+        while (true) {
+            auto* const next  = shard.next.load(std::memory_order_relaxed);
+            auto* const table = shard.current.load(std::memory_order_relaxed);
+            auto* const target = next != nullptr ? next : table;
+            if (target != nullptr && _fits(*target, hash)) {
+                return target;
+            }
+            if (table == nullptr) {
+                shard.current.store(
+                    _make_table(_min_slots), std::memory_order_release);
+            } else if (next != nullptr) {
+                // unlucky hashes filled the new table before the old one
+                // was emptied, rebuild it larger
+                shard.next.store(
+                    _rebuild(*next, next->slots * 2),
+                    std::memory_order_release);
+                _retire(next);
+            } else {
+                shard.next.store(
+                    _make_table(table->slots * 2), std::memory_order_release);
+                shard.cursor.store(0, std::memory_order_relaxed);
+                _migrate(shard);
+            }
+        }
+    }
+
+    /// Moves the next `migration_step` elements of a growing shard.
+    void _migrate(_shard& shard) {
+        auto* const next  = shard.next.load(std::memory_order_relaxed);
+        auto* const table = shard.current.load(std::memory_order_relaxed);
+        auto cursor       = shard.cursor.load(std::memory_order_relaxed);
+        const auto end    = table->extent() - 1;
+        for (size_t moved = 0; cursor != end && moved != migration_step;
+             ++cursor) {
+            auto& entry = table->entries[cursor];
+            if (entry.has_value()) {
+                const auto hash = static_cast<size_t>(hash_(entry.value.first));
+                if (!_fits(*next, hash)) {
+                    shard.cursor.store(cursor, std::memory_order_relaxed);
+                    _writable(shard, hash); // grows the new table
+                    _migrate(shard);
+                    return;
+                }
+                // a copy stays behind, readers skip it from now on
+                _place(
+                    *shard.next.load(std::memory_order_relaxed),
+                    shard.next.load(std::memory_order_relaxed)
+                        ->index_for(hash),
+                    _pair(std::move(entry.value)));
+                ++moved;
+            }
+        }
+        shard.cursor.store(cursor, std::memory_order_relaxed);
+        if (cursor == end) {
+            shard.current.store(
+                shard.next.load(std::memory_order_relaxed),
+                std::memory_order_release);
+            shard.next.store(nullptr, std::memory_order_release);
+            shard.cursor.store(0, std::memory_order_relaxed);
+            _retire(table);
+        }
+    }
+
+    /// Whether inserting `hash` keeps the load under one half and every
+    /// element displaced by robin hood within `max_lookups` of its slot.
+    static bool _fits(const _table& table, size_t hash) noexcept {
+        if ((table.size + 1) * 2 > table.slots) {
+            return false;
+        }
+        auto index = table.index_for(hash);
+        for (int8_t distance = 0;; ++distance, ++index) {
+            if (distance >= table.max_lookups) {
+                return false;
+            }
+            const auto existing = table.entries[index].distance_from_desired;
+            if (existing < 0) {
+                return true;
+            }
+            if (existing < distance) {
+                distance = existing;
+            }
+        }
+    }
+
+    /// Robin hood insertion, the same as `sherwood_v3_table`. `_fits` must
+    /// have been checked.
+    static void _place(_table& table, size_t index, _pair&& pair) noexcept {
+        _pair carried(std::move(pair));
+        for (int8_t distance = 0;; ++distance, ++index) {
+            auto& entry = table.entries[index];
+            if (entry.is_empty()) {
+                entry.emplace(distance, std::move(carried));
+                ++table.size;
+                return;
+            }
+            if (entry.distance_from_desired < distance) {
+                std::swap(distance, entry.distance_from_desired);
+                std::swap(carried, entry.value);
+            }
+        }
+    }
+
+    /// Backward shift deletion, the same as `sherwood_v3_table`. Elements
+    /// only move towards lower slots, never below `index`.
+    static void _erase_at(_table& table, size_t index) noexcept {
+        auto* current = table.entries + index;
+        current->destroy_value();
+        --table.size;
+        for (auto* next = current + 1; !next->is_at_desired_position();
+             ++current, ++next) {
+            current->emplace(
+                static_cast<int8_t>(next->distance_from_desired - 1),
+                std::move(next->value));
+            next->destroy_value();
+        }
+    }
+
+    template <typename Fn>
+    static void _for_each(const _table& table, size_t from, Fn& fn) {
+        const auto end = table.extent() - 1;
+        for (auto index = from; index < end; ++index) {
+            const auto& entry = table.entries[index];
+            if (entry.has_value()) {
+                std::invoke(fn, entry.value.first, entry.value.second);
+            }
+        }
+    }
+
+    _table* _make_table(size_t slots) {
+        _table_alloc table_alloc{ alloc_ };
+        auto* const table = _table_traits::allocate(table_alloc, 1);
+        ::new (table) _table{
+            _entry_alloc{ alloc_ }, nullptr, slots, 0, fibonacci_hash_policy{},
+            std::max(detailv3::min_lookups, detailv3::log2(slots))
+        };
+        table->policy.commit(table->policy.next_size_over(table->slots));
+        ATOM_TRY {
+            table->entries =
+                _entry_traits::allocate(table->alloc, table->extent());
+        }
+        ATOM_CATCH(...) {
+            table->~_table();
+            _table_traits::deallocate(table_alloc, table, 1);
+            ATOM_RETHROW;
+        }
+        const auto end = table->extent() - 1;
+        for (size_t i = 0; i < end; ++i) {
+            ::new (table->entries + i) _entry{};
+        }
+        ::new (table->entries + end) _entry{ _entry::special_end_value };
+        return table;
+    }
+
+    /// A table of `slots` holding the elements of `source`, which is only
+    /// moved from, so copied when read optimistically.
+    _table* _rebuild(_table& source, size_t slots) {
+        auto* table    = _make_table(slots);
+        const auto end = source.extent() - 1;
+        for (size_t i = 0; i < end; ++i) {
+            auto& entry = source.entries[i];
+            if (!entry.has_value()) {
+                continue;
+            }
+            const auto hash = static_cast<size_t>(hash_(entry.value.first));
+            if (!_fits(*table, hash)) {
+                _free_table(table);
+                return _rebuild(source, slots * 2);
+            }
+            _place(
+                *table, table->index_for(hash), _pair(std::move(entry.value)));
+        }
+        return table;
+    }
+
+    static void _free_table(_table* table) noexcept {
+        if (table == nullptr) {
+            return;
+        }
+        const auto extent = table->extent();
+        for (size_t i = 0; i + 1 < extent; ++i) {
+            if (table->entries[i].has_value()) {
+                table->entries[i].destroy_value();
+            }
+        }
+        for (size_t i = 0; i < extent; ++i) {
+            table->entries[i].~_entry();
+        }
+        _entry_traits::deallocate(table->alloc, table->entries, extent);
+        _table_alloc table_alloc{ table->alloc };
+        table->~_table();
+        _table_traits::deallocate(table_alloc, table, 1);
+    }
+
+    /// Frees a table unlinked from its shard once no reader could see it.
+    void _retire(_table* table) {
+        if (table == nullptr) {
+            return;
+        }
+        if constexpr (_optimistic) {
+            domain_.retire(table, [](void* erased) noexcept {
+                _free_table(static_cast<_table*>(erased));
+            });
+        } else {
+            _free_table(table); // readers hold the lock of the shard
+        }
+    }
+
+    ATOM_NO_UNIQUE_ADDR Hash hash_;
+    ATOM_NO_UNIQUE_ADDR Equal equal_;
+    ATOM_NO_UNIQUE_ADDR Alloc alloc_;
+    ATOM_NO_UNIQUE_ADDR _shard_alloc shard_alloc_;
+    size_t shard_mask_;
+    _shard* shards_ = nullptr;
+    mutable _domain domain_;
+};
+
+namespace pmr {
+
+template <
+    typename Key, typename Value, typename Hash = std::hash<Key>,
+    typename Equal = std::equal_to<Key>>
+using concurrent_flat_hash_map = neutron::concurrent_flat_hash_map<
+    Key, Value, Hash, Equal,
+    std::pmr::polymorphic_allocator<std::pair<Key, Value>>>;
+
+} // namespace pmr
+
+} // namespace neutron
@@ -0,0 +1,421 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <memory_resource> // IWYU pragma: keep
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "neutron/detail/concepts/allocator.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
+
+namespace neutron {
+
+/*! @cond TURN_OFF_DOXYGEN */
+namespace _concurrent_queue {
+
+inline constexpr size_t _cacheline =
+    std::hardware_destructive_interference_size;
+
+/// Capacity rounded up to a power of two, at least 2.
+constexpr size_t _ring_capacity(size_t capacity) noexcept {
+    return std::bit_ceil(capacity < 2 ? size_t{ 2 } : capacity);
+}
+
+} // namespace _concurrent_queue
+/*! @endcond */
+
+/**
+ * @class mpmc_queue
+ * @brief A bounded lock-free queue for any number of producers and consumers.
+ * @details The ring of Dmitry Vyukov: every cell carries a sequence number
+ * telling whether it is ready to be written or read at a given turn, so
+ * producers and consumers only contend on their own position counter and on
+ * the cells themselves. Cells are cache-line aligned so neighbouring ones are
+ * not falsely shared. The capacity is rounded up to a power of two.
+ * @tparam Ty Nothrow move constructible type of the elements.
+ */
+template <typename Ty, std_simple_allocator Alloc = std::allocator<Ty>>
+class mpmc_queue {
+    static_assert(std::is_nothrow_move_constructible_v<Ty>);
+
+    struct alignas(_concurrent_queue::_cacheline) _cell {
+        std::atomic<size_t> sequence;
+        alignas(Ty) std::byte storage[sizeof(Ty)];
+
+        Ty* get() noexcept {
+            return std::launder(reinterpret_cast<Ty*>(storage)); // NOLINT
+        }
+    };
+
+    using _cell_alloc  = rebind_alloc_t<Alloc, _cell>;
+    using _cell_traits = std::allocator_traits<_cell_alloc>;
+
+public:
+    using value_type     = Ty;
+    using allocator_type = Alloc;
+    using size_type      = size_t;
+
+    explicit mpmc_queue(size_type capacity, const Alloc& alloc = Alloc{})
+        : alloc_(alloc),
+          mask_(_concurrent_queue::_ring_capacity(capacity) - 1),
+          cells_(_cell_traits::allocate(alloc_, mask_ + 1)), enqueue_(0),
+          dequeue_(0) {
+        for (size_type i = 0; i <= mask_; ++i) {
+            ::new (cells_ + i) _cell{};
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_queue(const mpmc_queue&)            = delete;
+    mpmc_queue(mpmc_queue&&)                 = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(mpmc_queue&&)      = delete;
+
+    ~mpmc_queue() {
+        if constexpr (!std::is_trivially_destructible_v<Ty>) {
+            auto head = dequeue_.load(std::memory_order_relaxed);
+            auto tail = enqueue_.load(std::memory_order_relaxed);
+            for (; head != tail; ++head) {
+                cells_[head & mask_].get()->~Ty();
+            }
+        }
+        for (size_type i = 0; i <= mask_; ++i) {
+            cells_[i].~_cell();
+        }
+        _cell_traits::deallocate(alloc_, cells_, mask_ + 1);
+    }
+
+    /**
+     * @brief Constructs an element at the back, unless the queue is full.
+     * @details An element whose construction may throw is constructed before
+     * a cell is claimed, then moved in.
+     * @return Whether the element was pushed.
+     */
+    template <typename... Args>
+    bool try_emplace(Args&&... args) noexcept(
+        std::is_nothrow_constructible_v<Ty, Args...>) {
+        if constexpr (std::is_nothrow_constructible_v<Ty, Args...>) {
+            return _emplace(std::forward<Args>(args)...);
+        } else {
+            return _emplace(Ty(std::forward<Args>(args)...));
+        }
+    }
+
+    bool try_push(const Ty& value) noexcept(
+        std::is_nothrow_copy_constructible_v<Ty>) {
+        return try_emplace(value);
+    }
+
+    bool try_push(Ty&& value) noexcept { return try_emplace(std::move(value)); }
+
+    /**
+     * @brief Moves the front element into `out`, unless the queue is empty.
+     * @return Whether an element was popped. If the assignment throws, the
+     * element is dropped, and its cell released all the same.
+     */
+    bool try_pop(Ty& out) noexcept(std::is_nothrow_move_assignable_v<Ty>) {
+        auto pos = dequeue_.load(std::memory_order_relaxed);
+        while (true) {
+            auto& cell     = cells_[pos & mask_];
+            const auto seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff =
+                static_cast<std::ptrdiff_t>(seq) -
+                static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    auto* const value = cell.get();
+                    // the cell is claimed: it must be released even if the
+                    // assignment throws, or the ring is stuck at it
+                    const auto release = [&cell, value, pos, this]() noexcept {
+                        value->~Ty();
+                        cell.sequence.store(
+                            pos + mask_ + 1, std::memory_order_release);
+                    };
+                    if constexpr (std::is_nothrow_move_assignable_v<Ty>) {
+                        out = std::move(*value);
+                    } else {
+                        ATOM_TRY { out = std::move(*value); }
+                        ATOM_CATCH(...) {
+                            release();
+                            ATOM_RETHROW;
+                        }
+                    }
+                    release();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // not written yet, empty
+            } else {
+                pos = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ATOM_NODISCARD size_type capacity() const noexcept { return mask_ + 1; }
+
+    /**
+     * @brief Number of elements, only a hint while other threads operate.
+     */
+    ATOM_NODISCARD size_type size_approx() const noexcept {
+        const auto tail = enqueue_.load(std::memory_order_relaxed);
+        const auto head = dequeue_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return allocator_type{ alloc_ };
+    }
+
+private:
+    template <typename... Args>
+    bool _emplace(Args&&... args) noexcept {
+        auto pos = enqueue_.load(std::memory_order_relaxed);
+        while (true) {
+            auto& cell     = cells_[pos & mask_];
+            const auto seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff =
+                static_cast<std::ptrdiff_t>(seq) -
+                static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    ::new (cell.storage) Ty(std::forward<Args>(args)...);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // a whole lap behind, full
+            } else {
+                pos = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ATOM_NO_UNIQUE_ADDR _cell_alloc alloc_;
+    size_type mask_;
+    _cell* cells_;
+    alignas(_concurrent_queue::_cacheline) std::atomic<size_type> enqueue_;
+    alignas(_concurrent_queue::_cacheline) std::atomic<size_type> dequeue_;
+};
+
+/**
+ * @class spsc_ring
+ * @brief A bounded wait-free ring for one producer and one consumer thread.
+ * @details Each side owns its index and keeps a cached copy of the other's,
+ * refreshed only when the ring looks full or empty, so in the steady state a
+ * push or a pop touches no cache line written by the other side. `push` and
+ * `pop` over spans move batches at the cost of a single publication. The
+ * capacity is rounded up to a power of two.
+ * @warning At most one thread may push and one thread may pop at a time.
+ */
+template <typename Ty, std_simple_allocator Alloc = std::allocator<Ty>>
+class spsc_ring {
+    static_assert(std::is_nothrow_move_constructible_v<Ty>);
+
+    using _alloc_traits = std::allocator_traits<Alloc>;
+
+public:
+    using value_type     = Ty;
+    using allocator_type = Alloc;
+    using size_type      = size_t;
+
+    explicit spsc_ring(size_type capacity, const Alloc& alloc = Alloc{})
+        : alloc_(alloc),
+          mask_(_concurrent_queue::_ring_capacity(capacity) - 1),
+          buffer_(_alloc_traits::allocate(alloc_, mask_ + 1)) {}
+
+    spsc_ring(const spsc_ring&)            = delete;
+    spsc_ring(spsc_ring&&)                 = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+    spsc_ring& operator=(spsc_ring&&)      = delete;
+
+    ~spsc_ring() {
+        if constexpr (!std::is_trivially_destructible_v<Ty>) {
+            auto head       = head_.load(std::memory_order_relaxed);
+            const auto tail = tail_.load(std::memory_order_relaxed);
+            for (; head != tail; ++head) {
+                std::destroy_at(buffer_ + (head & mask_));
+            }
+        }
+        _alloc_traits::deallocate(alloc_, buffer_, mask_ + 1);
+    }
+
+    /**
+     * @brief Constructs an element at the back, unless the ring is full.
+     * Producer side.
+     * @return Whether the element was pushed.
+     */
+    template <typename... Args>
+    bool try_emplace(Args&&... args) noexcept(
+        std::is_nothrow_constructible_v<Ty, Args...>) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (_writable(tail, 1) == 0) {
+            return false;
+        }
+        std::construct_at(
+            buffer_ + (tail & mask_), std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const Ty& value) noexcept(
+        std::is_nothrow_copy_constructible_v<Ty>) {
+        return try_emplace(value);
+    }
+
+    bool try_push(Ty&& value) noexcept { return try_emplace(std::move(value)); }
+
+    /**
+     * @brief Copies as many of `values` as fit at the back. Producer side.
+     * @return Number of elements pushed, a prefix of `values`. If a copy
+     * throws, the ones before it are pushed.
+     */
+    size_type push(std::span<const Ty> values) noexcept(
+        std::is_nothrow_copy_constructible_v<Ty>) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        const auto count =
+            std::min(values.size(), _writable(tail, values.size()));
+        if constexpr (std::is_nothrow_copy_constructible_v<Ty>) {
+            for (size_type i = 0; i < count; ++i) {
+                std::construct_at(buffer_ + ((tail + i) & mask_), values[i]);
+            }
+        } else {
+            size_type i = 0;
+            ATOM_TRY {
+                for (; i < count; ++i) {
+                    std::construct_at(
+                        buffer_ + ((tail + i) & mask_), values[i]);
+                }
+            }
+            ATOM_CATCH(...) {
+                tail_.store(tail + i, std::memory_order_release);
+                ATOM_RETHROW;
+            }
+        }
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Moves the front element into `out`, unless the ring is empty.
+     * Consumer side.
+     * @return Whether an element was popped.
+     */
+    bool try_pop(Ty& out) noexcept(std::is_nothrow_move_assignable_v<Ty>) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (_readable(head, 1) == 0) {
+            return false;
+        }
+        auto* const value = buffer_ + (head & mask_);
+        out               = std::move(*value);
+        std::destroy_at(value);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Moves up to `out.size()` elements from the front into `out`.
+     * Consumer side.
+     * @return Number of elements popped, written to the front of `out`. If an
+     * assignment throws, the ones before it are popped and the element it
+     * failed on stays at the front.
+     */
+    size_type pop(std::span<Ty> out) noexcept(
+        std::is_nothrow_move_assignable_v<Ty>) {
+        const auto head  = head_.load(std::memory_order_relaxed);
+        const auto count = std::min(out.size(), _readable(head, out.size()));
+        if constexpr (std::is_nothrow_move_assignable_v<Ty>) {
+            for (size_type i = 0; i < count; ++i) {
+                auto* const value = buffer_ + ((head + i) & mask_);
+                out[i]            = std::move(*value);
+                std::destroy_at(value);
+            }
+        } else {
+            size_type i = 0;
+            ATOM_TRY {
+                for (; i < count; ++i) {
+                    auto* const value = buffer_ + ((head + i) & mask_);
+                    out[i]            = std::move(*value);
+                    std::destroy_at(value);
+                }
+            }
+            ATOM_CATCH(...) {
+                // the destroyed elements must not be destroyed again
+                head_.store(head + i, std::memory_order_release);
+                ATOM_RETHROW;
+            }
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    ATOM_NODISCARD size_type capacity() const noexcept { return mask_ + 1; }
+
+    /**
+     * @brief Number of elements, exact only on the producer or consumer side
+     * while the other one is idle.
+     */
+    ATOM_NODISCARD size_type size_approx() const noexcept {
+        // the head first: the consumer read a tail at least as far before
+        // publishing it, so a later load of the tail is not behind it
+        const auto head = head_.load(std::memory_order_acquire);
+        const auto tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    ATOM_NODISCARD bool empty() const noexcept { return size_approx() == 0; }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    // the cached index of the other side is refreshed only when it does not
+    // leave room for `wanted` elements
+
+    size_type _writable(size_type tail, size_type wanted) noexcept {
+        auto room = mask_ + 1 - (tail - head_cache_);
+        if (room < wanted) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            room        = mask_ + 1 - (tail - head_cache_);
+        }
+        return room;
+    }
+
+    size_type _readable(size_type head, size_type wanted) noexcept {
+        auto ready = tail_cache_ - head;
+        if (ready < wanted) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            ready       = tail_cache_ - head;
+        }
+        return ready;
+    }
+
+    ATOM_NO_UNIQUE_ADDR Alloc alloc_;
+    size_type mask_;
+    Ty* buffer_;
+    // consumer side
+    alignas(_concurrent_queue::_cacheline) std::atomic<size_type> head_{ 0 };
+    size_type tail_cache_ = 0;
+    // producer side
+    alignas(_concurrent_queue::_cacheline) std::atomic<size_type> tail_{ 0 };
+    size_type head_cache_ = 0;
+};
+
+namespace pmr {
+
+template <typename Ty>
+using mpmc_queue = mpmc_queue<Ty, std::pmr::polymorphic_allocator<Ty>>;
+
+template <typename Ty>
+using spsc_ring = spsc_ring<Ty, std::pmr::polymorphic_allocator<Ty>>;
+
+} // namespace pmr
+
+} // namespace neutron
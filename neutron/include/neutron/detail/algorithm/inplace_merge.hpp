@@ -14,15 +14,15 @@
 
 namespace neutron {
 
-template <std::ranges::random_access_range... Ranges>
+template <std::ranges::random_access_range... Ranges, typename Indices>
 constexpr void
-    _cycle_leader(Ranges&... ranges, std::vector<size_t>& indices, size_t size) noexcept(
+    _cycle_leader(Ranges&... ranges, Indices& indices, size_t size) noexcept(
         (std::is_nothrow_move_assignable_v<
              std::ranges::range_value_t<Ranges>> &&
          ...)) {
     constexpr auto is = std::index_sequence_for<Ranges...>();
 
-    auto begins = std::forward_as_tuple(std::ranges::begin(ranges)...);
+    auto begins = std::make_tuple(std::ranges::begin(ranges)...);
 
     for (size_t i = 0; i < size; ++i) {
         if (indices[i] == i) {
@@ -6,18 +6,24 @@
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <memory_resource>
 #include <new>
+#include <numeric>
 #include <span>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 #include "neutron/concepts.hpp"
+#include "neutron/detail/algorithm/inplace_merge.hpp"
 #include "neutron/detail/ecs/component.hpp"
 #include "neutron/detail/ecs/entity.hpp"
+#include "neutron/detail/ecs/entity_table.hpp"
 #include "neutron/detail/ecs/fwd.hpp"
 #include "neutron/detail/macros.hpp"
 #include "neutron/detail/memory/uninitialized_move_if_noexcept.hpp"
@@ -26,7 +32,7 @@
 #include "neutron/detail/reflection/legacy/hash_of.hpp"
 #include "neutron/detail/tuple/rmcvref_first.hpp"
 #include "neutron/detail/utility/spreader.hpp"
-#include "neutron/shift_map.hpp"
+#include "neutron/metafn.hpp"
 
 namespace neutron {
 
@@ -43,6 +49,12 @@ class _view_base;
 
 } // namespace _view
 
+namespace _snapshot {
+
+struct _access;
+
+} // namespace _snapshot
+
 // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 // NOLINTBEGIN(cppcoreguidelines-avoid-c-arrays)
 // NOLINTBEGIN(modernize-avoid-c-arrays)
@@ -69,6 +81,12 @@ struct basic_info {
      */
     template <typename Ty>
     consteval static basic_info make() noexcept {
+        // columns are moved with `move_if_noexcept` when growing or sorted,
+        // which must leave the source intact if it throws
+        static_assert(
+            std::is_nothrow_move_constructible_v<Ty> ||
+                std::is_copy_constructible_v<Ty>,
+            "a component must be nothrow move constructible or copyable");
         return { .trivially_copyable    = std::is_trivially_copyable_v<Ty>,
                  .trivially_relocatable = neutron::trivially_relocatable<Ty>,
                  .trivially_move_assignable =
@@ -132,6 +150,8 @@ class archetype<Alloc> {
     template <std_simple_allocator, component...>
     friend class _view::_eview_base;
 
+    friend struct _snapshot::_access;
+
     template <typename Ty>
     using _allocator_t = rebind_alloc_t<Alloc, Ty>;
 
@@ -172,6 +192,11 @@ public:
     using allocator_type   = _allocator_t<std::byte>;
     using allocator_traits = std::allocator_traits<allocator_type>;
 
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    /// Table of the archetype and the row of every entity, see `attach`.
+    using table_type = entity_table<archetype, allocator_type>;
+
     /**
      * @brief Constructs an archetype from a list of component types.
      *
@@ -240,7 +265,7 @@ public:
               alloc),
           storage_(sizeof...(Components), alloc), capacity_(initial_capacity),
           hash_(make_array_hash<type_list<Components...>>()),
-          entity2index_(alloc), index2entity_(alloc) {
+          owned_(nullptr, _table_deletor{ alloc }), index2entity_(alloc) {
         [this]<size_t... Is>(std::index_sequence<Is...>) {
             (_set_storage<Is, Components...>(), ...);
         }(std::index_sequence_for<Components...>());
@@ -266,7 +291,8 @@ public:
           move_assignments_(archetype.get_allocator()),
           destructors_(archetype.get_allocator()),
           storage_(archetype.get_allocator()),
-          entity2index_(archetype.get_allocator()),
+          owned_(nullptr, _table_deletor{ archetype.get_allocator() }),
+          table_(archetype._shared_table()),
           index2entity_(archetype.get_allocator())
     //   created_(archetype.get_allocator())
     {
@@ -344,7 +370,8 @@ public:
           move_assignments_(archetype.get_allocator()),
           destructors_(archetype.get_allocator()),
           storage_(archetype.get_allocator()),
-          entity2index_(archetype.get_allocator()),
+          owned_(nullptr, _table_deletor{ archetype.get_allocator() }),
+          table_(archetype._shared_table()),
           index2entity_(archetype.get_allocator()) {
         constexpr auto hash_array = make_hash_array<type_list<Components...>>();
 
@@ -402,13 +429,20 @@ public:
           basic_info_(std::move(that.basic_info_)),
           constructors_(std::move(that.constructors_)),
           move_constructors_(std::move(that.move_constructors_)),
+          move_assignments_(std::move(that.move_assignments_)),
           destructors_(std::move(that.destructors_)),
           storage_(std::move(that.storage_)),
           size_(std::exchange(that.size_, 0)),
           capacity_(std::exchange(that.capacity_, 0)),
           hash_(std::exchange(that.hash_, 0)),
-          entity2index_(std::move(that.entity2index_)),
-          index2entity_(std::move(that.index2entity_)) {}
+          owned_(std::move(that.owned_)),
+          table_(std::exchange(that.table_, nullptr)),
+          index2entity_(std::move(that.index2entity_)) {
+        for (size_type i = 0; i < size_; ++i) {
+            table_->rebind(
+                index2entity_[i], &that, this, static_cast<index_t>(i));
+        }
+    }
 
     archetype& operator=(archetype&&) = delete;
 
@@ -471,49 +505,97 @@ public:
         _emplace(entity, std::forward<Components>(components)...);
     }
 
-    constexpr void erase(entity_t entity) {
-        const auto index      = entity2index_.at(entity);
-        const auto last_index = size_ - 1;
+    /**
+     * @brief Appends `count` copies of a set of `rows` rows.
+     *
+     * Each column is filled in one pass: trivially copyable components are
+     * copied with `memcpy`, others with `uninitialized_copy_n`. Entities are
+     * taken from `make_entity`, which is called once per new row.
+     * @param count       Number of copies.
+     * @param rows        Number of rows in a copy.
+     * @param make_entity Invocable returning the entity of the next row.
+     * @param sources     Pointers to `rows` elements of each component.
+     */
+    template <component... Components, std::invocable Fn>
+    void emplace_copies(
+        size_type count, size_type rows, Fn&& make_entity,
+        const Components*... sources) {
+        assert(make_array_hash<type_list<Components...>>() == hash_);
+
+        const auto n = count * rows;
+        if (n == 0) {
+            return;
+        }
 
-        if (index != last_index) {
-            for (uint32_t i = 0; i < hash_list_.size(); ++i) {
-                const basic_info info = basic_info_[i];
-                if (info.size == 0) {
-                    continue;
-                }
+        if (size_ + n > capacity_) {
+            _relocate((std::max)(size_ + n, capacity_ << 1));
+        }
+        if (index2entity_.capacity() < size_ + n) {
+            index2entity_.reserve(
+                (std::max)(size_ + n, index2entity_.capacity() << 1));
+        }
 
-                auto* const data = storage_[i].get();
-                auto* dst        = data + (info.size * index);
-                auto* src        = data + (info.size * last_index);
+        auto columns = _get<Components...>();
+        [this, &columns, count, rows, sources...]<size_t... Is>(
+            std::index_sequence<Is...>) {
+            size_type succ = 0;
+            auto guard     = make_exception_guard([&, this]() noexcept {
+                const auto n = count * rows;
+                ((Is < succ ? _destroy_copies(std::get<Is>(columns), n)
+                            : void()),
+                 ...);
+            });
+            ((_copy_rows(std::get<Is>(columns), sources, rows, count), ++succ),
+             ...);
+            guard.mark_complete();
+        }(std::index_sequence_for<Components...>());
 
-                if (info.trivially_move_assignable) {
-                    std::memcpy(dst, src, info.size);
-                } else {
-                    // requires component move assignable
-                    move_assignments_[i](dst, src);
-                    // requires component destructible
-                    destructors_[i](src, 1);
-                }
+        auto guard = make_exception_guard([this, &columns, n]() noexcept {
+            for (size_type i = size_; i < index2entity_.size(); ++i) {
+                table_->unbind(index2entity_[i]);
             }
+            index2entity_.resize(size_);
+            std::apply(
+                [this, n](auto*... cols) { (_destroy_copies(cols, n), ...); },
+                columns);
+        });
+        for (size_type i = 0; i < n; ++i) {
+            const entity_t entity = make_entity();
+            index2entity_.push_back(entity);
+            _table().bind(entity, this, static_cast<index_t>(size_ + i));
+        }
+        guard.mark_complete();
+        size_ += n;
+    }
 
-            const auto last_entity     = index2entity_[last_index];
-            index2entity_[index]       = last_entity;
-            entity2index_[last_entity] = index;
-        } else {
-            for (uint32_t i = 0; i < hash_list_.size(); ++i) {
-                const basic_info info = basic_info_[i];
-                if (info.size == 0) {
-                    continue;
-                }
-
-                auto* const data = storage_[i].get();
-                destructors_[i](data + (info.size * index), 1);
-            }
+    /**
+     * @throw std::out_of_range If the entity is not stored here.
+     */
+    constexpr void erase(entity_t entity) {
+        const auto index = row_of(entity);
+        if (index == npos) [[unlikely]] {
+            throw std::out_of_range("archetype: entity is not stored here");
         }
+        _erase_row(index);
+    }
 
-        entity2index_.erase(entity);
-        index2entity_.pop_back();
-        --size_;
+    /**
+     * @brief Erases many entities, looking their rows up with `rows_of`.
+     * @throw std::out_of_range If an entity is not stored here or listed
+     * twice, then none is erased.
+     */
+    constexpr void erase(std::span<const entity_t> entities) {
+        _vector_t<size_type> rows(entities.size(), get_allocator());
+        rows_of(entities, rows.begin());
+        // from the last row, the one moved into a gap is never to be erased
+        std::ranges::sort(rows, std::ranges::greater{});
+        if ((!rows.empty() && rows.front() == npos) ||
+            std::ranges::adjacent_find(rows) != rows.end()) [[unlikely]] {
+            throw std::out_of_range("archetype: entity is not stored here");
+        }
+        for (const auto index : rows) {
+            _erase_row(index);
+        }
     }
 
     ATOM_NODISCARD constexpr size_type kinds() const noexcept {
@@ -540,11 +622,56 @@ public:
     ATOM_NODISCARD _buffer_ptr* data() noexcept { return storage_.data(); }
 
     ATOM_NODISCARD constexpr auto entities() noexcept {
-        return entity2index_ | std::views::keys;
+        return row_entities();
+    }
+
+    /**
+     * @brief Gets the entities in row order, aligned with the rows of views.
+     */
+    ATOM_NODISCARD constexpr auto row_entities() const noexcept
+        -> std::span<const entity_t> {
+        return { index2entity_.data(), size_ };
+    }
+
+    ATOM_NODISCARD constexpr bool contains(entity_t entity) const noexcept {
+        return _location(entity) != nullptr;
+    }
+
+    /**
+     * @brief Gets the row of an entity.
+     * @return The row, or `npos` if the entity is not stored here.
+     */
+    ATOM_NODISCARD constexpr size_type row_of(entity_t entity) const noexcept {
+        const auto* const loc = _location(entity);
+        return loc != nullptr ? loc->row : npos;
+    }
+
+    /**
+     * @brief Gets the rows of `entities`, `npos` for those not stored here.
+     * The locations are prefetched a few entities ahead of the lookups.
+     * @return `out` past the last row written.
+     */
+    template <std::output_iterator<size_type> Out>
+    constexpr Out rows_of(std::span<const entity_t> entities, Out out) const {
+        constexpr size_t distance = 8;
+        const auto count          = entities.size();
+        if (table_ == nullptr) {
+            return std::ranges::fill_n(out, count, npos);
+        }
+        for (size_t i = 0; i < (std::min)(distance, count); ++i) {
+            table_->prefetch(entities[i]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (i + distance < count) {
+                table_->prefetch(entities[i + distance]);
+            }
+            *out = row_of(entities[i]);
+            ++out;
+        }
+        return out;
     }
 
     constexpr void reserve(size_type n) {
-        entity2index_.reserve(n);
         index2entity_.reserve(n);
         if (capacity_ >= n) {
             return;
@@ -553,6 +680,17 @@ public:
         _relocate(n);
     }
 
+    /**
+     * @brief Records the rows of the entities in `table`, shared by all the
+     * archetypes of a world, instead of in a table of its own.
+     * @warning The rows already stored must be recorded in `table`, which
+     * holds for an empty archetype.
+     */
+    void attach(table_type& table) noexcept {
+        table_ = &table;
+        owned_.reset();
+    }
+
     ATOM_NODISCARD constexpr auto clear() {
         const auto kinds = hash_list_.size();
         for (size_type i = 0; i < kinds; ++i) {
@@ -560,11 +698,67 @@ public:
             auto* const ptr       = storage_[i].get();
             destructors_[i](ptr, size_);
         }
+        for (const auto entity : row_entities()) {
+            table_->unbind(entity);
+        }
         index2entity_.clear();
-        entity2index_.clear();
         size_ = 0;
     }
 
+    /**
+     * @brief Releases column capacity beyond the live rows.
+     *
+     * The capacity never drops below the initial capacity.
+     */
+    void shrink_to_fit() {
+        const auto capacity = (std::max)(size_, initial_capacity);
+        if (capacity >= capacity_) {
+            return;
+        }
+
+        _relocate(capacity);
+        index2entity_.shrink_to_fit();
+    }
+
+    /**
+     * @brief Reorders rows so that `proj(entity)` is ascending.
+     *
+     * Rows with equal keys keep their relative order.
+     * @return Whether any row has been moved.
+     */
+    template <typename Proj>
+    requires std::totally_ordered<std::invoke_result_t<Proj&, entity_t>>
+    bool sort(Proj proj) {
+        return _sort_rows(std::ranges::less{}, [this, &proj](size_t row) {
+            return std::invoke(proj, index2entity_[row]);
+        });
+    }
+
+    /**
+     * @brief Reorders rows so that `proj(key)` of component `Key` is ordered
+     * by `comp`.
+     *
+     * Sorting is incremental: the longest ordered prefix is kept, only the
+     * rows behind it are sorted and then merged into it. Rows appended since
+     * the last call, or whose keys have been modified near the end, cost
+     * little more than a pass over the keys. All columns are permuted in
+     * lockstep, so entities with close keys become adjacent in memory.
+     * @return Whether any row has been moved.
+     */
+    template <
+        component Key, typename Comp = std::ranges::less,
+        typename Proj = std::identity>
+    requires(!std::is_empty_v<Key>) &&
+            std::indirect_strict_weak_order<
+                Comp, std::projected<const Key*, Proj>>
+    bool sort_by(Comp comp = {}, Proj proj = {}) {
+        assert(has<Key>());
+        const Key* const keys = std::get<0>(_get<Key>());
+        return _sort_rows(comp, [keys, &proj](size_t row) -> decltype(auto) {
+            return std::invoke(proj, keys[row]);
+        });
+    }
+
     ATOM_NODISCARD constexpr auto get_allocator() const noexcept {
         return hash_list_.get_allocator();
     }
@@ -649,7 +843,7 @@ private:
             _relocate(capacity_ << 1);
         }
         _emplace_normally();
-        entity2index_.try_emplace(entity, index);
+        _table().bind(entity, this, index);
         index2entity_.push_back(entity);
         ++size_;
     }
@@ -724,7 +918,7 @@ private:
 
     auto _relocate(size_type capacity) {
         const auto kinds = hash_list_.size();
-        _vector_t<_buffer_ptr> buffers{ kinds, entity2index_.get_allocator() };
+        _vector_t<_buffer_ptr> buffers{ kinds, get_allocator() };
         _prepare_for_relocation(kinds, buffers, capacity);
         _relocate_data(kinds, buffers);
         capacity_ = capacity;
@@ -838,6 +1032,53 @@ private:
         capacity_ = capacity;
     }
 
+    // moves the last row into `index`
+    constexpr void _erase_row(size_type index) {
+        const entity_t entity = index2entity_[index];
+        const auto last_index = size_ - 1;
+
+        if (index != last_index) {
+            for (uint32_t i = 0; i < hash_list_.size(); ++i) {
+                const basic_info info = basic_info_[i];
+                if (info.size == 0) {
+                    continue;
+                }
+
+                auto* const data = storage_[i].get();
+                auto* dst        = data + (info.size * index);
+                auto* src        = data + (info.size * last_index);
+
+                if (info.trivially_move_assignable) {
+                    std::memcpy(dst, src, info.size);
+                } else {
+                    // requires component move assignable
+                    move_assignments_[i](dst, src);
+                    // requires component destructible
+                    destructors_[i](src, 1);
+                }
+            }
+
+            const auto last_entity = index2entity_[last_index];
+            index2entity_[index]   = last_entity;
+            table_->rebind(
+                last_entity, this, this, static_cast<index_t>(index));
+        } else {
+            for (uint32_t i = 0; i < hash_list_.size(); ++i) {
+                const basic_info info = basic_info_[i];
+                if (info.size == 0) {
+                    continue;
+                }
+
+                auto* const data = storage_[i].get();
+                destructors_[i](data + (info.size * index), 1);
+            }
+        }
+
+        table_->unbind(entity);
+        index2entity_.pop_back();
+        --size_;
+    }
+
     // emplace<...>();
 
     template <
@@ -915,7 +1156,7 @@ private:
             _relocate<Components...>(capacity_ << 1);
         }
         _emplace_normally<Components...>();
-        entity2index_.try_emplace(entity, index);
+        _table().bind(entity, this, index);
         index2entity_.push_back(entity);
         ++size_;
     }
@@ -1017,7 +1258,7 @@ private:
             _relocate<SortedComponents...>(capacity_ << 1);
         }
         _emplace_vals_normally(sorted, std::forward<Tup>(components));
-        entity2index_.try_emplace(entity, index);
+        _table().bind(entity, this, index);
         index2entity_.push_back(entity);
         ++size_;
     }
@@ -1054,6 +1295,283 @@ private:
         }(std::index_sequence_for<Components...>());
     }
 
+    // sort
+
+    template <typename Comp, typename KeyOf>
+    bool _sort_rows(Comp comp, KeyOf key_of) {
+        const auto less = [&comp, &key_of](size_t lhs, size_t rhs) {
+            return std::invoke(comp, key_of(lhs), key_of(rhs));
+        };
+
+        size_type sorted = size_ != 0 ? 1 : 0;
+        while (sorted < size_ && !less(sorted, sorted - 1)) {
+            ++sorted;
+        }
+        if (sorted == size_) {
+            return false;
+        }
+
+        _vector_t<size_t> order(size_, get_allocator());
+        std::iota(order.begin(), order.end(), size_t{ 0 });
+        const auto middle = order.begin() + static_cast<ptrdiff_t>(sorted);
+        std::stable_sort(middle, order.end(), less);
+        std::inplace_merge(order.begin(), middle, order.end(), less);
+        _permute(order);
+        return true;
+    }
+
+    /**
+     * @brief Moves row `order[i]` to row `i` for every column.
+     *
+     * Columns that are not trivially copyable are moved into new buffers
+     * first, which is the only step that could throw. A throwing move is a
+     * copy then, see `basic_info::make`, so the old buffers are intact until
+     * all succeeded. Others are permuted in place, cycle by cycle like
+     * `neutron::_cycle_leader`.
+     */
+    void _permute(_vector_t<size_t>& order) {
+        const auto kinds = hash_list_.size();
+        _vector_t<_buffer_ptr> buffers{ kinds, storage_.get_allocator() };
+        size_type scratch = 0;
+        for (size_type i = 0; i < kinds; ++i) {
+            const basic_info info = basic_info_[i];
+            if (info.size == 0) {
+                continue;
+            }
+
+            if (info.trivially_copyable) {
+                scratch = (std::max<size_type>)(scratch, info.size);
+            } else {
+                const auto align = _get_align(info.align);
+                buffers[i]       = _get_buffer(info.size, capacity_, align);
+            }
+        }
+        auto temp = _get_buffer(scratch, 1, _get_align(default_alignment));
+        _vector_t<bool> visited(size_, get_allocator());
+
+        size_type idx = 0;
+        size_type row = 0;
+        auto guard    = make_exception_guard(
+            [this, &buffers, &idx, &row]() noexcept {
+                for (size_type i = 0; i <= idx && i < buffers.size(); ++i) {
+                    if (buffers[i] != nullptr) {
+                        destructors_[i](
+                            buffers[i].get(), i < idx ? size_ : row);
+                    }
+                }
+            });
+        for (; idx < kinds; ++idx) {
+            if (buffers[idx] == nullptr) {
+                continue;
+            }
+
+            const auto size = basic_info_[idx].size;
+            auto* const src = storage_[idx].get();
+            auto* const dst = buffers[idx].get();
+            for (row = 0; row < size_; ++row) {
+                move_constructors_[idx](
+                    src + (size * order[row]), 1, dst + (size * row));
+            }
+        }
+        guard.mark_complete();
+
+        for (size_type i = 0; i < kinds; ++i) {
+            const basic_info info = basic_info_[i];
+            if (buffers[i] != nullptr) {
+                destructors_[i](storage_[i].get(), size_);
+                storage_[i] = std::move(buffers[i]);
+            } else if (info.size != 0) {
+                std::fill(visited.begin(), visited.end(), false);
+                _permute_in_place(
+                    storage_[i].get(), info.size, order, visited, temp.get());
+            }
+        }
+
+        _cycle_leader<_vector_t<entity_t>>(index2entity_, order, size_);
+        _reindex();
+    }
+
+    void _permute_in_place(
+        std::byte* data, size_t size, const _vector_t<size_t>& order,
+        _vector_t<bool>& visited, std::byte* temp) const noexcept {
+        for (size_type i = 0; i < size_; ++i) {
+            if (visited[i] || order[i] == i) {
+                continue;
+            }
+
+            std::memcpy(temp, data + (size * i), size);
+            auto curr = i;
+            while (true) {
+                visited[curr]   = true;
+                const auto next = order[curr];
+                if (next == i) {
+                    std::memcpy(data + (size * curr), temp, size);
+                    break;
+                }
+                std::memcpy(data + (size * curr), data + (size * next), size);
+                curr = next;
+            }
+        }
+    }
+
+    // emplace_copies(...);
+
+    /**
+     * @brief Writes `count` copies of `rows` elements behind the last row.
+     */
+    template <typename Ty>
+    void _copy_rows(
+        Ty* column, const Ty* src, size_type rows, size_type count) const {
+        if constexpr (std::is_empty_v<Ty>) {
+            return;
+        } else if constexpr (std::is_trivially_copyable_v<Ty>) {
+            // copy once, then double the copied range
+            auto* const dst  = reinterpret_cast<std::byte*>(column + size_);
+            const auto total = sizeof(Ty) * rows * count;
+            size_type copied = sizeof(Ty) * rows;
+            std::memcpy(dst, src, copied);
+            while (copied < total) {
+                const auto length = (std::min)(copied, total - copied);
+                std::memcpy(dst + copied, dst, length);
+                copied += length;
+            }
+        } else if (rows == 1) {
+            std::uninitialized_fill_n(column + size_, count, *src);
+        } else {
+            auto* const dst = column + size_;
+            size_type done  = 0;
+            auto guard      = make_exception_guard([dst, rows, &done] {
+                std::destroy_n(dst, rows * done);
+            });
+            for (; done < count; ++done) {
+                std::uninitialized_copy_n(src, rows, dst + (rows * done));
+            }
+            guard.mark_complete();
+        }
+    }
+
+    template <typename Ty>
+    void _destroy_copies(Ty* column, size_type n) const noexcept {
+        if constexpr (!std::is_empty_v<Ty>) {
+            std::destroy_n(column + size_, n);
+        }
+    }
+
+    // resize
+
+    /**
+     * @brief Grows or shrinks the row count without touching entity lookup.
+     *
+     * New rows of trivially copyable columns are zero-filled, other columns
+     * are default constructed. The caller is expected to fill
+     * `index2entity_` and call `_reindex()` afterwards.
+     */
+    void _resize(size_type n) {
+        if (n > capacity_) {
+            _relocate((std::max)(n, capacity_ << 1));
+        }
+
+        const auto kinds = hash_list_.size();
+        if (n > size_) {
+            const auto count = n - size_;
+            size_type idx    = 0;
+            auto guard = make_exception_guard([this, &idx, count]() noexcept {
+                for (size_type i = 0; i < idx; ++i) {
+                    const basic_info info = basic_info_[i];
+                    if (info.size != 0 && !info.trivially_copyable) {
+                        destructors_[i](
+                            storage_[i].get() + (info.size * size_), count);
+                    }
+                }
+            });
+            for (; idx < kinds; ++idx) {
+                const basic_info info = basic_info_[idx];
+                if (info.size == 0) {
+                    continue;
+                }
+
+                auto* const tail = storage_[idx].get() + (info.size * size_);
+                if (info.trivially_copyable) {
+                    std::memset(tail, 0, info.size * count);
+                } else {
+                    constructors_[idx](tail, count);
+                }
+            }
+            guard.mark_complete();
+        } else {
+            for (size_type i = 0; i < kinds; ++i) {
+                const basic_info info = basic_info_[i];
+                if (info.size == 0 || info.trivially_copyable) {
+                    continue;
+                }
+
+                destructors_[i](
+                    storage_[i].get() + (info.size * n), size_ - n);
+            }
+        }
+
+        index2entity_.resize(n);
+        size_ = n;
+    }
+
+    /**
+     * @brief Records the row of every entity from `index2entity_`.
+     */
+    void _reindex() {
+        for (size_type i = 0; i < size_; ++i) {
+            _table().bind(index2entity_[i], this, static_cast<index_t>(i));
+        }
+    }
+
+    /// Destroys and frees the table of an archetype standing alone.
+    struct _table_deletor {
+        allocator_type alloc;
+
+        void operator()(table_type* table) const noexcept {
+            using traits = std::allocator_traits<_allocator_t<table_type>>;
+            _allocator_t<table_type> table_alloc{ alloc };
+            std::destroy_at(table);
+            traits::deallocate(table_alloc, table, 1);
+        }
+    };
+
+    using _table_ptr = std::unique_ptr<table_type, _table_deletor>;
+
+    /**
+     * @brief The table the rows are recorded in, one of the archetype's own
+     * allocated on first use unless it has been attached to a shared one.
+     */
+    table_type& _table() {
+        if (table_ == nullptr) [[unlikely]] {
+            using traits = std::allocator_traits<_allocator_t<table_type>>;
+            _allocator_t<table_type> alloc{ owned_.get_deleter().alloc };
+            auto* const table = traits::allocate(alloc, 1);
+            auto guard        = make_exception_guard([&alloc, table]() noexcept {
+                traits::deallocate(alloc, table, 1);
+            });
+            std::construct_at(table, owned_.get_deleter().alloc);
+            guard.mark_complete();
+            owned_.reset(table);
+            table_ = table;
+        }
+        return *table_;
+    }
+
+    /**
+     * @brief The table an archetype built from this one records its rows in:
+     * the table of the world this one shares, or none until it needs its own.
+     */
+    ATOM_NODISCARD table_type* _shared_table() const noexcept {
+        return owned_ ? nullptr : table_;
+    }
+
+    /**
+     * @brief The location of `entity`, if it is stored here.
+     */
+    ATOM_NODISCARD const auto* _location(entity_t entity) const noexcept {
+        return table_ != nullptr ? table_->find(entity, this) : nullptr;
+    }
+
     template <component... Components>
     ATOM_NODISCARD auto _get()
         -> std::tuple<std::remove_cvref_t<Components>*...> {
@@ -1079,8 +1597,11 @@ private:
     size_type size_{};
     size_type capacity_{};
     uint64_t hash_{};
-    shift_map<entity_t, index_t, 256UL, half_bits<entity_t>, Alloc>
-        entity2index_;
+    /// Rows of the entities when the archetype stands alone, allocated once
+    /// the first one is stored.
+    _table_ptr owned_;
+    /// `owned_`, the table shared by all the archetypes of a world, or none.
+    table_type* table_{};
     // _vector_t<bool> created_;
     _vector_t<entity_t> index2entity_;
 };
@@ -0,0 +1,28 @@
+// IWYU pragma: private, include <neutron/ecs.hpp>
+#pragma once
+#include "neutron/detail/ecs/fwd.hpp"
+
+#include <cstddef>
+#include "neutron/detail/ecs/construct_from_world.hpp"
+#include "neutron/detail/ecs/world_accessor.hpp"
+#include "neutron/detail/memory/frame_arena.hpp"
+
+namespace neutron {
+
+/**
+ * @brief A system taking an `arena_allocator<Ty>` draws from a frame arena of
+ * the world, rewound at the end of each `call_update`.
+ *
+ * Systems of a system list run concurrently, and each one is given the arena
+ * of its position in the list, so no two of them share an arena at once.
+ */
+template <auto Sys, typename Ty, size_t Index>
+struct construct_from_world_t<Sys, arena_allocator<Ty>, Index> {
+    template <world World>
+    arena_allocator<Ty> operator()(World& world) const noexcept {
+        auto& arenas = world_accessor::frame_arenas(world);
+        return arena_allocator<Ty>{ arenas[Index % arenas.size()] };
+    }
+};
+
+} // namespace neutron
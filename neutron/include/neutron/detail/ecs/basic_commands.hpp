@@ -3,7 +3,9 @@
 #include "neutron/detail/ecs/fwd.hpp"
 
 #include <concepts>
+#include <functional>
 #include <memory_resource>
+#include <span>
 #include <utility>
 #include "neutron/detail/ecs/command_buffer.hpp"
 #include "neutron/detail/ecs/construct_from_world.hpp"
@@ -58,10 +60,41 @@ public:
             entity);
     }
 
+    template <std_simple_allocator Al, component... Components>
+    future_entity_t instantiate(
+        const basic_prefab<Al, Components...>& prefab, size_t count = 1) {
+        return command_buffer_->instantiate(prefab, count);
+    }
+
+    /**
+     * @brief Sorts the rows of the archetypes holding `Key` when the command
+     * buffer is applied, for queriors using `order_by`.
+     */
+    template <
+        component Key, typename Comp = std::ranges::less,
+        typename Proj = std::identity>
+    void sort_by(Comp comp = {}, Proj proj = {}) {
+        command_buffer_->template sort_by<Key>(
+            std::move(comp), std::move(proj));
+    }
+
+    /**
+     * @brief Refreshes `index` from the entities marked on it when the
+     * command buffer is applied, after the commands recorded before.
+     */
+    template <typename Index>
+    void refresh(Index& index) {
+        command_buffer_->refresh(index);
+    }
+
     void kill(future_entity_t entity) { command_buffer_->kill(entity); }
 
     void kill(entity_t entity) { return command_buffer_->kill(entity); }
 
+    void kill(std::span<const entity_t> entities) {
+        command_buffer_->kill(entities);
+    }
+
     command_buffer<Alloc>* get_command_buffer() const noexcept {
         return command_buffer_;
     }
@@ -1,12 +1,20 @@
 #pragma once
 #include "neutron/detail/ecs/fwd.hpp"
 
+#include <algorithm>
 #include <concepts>
 #include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <ranges>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 #include "neutron/detail/ecs/archetype.hpp"
 #include "neutron/detail/ecs/bundle.hpp"
+#include "neutron/detail/ecs/entity.hpp"
 #include "neutron/detail/ecs/world_accessor.hpp"
 #include "neutron/detail/macros.hpp"
 #include "neutron/detail/type_traits/same_cvref.hpp"
@@ -94,6 +102,29 @@ struct changed {
     constexpr bool fetch(const auto& archetype) { return true; }
 };
 
+/**
+ * @brief Matches the archetypes holding component `Key`, whose rows are
+ * visited in the order kept by `world_base::sort_by<Key>(Comp{}, Proj{})`.
+ *
+ * The querior itself never reorders rows, as it could be constructed while
+ * other systems read the same columns. The sort is an explicit pass instead:
+ * call `sort_by` on the world between stages, or record it with
+ * `commands::sort_by` so that it runs when the command buffers are applied.
+ * Rows added or modified since the last pass may be out of order.
+ */
+template <
+    component Key, typename Comp = std::ranges::less,
+    typename Proj = std::identity>
+struct order_by {
+    using key_type        = Key;
+    using comparator_type = Comp;
+    using projection_type = Proj;
+
+    constexpr bool init(const auto& archetype) {
+        return archetype.template has<Key>();
+    }
+};
+
 template <typename Ty>
 struct _is_with_like {
     constexpr static auto value = is_specific_type_list_v<with, Ty> ||
@@ -133,6 +164,15 @@ concept _has_fetch =
         { filter.fetch(archetype, entity) } -> std::same_as<bool>;
     };
 
+/**
+ * @brief A filter narrowing the query to the entities it selects, e.g. those
+ * a spatial index finds in a region. It calls `fn(entity)` for each of them.
+ */
+template <typename Filter>
+concept _has_select = requires(const Filter& filter, void (*fn)(entity_t)) {
+    filter.select(fn);
+};
+
 } // namespace _query_filter
 
 template <typename Filter, typename Alloc>
@@ -159,6 +199,11 @@ class basic_querior<Alloc, Count, Filters...> {
     template <typename... Tys>
     using _query_t = basic_querior<Alloc, Count, Tys...>;
 
+    using _row_t = std::pair<_archetype_t*, size_t>;
+
+    static constexpr bool _selective =
+        (_query_filter::_has_select<Filters> || ...);
+
     template <typename Filter>
     struct _has_init :
         std::bool_constant<_query_filter::_has_init<
@@ -183,48 +228,176 @@ public:
     using eview_t = type_list_rebind_t<_eview_type, component_list>;
 
     template <world World>
+    requires(std::default_initializable<Filters> && ...)
     explicit basic_querior(World& world) {
-        auto& archetypes = world_accessor::archetypes(world);
-        for (auto& [hash, archetype] : archetypes) {
-            if (_init(initable_filters{}, archetype)) {
-                archetypes_.emplace_back(&archetype);
-            }
-        }
+        _watch(world);
     }
 
-    auto get() noexcept {
-        return archetypes_ | std::views::transform([](_archetype_t* archetype) {
-                   return view_of(*archetype, component_list{});
-               }) |
-               std::views::join;
+    /**
+     * @brief Constructs a querior from filter instances, for filters carrying
+     * state such as `in_region` or `in_radius`.
+     *
+     * If any filter selects entities, only the rows of the selected entities
+     * are visited instead of whole archetypes.
+     */
+    template <world World>
+    requires(sizeof...(Filters) != 0)
+    basic_querior(World& world, Filters... filters)
+        : filters_(std::move(filters)...) {
+        _watch(world);
     }
 
-    auto get_with_entity() noexcept {
-        return archetypes_ | std::views::transform([](_archetype_t* archetype) {
-                   // TODO: something like zip view
-                   return view_of(*archetype, component_list{});
-               }) |
-               std::views::join;
+    /**
+     * @note The archetypes are collected again first if the world has been
+     * compacted since, see `world_base::compact`.
+     */
+    auto get() {
+        _refresh();
+        if constexpr (_selective) {
+            return rows_ | std::views::transform([](const _row_t& row) {
+                       return *(
+                           view_of(*row.first, component_list{}).begin() +
+                           static_cast<ptrdiff_t>(row.second));
+                   });
+        } else {
+            return archetypes_ |
+                   std::views::transform([](_archetype_t* archetype) {
+                       return view_of(*archetype, component_list{});
+                   }) |
+                   std::views::join;
+        }
     }
 
-    auto entities() noexcept {
-        return archetypes_ | std::views::transform([](_archetype_t* archetype) {
-                   return archetype->entities();
-               }) |
-               std::views::join;
+    auto get_with_entity() {
+        _refresh();
+        if constexpr (_selective) {
+            return get();
+        } else {
+            return archetypes_ |
+                   std::views::transform([](_archetype_t* archetype) {
+                       // TODO: something like zip view
+                       return view_of(*archetype, component_list{});
+                   }) |
+                   std::views::join;
+        }
     }
 
-    ATOM_NODISCARD auto raw() noexcept -> _vector_t<_archetype_t*> {
+    auto entities() {
+        _refresh();
+        if constexpr (_selective) {
+            return rows_ | std::views::transform([](const _row_t& row) {
+                       return row.first->row_entities()[row.second];
+                   });
+        } else {
+            return archetypes_ |
+                   std::views::transform([](_archetype_t* archetype) {
+                       return archetype->entities();
+                   }) |
+                   std::views::join;
+        }
+    }
+
+    ATOM_NODISCARD auto raw() -> _vector_t<_archetype_t*> {
+        _refresh();
         return archetypes_;
     }
 
-    ATOM_NODISCARD size_t size() const noexcept { return archetypes_.size(); }
+    ATOM_NODISCARD size_t size() const {
+        _refresh();
+        return archetypes_.size();
+    }
 
 private:
-    template <typename... Flt>
+    /**
+     * @brief Collects the archetypes of `world`, and remembers how to do it
+     * again once it has been compacted.
+     */
+    template <world World>
+    void _watch(World& world) {
+        world_   = std::addressof(world);
+        epoch_   = &world_accessor::compact_epoch(world);
+        collect_ = [](const basic_querior& self) {
+            auto& world = *static_cast<World*>(self.world_);
+            std::apply(
+                [&self, &world](auto&... filters) {
+                    self._collect(world, filters...);
+                },
+                self.filters_);
+        };
+        collect_(*this);
+    }
+
+    void _refresh() const {
+        if (seen_ != *epoch_) [[unlikely]] {
+            archetypes_.clear();
+            rows_.clear();
+            collect_(*this);
+        }
+    }
+
+    template <world World>
+    void _collect(World& world, Filters&... filters) const {
+        seen_            = *epoch_;
+        auto& archetypes = world_accessor::archetypes(world);
+        for (auto& [hash, archetype] : archetypes) {
+            if ((_init(filters, archetype) && ...)) {
+                archetypes_.emplace_back(&archetype);
+            }
+        }
+        if constexpr (_selective) {
+            _select(filters...);
+        }
+    }
+
+    template <typename Flt>
     ATOM_NODISCARD static bool
-        _init(type_list<Flt...>, const _archetype_t& archetype) noexcept {
-        return (Flt{}.init(archetype) && ...);
+        _init(Flt& filter, const _archetype_t& archetype) noexcept {
+        if constexpr (_has_init<Flt>::value) {
+            return filter.init(archetype);
+        } else {
+            return true;
+        }
+    }
+
+    /**
+     * @brief Intersects the entities of all selecting filters, then keeps the
+     * rows of them in matched archetypes.
+     */
+    void _select(const Filters&... filters) const {
+        using entities_type = std::vector<entity_t, _allocator_t<entity_t>>;
+        entities_type selected;
+        entities_type next;
+        entities_type scratch;
+        bool first       = true;
+        auto select_with = [&](const auto& filter) {
+            using filter_type = std::remove_cvref_t<decltype(filter)>;
+            if constexpr (_query_filter::_has_select<filter_type>) {
+                next.clear();
+                filter.select([&next](entity_t entity) {
+                    next.push_back(entity);
+                });
+                std::ranges::sort(next);
+                if (first) {
+                    selected.swap(next);
+                    first = false;
+                } else {
+                    scratch.clear();
+                    std::ranges::set_intersection(
+                        selected, next, std::back_inserter(scratch));
+                    selected.swap(scratch);
+                }
+            }
+        };
+        (select_with(filters), ...);
+
+        for (_archetype_t* archetype : archetypes_) {
+            for (const auto entity : selected) {
+                const auto row = archetype->row_of(entity);
+                if (row != _archetype_t::npos) {
+                    rows_.emplace_back(archetype, row);
+                }
+            }
+        }
     }
 
     template <typename... Flt>
@@ -234,7 +407,14 @@ private:
         return (Flt{}.fetch(archetype, entity) && ...);
     }
 
-    _vector_t<_archetype_t*> archetypes_;
+    void* world_{};
+    const uint64_t* epoch_{};
+    void (*collect_)(const basic_querior&){};
+    // collected again on access once the world has been compacted
+    mutable std::tuple<Filters...> filters_;
+    mutable uint64_t seen_{};
+    mutable _vector_t<_archetype_t*> archetypes_;
+    mutable _vector_t<_row_t> rows_;
 };
 
 namespace internal {
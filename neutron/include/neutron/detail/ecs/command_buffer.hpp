@@ -4,16 +4,16 @@
 
 #include <concepts>
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <new>
+#include <span>
 #include <type_traits>
 #include <vector>
 #include "neutron/detail/ecs/world_base.hpp"
 
 #ifndef neutron_STD_FUNCTION_CMDBUF
     #include <bit>
-#else
-    #include <functional>
 #endif
 
 namespace neutron {
@@ -253,6 +253,25 @@ private:
     entity_t entity_;
 };
 
+template <typename Alloc, typename Prefab>
+class _instantiate : _command_impl_base<_instantiate<Alloc, Prefab>, Alloc> {
+public:
+    using future_map_t = typename _command_base<Alloc>::future_map_t;
+
+    _instantiate(
+        future_entity_t first, const Prefab& prefab, size_t count) noexcept
+        : first_(first), count_(count), prefab_(&prefab) {}
+
+    void invoke(world_base<Alloc>& world, future_map_t& future_map) {
+        world.instantiate(*prefab_, count_, future_map.begin() + first_.get());
+    }
+
+private:
+    future_entity_t first_;
+    size_t count_;
+    const Prefab* prefab_;
+};
+
 template <typename Alloc>
 class _kill_fut : _command_impl_base<_kill_fut<Alloc>, Alloc> {
 public:
@@ -284,6 +303,60 @@ private:
     entity_t entity_;
 };
 
+template <typename Alloc>
+class _kill_batch : _command_impl_base<_kill_batch<Alloc>, Alloc> {
+public:
+    using future_map_t = typename _command_base<Alloc>::future_map_t;
+
+    _kill_batch(std::span<const entity_t> entities, const Alloc& alloc)
+        : entities_(entities.begin(), entities.end(), alloc) {}
+
+    void invoke(
+        world_base<Alloc>& world, [[maybe_unused]] future_map_t& future_map) {
+        world.kill(std::span<const entity_t>{ entities_ });
+    }
+
+private:
+    future_map_t entities_;
+};
+
+template <typename Alloc, component Key, typename Comp, typename Proj>
+class _sort_by :
+    _command_impl_base<_sort_by<Alloc, Key, Comp, Proj>, Alloc> {
+public:
+    using future_map_t = typename _command_base<Alloc>::future_map_t;
+
+    _sort_by(Comp comp, Proj proj) noexcept(
+        std::is_nothrow_move_constructible_v<Comp> &&
+        std::is_nothrow_move_constructible_v<Proj>)
+        : comp_(std::move(comp)), proj_(std::move(proj)) {}
+
+    void invoke(
+        world_base<Alloc>& world, [[maybe_unused]] future_map_t& future_map) {
+        world.template sort_by<Key>(std::move(comp_), std::move(proj_));
+    }
+
+private:
+    Comp comp_;
+    Proj proj_;
+};
+
+template <typename Alloc, typename Index>
+class _refresh : _command_impl_base<_refresh<Alloc, Index>, Alloc> {
+public:
+    using future_map_t = typename _command_base<Alloc>::future_map_t;
+
+    _refresh(Index& index) noexcept : index_(&index) {}
+
+    void invoke(
+        world_base<Alloc>& world, [[maybe_unused]] future_map_t& future_map) {
+        index_->refresh(world);
+    }
+
+private:
+    Index* index_;
+};
+
 } // namespace _command
 
 template <std_simple_allocator Alloc>
@@ -432,6 +505,28 @@ public:
         commands_.emplace_back(ptr);
     }
 
+    /**
+     * @brief Records instantiating `count` copies of `prefab`.
+     *
+     * The prefab is referenced, not copied: it should outlive `apply` and
+     * keep its row count until then.
+     * @return Future of the first new entity. The others follow it copy by
+     * copy and row by row with consecutive in-frame indices.
+     */
+    template <std_simple_allocator Al, component... Components>
+    future_entity_t instantiate(
+        const basic_prefab<Al, Components...>& prefab, size_t count = 1) {
+        using command =
+            _command::_instantiate<Alloc, basic_prefab<Al, Components...>>;
+
+        auto* const ptr = _assure<command>();
+        const auto fut  = future_entity_t{ inframe_index_ };
+        inframe_index_ += static_cast<index_t>(prefab.size() * count);
+        ::new (ptr) command{ fut, prefab, count };
+        commands_.emplace_back(ptr);
+        return fut;
+    }
+
     void kill(future_entity_t entity) {
         using command = _command::_kill_fut<Alloc>;
 
@@ -448,6 +543,48 @@ public:
         commands_.emplace_back(ptr);
     }
 
+    /**
+     * @brief Records killing `entities`, erased from their archetypes in
+     * runs, see `world_base::kill`.
+     */
+    void kill(std::span<const entity_t> entities) {
+        using command = _command::_kill_batch<Alloc>;
+
+        auto* const ptr = _assure<command>();
+        ::new (ptr) command{ entities, get_allocator() };
+        commands_.emplace_back(ptr);
+    }
+
+    /**
+     * @brief Records sorting the rows of the archetypes holding `Key`, see
+     * `world_base::sort_by`.
+     */
+    template <
+        component Key, typename Comp = std::ranges::less,
+        typename Proj = std::identity>
+    void sort_by(Comp comp = {}, Proj proj = {}) {
+        using command = _command::_sort_by<Alloc, Key, Comp, Proj>;
+
+        auto* const ptr = _assure<command>();
+        ::new (ptr) command{ std::move(comp), std::move(proj) };
+        commands_.emplace_back(ptr);
+    }
+
+    /**
+     * @brief Records refreshing `index`, e.g. a `spatial_grid`, from the
+     * entities marked on it, after the commands recorded before.
+     *
+     * The index is referenced, it should outlive `apply`.
+     */
+    template <typename Index>
+    void refresh(Index& index) {
+        using command = _command::_refresh<Alloc, Index>;
+
+        auto* const ptr = _assure<command>();
+        ::new (ptr) command{ index };
+        commands_.emplace_back(ptr);
+    }
+
     void apply(world_base<Alloc>& world) {
         _vector_t<entity_t> future_map(
             inframe_index_, commands_.get_allocator());
@@ -644,6 +781,28 @@ public:
             });
     }
 
+    /**
+     * @brief Records instantiating `count` copies of `prefab`.
+     *
+     * The prefab is referenced, not copied: it should outlive `apply` and
+     * keep its row count until then.
+     * @return Future of the first new entity. The others follow it copy by
+     * copy and row by row with consecutive in-frame indices.
+     */
+    template <std_simple_allocator Al, component... Components>
+    future_entity_t instantiate(
+        const basic_prefab<Al, Components...>& prefab, size_t count = 1) {
+        const auto fut = future_entity_t{ inframe_index_ };
+        inframe_index_ += static_cast<index_t>(prefab.size() * count);
+        commands_.emplace_back(
+            [fut, &prefab, count](
+                _world_base& world, _vector_t<entity_t>& future_map) {
+                world.instantiate(
+                    prefab, count, future_map.begin() + fut.get());
+            });
+        return fut;
+    }
+
     void kill(future_entity_t entity) {
         commands_.emplace_back(
             [entity](
@@ -662,6 +821,49 @@ public:
             });
     }
 
+    /**
+     * @brief Records killing `entities`, erased from their archetypes in
+     * runs, see `world_base::kill`.
+     */
+    void kill(std::span<const entity_t> entities) {
+        commands_.emplace_back(
+            [entities = _vector_t<entity_t>(
+                 entities.begin(), entities.end(), commands_.get_allocator())](
+                _world_base& world, [[maybe_unused]] _vector_t<entity_t>&) {
+                world.kill(std::span<const entity_t>{ entities });
+            });
+    }
+
+    /**
+     * @brief Records sorting the rows of the archetypes holding `Key`, see
+     * `world_base::sort_by`.
+     */
+    template <
+        component Key, typename Comp = std::ranges::less,
+        typename Proj = std::identity>
+    void sort_by(Comp comp = {}, Proj proj = {}) {
+        commands_.emplace_back(
+            [comp = std::move(comp), proj = std::move(proj)](
+                _world_base& world, [[maybe_unused]] _vector_t<entity_t>&) {
+                world.template sort_by<Key>(comp, proj);
+            });
+    }
+
+    /**
+     * @brief Records refreshing `index`, e.g. a `spatial_grid`, from the
+     * entities marked on it, after the commands recorded before.
+     *
+     * The index is referenced, it should outlive `apply`.
+     */
+    template <typename Index>
+    void refresh(Index& index) {
+        commands_.emplace_back(
+            [&index](
+                _world_base& world, [[maybe_unused]] _vector_t<entity_t>&) {
+                index.refresh(world);
+            });
+    }
+
     void apply(world_base<Alloc>& world) {
         _vector_t<entity_t> future_map(
             inframe_index_, commands_.get_allocator());
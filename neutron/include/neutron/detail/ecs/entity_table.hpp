@@ -0,0 +1,477 @@
+// IWYU pragma: private, include <neutron/ecs.hpp>
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <memory_resource> // IWYU pragma: keep
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "neutron/detail/concepts/allocator.hpp"
+#include "neutron/detail/ecs/entity.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
+#include "neutron/detail/utility/exception_guard.hpp"
+
+#if __has_include(<sys/mman.h>)
+    #include <sys/mman.h>
+    #define ATOM_HAS_MMAP 1
+#endif
+
+/// Maps the pages of `entity_table` with `MAP_HUGETLB`. Explicit huge pages
+/// must have been reserved, see `vm.nr_hugepages`, so they are opt-in;
+/// transparent huge pages are always asked for with `madvise`.
+#ifndef ATOM_ENABLE_HUGETLB
+    #define ATOM_ENABLE_HUGETLB 0
+#endif
+
+namespace neutron {
+
+/*! @cond TURN_OFF_DOXYGEN */
+namespace _entity_table {
+
+/// The size of a huge page on x86-64 and of a common one on aarch64.
+inline constexpr size_t page_bytes = size_t{ 2 } << 20U;
+
+#if defined(ATOM_HAS_MMAP)
+
+/**
+ * @brief Maps `page_bytes` of zeroed memory aligned to `page_bytes`, so that
+ * the kernel could back it with a single huge page.
+ * @throw std::bad_alloc If the memory could not be mapped.
+ */
+inline void* _map_page() {
+    constexpr int prot  = PROT_READ | PROT_WRITE;
+    constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    #if ATOM_ENABLE_HUGETLB && defined(MAP_HUGETLB)
+    if (void* const page =
+            ::mmap(nullptr, page_bytes, prot, flags | MAP_HUGETLB, -1, 0);
+        page != MAP_FAILED) {
+        return page;
+    }
+    #endif
+
+    // map twice the size, then trim both ends to the alignment
+    void* const raw = ::mmap(nullptr, page_bytes << 1U, prot, flags, -1, 0);
+    if (raw == MAP_FAILED) [[unlikely]] {
+        throw std::bad_alloc{};
+    }
+    auto* const first   = static_cast<std::byte*>(raw);
+    const auto address  = reinterpret_cast<uintptr_t>(raw); // NOLINT
+    const auto head     = (page_bytes - (address & (page_bytes - 1))) &
+                          (page_bytes - 1);
+    auto* const page    = first + head;
+    if (head != 0) {
+        ::munmap(first, head);
+    }
+    ::munmap(page + page_bytes, page_bytes - head);
+    #if defined(MADV_HUGEPAGE)
+    ::madvise(page, page_bytes, MADV_HUGEPAGE);
+    #endif
+    return page;
+}
+
+inline void _unmap_page(void* page) noexcept { ::munmap(page, page_bytes); }
+
+#endif
+
+} // namespace _entity_table
+/*! @endcond */
+
+/**
+ * @class entity_table
+ * @brief The location of every entity of a world: its generation, the
+ * archetype storing it and its row there, indexed by the index of the entity.
+ *
+ * The table is made of pages of 2 MiB. With `std::allocator` and `mmap`
+ * available, the pages are mapped aligned to their size and advised to be
+ * backed by huge pages, so that ten million entities take 80 TLB entries
+ * instead of 40000. Only the first page is smaller, so that small worlds do
+ * not pay for a whole page: it is reallocated from the allocator, twice as
+ * large each time, until it is full. Other allocators provide all the pages.
+ * Full pages never move, so a location stays in place once the table holds
+ * more than a page, and not before.
+ *
+ * Zeroed bytes are a live entity of generation zero stored nowhere, so
+ * mapped pages need no initialisation. A killed entity has no owner and the
+ * row `killed`.
+ * @tparam Owner Type of the archetypes.
+ * @tparam Alloc Allocator of the pages and of their directory.
+ */
+template <typename Owner, std_simple_allocator Alloc = std::allocator<std::byte>>
+class entity_table {
+public:
+    struct location {
+        generation_t generation;
+        index_t row;
+        Owner* owner;
+    };
+
+    using size_type      = size_t;
+    using allocator_type = Alloc;
+
+    static constexpr index_t killed = (std::numeric_limits<index_t>::max)();
+
+    /// Number of locations in a page.
+    static constexpr size_type page_size =
+        _entity_table::page_bytes / sizeof(location);
+
+    static_assert(std::has_single_bit(page_size));
+
+    template <typename Al = Alloc>
+    explicit entity_table(const Al& alloc = Alloc{}) : pages_(alloc) {}
+
+    entity_table(entity_table&& that) noexcept
+        : pages_(std::move(that.pages_)),
+          size_(std::exchange(that.size_, 0)),
+          capacity_(std::exchange(that.capacity_, 0)) {}
+
+    /**
+     * @brief Takes the pages of `that`, or copies its locations into pages
+     * of its own if the allocators differ and do not propagate.
+     */
+    entity_table& operator=(entity_table&& that) noexcept(_steals_pages) {
+        if (this != &that) [[likely]] {
+            if constexpr (!_steals_pages) {
+                if (pages_.get_allocator() != that.pages_.get_allocator()) {
+                    _assign(that);
+                    that._release();
+                    return *this;
+                }
+            }
+            _release();
+            pages_    = std::move(that.pages_);
+            size_     = std::exchange(that.size_, 0);
+            capacity_ = std::exchange(that.capacity_, 0);
+            that.pages_.clear();
+        }
+        return *this;
+    }
+
+    entity_table(const entity_table&)            = delete;
+    entity_table& operator=(const entity_table&) = delete;
+
+    ~entity_table() noexcept { _release(); }
+
+    ATOM_NODISCARD size_type size() const noexcept { return size_; }
+
+    ATOM_NODISCARD bool empty() const noexcept { return size_ == 0; }
+
+    ATOM_NODISCARD size_type capacity() const noexcept { return capacity_; }
+
+    ATOM_NODISCARD location& operator[](index_t index) noexcept {
+        assert(index < size_);
+        return pages_[index >> _shift][index & (page_size - 1)];
+    }
+
+    ATOM_NODISCARD const location& operator[](index_t index) const noexcept {
+        assert(index < size_);
+        return pages_[index >> _shift][index & (page_size - 1)];
+    }
+
+    /**
+     * @brief The location of `entity`, if it is alive and its generation is
+     * the current one.
+     * @return The location, or `nullptr`.
+     */
+    ATOM_NODISCARD location* find(entity_t entity) noexcept {
+        const auto index = static_cast<index_t>(entity);
+        if (index >= size_) {
+            return nullptr;
+        }
+        auto& loc = (*this)[index];
+        return loc.generation == _generation(entity) && !_killed(loc) ? &loc
+                                                                      : nullptr;
+    }
+
+    ATOM_NODISCARD const location* find(entity_t entity) const noexcept {
+        return const_cast<entity_table*>(this)->find(entity); // NOLINT
+    }
+
+    /**
+     * @brief The location of `entity`, if it is alive and stored by `owner`.
+     * @return The location, or `nullptr`.
+     */
+    ATOM_NODISCARD const location*
+        find(entity_t entity, const Owner* owner) const noexcept {
+        const auto* const loc = find(entity);
+        return loc != nullptr && loc->owner == owner ? loc : nullptr;
+    }
+
+    ATOM_NODISCARD bool contains(entity_t entity) const noexcept {
+        return find(entity) != nullptr;
+    }
+
+    /**
+     * @brief Hints the location of `entity` into the cache ahead of a lookup.
+     */
+    void prefetch(entity_t entity) const noexcept {
+        const auto index = static_cast<index_t>(entity);
+        if (index < size_) {
+            ATOM_PREFETCH(&(*this)[index]);
+        }
+    }
+
+    /**
+     * @brief The entity at `index`, its index zeroed if it has been killed.
+     */
+    ATOM_NODISCARD entity_t entity(index_t index) const noexcept {
+        const auto& loc = (*this)[index];
+        return _make(loc.generation, _killed(loc) ? 0 : index);
+    }
+
+    ATOM_NODISCARD bool is_killed(index_t index) const noexcept {
+        return _killed((*this)[index]);
+    }
+
+    /**
+     * @brief Appends a live entity of generation zero, stored nowhere.
+     */
+    entity_t emplace_back() {
+        const auto index = static_cast<index_t>(size_);
+        resize(size_ + 1);
+        return index;
+    }
+
+    /**
+     * @brief Brings the killed entity at `index` back with the next
+     * generation.
+     */
+    entity_t revive(index_t index) noexcept {
+        auto& loc = (*this)[index];
+        assert(_killed(loc));
+        loc = { .generation = loc.generation + 1, .row = 0, .owner = nullptr };
+        return _make(loc.generation, index);
+    }
+
+    /**
+     * @brief Kills the entity at `index`, which must be stored nowhere.
+     */
+    void kill(index_t index) noexcept {
+        auto& loc = (*this)[index];
+        assert(loc.owner == nullptr);
+        loc.row = killed;
+    }
+
+    /**
+     * @brief Overwrites the location at `index` with `entity`, killed if its
+     * index is zero, and `owner`.
+     *
+     * The row is kept when `owner` is the same, so that archetypes could be
+     * restored before the table.
+     */
+    void assign(index_t index, entity_t entity, Owner* owner) noexcept {
+        auto& loc      = (*this)[index];
+        const auto row = loc.owner == owner ? loc.row : 0;
+        loc.generation = _generation(entity);
+        loc.owner      = owner;
+        loc.row =
+            owner == nullptr && static_cast<index_t>(entity) == 0 ? killed : row;
+    }
+
+    /**
+     * @brief Records that `entity` is stored by `owner` at `row`, growing
+     * the table up to the index of `entity` if needed.
+     */
+    void bind(entity_t entity, Owner* owner, index_t row) {
+        const auto index = static_cast<index_t>(entity);
+        if (index >= size_) [[unlikely]] {
+            resize(size_type{ index } + 1);
+        }
+        (*this)[index] = { .generation = _generation(entity),
+                           .row        = row,
+                           .owner      = owner };
+    }
+
+    /**
+     * @brief Hands `entity`, which `from` must store, over to `to` at `row`,
+     * without it appearing stored nowhere in between.
+     *
+     * A moved archetype takes over the rows of its source this way, and the
+     * last row of an archetype moves into the gap of an erased one with
+     * `from` and `to` the same.
+     */
+    void rebind(
+        entity_t entity, const Owner* from, Owner* to, index_t row) noexcept {
+        auto& loc = (*this)[static_cast<index_t>(entity)];
+        assert(loc.generation == _generation(entity) && loc.owner == from);
+        (void)from;
+        loc.owner = to;
+        loc.row   = row;
+    }
+
+    /**
+     * @brief Records that `entity` is stored nowhere anymore.
+     */
+    void unbind(entity_t entity) noexcept {
+        const auto index = static_cast<index_t>(entity);
+        if (index < size_) {
+            auto& loc = (*this)[index];
+            loc.owner = nullptr;
+            loc.row   = 0;
+        }
+    }
+
+    void reserve(size_type n) {
+        if (n > capacity_) {
+            _grow(n);
+        }
+    }
+
+    /**
+     * @brief Resizes the table, new locations being live entities of
+     * generation zero stored nowhere.
+     */
+    void resize(size_type n) {
+        reserve(n);
+        const auto first = std::exchange(size_, n);
+        for (auto i = first; i < n; ++i) {
+            (*this)[static_cast<index_t>(i)] = {};
+        }
+    }
+
+    /**
+     * @brief Empties the table, keeping its pages.
+     */
+    void clear() noexcept { size_ = 0; }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return allocator_type(pages_.get_allocator());
+    }
+
+private:
+    template <typename Ty>
+    using _allocator_t = rebind_alloc_t<Alloc, Ty>;
+
+    using _page_allocator = _allocator_t<location>;
+
+    using _page_traits = std::allocator_traits<_page_allocator>;
+
+    /// Whether a moved-to table could always free the pages of the other.
+    static constexpr bool _steals_pages =
+        _page_traits::propagate_on_container_move_assignment::value ||
+        _page_traits::is_always_equal::value;
+
+    static constexpr unsigned _shift = std::countr_zero(page_size);
+
+#if defined(ATOM_HAS_MMAP)
+    static constexpr bool _maps_pages =
+        std::is_same_v<_page_allocator, std::allocator<location>>;
+#else
+    static constexpr bool _maps_pages = false;
+#endif
+
+    ATOM_NODISCARD static constexpr generation_t
+        _generation(entity_t entity) noexcept {
+        return static_cast<generation_t>(entity >> 32U);
+    }
+
+    ATOM_NODISCARD static constexpr entity_t
+        _make(generation_t generation, index_t index) noexcept {
+        return (static_cast<entity_t>(generation) << 32U) | index;
+    }
+
+    ATOM_NODISCARD static constexpr bool _killed(const location& loc) noexcept {
+        return loc.owner == nullptr && loc.row == killed;
+    }
+
+    location* _new_page(size_type count) {
+#if defined(ATOM_HAS_MMAP)
+        if constexpr (_maps_pages) {
+            if (count == page_size) {
+                return static_cast<location*>(_entity_table::_map_page());
+            }
+        }
+#endif
+        _page_allocator alloc{ pages_.get_allocator() };
+        return std::allocator_traits<_page_allocator>::allocate(alloc, count);
+    }
+
+    void _delete_page(location* page, size_type count) noexcept {
+#if defined(ATOM_HAS_MMAP)
+        if constexpr (_maps_pages) {
+            if (count == page_size) {
+                _entity_table::_unmap_page(page);
+                return;
+            }
+        }
+#endif
+        _page_allocator alloc{ pages_.get_allocator() };
+        std::allocator_traits<_page_allocator>::deallocate(alloc, page, count);
+    }
+
+    void _grow(size_type n) {
+        if (capacity_ < page_size) {
+            // the first page doubles until it is full
+            const auto count = (std::min)(
+                page_size, (std::max)({ n, capacity_ << 1U, size_type{ 64 } }));
+            auto* const page = _new_page(count);
+            auto guard       = make_exception_guard(
+                [this, page, count]() noexcept { _delete_page(page, count); });
+            if (pages_.empty()) {
+                pages_.push_back(page);
+            } else {
+                std::memcpy(page, pages_.front(), sizeof(location) * size_);
+                _delete_page(pages_.front(), capacity_);
+                pages_.front() = page;
+            }
+            guard.mark_complete();
+            capacity_ = count;
+            if (capacity_ >= n) {
+                return;
+            }
+        }
+
+        pages_.reserve((n + page_size - 1) >> _shift);
+        while (capacity_ < n) {
+            pages_.push_back(_new_page(page_size));
+            capacity_ += page_size;
+        }
+    }
+
+    /**
+     * @brief Replaces the locations with those of `that`, in pages of its
+     * own.
+     */
+    void _assign(const entity_table& that) {
+        size_ = 0;
+        reserve(that.size_);
+        for (size_type first = 0; first < that.size_; first += page_size) {
+            const auto count = (std::min)(page_size, that.size_ - first);
+            std::memcpy(
+                pages_[first >> _shift], that.pages_[first >> _shift],
+                sizeof(location) * count);
+        }
+        size_ = that.size_;
+    }
+
+    void _release() noexcept {
+        const auto first = (std::min)(capacity_, page_size);
+        for (size_type i = 0; i < pages_.size(); ++i) {
+            _delete_page(pages_[i], i == 0 ? first : page_size);
+        }
+        pages_.clear();
+        capacity_ = 0;
+        size_     = 0;
+    }
+
+    std::vector<location*, _allocator_t<location*>> pages_;
+    size_type size_{};
+    size_type capacity_{};
+};
+
+namespace pmr {
+
+template <typename Owner>
+using entity_table =
+    ::neutron::entity_table<Owner, std::pmr::polymorphic_allocator<>>;
+
+} // namespace pmr
+
+} // namespace neutron
@@ -0,0 +1,140 @@
+// IWYU pragma: private, include <neutron/ecs.hpp>
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "neutron/detail/concepts/allocator.hpp"
+#include "neutron/detail/concepts/one_of.hpp"
+#include "neutron/detail/ecs/component.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
+#include "neutron/detail/metafn/make.hpp"
+#include "neutron/detail/reflection/hash.hpp"
+#include "neutron/detail/tuple/rmcvref_first.hpp"
+#include "neutron/detail/utility/exception_guard.hpp"
+
+namespace neutron {
+
+/**
+ * @brief A stored set of archetype rows used as a template for new entities.
+ *
+ * Rows are kept in Structure-of-Arrays layout, one column per component, so
+ * `world_base::instantiate` could clone a whole batch with a single copy per
+ * column instead of spawning entities one by one. Several rows could describe
+ * a group spawned together, e.g. a projectile and its trail.
+ * @tparam Alloc Allocator type conforming to `std_simple_allocator` concept.
+ * @tparam Components Component types of every row.
+ */
+template <std_simple_allocator Alloc, component... Components>
+requires(sizeof...(Components) != 0) &&
+        (std::same_as<Components, std::remove_cvref_t<Components>> && ...)
+class basic_prefab {
+    template <typename Ty>
+    using _allocator_t = rebind_alloc_t<Alloc, Ty>;
+
+    template <typename Ty>
+    using _vector_t = std::vector<Ty, _allocator_t<Ty>>;
+
+public:
+    using allocator_type = Alloc;
+    using size_type      = size_t;
+    using component_list = type_list<Components...>;
+
+    /// Hash of the archetype the rows would be cloned into.
+    static constexpr uint64_t hash = make_array_hash<component_list>();
+
+    template <typename Al = Alloc>
+    explicit basic_prefab(const Al& alloc = {})
+        : columns_(
+              _vector_t<Components>(_allocator_t<Components>{ alloc })...) {}
+
+    /**
+     * @brief Constructs a prefab holding a single row.
+     */
+    template <component... Args>
+    requires(sizeof...(Args) == sizeof...(Components)) &&
+            (one_of<std::remove_cvref_t<Args>, Components...> && ...)
+    explicit basic_prefab(Args&&... components) : basic_prefab() {
+        emplace_back(std::forward<Args>(components)...);
+    }
+
+    /**
+     * @brief Appends a row. Components could be passed in any order.
+     * @return Index of the new row.
+     */
+    template <component... Args>
+    requires(sizeof...(Args) == sizeof...(Components))
+    size_type emplace_back(Args&&... components) {
+        const auto index = size();
+        auto args = std::forward_as_tuple(std::forward<Args>(components)...);
+        size_type succ = 0;
+        auto guard     = make_exception_guard([this, &succ]() noexcept {
+            [this, succ]<size_t... Is>(std::index_sequence<Is...>) {
+                ((Is < succ ? std::get<Is>(columns_).pop_back() : void()),
+                 ...);
+            }(std::index_sequence_for<Components...>());
+        });
+        [this, &args, &succ]<size_t... Is>(std::index_sequence<Is...>) {
+            ((std::get<Is>(columns_).emplace_back(
+                  rmcvref_first<Components>(std::move(args))),
+              ++succ),
+             ...);
+        }(std::index_sequence_for<Components...>());
+        guard.mark_complete();
+        return index;
+    }
+
+    void reserve(size_type n) {
+        (std::get<_vector_t<Components>>(columns_).reserve(n), ...);
+    }
+
+    void clear() noexcept {
+        (std::get<_vector_t<Components>>(columns_).clear(), ...);
+    }
+
+    ATOM_NODISCARD size_type size() const noexcept {
+        return std::get<0>(columns_).size();
+    }
+
+    ATOM_NODISCARD bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * @brief Gets the column of component `Ty`, one element per row.
+     */
+    template <component Ty>
+    ATOM_NODISCARD std::span<Ty> get() noexcept {
+        return std::get<_vector_t<Ty>>(columns_);
+    }
+
+    template <component Ty>
+    ATOM_NODISCARD std::span<const Ty> get() const noexcept {
+        return std::get<_vector_t<Ty>>(columns_);
+    }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return allocator_type(std::get<0>(columns_).get_allocator());
+    }
+
+private:
+    std::tuple<_vector_t<Components>...> columns_;
+};
+
+template <component... Components>
+using prefab = basic_prefab<std::allocator<std::byte>, Components...>;
+
+namespace pmr {
+
+template <component... Components>
+using prefab =
+    basic_prefab<std::pmr::polymorphic_allocator<std::byte>, Components...>;
+
+} // namespace pmr
+
+} // namespace neutron
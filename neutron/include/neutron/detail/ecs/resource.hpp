@@ -3,6 +3,7 @@
 #include <concepts>
 #include "neutron/detail/ecs/bundle.hpp"
 #include "neutron/detail/metafn/requires.hpp"
+#include "neutron/epoch.hpp"
 
 namespace neutron {
 
@@ -11,6 +12,10 @@ struct resource_t {};
 template <typename Ty>
 constexpr bool as_resource = false;
 
+/// The world marks the end of each system list as a quiescent point of it.
+template <>
+constexpr bool as_resource<epoch_domain> = true;
+
 template <typename Ty>
 concept resource = requires {
     typename std::remove_cvref_t<Ty>::resource_concept;
@@ -0,0 +1,905 @@
+// IWYU pragma: private, include <neutron/ecs.hpp>
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "neutron/detail/ecs/archetype.hpp"
+#include "neutron/detail/ecs/entity.hpp"
+#include "neutron/detail/ecs/world_base.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
+
+namespace neutron {
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+/**
+ * @brief A changed byte range of one column.
+ *
+ * The bytes are the XOR of the baseline and the target, so a patch applies in
+ * both directions. Rows beyond the shorter side are XORed against zeros.
+ */
+struct column_patch {
+    /// Column index in the archetype, `kinds()` for the entity rows.
+    uint32_t column;
+    /// Byte offset in the column.
+    uint32_t offset;
+    /// Length of the range in bytes.
+    uint32_t length;
+    /// Offset of the XORed bytes in `world_delta::bytes()`.
+    uint32_t data;
+};
+
+/**
+ * @brief A change of one slot in the entity table.
+ *
+ * An archetype hash of zero means the entity has no component.
+ */
+struct entity_change {
+    index_t index;
+    entity_t from;
+    entity_t to;
+    uint64_t from_archetype;
+    uint64_t to_archetype;
+};
+
+/**
+ * @brief Row count change and column patches of one archetype.
+ */
+struct archetype_patch {
+    uint64_t hash;
+    uint32_t from_size;
+    uint32_t to_size;
+    /// First element in `world_delta::patches()`.
+    uint32_t first_patch;
+    uint32_t patch_count;
+    /// First element in `world_delta::layouts()`.
+    uint32_t first_info;
+    uint32_t kinds;
+};
+
+template <std_simple_allocator Alloc = std::allocator<std::byte>>
+class world_snapshot;
+
+/**
+ * @brief A compact difference between two world states.
+ *
+ * Only trivially copyable components are encoded; other columns are default
+ * constructed when rows appear and keep their values otherwise. Because column
+ * ranges are XOR encoded, the same delta moves a world forward with
+ * `apply_delta` and backward with `revert_delta`.
+ */
+template <std_simple_allocator Alloc = std::allocator<std::byte>>
+class world_delta {
+    friend struct _snapshot::_access;
+
+    template <typename Ty>
+    using _allocator_t = rebind_alloc_t<Alloc, Ty>;
+
+    template <typename Ty>
+    using _vector_t = std::vector<Ty, _allocator_t<Ty>>;
+
+public:
+    using allocator_type = Alloc;
+    using size_type      = size_t;
+
+    template <typename Al = Alloc>
+    explicit world_delta(const Al& alloc = {})
+        : spawned_(alloc), killed_(alloc), moved_(alloc), archetypes_(alloc),
+          patches_(alloc), layouts_(alloc), bytes_(alloc) {}
+
+    /// @brief Slots that hold a new alive entity.
+    ATOM_NODISCARD auto spawned() const noexcept
+        -> std::span<const entity_change> {
+        return spawned_;
+    }
+
+    /// @brief Slots whose entity has been killed.
+    ATOM_NODISCARD auto killed() const noexcept
+        -> std::span<const entity_change> {
+        return killed_;
+    }
+
+    /// @brief Entities that moved to another archetype.
+    ATOM_NODISCARD auto moved() const noexcept
+        -> std::span<const entity_change> {
+        return moved_;
+    }
+
+    ATOM_NODISCARD auto archetypes() const noexcept
+        -> std::span<const archetype_patch> {
+        return archetypes_;
+    }
+
+    ATOM_NODISCARD auto patches() const noexcept
+        -> std::span<const column_patch> {
+        return patches_;
+    }
+
+    ATOM_NODISCARD auto layouts() const noexcept
+        -> std::span<const basic_info> {
+        return layouts_;
+    }
+
+    ATOM_NODISCARD auto bytes() const noexcept -> std::span<const std::byte> {
+        return bytes_;
+    }
+
+    ATOM_NODISCARD size_type from_entities() const noexcept {
+        return from_entities_;
+    }
+
+    ATOM_NODISCARD size_type to_entities() const noexcept {
+        return to_entities_;
+    }
+
+    ATOM_NODISCARD bool empty() const noexcept {
+        return spawned_.empty() && killed_.empty() && moved_.empty() &&
+               archetypes_.empty() && from_entities_ == to_entities_;
+    }
+
+    /**
+     * @brief Size of the encoded payload in bytes.
+     */
+    ATOM_NODISCARD size_type size_bytes() const noexcept {
+        return ((spawned_.size() + killed_.size() + moved_.size()) *
+                sizeof(entity_change)) +
+               (archetypes_.size() * sizeof(archetype_patch)) +
+               (patches_.size() * sizeof(column_patch)) +
+               (layouts_.size() * sizeof(basic_info)) + bytes_.size();
+    }
+
+    /**
+     * @brief Drops the content but keeps the capacity for the next frame.
+     */
+    void clear() noexcept {
+        spawned_.clear();
+        killed_.clear();
+        moved_.clear();
+        archetypes_.clear();
+        patches_.clear();
+        layouts_.clear();
+        bytes_.clear();
+        from_entities_ = 0;
+        to_entities_   = 0;
+    }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return bytes_.get_allocator();
+    }
+
+private:
+    _vector_t<entity_change> spawned_;
+    _vector_t<entity_change> killed_;
+    _vector_t<entity_change> moved_;
+    _vector_t<archetype_patch> archetypes_;
+    _vector_t<column_patch> patches_;
+    _vector_t<basic_info> layouts_;
+    _vector_t<std::byte> bytes_;
+    size_type from_entities_{};
+    size_type to_entities_{};
+};
+
+/**
+ * @brief A copy of the entity table and every trivially copyable column of a
+ * world.
+ *
+ * A snapshot is meant to be captured rarely and used as a baseline: diff the
+ * live world against it each tick, and advance it with `apply_delta` instead
+ * of capturing again. Buffers are reused across captures.
+ */
+template <std_simple_allocator Alloc>
+class world_snapshot {
+    friend struct _snapshot::_access;
+
+    template <typename Ty>
+    using _allocator_t = rebind_alloc_t<Alloc, Ty>;
+
+    template <typename Ty>
+    using _vector_t = std::vector<Ty, _allocator_t<Ty>>;
+
+    struct _image {
+        template <typename Al>
+        explicit _image(uint64_t hash, const Al& alloc)
+            : hash(hash), infos(alloc), columns(alloc), rows(alloc) {}
+
+        uint64_t hash;
+        size_t size{};
+        _vector_t<basic_info> infos;
+        _vector_t<_vector_t<std::byte>> columns;
+        _vector_t<entity_t> rows;
+    };
+
+public:
+    using allocator_type = Alloc;
+    using size_type      = size_t;
+
+    template <typename Al = Alloc>
+    explicit world_snapshot(const Al& alloc = {})
+        : entities_(alloc), images_(alloc) {}
+
+    template <typename Al = Alloc>
+    explicit world_snapshot(
+        const world_base<Alloc>& world, const Al& alloc = {})
+        : world_snapshot(alloc) {
+        capture(world);
+    }
+
+    /**
+     * @brief Copies the state of `world` into this snapshot.
+     */
+    void capture(const world_base<Alloc>& world);
+
+    /**
+     * @brief Writes this snapshot back into `world`.
+     *
+     * Archetypes are matched by hash and must exist in `world`.
+     */
+    void restore(world_base<Alloc>& world) const;
+
+    ATOM_NODISCARD size_type archetypes() const noexcept {
+        return images_.size();
+    }
+
+    ATOM_NODISCARD size_type entities() const noexcept {
+        return entities_.size();
+    }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return entities_.get_allocator();
+    }
+
+private:
+    _image* _find(uint64_t hash) noexcept {
+        auto iter = std::ranges::lower_bound(images_, hash, {}, &_image::hash);
+        return iter != images_.end() && iter->hash == hash ? &*iter : nullptr;
+    }
+
+    const _image* _find(uint64_t hash) const noexcept {
+        auto iter = std::ranges::lower_bound(images_, hash, {}, &_image::hash);
+        return iter != images_.end() && iter->hash == hash ? &*iter : nullptr;
+    }
+
+    _image& _assure(uint64_t hash) {
+        auto iter = std::ranges::lower_bound(images_, hash, {}, &_image::hash);
+        if (iter == images_.end() || iter->hash != hash) {
+            iter = images_.emplace(iter, hash, images_.get_allocator());
+        }
+        return *iter;
+    }
+
+    /// (entity, archetype hash) for each slot of the entity table.
+    _vector_t<std::pair<entity_t, uint64_t>> entities_;
+    /// Archetype images sorted by hash.
+    _vector_t<_image> images_;
+};
+
+namespace _snapshot {
+
+/// Equal runs shorter than this are folded into the surrounding range.
+constexpr size_t merge_gap = 16;
+
+ATOM_NODISCARD constexpr bool _alive(entity_t entity) noexcept {
+    return static_cast<index_t>(entity) != 0;
+}
+
+struct _access {
+    // archetype
+
+    template <typename Alloc>
+    static uint64_t hash(const archetype<Alloc>& arche) noexcept {
+        return arche.hash_;
+    }
+
+    template <typename Alloc>
+    static size_t size(const archetype<Alloc>& arche) noexcept {
+        return arche.size_;
+    }
+
+    template <typename Alloc>
+    static std::span<const basic_info>
+        infos(const archetype<Alloc>& arche) noexcept {
+        return arche.basic_info_;
+    }
+
+    template <typename Alloc>
+    static const std::byte*
+        column(const archetype<Alloc>& arche, size_t index) noexcept {
+        return arche.storage_[index].get();
+    }
+
+    template <typename Alloc>
+    static std::byte* column(archetype<Alloc>& arche, size_t index) noexcept {
+        return arche.storage_[index].get();
+    }
+
+    template <typename Alloc>
+    static const entity_t* rows(const archetype<Alloc>& arche) noexcept {
+        return arche.index2entity_.data();
+    }
+
+    template <typename Alloc>
+    static entity_t* rows(archetype<Alloc>& arche) noexcept {
+        return arche.index2entity_.data();
+    }
+
+    template <typename Alloc>
+    static void resize(archetype<Alloc>& arche, size_t n) {
+        arche._resize(n);
+    }
+
+    template <typename Alloc>
+    static void reindex(archetype<Alloc>& arche) {
+        arche._reindex();
+    }
+
+    // snapshot image
+
+    template <typename Image>
+    requires requires(const Image& img) { img.columns; }
+    static uint64_t hash(const Image& image) noexcept {
+        return image.hash;
+    }
+
+    template <typename Image>
+    requires requires(const Image& img) { img.columns; }
+    static size_t size(const Image& image) noexcept {
+        return image.size;
+    }
+
+    template <typename Image>
+    requires requires(const Image& img) { img.columns; }
+    static std::span<const basic_info> infos(const Image& image) noexcept {
+        return image.infos;
+    }
+
+    template <typename Image>
+    requires requires(const Image& img) { img.columns; }
+    static const std::byte* column(const Image& image, size_t index) noexcept {
+        return image.columns[index].data();
+    }
+
+    template <typename Image>
+    requires requires(const Image& img) { img.columns; }
+    static std::byte* column(Image& image, size_t index) noexcept {
+        return image.columns[index].data();
+    }
+
+    template <typename Image>
+    requires requires(const Image& img) { img.columns; }
+    static const entity_t* rows(const Image& image) noexcept {
+        return image.rows.data();
+    }
+
+    template <typename Image>
+    requires requires(const Image& img) { img.columns; }
+    static entity_t* rows(Image& image) noexcept {
+        return image.rows.data();
+    }
+
+    template <typename Image>
+    requires requires(const Image& img) { img.columns; }
+    static void resize(Image& image, size_t n) {
+        const auto kinds = image.infos.size();
+        for (size_t i = 0; i < kinds; ++i) {
+            const basic_info info = image.infos[i];
+            if (info.size != 0 && info.trivially_copyable) {
+                image.columns[i].resize(info.size * n);
+            }
+        }
+        image.rows.resize(n);
+        image.size = n;
+    }
+
+    template <typename Image>
+    requires requires(const Image& img) { img.columns; }
+    static void reindex(Image&) noexcept {}
+
+    // world
+
+    template <typename Alloc>
+    static size_t entity_count(const world_base<Alloc>& world) noexcept {
+        return world.locations_.size();
+    }
+
+    template <typename Alloc>
+    static std::pair<entity_t, uint64_t>
+        entity_at(const world_base<Alloc>& world, size_t index) noexcept {
+        const auto* const arche = world.locations_[index].owner;
+        return { world.locations_.entity(static_cast<index_t>(index)),
+                 arche != nullptr ? arche->hash() : 0 };
+    }
+
+    template <typename Alloc>
+    static const archetype<Alloc>*
+        find(const world_base<Alloc>& world, uint64_t hash) noexcept {
+        auto iter = world.archetypes_.find(hash);
+        return iter != world.archetypes_.end() ? &iter->second : nullptr;
+    }
+
+    template <typename Alloc>
+    static archetype<Alloc>* find(world_base<Alloc>& world, uint64_t hash) {
+        auto iter = world.archetypes_.find(hash);
+        if (iter == world.archetypes_.end()) [[unlikely]] {
+            throw std::out_of_range(
+                "world_delta: archetype is not registered in the world");
+        }
+        return &iter->second;
+    }
+
+    template <typename Alloc, typename Fn>
+    static void for_each(const world_base<Alloc>& world, Fn&& fn) {
+        for (const auto& [_, arche] : world.archetypes_) {
+            fn(arche);
+        }
+    }
+
+    template <typename Alloc>
+    static void resize_entities(world_base<Alloc>& world, size_t n) {
+        world.locations_.resize(n);
+    }
+
+    template <typename Alloc>
+    static void set_entity(
+        world_base<Alloc>& world, size_t index, entity_t entity,
+        uint64_t hash) {
+        world.locations_.assign(
+            static_cast<index_t>(index), entity,
+            hash != 0 ? find(world, hash) : nullptr);
+    }
+
+    template <typename Alloc>
+    static void rebuild_free_indices(world_base<Alloc>& world) {
+        world._rebuild_free_indices();
+    }
+
+    // snapshot
+
+    template <typename Alloc>
+    static size_t
+        entity_count(const world_snapshot<Alloc>& snapshot) noexcept {
+        return snapshot.entities_.size();
+    }
+
+    template <typename Alloc>
+    static std::pair<entity_t, uint64_t> entity_at(
+        const world_snapshot<Alloc>& snapshot, size_t index) noexcept {
+        return snapshot.entities_[index];
+    }
+
+    template <typename Alloc>
+    static auto find(const world_snapshot<Alloc>& snapshot, uint64_t hash) {
+        return snapshot._find(hash);
+    }
+
+    template <typename Alloc>
+    static auto* find(world_snapshot<Alloc>& snapshot, uint64_t hash) {
+        return snapshot._find(hash);
+    }
+
+    template <typename Alloc, typename Fn>
+    static void for_each(const world_snapshot<Alloc>& snapshot, Fn&& fn) {
+        for (const auto& image : snapshot.images_) {
+            fn(image);
+        }
+    }
+
+    template <typename Alloc>
+    static void resize_entities(world_snapshot<Alloc>& snapshot, size_t n) {
+        snapshot.entities_.resize(n);
+    }
+
+    template <typename Alloc>
+    static void set_entity(
+        world_snapshot<Alloc>& snapshot, size_t index, entity_t entity,
+        uint64_t hash) noexcept {
+        snapshot.entities_[index] = { entity, hash };
+    }
+
+    template <typename Alloc>
+    static void rebuild_free_indices(world_snapshot<Alloc>&) noexcept {}
+
+    // delta
+
+    /**
+     * @brief Returns the first position in `[pos, len)` whose bytes differ, the
+     * side that ran out of bytes counting as zero.
+     */
+    static size_t _skip_equal(
+        const std::byte* lhs, size_t llen, const std::byte* rhs, size_t rlen,
+        size_t pos, size_t len) noexcept {
+        const size_t common = (std::min)(llen, rlen);
+        while (pos + sizeof(uint64_t) <= common) {
+            uint64_t lword = 0;
+            uint64_t rword = 0;
+            std::memcpy(&lword, lhs + pos, sizeof(uint64_t));
+            std::memcpy(&rword, rhs + pos, sizeof(uint64_t));
+            if (lword != rword) {
+                break;
+            }
+            pos += sizeof(uint64_t);
+        }
+        for (; pos < len; ++pos) {
+            const auto lbyte = pos < llen ? lhs[pos] : std::byte{};
+            const auto rbyte = pos < rlen ? rhs[pos] : std::byte{};
+            if (lbyte != rbyte) {
+                break;
+            }
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Appends XOR encoded ranges for the difference between two byte
+     * arrays.
+     */
+    template <typename Delta>
+    static void _encode(
+        Delta& delta, uint32_t column, const std::byte* lhs, size_t llen,
+        const std::byte* rhs, size_t rlen) {
+        const size_t len = (std::max)(llen, rlen);
+        size_t pos       = _skip_equal(lhs, llen, rhs, rlen, 0, len);
+        while (pos < len) {
+            size_t end   = pos;
+            size_t equal = 0;
+            for (; end < len && equal <= merge_gap; ++end) {
+                const auto lbyte = end < llen ? lhs[end] : std::byte{};
+                const auto rbyte = end < rlen ? rhs[end] : std::byte{};
+                equal            = lbyte == rbyte ? equal + 1 : 0;
+            }
+            end -= equal;
+
+            const auto data = delta.bytes_.size();
+            delta.bytes_.resize(data + (end - pos));
+            for (size_t i = pos; i < end; ++i) {
+                const auto lbyte = i < llen ? lhs[i] : std::byte{};
+                const auto rbyte = i < rlen ? rhs[i] : std::byte{};
+                delta.bytes_[data + (i - pos)] = lbyte ^ rbyte;
+            }
+            delta.patches_.push_back(
+                { .column = column,
+                  .offset = static_cast<uint32_t>(pos),
+                  .length = static_cast<uint32_t>(end - pos),
+                  .data   = static_cast<uint32_t>(data) });
+
+            pos = _skip_equal(lhs, llen, rhs, rlen, end, len);
+        }
+    }
+
+    template <typename Delta, typename From, typename To>
+    static void _diff_archetype(Delta& delta, const From* from, const To& to) {
+        const auto layout    = infos(to);
+        const auto kinds     = layout.size();
+        const auto from_size = from != nullptr ? size(*from) : 0;
+        const auto to_size   = size(to);
+
+        archetype_patch patch{
+            .hash        = hash(to),
+            .from_size   = static_cast<uint32_t>(from_size),
+            .to_size     = static_cast<uint32_t>(to_size),
+            .first_patch = static_cast<uint32_t>(delta.patches_.size()),
+            .patch_count = 0,
+            .first_info  = static_cast<uint32_t>(delta.layouts_.size()),
+            .kinds       = static_cast<uint32_t>(kinds)
+        };
+
+        for (size_t i = 0; i < kinds; ++i) {
+            const basic_info info = layout[i];
+            if (info.size == 0 || !info.trivially_copyable) {
+                continue;
+            }
+
+            const auto* lhs = from != nullptr ? column(*from, i) : nullptr;
+            _encode(
+                delta, static_cast<uint32_t>(i), lhs, info.size * from_size,
+                column(to, i), info.size * to_size);
+        }
+        const auto* lrows = from != nullptr ? rows(*from) : nullptr;
+        _encode(
+            delta, static_cast<uint32_t>(kinds),
+            reinterpret_cast<const std::byte*>(lrows),
+            sizeof(entity_t) * from_size,
+            reinterpret_cast<const std::byte*>(rows(to)),
+            sizeof(entity_t) * to_size);
+
+        patch.patch_count =
+            static_cast<uint32_t>(delta.patches_.size()) - patch.first_patch;
+        if (patch.patch_count == 0 && from_size == to_size) {
+            return;
+        }
+
+        delta.layouts_.insert(
+            delta.layouts_.end(), layout.begin(), layout.end());
+        delta.archetypes_.push_back(patch);
+    }
+
+    template <typename Delta, typename From, typename To>
+    static void _diff(Delta& delta, const From& from, const To& to) {
+        delta.clear();
+
+        // entity table
+
+        const auto from_count = entity_count(from);
+        const auto to_count   = entity_count(to);
+        const auto count      = (std::max)(from_count, to_count);
+        delta.from_entities_  = from_count;
+        delta.to_entities_    = to_count;
+        for (size_t i = 1; i < count; ++i) {
+            using slot_type = std::pair<entity_t, uint64_t>;
+            const auto [fentity, fhash] =
+                i < from_count ? entity_at(from, i) : slot_type{};
+            const auto [tentity, thash] =
+                i < to_count ? entity_at(to, i) : slot_type{};
+            if (fentity == tentity && fhash == thash) {
+                continue;
+            }
+
+            const entity_change change{ .index = static_cast<index_t>(i),
+                                        .from  = fentity,
+                                        .to    = tentity,
+                                        .from_archetype = fhash,
+                                        .to_archetype   = thash };
+            if (_alive(tentity) && fentity != tentity) {
+                delta.spawned_.push_back(change);
+            } else if (_alive(tentity)) {
+                delta.moved_.push_back(change);
+            } else {
+                delta.killed_.push_back(change);
+            }
+        }
+
+        // archetypes
+
+        for_each(to, [&delta, &from](const auto& arche) {
+            _diff_archetype(delta, find(from, hash(arche)), arche);
+        });
+        for_each(from, [&delta, &to](const auto& arche) {
+            if (find(to, hash(arche)) != nullptr) {
+                return;
+            }
+
+            // the archetype has been retired, record a shrink to zero rows
+            const auto layout = infos(arche);
+            const auto kinds  = layout.size();
+            archetype_patch patch{
+                .hash        = hash(arche),
+                .from_size   = static_cast<uint32_t>(size(arche)),
+                .to_size     = 0,
+                .first_patch = static_cast<uint32_t>(delta.patches_.size()),
+                .patch_count = 0,
+                .first_info  = static_cast<uint32_t>(delta.layouts_.size()),
+                .kinds       = static_cast<uint32_t>(kinds)
+            };
+            for (size_t i = 0; i < kinds; ++i) {
+                const basic_info info = layout[i];
+                if (info.size != 0 && info.trivially_copyable) {
+                    _encode(
+                        delta, static_cast<uint32_t>(i), column(arche, i),
+                        info.size * patch.from_size, nullptr, 0);
+                }
+            }
+            _encode(
+                delta, static_cast<uint32_t>(kinds),
+                reinterpret_cast<const std::byte*>(rows(arche)),
+                sizeof(entity_t) * patch.from_size, nullptr, 0);
+            patch.patch_count =
+                static_cast<uint32_t>(delta.patches_.size()) -
+                patch.first_patch;
+            delta.layouts_.insert(
+                delta.layouts_.end(), layout.begin(), layout.end());
+            delta.archetypes_.push_back(patch);
+        });
+    }
+
+    template <typename Target, typename Delta>
+    static void _patch_archetype(
+        Target& target, const Delta& delta, const archetype_patch& patch,
+        bool forward) {
+        const auto source_size = forward ? patch.from_size : patch.to_size;
+        const auto target_size = forward ? patch.to_size : patch.from_size;
+        const auto max_size    = (std::max)(source_size, target_size);
+
+        assert(size(target) == source_size);
+        resize(target, max_size);
+
+        const auto patches =
+            delta.patches().subspan(patch.first_patch, patch.patch_count);
+        const auto bytes = delta.bytes();
+        for (const column_patch& range : patches) {
+            auto* dst = range.column == patch.kinds
+                            ? reinterpret_cast<std::byte*>(rows(target))
+                            : column(target, range.column);
+            dst += range.offset;
+            const auto* src = bytes.data() + range.data;
+            for (uint32_t i = 0; i < range.length; ++i) {
+                dst[i] ^= src[i];
+            }
+        }
+
+        resize(target, target_size);
+        reindex(target);
+    }
+
+    template <typename Delta>
+    static void _apply(auto& target, const Delta& delta, bool forward) {
+        const auto layouts = delta.layouts();
+        for (const archetype_patch& patch : delta.archetypes()) {
+            auto* arche = find(target, patch.hash);
+            if constexpr (requires { target.images_; }) {
+                if (arche == nullptr) {
+                    auto& image = target._assure(patch.hash);
+                    image.infos.assign(
+                        layouts.begin() + patch.first_info,
+                        layouts.begin() + patch.first_info + patch.kinds);
+                    image.columns.resize(patch.kinds);
+                    arche = &image;
+                }
+            }
+            _patch_archetype(*arche, delta, patch, forward);
+        }
+
+        const auto count =
+            forward ? delta.to_entities() : delta.from_entities();
+        resize_entities(target, (std::max)(count, size_t{ 1 }));
+        bool table_changed = false;
+        for (const auto changes :
+             { delta.spawned(), delta.killed(), delta.moved() }) {
+            for (const entity_change& change : changes) {
+                if (change.index >= count) {
+                    continue;
+                }
+
+                const auto entity = forward ? change.to : change.from;
+                const auto arche_hash =
+                    forward ? change.to_archetype : change.from_archetype;
+                set_entity(target, change.index, entity, arche_hash);
+                table_changed = true;
+            }
+        }
+        if (table_changed || delta.from_entities() != delta.to_entities()) {
+            rebuild_free_indices(target);
+        }
+    }
+};
+
+} // namespace _snapshot
+
+template <std_simple_allocator Alloc>
+void world_snapshot<Alloc>::capture(const world_base<Alloc>& world) {
+    using _snapshot::_access;
+
+    const auto count = _access::entity_count(world);
+    entities_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        entities_[i] = _access::entity_at(world, i);
+    }
+
+    // drop images of retired archetypes
+    std::erase_if(images_, [&world](const _image& image) {
+        return _access::find(world, image.hash) == nullptr;
+    });
+
+    _access::for_each(world, [this](const auto& arche) {
+        _image& image    = _assure(_access::hash(arche));
+        const auto infos = _access::infos(arche);
+        const auto kinds = infos.size();
+        const auto size  = _access::size(arche);
+        image.infos.assign(infos.begin(), infos.end());
+        image.columns.resize(kinds);
+        image.size = size;
+        for (size_t i = 0; i < kinds; ++i) {
+            const basic_info info = infos[i];
+            if (info.size == 0 || !info.trivially_copyable) {
+                image.columns[i].clear();
+                continue;
+            }
+
+            const auto* const first = _access::column(arche, i);
+            image.columns[i].assign(first, first + (info.size * size));
+        }
+        const auto* const rows = _access::rows(arche);
+        image.rows.assign(rows, rows + size);
+    });
+}
+
+template <std_simple_allocator Alloc>
+void world_snapshot<Alloc>::restore(world_base<Alloc>& world) const {
+    using _snapshot::_access;
+
+    _access::for_each(world, [this, &world](const auto& carche) {
+        auto& arche         = *_access::find(world, _access::hash(carche));
+        const _image* image = _find(_access::hash(arche));
+        if (image == nullptr) {
+            _access::resize(arche, 0);
+            _access::reindex(arche);
+            return;
+        }
+
+        _access::resize(arche, image->size);
+        const auto kinds = image->infos.size();
+        for (size_t i = 0; i < kinds; ++i) {
+            const basic_info info = image->infos[i];
+            if (info.size != 0 && info.trivially_copyable) {
+                std::memcpy(
+                    _access::column(arche, i), image->columns[i].data(),
+                    image->columns[i].size());
+            }
+        }
+        std::ranges::copy(image->rows, _access::rows(arche));
+        _access::reindex(arche);
+    });
+
+    _access::resize_entities(world, entities_.size());
+    for (size_t i = 1; i < entities_.size(); ++i) {
+        const auto [entity, hash] = entities_[i];
+        _access::set_entity(world, i, entity, hash);
+    }
+    _access::rebuild_free_indices(world);
+}
+
+/**
+ * @brief Computes the delta that turns `from` into `to`.
+ *
+ * Both sides may be a `world_base` or a `world_snapshot`. The previous content
+ * of `delta` is discarded, its capacity is reused.
+ */
+template <typename From, typename To, std_simple_allocator Alloc>
+void make_delta(
+    const From& from, const To& to, world_delta<Alloc>& delta) {
+    _snapshot::_access::_diff(delta, from, to);
+}
+
+template <typename From, typename To>
+ATOM_NODISCARD auto make_delta(const From& from, const To& to) {
+    world_delta<typename To::allocator_type> delta{ to.get_allocator() };
+    _snapshot::_access::_diff(delta, from, to);
+    return delta;
+}
+
+/**
+ * @brief Moves `target` from the `from` state of `delta` to its `to` state.
+ */
+template <std_simple_allocator Alloc>
+void apply_delta(world_base<Alloc>& target, const world_delta<Alloc>& delta) {
+    _snapshot::_access::_apply(target, delta, true);
+}
+
+template <std_simple_allocator Alloc>
+void apply_delta(
+    world_snapshot<Alloc>& target, const world_delta<Alloc>& delta) {
+    _snapshot::_access::_apply(target, delta, true);
+}
+
+/**
+ * @brief Moves `target` from the `to` state of `delta` back to its `from`
+ * state.
+ */
+template <std_simple_allocator Alloc>
+void revert_delta(world_base<Alloc>& target, const world_delta<Alloc>& delta) {
+    _snapshot::_access::_apply(target, delta, false);
+}
+
+template <std_simple_allocator Alloc>
+void revert_delta(
+    world_snapshot<Alloc>& target, const world_delta<Alloc>& delta) {
+    _snapshot::_access::_apply(target, delta, false);
+}
+
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+namespace pmr {
+
+using world_snapshot = world_snapshot<std::pmr::polymorphic_allocator<>>;
+using world_delta    = world_delta<std::pmr::polymorphic_allocator<>>;
+
+} // namespace pmr
+
+} // namespace neutron
@@ -0,0 +1,487 @@
+// IWYU pragma: private, include <neutron/ecs.hpp>
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "neutron/detail/concepts/allocator.hpp"
+#include "neutron/detail/ecs/archetype.hpp"
+#include "neutron/detail/ecs/component.hpp"
+#include "neutron/detail/ecs/entity.hpp"
+#include "neutron/detail/ecs/resource.hpp"
+#include "neutron/detail/ecs/world_accessor.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
+#include "neutron/flat_hash_map.hpp"
+#include "neutron/shift_map.hpp"
+
+namespace neutron {
+
+/*! @cond TURN_OFF_DOXYGEN */
+namespace _spatial {
+
+/// Default projection, reads members `x` and `y`.
+struct xy {
+    template <typename Position>
+    constexpr std::pair<float, float>
+        operator()(const Position& position) const noexcept {
+        return { static_cast<float>(position.x),
+                 static_cast<float>(position.y) };
+    }
+};
+
+} // namespace _spatial
+/*! @endcond */
+
+/**
+ * @brief A uniform grid over the 2D positions of entities, used as a resource.
+ *
+ * Entities are bucketed into square cells of `cell_size()`, only cells that
+ * hold entities are stored. A region or radius query visits the cells it
+ * overlaps, so a neighbour query costs about the number of entities nearby
+ * instead of the number of entities in the world.
+ *
+ * The grid is kept in step with the world incrementally: systems moving,
+ * killing or stripping entities `mark` them, and `refresh` re-reads only the
+ * marked ones, usually recorded with `commands.refresh(grid)` so that it runs
+ * when the command buffers are applied. `sync` mirrors every position at
+ * once, e.g. to build the grid. Entries whose cell did not change are updated
+ * in place, and entries of killed entities, or of entities that lost their
+ * position, are dropped. Entities at non-finite positions are not stored.
+ * @tparam Position Component holding the position.
+ * @tparam Proj Projection from `const Position&` to a pair of coordinates.
+ * @tparam Alloc Allocator type conforming to `std_simple_allocator` concept.
+ */
+template <
+    component Position, typename Proj = _spatial::xy,
+    std_simple_allocator Alloc = std::allocator<std::byte>>
+requires std::invocable<const Proj&, const Position&>
+class basic_spatial_grid {
+    template <typename Ty>
+    using _allocator_t = rebind_alloc_t<Alloc, Ty>;
+
+    template <typename Ty>
+    using _vector_t = std::vector<Ty, _allocator_t<Ty>>;
+
+    using _cell_t = uint64_t;
+
+    struct _entry {
+        entity_t entity;
+        float x;
+        float y;
+        _cell_t cell;
+        uint32_t slot;  // index in the cell
+        uint32_t stamp; // last sync visiting it
+    };
+
+    using _cell_map = flat_hash_map<
+        _cell_t, _vector_t<uint32_t>, std::hash<_cell_t>,
+        std::equal_to<_cell_t>,
+        _allocator_t<std::pair<_cell_t, _vector_t<uint32_t>>>>;
+
+public:
+    using resource_concept = resource_t;
+    using position_type    = Position;
+    using allocator_type   = Alloc;
+    using size_type        = size_t;
+
+    template <typename Al = Alloc>
+    explicit basic_spatial_grid(float cell_size = 1.0F, const Al& alloc = {})
+        : entries_(_allocator_t<_entry>{ alloc }),
+          lookup_(_allocator_t<std::pair<const entity_t, index_t>>{ alloc }),
+          cells_(_allocator_t<std::pair<_cell_t, _vector_t<uint32_t>>>{
+              alloc }),
+          marked_(_allocator_t<entity_t>{ alloc }) {
+        set_cell_size(cell_size);
+    }
+
+    ATOM_NODISCARD float cell_size() const noexcept { return cell_size_; }
+
+    /**
+     * @brief Changes the cell size and rebuilds the cells.
+     * @param cell_size Edge of a cell, a good value is about the radius most
+     * queries use.
+     */
+    void set_cell_size(float cell_size) {
+        assert(cell_size > 0);
+        cell_size_ = cell_size;
+        inv_cell_  = 1.0F / cell_size;
+        cells_.clear();
+        for (uint32_t i = 0; i < entries_.size(); ++i) {
+            auto& entry = entries_[i];
+            entry.cell  = _cell_of(entry.x, entry.y);
+            _link(i);
+        }
+    }
+
+    /**
+     * @brief Inserts an entity or moves it to a new position.
+     *
+     * An entity moved to a non-finite position is erased.
+     */
+    void update(entity_t entity, float x, float y) { _update(entity, x, y); }
+
+    /**
+     * @brief Records that `entity` has moved, has been killed or has lost
+     * `Position`, for the next `refresh`.
+     */
+    void mark(entity_t entity) { marked_.push_back(entity); }
+
+    /**
+     * @brief Updates the entries of the entities marked since the last call.
+     *
+     * Positions are read through the entity locations of the world, so it
+     * costs about the number of marked entities where `sync` visits all of
+     * them. Marked entities that are not alive anymore, or have no
+     * `Position`, are erased.
+     * @param world A world, or the `world_base` a command buffer is applied to.
+     */
+    template <typename World>
+    void refresh(World& world) {
+        const auto& locations = world_accessor::locations(world);
+        for (const auto entity : marked_) {
+            const auto* const loc = locations.find(entity);
+            auto* const archetype = loc != nullptr ? loc->owner : nullptr;
+            if (archetype == nullptr ||
+                !archetype->template has<Position>()) {
+                erase(entity);
+                continue;
+            }
+            const auto iter = view_of<Position>(*archetype).begin() +
+                              static_cast<ptrdiff_t>(loc->row);
+            const auto [x, y] = std::invoke(proj_, std::get<0>(*iter));
+            _update(entity, x, y);
+        }
+        marked_.clear();
+    }
+
+    void erase(entity_t entity) noexcept {
+        const auto iter = lookup_.find(entity);
+        if (iter != lookup_.end()) {
+            _erase_at(iter->second);
+        }
+    }
+
+    void clear() noexcept {
+        marked_.clear();
+        entries_.clear();
+        lookup_.clear();
+        cells_.clear();
+    }
+
+    /**
+     * @brief Mirrors the positions stored in the given archetypes.
+     *
+     * Archetypes without `Position` are skipped. Entries not visited, i.e. of
+     * entities killed or stripped of `Position` since the last call, are
+     * erased.
+     * @param archetypes Range of pointers to archetypes, e.g. `query.raw()`.
+     */
+    template <std::ranges::input_range Archetypes>
+    void sync(Archetypes&& archetypes) {
+        ++stamp_;
+        for (auto* archetype : archetypes) {
+            if (!archetype->template has<Position>()) {
+                continue;
+            }
+            const auto entities = archetype->row_entities();
+            auto iter           = view_of<Position>(*archetype).begin();
+            for (const auto entity : entities) {
+                const auto [x, y] = std::invoke(proj_, std::get<0>(*iter));
+                if (auto* const entry = _update(entity, x, y)) {
+                    entry->stamp = stamp_;
+                }
+                ++iter;
+            }
+        }
+        for (auto i = entries_.size(); i-- > 0;) {
+            if (entries_[i].stamp != stamp_) {
+                _erase_at(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    /**
+     * @brief Mirrors the positions of all entities in a world.
+     */
+    template <world World>
+    void sync(World& world) {
+        auto& archetypes = world_accessor::archetypes(world);
+        sync(archetypes | std::views::values |
+             std::views::transform([](auto& archetype) { return &archetype; }));
+    }
+
+    ATOM_NODISCARD bool contains(entity_t entity) const noexcept {
+        return lookup_.contains(entity);
+    }
+
+    ATOM_NODISCARD size_type size() const noexcept { return entries_.size(); }
+
+    ATOM_NODISCARD bool empty() const noexcept { return entries_.empty(); }
+
+    /**
+     * @brief Visits the entities inside an axis-aligned box, bounds included.
+     * @param fn Invoked as `fn(entity, x, y)` or `fn(entity)`.
+     */
+    template <typename Fn>
+    void for_each_in_region(
+        float min_x, float min_y, float max_x, float max_y, Fn&& fn) const {
+        _for_each_cell(
+            min_x, min_y, max_x, max_y, [&](const _entry& entry) {
+                if (entry.x >= min_x && entry.x <= max_x &&
+                    entry.y >= min_y && entry.y <= max_y) {
+                    _invoke(fn, entry);
+                }
+            });
+    }
+
+    /**
+     * @brief Visits the entities within `radius` of a point, bounds included.
+     * @param fn Invoked as `fn(entity, x, y)` or `fn(entity)`.
+     */
+    template <typename Fn>
+    void for_each_in_radius(float x, float y, float radius, Fn&& fn) const {
+        const float radius2 = radius * radius;
+        _for_each_cell(
+            x - radius, y - radius, x + radius, y + radius,
+            [&](const _entry& entry) {
+                const float dx = entry.x - x;
+                const float dy = entry.y - y;
+                if ((dx * dx) + (dy * dy) <= radius2) {
+                    _invoke(fn, entry);
+                }
+            });
+    }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return allocator_type(entries_.get_allocator());
+    }
+
+private:
+    template <typename Fn>
+    static void _invoke(Fn& fn, const _entry& entry) {
+        if constexpr (std::invocable<Fn&, entity_t, float, float>) {
+            fn(entry.entity, entry.x, entry.y);
+        } else {
+            fn(entry.entity);
+        }
+    }
+
+    /// Cell coordinates are clamped to `[-_coord_limit, _coord_limit]`, so
+    /// that positions far away share the border cells and the number of cells
+    /// a box spans fits in 64 bits.
+    static constexpr float _coord_limit = 1073741824.0F; // 2^30
+
+    ATOM_NODISCARD int32_t _coord_of(float value) const noexcept {
+        const float scaled = std::floor(value * inv_cell_);
+        if (std::isnan(scaled)) [[unlikely]] {
+            // stored positions are finite, only a query bound could be NaN,
+            // for which `_for_each_cell` returns early
+            return 0;
+        }
+        return static_cast<int32_t>(
+            std::clamp(scaled, -_coord_limit, _coord_limit));
+    }
+
+    ATOM_NODISCARD static constexpr _cell_t
+        _make_cell(int32_t cx, int32_t cy) noexcept {
+        return (static_cast<_cell_t>(static_cast<uint32_t>(cx)) << 32U) |
+               static_cast<uint32_t>(cy);
+    }
+
+    ATOM_NODISCARD _cell_t _cell_of(float x, float y) const noexcept {
+        return _make_cell(_coord_of(x), _coord_of(y));
+    }
+
+    template <typename Fn>
+    void _for_each_cell(
+        float min_x, float min_y, float max_x, float max_y, Fn&& fn) const {
+        if (!(min_x <= max_x && min_y <= max_y)) {
+            return;
+        }
+        const auto x0 = _coord_of(min_x);
+        const auto y0 = _coord_of(min_y);
+        const auto x1 = _coord_of(max_x);
+        const auto y1 = _coord_of(max_y);
+        const auto spanned =
+            (static_cast<uint64_t>(int64_t{ x1 } - x0) + 1) *
+            (static_cast<uint64_t>(int64_t{ y1 } - y0) + 1);
+
+        if (spanned > cells_.size()) {
+            // the box is larger than the occupied area, walk stored cells
+            for (const auto& [cell, slots] : cells_) {
+                const auto cx = static_cast<int32_t>(cell >> 32U);
+                const auto cy = static_cast<int32_t>(cell & 0xFFFFFFFFU);
+                if (cx < x0 || cx > x1 || cy < y0 || cy > y1) {
+                    continue;
+                }
+                for (const auto index : slots) {
+                    fn(entries_[index]);
+                }
+            }
+            return;
+        }
+
+        for (auto cy = y0; cy <= y1; ++cy) {
+            for (auto cx = x0; cx <= x1; ++cx) {
+                const auto iter = cells_.find(_make_cell(cx, cy));
+                if (iter == cells_.end()) {
+                    continue;
+                }
+                for (const auto index : iter->second) {
+                    fn(entries_[index]);
+                }
+            }
+        }
+    }
+
+    /// @return The entry of `entity`, or `nullptr` if the position is not
+    /// finite, in which case the entity is erased.
+    _entry* _update(entity_t entity, float x, float y) {
+        if (!std::isfinite(x) || !std::isfinite(y)) [[unlikely]] {
+            erase(entity);
+            return nullptr;
+        }
+        const auto cell = _cell_of(x, y);
+        const auto iter = lookup_.find(entity);
+        if (iter == lookup_.end()) {
+            const auto index = static_cast<uint32_t>(entries_.size());
+            entries_.push_back(_entry{ entity, x, y, cell, 0, stamp_ });
+            lookup_.try_emplace(entity, index);
+            _link(index);
+            return &entries_.back();
+        }
+
+        const auto index = iter->second;
+        auto& entry      = entries_[index];
+        entry.x          = x;
+        entry.y          = y;
+        if (entry.cell != cell) {
+            _unlink(entry);
+            entry.cell = cell;
+            _link(index);
+        }
+        return &entry;
+    }
+
+    void _link(uint32_t index) {
+        auto& entry = entries_[index];
+        auto& slots = cells_[entry.cell];
+        entry.slot  = static_cast<uint32_t>(slots.size());
+        slots.push_back(index);
+    }
+
+    void _unlink(const _entry& entry) noexcept {
+        const auto iter = cells_.find(entry.cell);
+        assert(iter != cells_.end());
+        auto& slots = iter->second;
+        const auto moved = slots.back();
+        slots[entry.slot]           = moved;
+        entries_[moved].slot = entry.slot;
+        slots.pop_back();
+        if (slots.empty()) {
+            cells_.erase(iter);
+        }
+    }
+
+    void _erase_at(uint32_t index) noexcept {
+        _unlink(entries_[index]);
+        lookup_.erase(entries_[index].entity);
+        const auto last = static_cast<uint32_t>(entries_.size() - 1);
+        if (index != last) {
+            auto& moved = entries_[last];
+            cells_.find(moved.cell)->second[moved.slot] = index;
+            lookup_[moved.entity]                       = index;
+            entries_[index]                             = moved;
+        }
+        entries_.pop_back();
+    }
+
+    _vector_t<_entry> entries_;
+    shift_map<entity_t, index_t, 256UL, half_bits<entity_t>, Alloc> lookup_;
+    _cell_map cells_;
+    _vector_t<entity_t> marked_;
+    float cell_size_{};
+    float inv_cell_{};
+    uint32_t stamp_{};
+    ATOM_NO_UNIQUE_ADDR Proj proj_{};
+};
+
+template <component Position, typename Proj = _spatial::xy>
+using spatial_grid =
+    basic_spatial_grid<Position, Proj, std::allocator<std::byte>>;
+
+namespace pmr {
+
+template <component Position, typename Proj = _spatial::xy>
+using spatial_grid = basic_spatial_grid<
+    Position, Proj, std::pmr::polymorphic_allocator<std::byte>>;
+
+} // namespace pmr
+
+/**
+ * @brief Query filter keeping the entities a spatial index finds inside an
+ * axis-aligned box.
+ *
+ * It carries state, so the querior should be constructed with an instance,
+ * e.g. `query(world, with<Position>{}, in_region<grid>{ &grid, 0, 0, 8, 8 })`.
+ * A default constructed one selects nothing.
+ */
+template <typename Index>
+struct in_region {
+    const Index* index{};
+    float min_x{};
+    float min_y{};
+    float max_x{};
+    float max_y{};
+
+    constexpr bool init(const auto& archetype) const {
+        return archetype.template has<typename Index::position_type>();
+    }
+
+    template <typename Fn>
+    void select(Fn&& fn) const {
+        if (index != nullptr) {
+            index->for_each_in_region(
+                min_x, min_y, max_x, max_y,
+                [&fn](entity_t entity) { fn(entity); });
+        }
+    }
+};
+
+/**
+ * @brief Query filter keeping the entities a spatial index finds within a
+ * radius of a point.
+ * @see in_region
+ */
+template <typename Index>
+struct in_radius {
+    const Index* index{};
+    float x{};
+    float y{};
+    float radius{};
+
+    constexpr bool init(const auto& archetype) const {
+        return archetype.template has<typename Index::position_type>();
+    }
+
+    template <typename Fn>
+    void select(Fn&& fn) const {
+        if (index != nullptr) {
+            index->for_each_in_radius(
+                x, y, radius, [&fn](entity_t entity) { fn(entity); });
+        }
+    }
+};
+
+} // namespace neutron
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <tuple>
 #include <utility>
 #include <vector>
 #include "neutron/detail/ecs/archetype.hpp"
@@ -11,7 +12,10 @@
 #include "neutron/detail/ecs/metainfo.hpp"
 #include "neutron/detail/ecs/world_base.hpp"
 #include "neutron/detail/ecs/world_descriptor.hpp"
+#include "neutron/detail/memory/frame_arena.hpp"
 #include "neutron/detail/memory/rebind_alloc.hpp"
+#include "neutron/detail/metafn/size.hpp"
+#include "neutron/epoch.hpp"
 #include "neutron/execution.hpp"
 #include "neutron/memory.hpp"
 #include "neutron/tuple.hpp"
@@ -83,7 +87,15 @@ public:
 
     template <typename Al = Alloc>
     constexpr explicit basic_world(const Al& alloc = {})
-        : world_base<Alloc>(alloc) /*, resources_(), locals_()*/ {}
+        : world_base<Alloc>(alloc) /*, resources_(), locals_()*/,
+          frame_arenas_(alloc) {
+        // systems of a list never outnumber the systems of the world
+        constexpr auto count = std::max<size_t>(type_list_size_v<sysinfo>, 1);
+        frame_arenas_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            frame_arenas_.emplace_back();
+        }
+    }
 
     template <stage Stage, neutron::execution::scheduler Sch>
     void call(Sch& sch, _vector_t<command_buffer>& cmdbufs) {
@@ -92,6 +104,20 @@ public:
         _call_run_list<run_list>{}(sch, this);
     }
 
+    /**
+     * @brief Rewinds the frame arenas the systems allocate from through their
+     * `arena_allocator` parameter, done by `call_update` once a frame ends.
+     *
+     * No system runs then either, so the epoch domain among the resources, if
+     * any, reaches a quiescent point too.
+     */
+    void end_frame() {
+        for (auto& arena : frame_arenas_) {
+            arena.reset();
+        }
+        _reclaim();
+    }
+
 private:
     // static constexpr auto _hash_array() noexcept {
     //     return neutron::make_hash_array<components>();
@@ -143,6 +169,21 @@ private:
                 }
             };
 
+            /// Schedules on the lane given to `Sys` by `set_schedule`, if the
+            /// scheduler has lanes.
+            template <auto Sys, execution::scheduler Sch>
+            static auto _schedule(Sch& sch) {
+                constexpr auto priority = _set_schedule::_system_priority_v<
+                    Sys, typename Descriptor::schedule_policy>;
+                if constexpr (
+                    priority != _set_schedule::_no_priority &&
+                    requires { sch.with_priority(priority); }) {
+                    return execution::schedule(sch.with_priority(priority));
+                } else {
+                    return execution::schedule(sch);
+                }
+            }
+
             template <execution::scheduler Sch>
             void operator()(Sch& sch, basic_world* world) const {
                 using namespace execution;
@@ -152,12 +193,14 @@ private:
 
                 auto all = [&sch,
                             world]<size_t... Is>(std::index_sequence<Is...>) {
-                    return when_all((schedule(sch) | then([world] {
-                                         _call_sys<Is, SysInfo::fn>{}(world);
-                                     }))...);
+                    return when_all(
+                        (_schedule<SysInfo::fn>(sch) | then([world] {
+                             _call_sys<Is, SysInfo::fn>{}(world);
+                         }))...);
                 }(std::index_sequence_for<SysInfo...>());
                 sync_wait(std::move(all));
                 world->_apply_command_buffers();
+                world->_reclaim();
             }
         };
 
@@ -175,6 +218,14 @@ private:
         }
     }
 
+    /// No system runs between two system lists, which makes it a quiescent
+    /// point of the epoch domain among the resources, if any.
+    void _reclaim() {
+        if constexpr (type_list_has_v<epoch_domain, resources>) {
+            rmcvref_first<epoch_domain>(resources_).quiescent();
+        }
+    }
+
     /// variables could be use in only one specific system
     /// Locals are _sys_tuple, a tuple with system info, used to get the correct
     /// local for each sys
@@ -182,6 +233,9 @@ private:
     //  variables could be pass between each systems
     type_list_rebind_t<neutron::shared_tuple, resources> resources_;
 
+    /// scratch memory of the systems, one arena per position in a system list
+    _vector_t<frame_arena> frame_arenas_;
+
     _vector_t<command_buffer>* command_buffers_;
 };
 
@@ -246,6 +300,7 @@ void call_update(
     call<stage::pre_update>(sch, cmdbufs, world);
     call<stage::update>(sch, cmdbufs, world);
     call<stage::post_update>(sch, cmdbufs, world);
+    world.end_frame();
 }
 
 template <world... Worlds>
@@ -255,6 +310,7 @@ void call_update(
     call<stage::pre_update>(sch, cmdbufs, worlds);
     call<stage::update>(sch, cmdbufs, worlds);
     call<stage::post_update>(sch, cmdbufs, worlds);
+    std::apply([](Worlds&... each) { (each.end_frame(), ...); }, worlds);
 }
 
 } // namespace neutron
@@ -12,9 +12,21 @@ struct world_accessor {
     static auto& archetypes(World& world) noexcept {
         return world.archetypes_;
     }
+    /// @brief Bumped whenever `compact` might have retired archetypes or
+    /// moved their rows.
+    template <world World>
+    static const auto& compact_epoch(World& world) noexcept {
+        return world.compact_epoch_;
+    }
     template <world World>
     static auto& entities(World& world) noexcept {
-        return world.entities_;
+        return world.locations_;
+    }
+    /// @brief Same as `entities`, also for the `world_base` a command buffer
+    /// is applied to.
+    template <typename World>
+    static auto& locations(World& world) noexcept {
+        return world.locations_;
     }
     template <world World>
     static auto& locals(World& world) noexcept {
@@ -24,6 +36,10 @@ struct world_accessor {
     static auto& resources(World& world) noexcept {
         return world.resources_;
     }
+    template <world World>
+    static auto& frame_arenas(World& world) noexcept {
+        return world.frame_arenas_;
+    }
 };
 
 } // namespace neutron
@@ -9,11 +9,14 @@
 #include <limits>
 #include <memory>
 #include <queue>
+#include <span>
 #include <type_traits>
 #include <utility>
 #include <vector>
 #include "neutron/detail/ecs/archetype.hpp"
 #include "neutron/detail/ecs/component.hpp"
+#include "neutron/detail/ecs/prefab.hpp"
+#include "neutron/detail/macros.hpp"
 #include "neutron/flat_hash_map.hpp"
 #include "neutron/memory.hpp"
 #include "neutron/metafn.hpp"
@@ -32,6 +35,34 @@ struct _hash_transition {
     constexpr bool operator==(const _hash_transition& that) const noexcept {
         return from == that.from && delta == that.delta;
     }
+
+    /// splitmix64 finalizer, every bit of the result depends on every bit
+    /// of `value`.
+    static constexpr uint64_t _mix(uint64_t value) noexcept {
+        value ^= value >> 30U;
+        value *= 0xbf58476d1ce4e5b9;
+        value ^= value >> 27U;
+        value *= 0x94d049bb133111eb;
+        value ^= value >> 31U;
+        return value;
+    }
+
+    /// The part of the hash contributed by `delta`. The moves between
+    /// archetypes know their `delta` at compile time and fold it into a
+    /// constant, `hash` computes the very same value at run time.
+    static constexpr uint64_t mix_delta(uint64_t delta) noexcept {
+        // offset, so that swapping `from` and `delta` changes the hash
+        return _mix(delta + 0x9e3779b97f4a7c15);
+    }
+
+    /// The hash of `{ from, delta }` from `mix_delta(delta)`.
+    static constexpr size_t hash_mixed(uint64_t from, uint64_t mixed) noexcept {
+        return static_cast<size_t>(_mix(from) ^ mixed);
+    }
+
+    static constexpr size_t hash(uint64_t from, uint64_t delta) noexcept {
+        return hash_mixed(from, mix_delta(delta));
+    }
 };
 
 /**
@@ -49,6 +80,7 @@ class world_base {
     friend class basic_world;
 
     friend struct ::neutron::world_accessor;
+    friend struct ::neutron::_snapshot::_access;
 
     template <typename Ty>
     using _allocator_t = neutron::rebind_alloc_t<Alloc, Ty>;
@@ -75,12 +107,48 @@ class world_base {
     template <typename Ty>
     using _priority_queue = std::priority_queue<Ty, _vector_t<Ty>>;
 
+    using _entity_table = typename archetype::table_type;
+
 public:
-    using size_type = size_t;
+    using size_type      = size_t;
+    using allocator_type = Alloc;
 
     template <typename Al = Alloc>
     explicit world_base(const Al& alloc = Alloc{})
-        : archetypes_(alloc), entities_(1, alloc), transitions_(alloc) {}
+        : archetypes_(alloc), locations_(alloc), transitions_(alloc) {
+        locations_.emplace_back();
+    }
+
+    world_base(world_base&& that) noexcept
+        : archetypes_(std::move(that.archetypes_)),
+          locations_(std::move(that.locations_)),
+          free_indices_(std::move(that.free_indices_)),
+          transitions_(std::move(that.transitions_)),
+          compact_cursor_(std::exchange(that.compact_cursor_, 0)),
+          compact_epoch_(that.compact_epoch_++) {
+        _attach_archetypes();
+    }
+
+    /**
+     * @brief Takes the storage of `that`, which only allocates when the
+     * allocators differ and do not propagate.
+     */
+    world_base& operator=(world_base&& that) noexcept(
+        std::allocator_traits<
+            Alloc>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Alloc>::is_always_equal::value) {
+        if (this != &that) [[likely]] {
+            archetypes_     = std::move(that.archetypes_);
+            locations_      = std::move(that.locations_);
+            free_indices_   = std::move(that.free_indices_);
+            transitions_    = std::move(that.transitions_);
+            compact_cursor_ = std::exchange(that.compact_cursor_, 0);
+            ++compact_epoch_;
+            ++that.compact_epoch_;
+            _attach_archetypes();
+        }
+        return *this;
+    }
 
     constexpr entity_t spawn();
 
@@ -99,8 +167,38 @@ public:
     template <component... Components>
     constexpr void remove_components(entity_t entity);
 
+    /**
+     * @brief Spawns `count` copies of the rows stored in `prefab`.
+     *
+     * Column data is cloned in bulk instead of spawning entities one by one.
+     */
+    template <std_simple_allocator Al, component... Components>
+    void instantiate(
+        const basic_prefab<Al, Components...>& prefab, size_type count = 1);
+
+    /**
+     * @brief Spawns `count` copies of the rows stored in `prefab` and writes
+     * the new entities to `out`, copy by copy and row by row.
+     */
+    template <
+        std_simple_allocator Al, component... Components,
+        std::output_iterator<entity_t> Out>
+    Out instantiate(
+        const basic_prefab<Al, Components...>& prefab, size_type count,
+        Out out);
+
     constexpr void kill(entity_t entity);
 
+    /**
+     * @brief Kills many entities, erasing each run of them stored in one
+     * archetype at once, see `archetype::erase`.
+     *
+     * Unlike a single `kill`, entities that are not alive anymore are
+     * skipped, so that a stale one never takes down the entity reusing its
+     * index. The live ones must be distinct.
+     */
+    constexpr void kill(std::span<const entity_t> entities);
+
     constexpr void reserve(size_type n);
 
     template <component... Components>
@@ -110,30 +208,89 @@ public:
 
     void clear();
 
+    /**
+     * @brief Compacts at most `budget` archetypes, continuing where the
+     * previous call stopped.
+     *
+     * Empty archetypes are retired together with their cached transitions,
+     * and archetypes using less than a quarter of their capacity release the
+     * spare one. Each call retiring, shrinking or sorting any archetype bumps
+     * the compaction epoch, from which queriors notice that they have to
+     * collect their archetypes again. Views they returned before are
+     * invalidated, so it should be called between frames. Snapshots could
+     * not be restored into archetypes retired after their capture.
+     * @return Whether a whole pass over the archetypes has completed.
+     */
+    bool compact(size_type budget = (std::numeric_limits<size_type>::max)());
+
+    /**
+     * @brief Compacts like `compact(budget)` and also sorts the rows of every
+     * visited archetype so that `proj(entity)` is ascending.
+     */
+    template <typename Proj>
+    requires std::totally_ordered<std::invoke_result_t<Proj&, entity_t>>
+    bool compact(size_type budget, Proj proj);
+
+    /**
+     * @brief Sorts the rows of every archetype holding `Key` by
+     * `proj(key)`, see `archetype::sort_by`.
+     *
+     * Component columns are permuted, so nothing else should access the
+     * archetypes meanwhile: call it between stages, or record it with
+     * `command_buffer::sort_by`. Queriors using `order_by<Key, Comp, Proj>`
+     * visit the rows in this order.
+     * @return Number of archetypes whose rows have been moved.
+     */
+    template <
+        component Key, typename Comp = std::ranges::less,
+        typename Proj = std::identity>
+    requires(!std::is_empty_v<Key>)
+    size_type sort_by(Comp comp = {}, Proj proj = {});
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return allocator_type(locations_.get_allocator());
+    }
+
 private:
     constexpr entity_t _get_new_entity();
     template <component... Components>
     constexpr void _emplace_new_entity(entity_t entity);
     template <component... Components>
     constexpr void _emplace_new_entity(entity_t entity, Components&&...);
+    template <std_simple_allocator Al, component... Components, typename Fn>
+    void _instantiate(
+        const basic_prefab<Al, Components...>& prefab, size_type count,
+        Fn&& on_spawn);
+    template <typename Fn>
+    bool _compact(size_type budget, Fn&& visit);
+    void _retire_transitions(_vector_t<uint64_t>& retired);
+    void _rebuild_free_indices();
+    template <typename... Args>
+    auto _emplace_archetype(uint64_t hash, Args&&... args);
+    ATOM_NODISCARD archetype* _archetype_of(index_t index) noexcept;
+    void _attach_archetypes() noexcept;
 
     /// @brief A container stores archetypes with combined hash.
     archetype_map archetypes_;
-    /// @brief A stroage mapping index to entity and its archetype.
-    /// We do never pop or erase: when killing a entity, we set index zero
-    /// and its archetype pointer null.
-    /// Summary: for an entity ((gen, index), p_archetype),
-    /// ((gen, non-zero), nullptr) -> created, but has no component
-    /// ((gen, 0), 0) -> killed entity
-    _vector_t<std::pair<entity_t, archetype*>> entities_;
+    /// @brief The generation, archetype and row of every entity, shared by
+    /// all the archetypes.
+    /// We do never pop or erase: a killed entity keeps its generation, with
+    /// no archetype and the row `_entity_table::killed`.
+    _entity_table locations_;
     /// @brief A priority queue stores free indices.
     /// It makes us have the ability to get the smallest index all the time.
-    /// A smaller index means we could access `sparse_map` or `shift_map` with
-    /// lower frequency of cache missing.
+    /// A smaller index keeps the locations of live entities in fewer pages.
     _priority_queue<uint32_t> free_indices_;
 
     /// @brief Cache for O(1) entity movement.
     _flat_hash_map<_hash_transition, uint64_t> transitions_;
+
+    /// @brief Hash of the archetype the next `compact` starts from, zero for
+    /// the first one.
+    uint64_t compact_cursor_{};
+    /// @brief Bumped whenever archetypes might have been retired or their
+    /// rows moved, see `world_accessor::compact_epoch`.
+    uint64_t compact_epoch_{};
 };
 
 ATOM_FORCE_INLINE static constexpr generation_t
@@ -146,28 +303,34 @@ ATOM_FORCE_INLINE static constexpr index_t
     return static_cast<index_t>(entity);
 }
 
-ATOM_FORCE_INLINE static constexpr void
-    _reset_index(entity_t& entity) noexcept {
-    entity = ((entity >> 32) << 32);
-}
-
-ATOM_NODISCARD ATOM_FORCE_INLINE constexpr static entity_t
-    _make_entity(generation_t gen, index_t index) noexcept {
-    return (static_cast<entity_t>(gen) << 32UL) | index;
-}
-
 template <std_simple_allocator Alloc>
 constexpr entity_t world_base<Alloc>::_get_new_entity() {
     if (free_indices_.empty()) {
-        const auto index = entities_.size();
-        entities_.emplace_back(index, nullptr); // _make_entity(0, index)
-        return index;
+        return locations_.emplace_back();
     }
     const index_t index = free_indices_.top();
     free_indices_.pop();
-    const generation_t gen = _get_gen(entities_[index].first) + 1;
-    entities_[index].first = _make_entity(gen, index);
-    return entities_[index].first;
+    return locations_.revive(index);
+}
+
+template <std_simple_allocator Alloc>
+template <typename... Args>
+auto world_base<Alloc>::_emplace_archetype(uint64_t hash, Args&&... args) {
+    auto [iter, _] = archetypes_.try_emplace(hash, std::forward<Args>(args)...);
+    iter->second.attach(locations_);
+    return iter;
+}
+
+template <std_simple_allocator Alloc>
+auto world_base<Alloc>::_archetype_of(index_t index) noexcept -> archetype* {
+    return static_cast<archetype*>(locations_[index].owner);
+}
+
+template <std_simple_allocator Alloc>
+void world_base<Alloc>::_attach_archetypes() noexcept {
+    for (auto& [_, arche] : archetypes_) {
+        arche.attach(locations_);
+    }
 }
 
 template <std_simple_allocator Alloc>
@@ -182,17 +345,11 @@ constexpr void world_base<Alloc>::_emplace_new_entity(entity_t entity) {
     using list              = type_list<Components...>;
     constexpr uint64_t hash = make_array_hash<list>();
 
-    const auto index = _get_index(entity);
-    auto iter        = archetypes_.find(hash);
-    if (iter != archetypes_.end()) {
-        iter->second.template emplace<Components...>(entity);
-        entities_[index].second = &iter->second;
-    } else {
-        auto [iter, _] = archetypes_.try_emplace(
-            hash, archetype{ spread_type<Components...> });
-        iter->second.template emplace<Components...>(entity);
-        entities_[index].second = &iter->second;
+    auto iter = archetypes_.find(hash);
+    if (iter == archetypes_.end()) {
+        iter = _emplace_archetype(hash, archetype{ spread_type<Components...> });
     }
+    iter->second.template emplace<Components...>(entity);
 }
 
 template <std_simple_allocator Alloc>
@@ -213,17 +370,12 @@ constexpr void world_base<Alloc>::_emplace_new_entity(
     using list              = type_list<std::remove_cvref_t<Components>...>;
     constexpr uint64_t hash = make_array_hash<list>();
 
-    const auto index = _get_index(entity);
-    auto iter        = archetypes_.find(hash);
-    if (iter != archetypes_.end()) [[likely]] {
-        iter->second.emplace(entity, std::forward<Components>(components)...);
-        entities_[index].second = &iter->second;
-    } else [[unlikely]] {
-        auto [iter, _] = archetypes_.try_emplace(
+    auto iter = archetypes_.find(hash);
+    if (iter == archetypes_.end()) [[unlikely]] {
+        iter = _emplace_archetype(
             hash, archetype{ spread_type<std::remove_cvref_t<Components>...> });
-        iter->second.emplace(entity, std::forward<Components>(components)...);
-        entities_[index].second = &iter->second;
     }
+    iter->second.emplace(entity, std::forward<Components>(components)...);
 }
 
 template <std_simple_allocator Alloc>
@@ -244,17 +396,19 @@ constexpr void world_base<Alloc>::add_components(entity_t entity) {
     constexpr uint64_t hash = make_array_hash<tlist>();
 
     const auto index           = _get_index(entity);
-    archetype* const archetype = entities_[index].second;
+    archetype* const archetype = _archetype_of(index);
     if (archetype == nullptr) {
         _emplace_new_entity<Components...>(entity);
         return;
     }
 
     // get dst hash
+    constexpr uint64_t mixed = _hash_transition::mix_delta(hash);
     _hash_transition cond{ .from = archetype->hash(), .delta = hash };
     uint64_t to = 0;
-    if (auto trans = transitions_.find(cond); trans != transitions_.end())
-        [[likely]] {
+    if (auto trans = transitions_.find(
+            cond, _hash_transition::hash_mixed(cond.from, mixed));
+        trans != transitions_.end()) [[likely]] {
         to = trans->second;
     } else [[unlikely]] {
         constexpr auto arr = make_hash_array<tlist>();
@@ -272,9 +426,8 @@ constexpr void world_base<Alloc>::add_components(entity_t entity) {
     // get target archetype by given dst hash
     auto iter = archetypes_.find(to);
     if (iter == archetypes_.end()) [[unlikely]] {
-        auto [it, _] = archetypes_.try_emplace(
-            to, *archetype, add_components_t<Components...>());
-        iter = it;
+        iter =
+            _emplace_archetype(to, *archetype, add_components_t<Components...>());
     }
 
     // do move
@@ -287,7 +440,7 @@ constexpr void world_base<Alloc>::add_components(
     constexpr uint64_t hash =
         neutron::make_array_hash<neutron::type_list<Components...>>();
     const auto index      = _get_index(entity);
-    auto* const archetype = entities_[index].second;
+    auto* const archetype = _archetype_of(index);
     if (archetype == nullptr) {
         _emplace_new_entity<Components...>(
             entity, std::forward<Components>(components)...);
@@ -305,15 +458,17 @@ constexpr void world_base<Alloc>::remove_components(entity_t entity) {
     constexpr uint64_t hash = make_array_hash<tlist>();
 
     const auto index           = _get_index(entity);
-    archetype* const archetype = entities_[index].second;
+    archetype* const archetype = _archetype_of(index);
     if (archetype == nullptr) [[unlikely]] {
         return;
     }
 
+    constexpr uint64_t mixed = _hash_transition::mix_delta(hash);
     _hash_transition cond{ .from = archetype->hash(), .delta = hash };
     uint64_t to = 0;
-    if (auto trans = transitions_.find(cond); trans != transitions_.end())
-        [[likely]] {
+    if (auto trans = transitions_.find(
+            cond, _hash_transition::hash_mixed(cond.from, mixed));
+        trans != transitions_.end()) [[likely]] {
         to = trans->second;
     } else [[unlikely]] {
         constexpr auto arr = make_hash_array<tlist>();
@@ -330,34 +485,122 @@ constexpr void world_base<Alloc>::remove_components(entity_t entity) {
 
     auto iter = archetypes_.find(to);
     if (iter == archetypes_.end()) [[unlikely]] {
-        auto [it, _] = archetypes_.try_emplace(
-            to, *archetype, add_components_t<Components...>{});
-        iter = it;
+        iter =
+            _emplace_archetype(to, *archetype, add_components_t<Components...>{});
     }
 
     // do move
 }
 
+template <std_simple_allocator Alloc>
+template <std_simple_allocator Al, component... Components, typename Fn>
+void world_base<Alloc>::_instantiate(
+    const basic_prefab<Al, Components...>& prefab, size_type count,
+    Fn&& on_spawn) {
+    using namespace neutron;
+    constexpr uint64_t hash = basic_prefab<Al, Components...>::hash;
+
+    const auto n = prefab.size() * count;
+    if (n == 0) [[unlikely]] {
+        return;
+    }
+
+    auto iter = archetypes_.find(hash);
+    if (iter == archetypes_.end()) [[unlikely]] {
+        iter = _emplace_archetype(hash, archetype{ spread_type<Components...> });
+    }
+    archetype* const arche = &iter->second;
+
+    // allocate the pages of the batch at once
+    const auto reused = (std::min)(n, free_indices_.size());
+    locations_.reserve(locations_.size() + (n - reused));
+
+    _vector_t<entity_t> spawned(locations_.get_allocator());
+    spawned.reserve(n);
+    ATOM_TRY {
+        arche->emplace_copies(
+            count, prefab.size(),
+            [this, &on_spawn, &spawned] {
+                const entity_t entity = _get_new_entity();
+                spawned.push_back(entity);
+                on_spawn(entity);
+                return entity;
+            },
+            prefab.template get<Components>().data()...);
+    }
+    ATOM_CATCH(...) {
+        // the archetype has unbound the rows of the batch, so that the
+        // entities are stored nowhere and could be killed as empty ones
+        for (const entity_t entity : spawned) {
+            kill(entity);
+        }
+        ATOM_RETHROW;
+    }
+}
+
+template <std_simple_allocator Alloc>
+template <std_simple_allocator Al, component... Components>
+void world_base<Alloc>::instantiate(
+    const basic_prefab<Al, Components...>& prefab, size_type count) {
+    _instantiate(prefab, count, [](entity_t) noexcept {});
+}
+
+template <std_simple_allocator Alloc>
+template <
+    std_simple_allocator Al, component... Components,
+    std::output_iterator<entity_t> Out>
+Out world_base<Alloc>::instantiate(
+    const basic_prefab<Al, Components...>& prefab, size_type count, Out out) {
+    _instantiate(prefab, count, [&out](entity_t entity) {
+        *out = entity;
+        ++out;
+    });
+    return out;
+}
+
 template <std_simple_allocator Alloc>
 constexpr void world_base<Alloc>::kill(entity_t entity) {
     const auto index = _get_index(entity);
     const auto gen   = _get_gen(entity);
-    assert(entity == entities_[index].first);
+    assert(locations_.contains(entity));
 
-    auto*& arche = entities_[index].second;
-    if (arche != nullptr) {
+    if (auto* const arche = _archetype_of(index); arche != nullptr) {
         arche->erase(entity);
-        arche = nullptr;
     }
-    _reset_index(entities_[index].first);
+    locations_.kill(index);
     if (gen != (std::numeric_limits<uint32_t>::max)()) [[likely]] {
         free_indices_.push(index);
     }
 }
 
+template <std_simple_allocator Alloc>
+constexpr void world_base<Alloc>::kill(std::span<const entity_t> entities) {
+    while (!entities.empty()) {
+        if (!is_alive(entities.front())) {
+            entities = entities.subspan(1);
+            continue;
+        }
+        auto* const arche = _archetype_of(_get_index(entities.front()));
+        size_type count   = 1;
+        while (count < entities.size() && is_alive(entities[count]) &&
+               _archetype_of(_get_index(entities[count])) == arche) {
+            ++count;
+        }
+        const auto run = entities.first(count);
+        if (arche != nullptr) {
+            arche->erase(run);
+        }
+        for (const entity_t entity : run) {
+            // stored nowhere now, and killed as an empty one
+            kill(entity);
+        }
+        entities = entities.subspan(count);
+    }
+}
+
 template <std_simple_allocator Alloc>
 constexpr void world_base<Alloc>::reserve(size_type n) {
-    entities_.reserve(n);
+    locations_.reserve(n);
 }
 
 template <std_simple_allocator Alloc>
@@ -367,21 +610,116 @@ constexpr void world_base<Alloc>::reserve(size_type n) {
     using list          = type_list<Components...>;
     constexpr auto hash = make_array_hash<list>();
 
-    if (auto iter = archetypes_.find(hash); iter != archetypes_.end()) {
-        iter->second.reserve(n);
-    } else {
-        auto [it, succ] =
-            archetypes_.emplace(hash, archetype{ spread_type<Components...> });
-        it->second.reserve(n);
+    auto iter = archetypes_.find(hash);
+    if (iter == archetypes_.end()) {
+        iter = _emplace_archetype(hash, archetype{ spread_type<Components...> });
     }
+    iter->second.reserve(n);
 
-    entities_.reserve(n);
+    locations_.reserve(n);
 }
 
 template <std_simple_allocator Alloc>
 constexpr bool world_base<Alloc>::is_alive(entity_t entity) noexcept {
-    const auto index = _get_index(entity);
-    return index != 0 && entities_.size() > index;
+    return _get_index(entity) != 0 && locations_.contains(entity);
+}
+
+template <std_simple_allocator Alloc>
+void world_base<Alloc>::_rebuild_free_indices() {
+    _vector_t<uint32_t> indices(locations_.get_allocator());
+    for (size_type i = 1; i < locations_.size(); ++i) {
+        const auto index = static_cast<index_t>(i);
+        if (locations_.is_killed(index) &&
+            locations_[index].generation !=
+                (std::numeric_limits<uint32_t>::max)()) {
+            indices.push_back(index);
+        }
+    }
+    free_indices_ = _priority_queue<uint32_t>{ std::less<uint32_t>{},
+                                               std::move(indices) };
+}
+
+template <std_simple_allocator Alloc>
+template <typename Fn>
+bool world_base<Alloc>::_compact(size_type budget, Fn&& visit) {
+    auto iter = archetypes_.find(compact_cursor_);
+    if (iter == archetypes_.end()) {
+        iter = archetypes_.begin();
+    }
+
+    _vector_t<uint64_t> retired(archetypes_.get_allocator());
+    bool moved = false;
+    for (; iter != archetypes_.end() && budget != 0; --budget) {
+        archetype& arche = iter->second;
+        if (arche.empty()) {
+            retired.push_back(iter->first);
+            iter = archetypes_.erase(iter);
+            continue;
+        }
+
+        moved = visit(arche) || moved;
+        if (arche.capacity() > (arche.size() << 2)) {
+            arche.shrink_to_fit();
+            moved = true;
+        }
+        ++iter;
+    }
+
+    const bool complete = iter == archetypes_.end();
+    compact_cursor_     = complete ? 0 : iter->first;
+    if (moved || !retired.empty()) {
+        ++compact_epoch_;
+    }
+    if (!retired.empty()) {
+        _retire_transitions(retired);
+    }
+    return complete;
+}
+
+template <std_simple_allocator Alloc>
+void world_base<Alloc>::_retire_transitions(_vector_t<uint64_t>& retired) {
+    std::ranges::sort(retired);
+    const auto is_retired = [&retired](uint64_t hash) {
+        return std::ranges::binary_search(retired, hash);
+    };
+
+    _vector_t<_hash_transition> keys(transitions_.get_allocator());
+    for (const auto& [cond, to] : transitions_) {
+        if (is_retired(cond.from) || is_retired(to)) {
+            keys.push_back(cond);
+        }
+    }
+    for (const auto& cond : keys) {
+        transitions_.erase(cond);
+    }
+}
+
+template <std_simple_allocator Alloc>
+bool world_base<Alloc>::compact(size_type budget) {
+    return _compact(budget, [](archetype&) noexcept { return false; });
+}
+
+template <std_simple_allocator Alloc>
+template <typename Proj>
+requires std::totally_ordered<std::invoke_result_t<Proj&, entity_t>>
+bool world_base<Alloc>::compact(size_type budget, Proj proj) {
+    return _compact(
+        budget,
+        [&proj](archetype& arche) { return arche.sort(std::ref(proj)); });
+}
+
+template <std_simple_allocator Alloc>
+template <component Key, typename Comp, typename Proj>
+requires(!std::is_empty_v<Key>)
+auto world_base<Alloc>::sort_by(Comp comp, Proj proj) -> size_type {
+    size_type sorted = 0;
+    for (auto& [_, arche] : archetypes_) {
+        if (arche.template has<Key>() &&
+            arche.template sort_by<Key>(std::ref(comp), std::ref(proj))) {
+            ++sorted;
+        }
+    }
+    return sorted;
 }
 
 template <std_simple_allocator Alloc>
@@ -389,9 +727,9 @@ void world_base<Alloc>::clear() {
     for (auto& [_, archetype] : archetypes_) {
         archetype.clear();
     }
-    free_indices_ = _priority_queue<index_t>{ entities_.get_allocator() };
-    entities_.clear();
-    entities_.emplace_back();
+    free_indices_ = _priority_queue<index_t>{ locations_.get_allocator() };
+    locations_.clear();
+    locations_.emplace_back();
 }
 
 } // namespace _world_base
@@ -407,8 +745,8 @@ template <>
 struct hash<neutron::_world_base::_hash_transition> {
     size_t operator()(const neutron::_world_base::_hash_transition& transition)
         const noexcept {
-        return hash<uint64_t>{}(transition.from) ^
-               (hash<uint64_t>{}(transition.delta) << 1);
+        return neutron::_world_base::_hash_transition::hash(
+            transition.from, transition.delta);
     }
 };
 
@@ -21,14 +21,17 @@ struct world_descriptor_t {
     using sysinfo = SysInfo;
 
     template <stage Stage, auto Fn, typename... Requires>
-    using add_system_t = world_descriptor_t<type_list_cat_t<
-        SysInfo, type_list<_add_system::sysinfo<Stage, Fn, Requires...>>>>;
+    using add_system_t = world_descriptor_t<
+        type_list_cat_t<
+            SysInfo, type_list<_add_system::sysinfo<Stage, Fn, Requires...>>>,
+        Schedule, Sync, Custom...>;
 
     using schedule_policy = Schedule;
 
     template <typename... Policy>
     using set_schedule_t = world_descriptor_t<
-        SysInfo, type_list_cat_t<Schedule, type_list<Policy...>>>;
+        SysInfo, type_list_cat_t<Schedule, type_list<Policy...>>, Sync,
+        Custom...>;
 };
 
 constexpr inline world_descriptor_t<> world_desc;
@@ -1,6 +1,7 @@
 // IWYU pragma: private, include <neutron/ecs.hpp>
 #pragma once
 #include <cstddef>
+#include <cstdint>
 #include <neutron/concepts.hpp>
 #include <neutron/metafn.hpp>
 #include "neutron/detail/ecs/world_descriptor/fwd.hpp"
@@ -17,9 +18,55 @@ constexpr bool _is_group_desc<individual> = true;
 template <size_t Index>
 constexpr bool _is_group_desc<group<Index>> = true;
 
+/**
+ * @brief Runs the system `Sys` on the lane `Priority` of the scheduler, 0
+ * being the most urgent.
+ *
+ * Only schedulers with lanes, rebinding through `with_priority`, such as the
+ * ones of `priority_pool`, honour it; the others run every system alike.
+ */
+template <auto Sys, size_t Priority>
+struct priority {};
+
+template <typename T>
+constexpr bool _is_priority_desc = false;
+template <auto Sys, size_t Priority>
+constexpr bool _is_priority_desc<priority<Sys, Priority>> = true;
+
 template <typename Policy>
-concept _schedule_policy =
-    is_specific_value_list_v<frequency, Policy> || _is_group_desc<Policy>;
+concept _schedule_policy = is_specific_value_list_v<frequency, Policy> ||
+                           _is_group_desc<Policy> || _is_priority_desc<Policy>;
+
+/*! @cond TURN_OFF_DOXYGEN */
+namespace _set_schedule {
+
+inline constexpr size_t _no_priority = SIZE_MAX;
+
+template <auto Sys, typename Policy>
+constexpr size_t _priority_of = _no_priority;
+template <auto Sys, size_t Priority>
+constexpr size_t _priority_of<Sys, priority<Sys, Priority>> = Priority;
+
+template <auto Sys, typename Schedule>
+struct _system_priority;
+template <auto Sys, typename... Policy>
+struct _system_priority<Sys, type_list<Policy...>> {
+    static constexpr size_t value = [] {
+        size_t result = _no_priority;
+        ((result = _priority_of<Sys, Policy> != _no_priority
+                       ? _priority_of<Sys, Policy>
+                       : result),
+         ...);
+        return result;
+    }();
+};
+
+/// The priority given to `Sys` by the schedule policies, the last one wins.
+template <auto Sys, typename Schedule>
+constexpr size_t _system_priority_v = _system_priority<Sys, Schedule>::value;
+
+} // namespace _set_schedule
+/*! @endcond */
 
 template <_schedule_policy... Policy>
 struct _set_scheduler_t :
@@ -29,7 +76,6 @@ struct _set_scheduler_t :
         return typename Descriptor::template set_schedule_t<Policy...>{};
     }
 };
-;
 
 template <_schedule_policy... Policy>
 inline constexpr _set_scheduler_t<Policy...> set_schedule{};
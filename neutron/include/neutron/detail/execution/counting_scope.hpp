@@ -0,0 +1,371 @@
+// IWYU pragma: private, include <neutron/execution.hpp>
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <semaphore>
+#include <type_traits>
+#include <utility>
+#include "neutron/detail/execution/inplace_stop_source.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
+#include "neutron/execution.hpp" // IWYU pragma: keep
+
+namespace neutron {
+
+/**
+ * @brief Spawns a dynamic number of senders and joins them later, without
+ * allocating per spawn.
+ *
+ * The operation states of the spawned senders are constructed in the slots of
+ * a slab allocated once, `capacity` slots of `SlotSize` bytes, which also caps
+ * the work in flight. `try_spawn` fails when every slot is taken, `spawn`
+ * waits for one to be released. An operation state larger than a slot is
+ * rejected at compile time.
+ *
+ * `join()` returns a sender completing once no spawned work is in flight, on
+ * the thread completing the last of it, or inline if there is none. The scope
+ * is reusable afterwards, so one scope could serve a system frame after frame.
+ *
+ * Spawned senders observe the stop token of the scope through their receiver
+ * environment; `request_stop` asks all of them to stop. Their values are
+ * discarded, and completing with an error terminates, as with an exception
+ * escaping a thread.
+ * @warning Calling `spawn` on the only thread able to complete the work in
+ * flight deadlocks once the scope is full, use `try_spawn` there.
+ */
+template <
+    size_t SlotSize = 256, typename Alloc = std::allocator<std::byte>>
+class basic_counting_scope {
+    static_assert(SlotSize % alignof(std::max_align_t) == 0);
+
+    using _word_allocator = rebind_alloc_t<Alloc, std::max_align_t>;
+    using _alloc_traits   = std::allocator_traits<_word_allocator>;
+
+    struct _slot_header {
+        void (*destroy)(void*) noexcept;
+        std::atomic<uint32_t> next; // read by racing pops
+    };
+
+    static constexpr uint32_t _none = UINT32_MAX;
+
+    static constexpr size_t _stride =
+        ((sizeof(_slot_header) + alignof(std::max_align_t) - 1) /
+         alignof(std::max_align_t) * alignof(std::max_align_t)) +
+        SlotSize;
+
+    struct _env {
+        const basic_counting_scope* scope;
+
+        ATOM_NODISCARD inplace_stop_token
+            query(execution::get_stop_token_t) const noexcept {
+            return scope->source_.get_token();
+        }
+    };
+
+    struct _spawn_receiver {
+        using receiver_concept = execution::receiver_t;
+
+        basic_counting_scope* scope;
+        uint32_t slot;
+
+        template <typename... Args>
+        void set_value(Args&&...) && noexcept {
+            scope->_complete(slot);
+        }
+
+        template <typename Error>
+        void set_error(Error&&) && noexcept {
+            std::terminate();
+        }
+
+        void set_stopped() && noexcept { scope->_complete(slot); }
+
+        ATOM_NODISCARD _env get_env() const noexcept { return { scope }; }
+    };
+
+    struct _join_base {
+        _join_base* next = nullptr;
+        void (*complete)(_join_base*) noexcept = nullptr;
+    };
+
+    template <typename Rcvr>
+    struct _join_opstate : _join_base {
+        using operation_state_concept = execution::operation_state_t;
+
+        basic_counting_scope* scope;
+        ATOM_NO_UNIQUE_ADDR Rcvr rcvr;
+
+        template <typename R>
+        _join_opstate(basic_counting_scope* scope, R&& rcvr)
+            : _join_base{ nullptr, &_complete }, scope(scope),
+              rcvr(std::forward<R>(rcvr)) {}
+
+        void start() & noexcept {
+            if (!scope->_wait(this)) {
+                execution::set_value(std::move(rcvr));
+            }
+        }
+
+        static void _complete(_join_base* base) noexcept {
+            execution::set_value(
+                std::move(static_cast<_join_opstate*>(base)->rcvr));
+        }
+    };
+
+    class _join_sender {
+    public:
+        using sender_concept = execution::sender_t;
+        using completion_signatures =
+            execution::completion_signatures<execution::set_value_t()>;
+
+        explicit _join_sender(basic_counting_scope* scope) noexcept
+            : scope_(scope) {}
+
+        template <typename Rcvr>
+        auto connect(Rcvr&& rcvr) const
+            -> _join_opstate<std::remove_cvref_t<Rcvr>> {
+            return { scope_, std::forward<Rcvr>(rcvr) };
+        }
+
+    private:
+        basic_counting_scope* scope_;
+    };
+
+public:
+    static constexpr size_t slot_size = SlotSize;
+
+    using allocator_type = Alloc;
+
+    explicit basic_counting_scope(
+        size_t capacity, const Alloc& allocator = Alloc{})
+        : allocator_(allocator), capacity_(capacity),
+          slots_(static_cast<std::ptrdiff_t>(capacity)) {
+        // `_stride` is a multiple of the alignment, not of the size
+        words_ = ((capacity * _stride) + sizeof(std::max_align_t) - 1) /
+                 sizeof(std::max_align_t);
+        slab_  = reinterpret_cast<std::byte*>( // NOLINT
+            _alloc_traits::allocate(allocator_, words_));
+        for (size_t i = 0; i < capacity; ++i) {
+            const auto next =
+                i + 1 == capacity ? _none : static_cast<uint32_t>(i + 1);
+            ::new (_slot(static_cast<uint32_t>(i)))
+                _slot_header{ nullptr, next };
+        }
+        free_.store(capacity == 0 ? _pack(_none, 0) : _pack(0, 0));
+    }
+
+    basic_counting_scope(const basic_counting_scope&)            = delete;
+    basic_counting_scope& operator=(const basic_counting_scope&) = delete;
+    basic_counting_scope(basic_counting_scope&&)                 = delete;
+    basic_counting_scope& operator=(basic_counting_scope&&)      = delete;
+
+    /**
+     * @warning The work in flight must have been joined.
+     */
+    ~basic_counting_scope() {
+        _alloc_traits::deallocate(
+            allocator_,
+            reinterpret_cast<std::max_align_t*>(slab_), // NOLINT
+            words_);
+    }
+
+    /**
+     * @brief Connects `sndr` into a free slot and starts it.
+     * @return Whether a slot was free and the scope open.
+     */
+    template <typename Sndr>
+    bool try_spawn(Sndr&& sndr) {
+        if (closed_.load(std::memory_order_relaxed) ||
+            !slots_.try_acquire()) {
+            return false;
+        }
+        _start(std::forward<Sndr>(sndr));
+        return true;
+    }
+
+    /**
+     * @brief Connects `sndr` into a slot and starts it, waiting for a slot to
+     * be released if none is free.
+     * @return Whether the scope was open.
+     */
+    template <typename Sndr>
+    bool spawn(Sndr&& sndr) {
+        if (closed_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        slots_.acquire();
+        _start(std::forward<Sndr>(sndr));
+        return true;
+    }
+
+    /**
+     * @brief Sender completing once no spawned work is in flight.
+     */
+    ATOM_NODISCARD _join_sender join() noexcept {
+        return _join_sender{ this };
+    }
+
+    /**
+     * @brief Makes the following spawns fail.
+     */
+    void close() noexcept { closed_.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Requests the spawned work to stop, through the stop token in
+     * their environment. The request is not withdrawn afterwards.
+     */
+    void request_stop() noexcept { source_.request_stop(); }
+
+    ATOM_NODISCARD inplace_stop_token get_stop_token() const noexcept {
+        return source_.get_token();
+    }
+
+    ATOM_NODISCARD size_t capacity() const noexcept { return capacity_; }
+
+    /**
+     * @brief Number of spawned operations not yet completed.
+     */
+    ATOM_NODISCARD size_t in_flight() const noexcept {
+        return count_.load(std::memory_order_acquire);
+    }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return allocator_type{ allocator_ };
+    }
+
+private:
+    static constexpr uint64_t _pack(uint32_t index, uint32_t tag) noexcept {
+        return (static_cast<uint64_t>(tag) << 32U) | index;
+    }
+
+    ATOM_NODISCARD void* _slot(uint32_t index) const noexcept {
+        return slab_ + (index * _stride);
+    }
+
+    ATOM_NODISCARD _slot_header* _header(uint32_t index) const noexcept {
+        return std::launder(static_cast<_slot_header*>(_slot(index)));
+    }
+
+    ATOM_NODISCARD void* _storage(uint32_t index) const noexcept {
+        return static_cast<std::byte*>(_slot(index)) + (_stride - SlotSize);
+    }
+
+    // a slot is guaranteed by the semaphore, only the free list races
+    uint32_t _pop_slot() noexcept {
+        auto head = free_.load(std::memory_order_acquire);
+        while (true) {
+            const auto index = static_cast<uint32_t>(head);
+            const auto next =
+                _header(index)->next.load(std::memory_order_relaxed);
+            if (free_.compare_exchange_weak(
+                    head, _pack(next, static_cast<uint32_t>(head >> 32U) + 1),
+                    std::memory_order_acquire, std::memory_order_acquire)) {
+                return index;
+            }
+        }
+    }
+
+    void _push_slot(uint32_t index) noexcept {
+        auto head = free_.load(std::memory_order_relaxed);
+        do {
+            _header(index)->next.store(
+                static_cast<uint32_t>(head), std::memory_order_relaxed);
+        } while (!free_.compare_exchange_weak(
+            head, _pack(index, static_cast<uint32_t>(head >> 32U) + 1),
+            std::memory_order_release, std::memory_order_relaxed));
+        slots_.release();
+    }
+
+    template <typename Sndr>
+    void _start(Sndr&& sndr) {
+        using opstate_t = decltype(execution::connect(
+            std::declval<Sndr>(), std::declval<_spawn_receiver>()));
+        static_assert(
+            sizeof(opstate_t) <= SlotSize,
+            "the operation state does not fit in a slot of the scope");
+        static_assert(alignof(opstate_t) <= alignof(std::max_align_t));
+
+        const auto index = _pop_slot();
+        count_.fetch_add(1, std::memory_order_relaxed);
+        ATOM_TRY {
+            auto* const opstate = ::new (_storage(index)) opstate_t(
+                execution::connect(
+                    std::forward<Sndr>(sndr), _spawn_receiver{ this, index }));
+            _header(index)->destroy = [](void* pointer) noexcept {
+                static_cast<opstate_t*>(pointer)->~opstate_t();
+            };
+            execution::start(*opstate);
+        }
+        ATOM_CATCH(...) {
+            _push_slot(index);
+            _release();
+            ATOM_RETHROW;
+        }
+    }
+
+    void _complete(uint32_t index) noexcept {
+        auto* const header = _header(index);
+        header->destroy(_storage(index));
+        _push_slot(index);
+        _release();
+    }
+
+    void _release() noexcept {
+        if (count_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        _join_base* waiters = nullptr;
+        {
+            std::unique_lock guard{ mutex_ };
+            if (count_.load(std::memory_order_acquire) != 0) {
+                return; // respawned meanwhile, the next release completes them
+            }
+            waiters = std::exchange(waiters_, nullptr);
+        }
+        while (waiters != nullptr) {
+            auto* const waiter = std::exchange(waiters, waiters->next);
+            waiter->complete(waiter);
+        }
+    }
+
+    /// Registers a joiner, false if nothing is in flight.
+    bool _wait(_join_base* waiter) noexcept {
+        std::unique_lock guard{ mutex_ };
+        if (count_.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        waiter->next = waiters_;
+        waiters_     = waiter;
+        return true;
+    }
+
+    ATOM_NO_UNIQUE_ADDR _word_allocator allocator_;
+    size_t capacity_;
+    size_t words_;
+    std::byte* slab_;
+    std::counting_semaphore<> slots_;
+    std::atomic<uint64_t> free_;
+    std::atomic<size_t> count_{ 0 };
+    std::atomic<bool> closed_{ false };
+    std::mutex mutex_;
+    _join_base* waiters_ = nullptr;
+    inplace_stop_source source_;
+};
+
+using counting_scope = basic_counting_scope<>;
+
+namespace pmr {
+
+template <size_t SlotSize = 256>
+using counting_scope = basic_counting_scope<
+    SlotSize, std::pmr::polymorphic_allocator<std::byte>>;
+
+} // namespace pmr
+
+} // namespace neutron
@@ -1,9 +1,59 @@
 #pragma once
+#include <concepts>
+#include <type_traits>
+#include <utility>
+#include "neutron/detail/execution/inplace_stop_source.hpp"
+#include "neutron/detail/macros.hpp"
 
 namespace neutron {
 
+/**
+ * @brief Invokes `CallbackFn` once stop is requested on the source of a token.
+ *
+ * Constructed from a token whose stop was already requested, the callback is
+ * invoked immediately in the constructor.
+ */
 template <typename CallbackFn>
-class inplace_stop_callback;
+class inplace_stop_callback : _inplace_stop::_callback_base {
+public:
+    using callback_type = CallbackFn;
+
+    template <typename Init>
+    requires std::constructible_from<CallbackFn, Init>
+    explicit inplace_stop_callback(
+        inplace_stop_token token,
+        Init&& init) noexcept(std::is_nothrow_constructible_v<CallbackFn, Init>)
+        : _callback_base(&_execute), fn_(std::forward<Init>(init)),
+          source_(token.source_) {
+        if (source_ != nullptr && !source_->_try_add(this)) {
+            source_ = nullptr;
+            std::move(fn_)();
+        }
+    }
+
+    inplace_stop_callback(const inplace_stop_callback&)            = delete;
+    inplace_stop_callback& operator=(const inplace_stop_callback&) = delete;
+    inplace_stop_callback(inplace_stop_callback&&)                 = delete;
+    inplace_stop_callback& operator=(inplace_stop_callback&&)      = delete;
+
+    ~inplace_stop_callback() {
+        if (source_ != nullptr) {
+            source_->_remove(this);
+        }
+    }
+
+private:
+    static void _execute(_callback_base* base) noexcept {
+        std::move(static_cast<inplace_stop_callback*>(base)->fn_)();
+    }
+
+    ATOM_NO_UNIQUE_ADDR CallbackFn fn_;
+    const inplace_stop_source* source_;
+};
+
+template <typename CallbackFn>
+inplace_stop_callback(inplace_stop_token, CallbackFn)
+    -> inplace_stop_callback<CallbackFn>;
 
 template <typename T, typename CallbackFn>
 using stop_callback_for_t = T::template callback_type<CallbackFn>;
@@ -1,18 +1,186 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
 #include "neutron/detail/execution/inplace_stop_token.hpp"
 #include "neutron/detail/macros.hpp"
 
 namespace neutron {
 
+/*! @cond TURN_OFF_DOXYGEN */
+namespace _inplace_stop {
+
+struct _callback_base {
+    explicit _callback_base(void (*execute)(_callback_base*) noexcept) noexcept
+        : execute(execute) {}
+
+    void (*execute)(_callback_base*) noexcept;
+    _callback_base* next = nullptr;
+    _callback_base** prev = nullptr;
+    bool* removed_during_execution = nullptr;
+    std::atomic<bool> executed{ false };
+};
+
+} // namespace _inplace_stop
+/*! @endcond */
+
+/**
+ * @brief A stop source that needs no allocation.
+ *
+ * Registered callbacks are linked intrusively into the source, guarded by a
+ * spin lock folded into the state word. `request_stop` runs them on the
+ * requesting thread, outside the lock. A callback may be destroyed from
+ * within itself; destroying it from another thread while it runs waits for
+ * it to return.
+ */
 class inplace_stop_source {
 public:
-    ATOM_NODISCARD bool stop_requested() const noexcept;
-    static constexpr bool stop_possible() noexcept;
-    ATOM_NODISCARD auto get_token() const -> inplace_stop_token;
+    inplace_stop_source() noexcept = default;
+
+    inplace_stop_source(const inplace_stop_source&)            = delete;
+    inplace_stop_source& operator=(const inplace_stop_source&) = delete;
+    inplace_stop_source(inplace_stop_source&&)                 = delete;
+    inplace_stop_source& operator=(inplace_stop_source&&)      = delete;
+
+    ATOM_NODISCARD bool stop_requested() const noexcept {
+        return (state_.load(std::memory_order_acquire) & stop_requested_bit) !=
+               0;
+    }
+
+    ATOM_NODISCARD static constexpr bool stop_possible() noexcept {
+        return true;
+    }
+
+    ATOM_NODISCARD auto get_token() const noexcept -> inplace_stop_token {
+        return inplace_stop_token{ this };
+    }
+
+    /**
+     * @brief Requests stop and invokes the registered callbacks.
+     * @return Whether this call made the request, false if stop had already
+     * been requested.
+     */
+    bool request_stop() noexcept {
+        if (!_lock_unless_stopped(true)) {
+            return false;
+        }
+        notifying_thread_ = std::this_thread::get_id();
+        while (callbacks_ != nullptr) {
+            auto* const callback = callbacks_;
+            callbacks_           = callback->next;
+            if (callbacks_ != nullptr) {
+                callbacks_->prev = &callbacks_;
+            }
+            callback->prev = nullptr;
 
-    bool request_stop();
+            bool removed                       = false;
+            callback->removed_during_execution = &removed;
+            _unlock(stop_requested_bit);
+
+            callback->execute(callback);
+            if (!removed) {
+                callback->removed_during_execution = nullptr;
+                // the last access: once the flag is seen, `_remove` returns
+                // and the callback may be destroyed
+                callback->executed.store(true, std::memory_order_release);
+            }
+            _lock();
+        }
+        _unlock(stop_requested_bit);
+        return true;
+    }
 
 private:
+    template <typename CallbackFn>
+    friend class inplace_stop_callback;
+
+    static constexpr uint8_t stop_requested_bit = 1;
+    static constexpr uint8_t locked_bit         = 2;
+
+    bool _lock_unless_stopped(bool request) const noexcept {
+        auto state = state_.load(std::memory_order_relaxed);
+        do {
+            while (true) {
+                if ((state & stop_requested_bit) != 0) {
+                    return false;
+                }
+                if ((state & locked_bit) == 0) {
+                    break;
+                }
+                std::this_thread::yield();
+                state = state_.load(std::memory_order_relaxed);
+            }
+        } while (!state_.compare_exchange_weak(
+            state,
+            state | locked_bit | (request ? stop_requested_bit : uint8_t{}),
+            std::memory_order_acq_rel, std::memory_order_relaxed));
+        return true;
+    }
+
+    void _lock() const noexcept {
+        auto state = state_.load(std::memory_order_relaxed);
+        do {
+            while ((state & locked_bit) != 0) {
+                std::this_thread::yield();
+                state = state_.load(std::memory_order_relaxed);
+            }
+        } while (!state_.compare_exchange_weak(
+            state, state | locked_bit, std::memory_order_acquire,
+            std::memory_order_relaxed));
+    }
+
+    void _unlock(uint8_t state) const noexcept {
+        state_.store(state, std::memory_order_release);
+    }
+
+    bool _try_add(_inplace_stop::_callback_base* callback) const noexcept {
+        if (!_lock_unless_stopped(false)) {
+            return false;
+        }
+        callback->next = callbacks_;
+        callback->prev = &callbacks_;
+        if (callbacks_ != nullptr) {
+            callbacks_->prev = &callback->next;
+        }
+        callbacks_ = callback;
+        _unlock(0);
+        return true;
+    }
+
+    void _remove(_inplace_stop::_callback_base* callback) const noexcept {
+        _lock();
+        if (callback->prev != nullptr) { // still registered
+            *callback->prev = callback->next;
+            if (callback->next != nullptr) {
+                callback->next->prev = callback->prev;
+            }
+            _unlock(state_.load(std::memory_order_relaxed) & ~locked_bit);
+            return;
+        }
+        const auto notifying = notifying_thread_;
+        _unlock(stop_requested_bit);
+
+        // dequeued by request_stop, it is running or has run
+        if (notifying == std::this_thread::get_id()) {
+            if (callback->removed_during_execution != nullptr) {
+                *callback->removed_during_execution = true;
+            }
+        } else {
+            // not `wait`, whose `notify_all` would touch the callback after
+            // the flag let it be destroyed
+            while (!callback->executed.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    mutable std::atomic<uint8_t> state_{ 0 };
+    mutable _inplace_stop::_callback_base* callbacks_ = nullptr;
+    std::thread::id notifying_thread_;
 };
 
-} // namespace neutron::execution
+inline bool inplace_stop_token::stop_requested() const noexcept {
+    return source_ != nullptr && source_->stop_requested();
+}
+
+} // namespace neutron
@@ -1,10 +1,52 @@
 #pragma once
+#include <utility>
 #include "neutron/detail/macros.hpp"
 
 namespace neutron {
 
-struct inplace_stop_token {
-    //
+class inplace_stop_source;
+
+template <typename CallbackFn>
+class inplace_stop_callback;
+
+/**
+ * @brief Non-owning view of an `inplace_stop_source`.
+ *
+ * A default constructed token is not associated with any source, it never
+ * reports a stop request.
+ */
+class inplace_stop_token {
+public:
+    template <typename CallbackFn>
+    using callback_type = inplace_stop_callback<CallbackFn>;
+
+    inplace_stop_token() noexcept = default;
+
+    ATOM_NODISCARD bool stop_requested() const noexcept;
+
+    ATOM_NODISCARD bool stop_possible() const noexcept {
+        return source_ != nullptr;
+    }
+
+    void swap(inplace_stop_token& that) noexcept {
+        std::swap(source_, that.source_);
+    }
+
+    friend bool operator==(
+        const inplace_stop_token&,
+        const inplace_stop_token&) noexcept = default;
+
+private:
+    friend class inplace_stop_source;
+    template <typename CallbackFn>
+    friend class inplace_stop_callback;
+
+    explicit inplace_stop_token(const inplace_stop_source* source) noexcept
+        : source_(source) {}
+
+    const inplace_stop_source* source_ = nullptr;
 };
 
 } // namespace neutron
+
+#include "neutron/detail/execution/inplace_stop_source.hpp" // IWYU pragma: keep
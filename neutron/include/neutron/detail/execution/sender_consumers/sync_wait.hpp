@@ -6,6 +6,7 @@
 #include "neutron/detail/execution/default_domain.hpp"
 #include "neutron/detail/execution/fwd.hpp"
 #include "neutron/detail/execution/get_delegation_scheduler.hpp"
+#include "neutron/detail/execution/get_domain.hpp"
 #include "neutron/detail/execution/get_scheduler.hpp"
 #include "neutron/detail/execution/run_loop.hpp"
 #include "neutron/detail/macros.hpp"
@@ -81,7 +82,7 @@ struct sync_wait_t {
 
     template <execution::sender Sndr>
     auto operator()(Sndr&& sndr) const {
-        auto dom = _get_domain_early(sndr);
+        auto dom = execution::_get_domain_early(sndr);
         return execution::apply_sender(dom, *this, std::forward<Sndr>(sndr));
     }
 };
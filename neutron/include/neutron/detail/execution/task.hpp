@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <exception>
 #include <memory>
+#include <new>
 #include <optional>
 #include <stdexcept>
 #include <type_traits>
@@ -21,6 +22,8 @@
 #include "neutron/detail/execution/set_value.hpp"
 #include "neutron/detail/execution/task_scheduler.hpp"
 #include "neutron/detail/macros.hpp"
+#include "neutron/detail/memory/frame_pool.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
 #include "sender_adaptors/affine_on.hpp"
 
 namespace neutron::execution {
@@ -48,7 +51,7 @@ namespace _task {
 
 template <typename Env>
 struct _env_allocator {
-    using type = std::allocator<std::byte>;
+    using type = frame_allocator<std::byte>;
 };
 template <typename Env>
 requires requires { typename Env::allocator_type; }
@@ -56,6 +59,86 @@ struct _env_allocator<Env> {
     using type = Env::allocator_type;
 };
 
+/**
+ * @brief Gets the allocator following `std::allocator_arg` in the arguments
+ * of a coroutine, or a default constructed one.
+ */
+template <typename Alloc>
+constexpr Alloc _find_allocator() noexcept {
+    return Alloc();
+}
+template <typename Alloc, typename First, typename... Rest>
+constexpr Alloc
+    _find_allocator(const First& first, const Rest&... rest) noexcept {
+    if constexpr (sizeof...(Rest) == 0) {
+        return Alloc();
+    } else if constexpr (std::same_as<First, std::allocator_arg_t>) {
+        return [](const auto& alloc, const auto&...) noexcept {
+            static_assert(
+                std::convertible_to<decltype(alloc), Alloc>,
+                "the allocator after allocator_arg is not convertible to "
+                "the allocator_type of the task");
+            return Alloc(alloc);
+        }(rest...);
+    } else {
+        return _find_allocator<Alloc>(rest...);
+    }
+}
+
+/// Allocation unit of coroutine frames, keeps frames suitably aligned.
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) _frame_unit {
+    std::byte bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__]; // NOLINT
+};
+
+/**
+ * @brief Allocates coroutine frames from an allocator. A copy of the
+ * allocator is stored after the frame unless it is always equal.
+ */
+template <typename Alloc>
+struct _frame_allocation {
+    using allocator_type = rebind_alloc_t<Alloc, _frame_unit>;
+    using traits         = std::allocator_traits<allocator_type>;
+
+    static constexpr bool stored =
+        !(traits::is_always_equal::value &&
+          std::default_initializable<allocator_type>);
+
+    static constexpr size_t _offset(size_t size) noexcept {
+        constexpr auto align = alignof(allocator_type);
+        return (size + align - 1) & ~(align - 1);
+    }
+
+    static constexpr size_t _units(size_t size) noexcept {
+        const auto bytes =
+            stored ? _offset(size) + sizeof(allocator_type) : size;
+        return (bytes + sizeof(_frame_unit) - 1) / sizeof(_frame_unit);
+    }
+
+    static void* allocate(size_t size, const Alloc& from) {
+        allocator_type alloc(from);
+        void* const frame = traits::allocate(alloc, _units(size));
+        if constexpr (stored) {
+            ::new (static_cast<std::byte*>(frame) + _offset(size))
+                allocator_type(std::move(alloc));
+        }
+        return frame;
+    }
+
+    static void deallocate(void* frame, size_t size) noexcept {
+        auto* const first = static_cast<_frame_unit*>(frame);
+        if constexpr (stored) {
+            auto* const where = std::launder(reinterpret_cast<allocator_type*>(
+                static_cast<std::byte*>(frame) + _offset(size)));
+            allocator_type alloc(std::move(*where));
+            where->~allocator_type();
+            traits::deallocate(alloc, first, _units(size));
+        } else {
+            allocator_type alloc;
+            traits::deallocate(alloc, first, _units(size));
+        }
+    }
+};
+
 template <typename Env>
 struct _env_scheduler {
     using type = task_scheduler;
@@ -117,7 +200,7 @@ template <typename T>
 class _promise_base {
 public:
     template <typename Val>
-    constexpr void result_value(Val&& val) noexcept(
+    constexpr void return_value(Val&& val) noexcept(
         std::is_nothrow_constructible_v<T, Val>) {
         result_.emplace(std::forward<Val>(val));
     }
@@ -183,7 +266,8 @@ public:
     class promise_type : public _task::_promise_base<T> {
     public:
         template <typename... Args>
-        promise_type(const Args&... args);
+        promise_type(const Args&... args)
+            : alloc_(_task::_find_allocator<allocator_type>(args...)) {}
 
         ATOM_NODISCARD task get_return_object() noexcept {
             return task{ handle_type::from_promise(*this) };
@@ -250,10 +334,21 @@ public:
             return _env{ this };
         }
 
+        /**
+         * @brief Allocates the frame from the allocator passed after
+         * `std::allocator_arg`, or from a default `allocator_type`, which is
+         * the thread-local `frame_pool` unless `Env` says otherwise.
+         */
         template <class... Args>
-        void* operator new(size_t size, Args&&... args);
+        void* operator new(size_t size, Args&&... args) {
+            return _task::_frame_allocation<allocator_type>::allocate(
+                size, _task::_find_allocator<allocator_type>(args...));
+        }
 
-        void operator delete(void* pointer, size_t size) noexcept;
+        void operator delete(void* pointer, size_t size) noexcept {
+            _task::_frame_allocation<allocator_type>::deallocate(
+                pointer, size);
+        }
 
     private:
         template <typename>
@@ -270,7 +365,6 @@ public:
         allocator_type alloc_;
         stop_source_type source_;
         stop_token_type token_;
-        std::optional<T> result_;
         _error_variant errors_;
         _opstate_base* state_;
     };
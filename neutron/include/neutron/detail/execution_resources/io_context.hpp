@@ -0,0 +1,553 @@
+// IWYU pragma: private, include <neutron/execution_resources.hpp>
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "neutron/detail/macros.hpp"
+#include "neutron/execution.hpp" // IWYU pragma: keep
+
+#if __has_include(<unistd.h>)
+    #include <sys/types.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+    #define ATOM_HAS_PREAD 1
+
+    #if (defined(__linux) || defined(__linux__)) &&                            \
+        __has_include(<linux/io_uring.h>)
+        #include <linux/io_uring.h>
+        #include <sys/mman.h>
+        #include <sys/syscall.h>
+        #define ATOM_HAS_IO_URING 1
+    #endif
+#endif
+
+#if defined(ATOM_HAS_PREAD)
+
+namespace neutron {
+
+/// Tag selecting the thread doing blocking `pread`/`pwrite` in `io_context`.
+struct blocking_io_t {
+    explicit blocking_io_t() = default;
+};
+inline constexpr blocking_io_t blocking_io{};
+
+/**
+ * @brief An execution resource running file reads and writes asynchronously.
+ *
+ * On Linux the operations are submitted to an io_uring, and a thread owned by
+ * the context reaps their completions. When io_uring could not be set up, for
+ * example in a container forbidding it, or when constructed with
+ * `blocking_io`, a thread owned by the context performs them with `pread` and
+ * `pwrite` instead. Either way, the threads calling `start` never block on the
+ * file.
+ *
+ * `async_read` and `async_write` return senders completing with the number of
+ * bytes transferred, which may be less than requested, or with a
+ * `std::error_code`. They complete on the thread of the context, so chain
+ * `continues_on(sch)` to resume the work on a scheduler of choice.
+ * @warning The context should outlive the operations started on it, its
+ * destructor waits for the operations in flight.
+ */
+class io_context {
+    struct _op_base {
+        _op_base* next{};
+        void (*complete)(_op_base*, ptrdiff_t result) noexcept {};
+        int fd{};
+        bool write{};
+        ::iovec buffer{};
+        uint64_t offset{};
+        int error{}; // set when the kernel refuses the submission
+    };
+
+    template <typename Rcvr>
+    struct _opstate : _op_base {
+        using operation_state_concept = execution::operation_state_t;
+
+        io_context* context;
+        ATOM_NO_UNIQUE_ADDR Rcvr rcvr;
+
+        template <typename R>
+        _opstate(
+            io_context* context, int fd, bool write, void* data, size_t size,
+            uint64_t offset, R&& rcvr)
+            : _op_base{ nullptr, &_complete, fd,
+                        write,   { data, size }, offset },
+              context(context), rcvr(std::forward<R>(rcvr)) {}
+
+        void start() & noexcept { context->_submit(this); }
+
+        static void _complete(_op_base* base, ptrdiff_t result) noexcept {
+            auto* const self = static_cast<_opstate*>(base);
+            if (result < 0) {
+                execution::set_error(
+                    std::move(self->rcvr),
+                    std::error_code(
+                        static_cast<int>(-result), std::system_category()));
+            } else {
+                execution::set_value(
+                    std::move(self->rcvr), static_cast<size_t>(result));
+            }
+        }
+    };
+
+    class _sender {
+    public:
+        using sender_concept = execution::sender_t;
+        using completion_signatures =
+            execution::completion_signatures<
+                execution::set_value_t(size_t),
+                execution::set_error_t(std::error_code)>;
+
+        _sender(
+            io_context* context, int fd, bool write, void* data, size_t size,
+            uint64_t offset) noexcept
+            : context_(context), fd_(fd), write_(write), data_(data),
+              size_(size), offset_(offset) {}
+
+        template <typename Rcvr>
+        auto connect(Rcvr&& rcvr) const
+            -> _opstate<std::remove_cvref_t<Rcvr>> {
+            return { context_, fd_,     write_,
+                     data_,    size_,   offset_,
+                     std::forward<Rcvr>(rcvr) };
+        }
+
+    private:
+        io_context* context_;
+        int fd_;
+        bool write_;
+        void* data_;
+        size_t size_;
+        uint64_t offset_;
+    };
+
+public:
+    static constexpr unsigned default_entries = 256;
+
+    /**
+     * @brief Constructs a context, on io_uring if available.
+     * @param entries Submission queue size of the io_uring.
+     */
+    explicit io_context(unsigned entries = default_entries) {
+#if defined(ATOM_HAS_IO_URING)
+        if (_setup_ring(entries)) {
+            thread_ = std::thread([this] { _reap(); });
+            return;
+        }
+#endif
+        (void)entries;
+        thread_ = std::thread([this] { _serve(); });
+    }
+
+    /**
+     * @brief Constructs a context doing blocking I/O on its own thread.
+     */
+    explicit io_context(blocking_io_t) : thread_([this] { _serve(); }) {}
+
+    io_context(const io_context&)            = delete;
+    io_context& operator=(const io_context&) = delete;
+    io_context(io_context&&)                 = delete;
+    io_context& operator=(io_context&&)      = delete;
+
+    ~io_context() {
+        {
+            std::unique_lock guard{ mutex_ };
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+#if defined(ATOM_HAS_IO_URING)
+        if (ring_fd_ >= 0) {
+            _teardown_ring();
+        }
+#endif
+    }
+
+    /**
+     * @brief Whether operations are submitted to an io_uring.
+     */
+    ATOM_NODISCARD bool uses_io_uring() const noexcept {
+#if defined(ATOM_HAS_IO_URING)
+        return ring_fd_ >= 0;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Reads up to `buffer.size()` bytes of `fd` starting at `offset`.
+     */
+    ATOM_NODISCARD _sender
+        async_read(int fd, std::span<std::byte> buffer, uint64_t offset) {
+        return { this, fd, false, buffer.data(), buffer.size(), offset };
+    }
+
+    /**
+     * @brief Writes `buffer` to `fd` starting at `offset`.
+     */
+    ATOM_NODISCARD _sender async_write(
+        int fd, std::span<const std::byte> buffer, uint64_t offset) {
+        return { this,
+                 fd,
+                 true,
+                 const_cast<std::byte*>(buffer.data()), // NOLINT
+                 buffer.size(),
+                 offset };
+    }
+
+    ATOM_NODISCARD
+    auto get_id() const noexcept -> std::thread::id { return thread_.get_id(); }
+
+private:
+    static ptrdiff_t _perform(const _op_base* op) noexcept {
+        const auto result =
+            op->write ? ::pwrite(
+                            op->fd, op->buffer.iov_base, op->buffer.iov_len,
+                            static_cast<off_t>(op->offset))
+                      : ::pread(
+                            op->fd, op->buffer.iov_base, op->buffer.iov_len,
+                            static_cast<off_t>(op->offset));
+        return result < 0 ? -errno : result;
+    }
+
+    void _submit(_op_base* op) noexcept {
+#if defined(ATOM_HAS_IO_URING)
+        if (ring_fd_ >= 0) {
+            _op_base* failed = nullptr;
+            {
+                std::unique_lock guard{ mutex_ };
+                _push_pending(op);
+                failed = _submit_pending();
+            }
+            cv_.notify_one(); // the reaper may be idle
+            _complete_failed(failed);
+            return;
+        }
+#endif
+        {
+            std::unique_lock guard{ mutex_ };
+            _push_pending(op);
+        }
+        cv_.notify_one();
+    }
+
+    void _push_pending(_op_base* op) noexcept {
+        op->next = nullptr;
+        if (pending_tail_ != nullptr) {
+            pending_tail_->next = op;
+        } else {
+            pending_head_ = op;
+        }
+        pending_tail_ = op;
+    }
+
+    _op_base* _pop_pending() noexcept {
+        auto* const op = pending_head_;
+        if (op != nullptr) {
+            pending_head_ = op->next;
+            if (pending_head_ == nullptr) {
+                pending_tail_ = nullptr;
+            }
+        }
+        return op;
+    }
+
+    /// Body of the thread of a blocking context.
+    void _serve() {
+        for (;;) {
+            _op_base* op = nullptr;
+            {
+                std::unique_lock guard{ mutex_ };
+                cv_.wait(guard, [this] {
+                    return pending_head_ != nullptr || stopping_;
+                });
+                op = _pop_pending();
+            }
+            if (op == nullptr) {
+                return;
+            }
+            op->complete(op, _perform(op));
+        }
+    }
+
+#if defined(ATOM_HAS_IO_URING)
+    static int _enter(
+        int fd, unsigned to_submit, unsigned min_complete,
+        unsigned flags) noexcept {
+        return static_cast<int>(::syscall(
+            __NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr,
+            0));
+    }
+
+    bool _setup_ring(unsigned entries) noexcept {
+        ::io_uring_params params{};
+        const auto fd =
+            static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false;
+        }
+
+        sq_size_ = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+        cq_size_ =
+            params.cq_off.cqes + (params.cq_entries * sizeof(::io_uring_cqe));
+        const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) {
+            sq_size_ = cq_size_ = (std::max)(sq_size_, cq_size_);
+        }
+
+        void* const sq = ::mmap(
+            nullptr, sq_size_, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        void* cq = sq;
+        if (sq != MAP_FAILED && !single) {
+            cq = ::mmap(
+                nullptr, cq_size_, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        }
+        void* sqes = MAP_FAILED;
+        if (sq != MAP_FAILED && cq != MAP_FAILED) {
+            sqes = ::mmap(
+                nullptr, params.sq_entries * sizeof(::io_uring_sqe),
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                IORING_OFF_SQES);
+        }
+        if (sqes == MAP_FAILED) {
+            if (cq != MAP_FAILED && cq != sq) {
+                ::munmap(cq, cq_size_);
+            }
+            if (sq != MAP_FAILED) {
+                ::munmap(sq, sq_size_);
+            }
+            ::close(fd);
+            return false;
+        }
+
+        auto* const sq_bytes = static_cast<std::byte*>(sq);
+        auto* const cq_bytes = static_cast<std::byte*>(cq);
+        // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+        sq_head_  = reinterpret_cast<unsigned*>(sq_bytes + params.sq_off.head);
+        sq_tail_  = reinterpret_cast<unsigned*>(sq_bytes + params.sq_off.tail);
+        sq_mask_  = *reinterpret_cast<unsigned*>(
+            sq_bytes + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq_bytes + params.sq_off.array);
+        cq_head_  = reinterpret_cast<unsigned*>(cq_bytes + params.cq_off.head);
+        cq_tail_  = reinterpret_cast<unsigned*>(cq_bytes + params.cq_off.tail);
+        cq_mask_  = *reinterpret_cast<unsigned*>(
+            cq_bytes + params.cq_off.ring_mask);
+        cqes_ =
+            reinterpret_cast<::io_uring_cqe*>(cq_bytes + params.cq_off.cqes);
+        // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+        sqes_       = static_cast<::io_uring_sqe*>(sqes);
+        sq_ring_    = sq;
+        cq_ring_    = cq;
+        sq_entries_ = params.sq_entries;
+        cq_entries_ = params.cq_entries;
+        ring_fd_    = fd;
+        return true;
+    }
+
+    void _teardown_ring() noexcept {
+        ::munmap(sqes_, sq_entries_ * sizeof(::io_uring_sqe));
+        if (cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_size_);
+        }
+        ::munmap(sq_ring_, sq_size_);
+        ::close(ring_fd_);
+    }
+
+    /// Free entries of the submission queue, requires `mutex_` held.
+    ATOM_NODISCARD unsigned _sq_space() const noexcept {
+        const unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(
+            std::memory_order_acquire);
+        return sq_entries_ - (*sq_tail_ - head);
+    }
+
+    /// Writes one entry behind the tail of the submission queue, requires
+    /// `mutex_` held and a free entry. The next `_flush` submits it.
+    void _push_entry(const ::io_uring_sqe& entry) noexcept {
+        assert(_sq_space() != 0);
+        const unsigned tail  = *sq_tail_;
+        const unsigned index = tail & sq_mask_;
+        sqes_[index]         = entry;
+        sq_array_[index]     = index;
+        std::atomic_ref<unsigned>(*sq_tail_).store(
+            tail + 1, std::memory_order_release);
+        ++unsubmitted_;
+    }
+
+    /// Submits the entries written since the last call, requires `mutex_`
+    /// held. On `EAGAIN` or `EBUSY` they stay queued and the reaper retries.
+    /// On other errors they are withdrawn from the ring, and their operations
+    /// are linked in front of `failed` with the error.
+    /// @return The operations to complete with `_complete_failed`.
+    _op_base* _flush(_op_base* failed) noexcept {
+        while (unsubmitted_ != 0) {
+            const int submitted = _enter(ring_fd_, unsubmitted_, 0, 0);
+            if (submitted > 0) {
+                unsubmitted_ -= static_cast<unsigned>(submitted);
+                submitted_ += static_cast<unsigned>(submitted);
+                continue;
+            }
+            if (submitted == 0 || errno == EAGAIN || errno == EBUSY) {
+                break;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+
+            // the kernel consumes entries only while entering, so the ones
+            // behind its head are still ours
+            const int error = errno;
+            unsigned tail   = *sq_tail_;
+            for (; unsubmitted_ != 0; --unsubmitted_) {
+                --tail;
+                auto* const op = reinterpret_cast<_op_base*>( // NOLINT
+                    static_cast<uintptr_t>(sqes_[tail & sq_mask_].user_data));
+                op->error = error;
+                op->next  = failed;
+                failed    = op;
+                --in_flight_;
+            }
+            std::atomic_ref<unsigned>(*sq_tail_).store(
+                tail, std::memory_order_release);
+        }
+        return failed;
+    }
+
+    /// Moves pending operations into the submission queue while both rings
+    /// have room, then submits them, requires `mutex_` held.
+    /// @return The operations to complete with `_complete_failed`.
+    _op_base* _submit_pending() noexcept {
+        _op_base* failed = nullptr;
+        while (pending_head_ != nullptr && in_flight_ < cq_entries_) {
+            if (_sq_space() == 0) {
+                failed = _flush(failed);
+                if (_sq_space() == 0) {
+                    break; // the kernel is busy, the reaper retries
+                }
+            }
+            _push_sqe(_pop_pending());
+        }
+        return _flush(failed);
+    }
+
+    /// Completes the operations refused by the kernel with their error,
+    /// without holding `mutex_`.
+    static void _complete_failed(_op_base* failed) noexcept {
+        while (failed != nullptr) {
+            auto* const op = std::exchange(failed, failed->next);
+            op->complete(op, -op->error);
+        }
+    }
+
+    void _push_sqe(_op_base* op) noexcept {
+        ::io_uring_sqe entry{};
+        entry.opcode    = op->write ? IORING_OP_WRITEV : IORING_OP_READV;
+        entry.fd        = op->fd;
+        entry.addr      = reinterpret_cast<uintptr_t>(&op->buffer); // NOLINT
+        entry.len       = 1;
+        entry.off       = op->offset;
+        entry.user_data = reinterpret_cast<uintptr_t>(op); // NOLINT
+        ++in_flight_;
+        _push_entry(entry);
+    }
+
+    /// Body of the thread of an io_uring context.
+    ///
+    /// It waits in the kernel only while it has accepted entries, so that a
+    /// completion is bound to come, and on `cv_` while the rings are empty.
+    void _reap() {
+        for (;;) {
+            bool in_kernel = false;
+            {
+                std::unique_lock guard{ mutex_ };
+                cv_.wait(guard, [this] {
+                    return submitted_ != 0 || unsubmitted_ != 0 || stopping_;
+                });
+                if (stopping_ && in_flight_ == 0) {
+                    return;
+                }
+                in_kernel = submitted_ != 0;
+            }
+            if (in_kernel) {
+                _enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+            } else {
+                // entries are queued, but the kernel had no room for them
+                // and has nothing in flight to wait for
+                std::this_thread::yield();
+            }
+
+            unsigned head = *cq_head_;
+            const unsigned tail =
+                std::atomic_ref<unsigned>(*cq_tail_).load(
+                    std::memory_order_acquire);
+            unsigned reaped = 0;
+            while (head != tail) {
+                const auto cqe = cqes_[head & cq_mask_];
+                ++head;
+                ++reaped;
+                std::atomic_ref<unsigned>(*cq_head_).store(
+                    head, std::memory_order_release);
+                auto* const op = reinterpret_cast<_op_base*>( // NOLINT
+                    static_cast<uintptr_t>(cqe.user_data));
+                op->complete(op, cqe.res);
+            }
+
+            _op_base* failed = nullptr;
+            {
+                std::unique_lock guard{ mutex_ };
+                in_flight_ -= reaped;
+                submitted_ -= reaped;
+                // also retries the entries left queued by EAGAIN or EBUSY
+                failed = _submit_pending();
+            }
+            _complete_failed(failed);
+        }
+    }
+
+    int ring_fd_ = -1;
+    void* sq_ring_{};
+    void* cq_ring_{};
+    size_t sq_size_{};
+    size_t cq_size_{};
+    unsigned* sq_head_{};
+    unsigned* sq_tail_{};
+    unsigned* sq_array_{};
+    unsigned sq_mask_{};
+    unsigned sq_entries_{};
+    unsigned* cq_head_{};
+    unsigned* cq_tail_{};
+    unsigned cq_mask_{};
+    unsigned cq_entries_{};
+    ::io_uring_sqe* sqes_{};
+    ::io_uring_cqe* cqes_{};
+    /// Operations in the rings, from their entry to their completion.
+    size_t in_flight_{};
+    /// Entries written but not yet accepted by the kernel.
+    unsigned unsubmitted_{};
+    /// Entries accepted by the kernel whose completion is not reaped yet.
+    unsigned submitted_{};
+#endif
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    _op_base* pending_head_{};
+    _op_base* pending_tail_{};
+    bool stopping_{};
+    std::thread thread_;
+};
+
+} // namespace neutron
+
+#endif
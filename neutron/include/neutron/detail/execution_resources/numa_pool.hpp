@@ -0,0 +1,496 @@
+// IWYU pragma: private, include <neutron/execution_resources.hpp>
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "neutron/detail/execution_resources/affinity_thread.hpp"
+#include "neutron/detail/execution_resources/task_queue.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/execution.hpp" // IWYU pragma: keep
+
+#if defined(__linux) || defined(__linux__)
+    #include <sched.h>
+#endif
+
+namespace neutron {
+
+/**
+ * @brief Query for the NUMA node an environment or a scheduler runs on.
+ *
+ * Answered by the schedulers of `numa_pool` and the attributes of their
+ * senders. Memory first touched on that node is local to it, so allocating
+ * and filling archetypes from work scheduled there keeps them node-local.
+ */
+struct get_numa_node_t {
+    template <typename Queryable>
+    constexpr uint32_t operator()(const Queryable& object) const noexcept
+    requires requires {
+        { object.query(*this) } noexcept -> std::convertible_to<uint32_t>;
+    }
+    {
+        return object.query(*this);
+    }
+
+    constexpr bool query(execution::forwarding_query_t) const noexcept {
+        return true;
+    }
+};
+
+inline constexpr get_numa_node_t get_numa_node{};
+
+/**
+ * @brief Cores of the machine grouped by NUMA node.
+ */
+struct numa_topology {
+    struct node {
+        uint32_t id;
+        std::vector<uint32_t> cores;
+    };
+
+    std::vector<node> nodes;
+
+    ATOM_NODISCARD size_t cores() const noexcept {
+        size_t count = 0;
+        for (const auto& node : nodes) {
+            count += node.cores.size();
+        }
+        return count;
+    }
+
+    /**
+     * @brief Reads the topology from /sys, limited to the cores the process
+     * may run on.
+     *
+     * Falls back to a single node holding every core where /sys is not
+     * available.
+     */
+    ATOM_NODISCARD static numa_topology discover() {
+        numa_topology topology;
+#if defined(__linux) || defined(__linux__)
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        const bool masked =
+            ::sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+        for (const auto id : _read_list("/sys/devices/system/node/online")) {
+            node current{ id, {} };
+            for (const auto core : _read_list(
+                     "/sys/devices/system/node/node" + std::to_string(id) +
+                     "/cpulist")) {
+                if (!masked ||
+                    (core < CPU_SETSIZE && CPU_ISSET(core, &allowed))) {
+                    current.cores.push_back(core);
+                }
+            }
+            if (!current.cores.empty()) { // memory-only nodes run nothing
+                topology.nodes.push_back(std::move(current));
+            }
+        }
+#endif
+        if (topology.nodes.empty()) {
+            const auto concurrency = std::thread::hardware_concurrency();
+            node only{ 0, {} };
+            for (uint32_t core = 0; core < std::max(concurrency, 1U); ++core) {
+                only.cores.push_back(core);
+            }
+            topology.nodes.push_back(std::move(only));
+        }
+        return topology;
+    }
+
+    /**
+     * @brief Parses a list in the format of /sys, like "0-3,8,10-11".
+     */
+    ATOM_NODISCARD static std::vector<uint32_t>
+        parse_list(const std::string& text) {
+        std::vector<uint32_t> result;
+        size_t index = 0;
+        const auto number = [&text, &index] {
+            uint32_t value = 0;
+            while (index < text.size() && text[index] >= '0' &&
+                   text[index] <= '9') {
+                value = (value * 10) +
+                        static_cast<uint32_t>(text[index] - '0');
+                ++index;
+            }
+            return value;
+        };
+        while (index < text.size()) {
+            if (text[index] < '0' || text[index] > '9') {
+                ++index;
+                continue;
+            }
+            const auto first = number();
+            auto last        = first;
+            if (index < text.size() && text[index] == '-') {
+                ++index;
+                last = number();
+            }
+            for (auto value = first; value <= last; ++value) {
+                result.push_back(value);
+            }
+        }
+        return result;
+    }
+
+private:
+    static std::vector<uint32_t> _read_list(const std::string& path) {
+        std::ifstream file{ path };
+        std::string text;
+        std::getline(file, text);
+        return parse_list(text);
+    }
+};
+
+/**
+ * @brief A thread pool with one pinned worker per core, aware of NUMA nodes.
+ *
+ * Every node owns a queue shared by its workers, holding the work bound to
+ * that node, which never runs elsewhere. Every worker also owns a queue,
+ * holding the unbound work started from it. An idle worker takes work from
+ * its own queue, then from its node, then from the other workers of its node,
+ * and only then steals unbound work from the workers of the other nodes, so
+ * work and the memory it touches stay on one node unless it is saturated.
+ *
+ * `get_scheduler(index)` binds work to a node. `get_scheduler()` starts
+ * unbound work on the calling worker, or binds it round-robin across the
+ * nodes when called from elsewhere. Pinning is best effort, a core the
+ * process may not run on still gets a worker, just an unpinned one.
+ * @warning The destructor runs the work queued so far before joining.
+ */
+class numa_pool {
+    using _task_base = _pool::_task_base;
+    using _queue     = _pool::_task_queue;
+
+    struct _worker {
+        _queue queue;
+        uint32_t node;
+        uint32_t core;
+        std::atomic<bool> pinned{ false };
+        std::thread thread;
+    };
+
+    struct _node {
+        _queue queue;
+        uint32_t id;
+        size_t first_worker;
+        size_t worker_count;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::atomic<uint32_t> sleeping{ 0 };
+        std::atomic<size_t> queued{ 0 };
+    };
+
+public:
+    static constexpr uint32_t any_node = std::numeric_limits<uint32_t>::max();
+
+    class scheduler;
+
+private:
+    template <typename Rcvr>
+    struct _opstate : _task_base {
+        using operation_state_concept = execution::operation_state_t;
+
+        numa_pool* pool;
+        uint32_t node;
+        ATOM_NO_UNIQUE_ADDR Rcvr rcvr;
+
+        template <typename R>
+        _opstate(numa_pool* pool, uint32_t node, R&& rcvr)
+            : _task_base{ nullptr, &_execute }, pool(pool), node(node),
+              rcvr(std::forward<R>(rcvr)) {}
+
+        void start() & noexcept { pool->_enqueue(this, node); }
+
+        static void _execute(_task_base* base) noexcept {
+            auto* const self = static_cast<_opstate*>(base);
+            if (execution::get_stop_token(execution::get_env(self->rcvr))
+                    .stop_requested()) {
+                execution::set_stopped(std::move(self->rcvr));
+            } else {
+                execution::set_value(std::move(self->rcvr));
+            }
+        }
+    };
+
+    struct _env {
+        numa_pool* pool;
+        uint32_t node;
+
+        template <typename Completion>
+        auto query(const execution::get_completion_scheduler_t<Completion>&)
+            const noexcept -> scheduler;
+
+        ATOM_NODISCARD uint32_t query(get_numa_node_t) const noexcept {
+            return pool->_node_id(node);
+        }
+    };
+
+    class _sender {
+    public:
+        using sender_concept = execution::sender_t;
+        using completion_signatures = execution::completion_signatures<
+            execution::set_value_t(), execution::set_stopped_t()>;
+
+        _sender(numa_pool* pool, uint32_t node) noexcept
+            : pool_(pool), node_(node) {}
+
+        ATOM_NODISCARD _env get_env() const noexcept {
+            return { pool_, node_ };
+        }
+
+        template <typename Rcvr>
+        auto connect(Rcvr&& rcvr) const
+            -> _opstate<std::remove_cvref_t<Rcvr>> {
+            return { pool_, node_, std::forward<Rcvr>(rcvr) };
+        }
+
+    private:
+        numa_pool* pool_;
+        uint32_t node_;
+    };
+
+public:
+    class scheduler {
+    public:
+        using scheduler_concept = execution::scheduler_t;
+
+        ATOM_NODISCARD _sender schedule() const noexcept {
+            return { pool_, node_ };
+        }
+
+        /**
+         * @brief The id of the node, or `any_node` if not bound to one.
+         */
+        ATOM_NODISCARD uint32_t query(get_numa_node_t) const noexcept {
+            return pool_->_node_id(node_);
+        }
+
+        bool operator==(const scheduler&) const noexcept = default;
+
+    private:
+        friend class numa_pool;
+        scheduler(numa_pool* pool, uint32_t node) noexcept
+            : pool_(pool), node_(node) {}
+
+        numa_pool* pool_;
+        uint32_t node_;
+    };
+
+    numa_pool() : numa_pool(numa_topology::discover()) {}
+
+    explicit numa_pool(const numa_topology& topology) {
+        nodes_.reserve(topology.nodes.size());
+        for (const auto& node : topology.nodes) {
+            auto& current = *nodes_.emplace_back(std::make_unique<_node>());
+            current.id           = node.id;
+            current.first_worker = workers_.size();
+            current.worker_count = node.cores.size();
+            for (const auto core : node.cores) {
+                auto& worker =
+                    *workers_.emplace_back(std::make_unique<_worker>());
+                worker.node = static_cast<uint32_t>(nodes_.size() - 1);
+                worker.core = core;
+            }
+        }
+        for (auto& worker : workers_) {
+            worker->thread = std::thread([this, &worker = *worker] {
+                worker.pinned.store(set_affinity(
+                    worker.core, nodes_[worker.node]->id, std::nothrow));
+                _work(worker);
+            });
+        }
+    }
+
+    numa_pool(const numa_pool&)            = delete;
+    numa_pool& operator=(const numa_pool&) = delete;
+    numa_pool(numa_pool&&)                 = delete;
+    numa_pool& operator=(numa_pool&&)      = delete;
+
+    ~numa_pool() {
+        stopping_.store(true);
+        for (auto& node : nodes_) {
+            std::unique_lock guard{ node->mutex };
+            node->cv.notify_all();
+        }
+        for (auto& worker : workers_) {
+            worker->thread.join();
+        }
+    }
+
+    /**
+     * @brief Schedules onto the node of the calling worker, or any node.
+     */
+    ATOM_NODISCARD scheduler get_scheduler() noexcept {
+        return { this, any_node };
+    }
+
+    /**
+     * @brief Schedules onto the `index`-th node, in the order of the topology.
+     */
+    ATOM_NODISCARD scheduler get_scheduler(size_t index) noexcept {
+        return { this, static_cast<uint32_t>(index) };
+    }
+
+    ATOM_NODISCARD size_t size() const noexcept { return workers_.size(); }
+
+    ATOM_NODISCARD size_t node_count() const noexcept { return nodes_.size(); }
+
+    /**
+     * @brief The id of the `index`-th node, as used by the operating system.
+     */
+    ATOM_NODISCARD uint32_t node_id(size_t index) const noexcept {
+        return nodes_[index]->id;
+    }
+
+    /**
+     * @brief Number of workers that could be pinned to their core.
+     */
+    ATOM_NODISCARD size_t pinned() const noexcept {
+        size_t count = 0;
+        for (const auto& worker : workers_) {
+            count += worker->pinned.load() ? 1 : 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief The node id of the calling thread if it is a worker of a
+     * `numa_pool`, `any_node` otherwise.
+     */
+    ATOM_NODISCARD static uint32_t current_node() noexcept {
+        const auto& current = _current();
+        return current.pool == nullptr
+                   ? any_node
+                   : current.pool->nodes_[current.worker->node]->id;
+    }
+
+private:
+    struct _current_worker {
+        numa_pool* pool = nullptr;
+        _worker* worker = nullptr;
+    };
+
+    static _current_worker& _current() noexcept {
+        thread_local _current_worker current;
+        return current;
+    }
+
+    ATOM_NODISCARD uint32_t _node_id(uint32_t index) const noexcept {
+        return index == any_node ? any_node : nodes_[index]->id;
+    }
+
+    void _enqueue(_task_base* task, uint32_t node) {
+        const auto& current = _current();
+        if (current.pool == this && node == any_node) {
+            current.worker->queue.push(task);
+            stealable_.fetch_add(1);
+            // prefer a sleeper of the node, any other would have to steal
+            const auto first = current.worker->node;
+            for (size_t i = 0; i < nodes_.size(); ++i) {
+                if (_wake(*nodes_[(first + i) % nodes_.size()])) {
+                    break;
+                }
+            }
+            return;
+        }
+        if (node == any_node) {
+            node = static_cast<uint32_t>(
+                next_node_.fetch_add(1, std::memory_order_relaxed) %
+                nodes_.size());
+        }
+        auto& target = *nodes_[node];
+        target.queue.push(task);
+        target.queued.fetch_add(1);
+        _wake(target);
+    }
+
+    static bool _wake(_node& node) {
+        if (node.sleeping.load() == 0) {
+            return false;
+        }
+        std::unique_lock guard{ node.mutex };
+        node.cv.notify_one();
+        return true;
+    }
+
+    _task_base* _find(_worker& self) {
+        if (auto* const task = self.queue.pop()) {
+            stealable_.fetch_sub(1);
+            return task;
+        }
+        if (auto& node = *nodes_[self.node]; node.queued.load() != 0) {
+            if (auto* const task = node.queue.pop()) {
+                node.queued.fetch_sub(1);
+                return task;
+            }
+        }
+        if (stealable_.load() == 0) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            auto& node = *nodes_[(self.node + i) % nodes_.size()];
+            for (size_t j = 0; j < node.worker_count; ++j) {
+                auto& victim = *workers_[node.first_worker + j];
+                if (&victim == &self) {
+                    continue;
+                }
+                if (auto* const task = victim.queue.pop()) {
+                    stealable_.fetch_sub(1);
+                    return task;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    void _work(_worker& self) {
+        _current() = { this, &self };
+        auto& node = *nodes_[self.node];
+        while (true) {
+            if (auto* const task = _find(self)) {
+                task->execute(task);
+                continue;
+            }
+            const auto idle = [this, &node] {
+                return node.queued.load() == 0 && stealable_.load() == 0;
+            };
+            std::unique_lock guard{ node.mutex };
+            node.sleeping.fetch_add(1);
+            node.cv.wait(
+                guard, [this, &idle] { return !idle() || stopping_.load(); });
+            node.sleeping.fetch_sub(1);
+            if (idle() && stopping_.load()) {
+                break;
+            }
+        }
+        _current() = {};
+    }
+
+    std::vector<std::unique_ptr<_node>> nodes_;
+    std::vector<std::unique_ptr<_worker>> workers_;
+    std::atomic<size_t> stealable_{ 0 };
+    std::atomic<size_t> next_node_{ 0 };
+    std::atomic<bool> stopping_{ false };
+};
+
+template <typename Completion>
+inline auto numa_pool::_env::query(
+    const execution::get_completion_scheduler_t<Completion>&) const noexcept
+    -> scheduler {
+    return { pool, node };
+}
+
+} // namespace neutron
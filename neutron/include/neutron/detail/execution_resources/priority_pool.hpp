@@ -0,0 +1,345 @@
+// IWYU pragma: private, include <neutron/execution_resources.hpp>
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "neutron/detail/execution_resources/task_queue.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/execution.hpp" // IWYU pragma: keep
+
+namespace neutron {
+
+/**
+ * @brief Query for the priority of a piece of work, the index of the lane it
+ * should be queued on, 0 being the most urgent.
+ *
+ * Answered by the schedulers of `priority_pool` and the attributes of their
+ * senders. A receiver environment answering it overrides the lane of the
+ * scheduler its work is scheduled on.
+ */
+struct get_priority_t {
+    template <typename Queryable>
+    constexpr auto operator()(const Queryable& object) const noexcept
+    requires requires {
+        { object.query(*this) } noexcept;
+    }
+    {
+        return object.query(*this);
+    }
+
+    constexpr bool query(execution::forwarding_query_t) const noexcept {
+        return true;
+    }
+};
+
+inline constexpr get_priority_t get_priority{};
+
+/**
+ * @brief How a lane of a `priority_pool` competes with the others.
+ *
+ * A strict lane is served whenever it has work, before the lanes after it
+ * and before every weighted lane. Weighted lanes share what strict lanes
+ * leave in proportion to their weight, so bulk work still makes progress.
+ */
+struct priority_lane {
+    uint32_t weight = 0; ///< 0 for a strict lane.
+
+    ATOM_NODISCARD static constexpr priority_lane strict() noexcept {
+        return { 0 };
+    }
+
+    ATOM_NODISCARD static constexpr priority_lane
+        weighted(uint32_t weight) noexcept {
+        return { weight != 0 ? weight : 1 };
+    }
+
+    ATOM_NODISCARD constexpr bool is_strict() const noexcept {
+        return weight == 0;
+    }
+};
+
+/**
+ * @brief A fixed-size thread pool with one queue per priority lane.
+ *
+ * Latency-critical work, such as input, network or render preparation
+ * systems, is scheduled on a strict lane and never waits behind bulk work
+ * queued on a weighted one; it only waits for a worker to finish what it is
+ * running. The lanes are given most urgent first, by default one strict lane
+ * followed by two weighted lanes of weight 4 and 1.
+ *
+ * `get_scheduler(priority)` schedules on a lane, `get_scheduler()` on the
+ * last one. `with_priority` rebinds a scheduler to another lane, and
+ * `get_priority` on the receiver environment overrides the lane at connect
+ * time. A priority past the last lane means the last lane.
+ * @warning The destructor runs the work queued so far before joining.
+ */
+class priority_pool {
+    using _task_base = _pool::_task_base;
+
+    struct _lane {
+        priority_lane policy;
+        uint32_t credit  = 0;
+        _task_base* head = nullptr;
+        _task_base* tail = nullptr;
+        size_t size      = 0;
+
+        void push(_task_base* task) noexcept {
+            task->next = nullptr;
+            if (tail != nullptr) {
+                tail->next = task;
+            } else {
+                head = task;
+            }
+            tail = task;
+            ++size;
+        }
+
+        _task_base* pop() noexcept {
+            auto* const task = head;
+            head             = task->next;
+            if (head == nullptr) {
+                tail = nullptr;
+            }
+            --size;
+            return task;
+        }
+    };
+
+public:
+    class scheduler;
+
+private:
+    template <typename Rcvr>
+    struct _opstate : _task_base {
+        using operation_state_concept = execution::operation_state_t;
+
+        priority_pool* pool;
+        size_t priority;
+        ATOM_NO_UNIQUE_ADDR Rcvr rcvr;
+
+        template <typename R>
+        _opstate(priority_pool* pool, size_t priority, R&& rcvr)
+            : _task_base{ nullptr, &_execute }, pool(pool),
+              priority(priority), rcvr(std::forward<R>(rcvr)) {
+            if constexpr (requires(const Rcvr& receiver) {
+                              get_priority(execution::get_env(receiver));
+                          }) {
+                this->priority = static_cast<size_t>(
+                    get_priority(execution::get_env(this->rcvr)));
+            }
+        }
+
+        void start() & noexcept { pool->_enqueue(this, priority); }
+
+        static void _execute(_task_base* base) noexcept {
+            auto* const self = static_cast<_opstate*>(base);
+            if (execution::get_stop_token(execution::get_env(self->rcvr))
+                    .stop_requested()) {
+                execution::set_stopped(std::move(self->rcvr));
+            } else {
+                execution::set_value(std::move(self->rcvr));
+            }
+        }
+    };
+
+    struct _env {
+        priority_pool* pool;
+        size_t priority;
+
+        template <typename Completion>
+        auto query(const execution::get_completion_scheduler_t<Completion>&)
+            const noexcept -> scheduler {
+            return scheduler{ pool, priority };
+        }
+
+        ATOM_NODISCARD size_t query(get_priority_t) const noexcept {
+            return priority;
+        }
+    };
+
+    class _sender {
+    public:
+        using sender_concept = execution::sender_t;
+        using completion_signatures = execution::completion_signatures<
+            execution::set_value_t(), execution::set_stopped_t()>;
+
+        _sender(priority_pool* pool, size_t priority) noexcept
+            : pool_(pool), priority_(priority) {}
+
+        ATOM_NODISCARD _env get_env() const noexcept {
+            return { pool_, priority_ };
+        }
+
+        template <typename Rcvr>
+        auto connect(Rcvr&& rcvr) const -> _opstate<std::remove_cvref_t<Rcvr>> {
+            return { pool_, priority_, std::forward<Rcvr>(rcvr) };
+        }
+
+    private:
+        priority_pool* pool_;
+        size_t priority_;
+    };
+
+public:
+    class scheduler {
+    public:
+        using scheduler_concept = execution::scheduler_t;
+
+        ATOM_NODISCARD _sender schedule() const noexcept {
+            return { pool_, priority_ };
+        }
+
+        /**
+         * @brief The same pool, scheduling on the lane `priority`.
+         */
+        ATOM_NODISCARD scheduler with_priority(size_t priority) const noexcept {
+            return scheduler{ pool_, priority };
+        }
+
+        ATOM_NODISCARD size_t query(get_priority_t) const noexcept {
+            return priority_;
+        }
+
+        bool operator==(const scheduler&) const noexcept = default;
+
+    private:
+        friend class priority_pool;
+        scheduler(priority_pool* pool, size_t priority) noexcept
+            : pool_(pool), priority_(priority) {}
+
+        priority_pool* pool_;
+        size_t priority_;
+    };
+
+    explicit priority_pool(
+        size_t count = std::thread::hardware_concurrency(),
+        std::initializer_list<priority_lane> lanes = {
+            priority_lane::strict(), priority_lane::weighted(4),
+            priority_lane::weighted(1) }) {
+        lanes_.reserve(std::max<size_t>(lanes.size(), 1));
+        for (const auto& lane : lanes) {
+            lanes_.push_back({ lane, lane.weight });
+        }
+        if (lanes_.empty()) {
+            lanes_.push_back({ priority_lane::strict() });
+        }
+
+        count = count != 0 ? count : 1;
+        threads_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            threads_.emplace_back([this] { _work(); });
+        }
+    }
+
+    priority_pool(const priority_pool&)            = delete;
+    priority_pool& operator=(const priority_pool&) = delete;
+    priority_pool(priority_pool&&)                 = delete;
+    priority_pool& operator=(priority_pool&&)      = delete;
+
+    ~priority_pool() {
+        {
+            std::unique_lock guard{ mutex_ };
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    ATOM_NODISCARD scheduler get_scheduler(size_t priority) noexcept {
+        return scheduler{ this, priority };
+    }
+
+    /**
+     * @brief A scheduler on the least urgent lane.
+     */
+    ATOM_NODISCARD scheduler get_scheduler() noexcept {
+        return scheduler{ this, lanes_.size() - 1 };
+    }
+
+    ATOM_NODISCARD size_t size() const noexcept { return threads_.size(); }
+
+    ATOM_NODISCARD size_t lane_count() const noexcept { return lanes_.size(); }
+
+    /**
+     * @brief Number of operations waiting on the lane `priority`.
+     */
+    ATOM_NODISCARD size_t pending(size_t priority) {
+        std::unique_lock guard{ mutex_ };
+        return lanes_[_clamp(priority)].size;
+    }
+
+private:
+    ATOM_NODISCARD size_t _clamp(size_t priority) const noexcept {
+        return std::min(priority, lanes_.size() - 1);
+    }
+
+    void _enqueue(_task_base* task, size_t priority) {
+        {
+            std::unique_lock guard{ mutex_ };
+            lanes_[_clamp(priority)].push(task);
+        }
+        cv_.notify_one();
+    }
+
+    _task_base* _pop() noexcept {
+        for (auto& lane : lanes_) {
+            if (lane.policy.is_strict() && lane.size != 0) {
+                return lane.pop();
+            }
+        }
+
+        // weighted round robin, credits refilled once every lane with work
+        // has spent its own
+        const size_t count = lanes_.size();
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t i = 0; i < count; ++i) {
+                const size_t index = (cursor_ + i) % count;
+                auto& lane         = lanes_[index];
+                if (lane.policy.is_strict() || lane.size == 0 ||
+                    lane.credit == 0) {
+                    continue;
+                }
+                cursor_ = --lane.credit == 0 ? (index + 1) % count : index;
+                return lane.pop();
+            }
+            for (auto& lane : lanes_) {
+                lane.credit = lane.policy.weight;
+            }
+        }
+        return nullptr;
+    }
+
+    void _work() {
+        std::unique_lock guard{ mutex_ };
+        while (true) {
+            if (auto* const task = _pop()) {
+                guard.unlock();
+                task->execute(task);
+                guard.lock();
+                continue;
+            }
+            if (stopping_) {
+                break;
+            }
+            cv_.wait(guard);
+        }
+    }
+
+    std::vector<_lane> lanes_;
+    size_t cursor_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace neutron
@@ -0,0 +1,357 @@
+// IWYU pragma: private, include <neutron/execution_resources.hpp>
+#pragma once
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "neutron/detail/execution_resources/task_queue.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/execution.hpp" // IWYU pragma: keep
+
+namespace neutron {
+
+/**
+ * @brief Query for the context of the worker thread calling it.
+ *
+ * Answered by the schedulers of `static_context_thread_pool` and the
+ * attributes of their senders with a pointer to the context of the calling
+ * worker, or `nullptr` when not called on a worker of that pool.
+ */
+struct get_thread_context_t {
+    template <typename Queryable>
+    constexpr auto operator()(const Queryable& object) const noexcept
+    requires requires {
+        { object.query(*this) } noexcept;
+    }
+    {
+        return object.query(*this);
+    }
+
+    constexpr bool query(execution::forwarding_query_t) const noexcept {
+        return true;
+    }
+};
+
+inline constexpr get_thread_context_t get_thread_context{};
+
+/**
+ * @brief A fixed-size thread pool whose every worker owns a `Ctx`.
+ *
+ * The contexts hold per-thread state such as scratch arenas, command buffers,
+ * random engines or profiler lanes, so the work needs neither locks nor
+ * thread-indexed vectors to reach it. Each one is constructed on its worker
+ * thread, so the memory it allocates up front is first touched there; the
+ * constructor of the pool returns once all of them are built, and rethrows
+ * the exception of a failed one.
+ *
+ * `schedule()` completes with no value, `schedule_with_context()` with the
+ * `Ctx&` of the worker running it. The context is also reachable through
+ * `get_thread_context`, on the scheduler or the attributes of its senders.
+ *
+ * Work started from a worker stays in the queue of that worker, work from
+ * elsewhere goes to a queue shared by the pool. Idle workers take from their
+ * own queue, then the shared one, then steal from the others.
+ * @warning The destructor runs the work queued so far before joining.
+ */
+template <typename Ctx>
+class static_context_thread_pool {
+    using _task_base = _pool::_task_base;
+    using _queue     = _pool::_task_queue;
+
+    struct alignas(std::hardware_destructive_interference_size) _worker {
+        _queue queue;
+        std::unique_ptr<Ctx> context;
+        std::thread thread;
+    };
+
+public:
+    using context_type = Ctx;
+
+    class scheduler;
+
+private:
+    template <typename Rcvr, bool WithContext>
+    struct _opstate : _task_base {
+        using operation_state_concept = execution::operation_state_t;
+
+        static_context_thread_pool* pool;
+        ATOM_NO_UNIQUE_ADDR Rcvr rcvr;
+
+        template <typename R>
+        _opstate(static_context_thread_pool* pool, R&& rcvr)
+            : _task_base{ nullptr, &_execute }, pool(pool),
+              rcvr(std::forward<R>(rcvr)) {}
+
+        void start() & noexcept { pool->_enqueue(this); }
+
+        static void _execute(_task_base* base) noexcept {
+            auto* const self = static_cast<_opstate*>(base);
+            if (execution::get_stop_token(execution::get_env(self->rcvr))
+                    .stop_requested()) {
+                execution::set_stopped(std::move(self->rcvr));
+            } else if constexpr (WithContext) {
+                execution::set_value(
+                    std::move(self->rcvr), *self->pool->current_context());
+            } else {
+                execution::set_value(std::move(self->rcvr));
+            }
+        }
+    };
+
+    struct _env {
+        static_context_thread_pool* pool;
+
+        template <typename Completion>
+        auto query(const execution::get_completion_scheduler_t<Completion>&)
+            const noexcept -> scheduler {
+            return scheduler{ pool };
+        }
+
+        ATOM_NODISCARD Ctx* query(get_thread_context_t) const noexcept {
+            return pool->current_context();
+        }
+    };
+
+    template <bool WithContext>
+    class _sender {
+    public:
+        using sender_concept = execution::sender_t;
+        using completion_signatures = execution::completion_signatures<
+            std::conditional_t<
+                WithContext, execution::set_value_t(Ctx&),
+                execution::set_value_t()>,
+            execution::set_stopped_t()>;
+
+        explicit _sender(static_context_thread_pool* pool) noexcept
+            : pool_(pool) {}
+
+        ATOM_NODISCARD _env get_env() const noexcept { return { pool_ }; }
+
+        template <typename Rcvr>
+        auto connect(Rcvr&& rcvr) const
+            -> _opstate<std::remove_cvref_t<Rcvr>, WithContext> {
+            return { pool_, std::forward<Rcvr>(rcvr) };
+        }
+
+    private:
+        static_context_thread_pool* pool_;
+    };
+
+public:
+    class scheduler {
+    public:
+        using scheduler_concept = execution::scheduler_t;
+
+        ATOM_NODISCARD _sender<false> schedule() const noexcept {
+            return _sender<false>{ pool_ };
+        }
+
+        ATOM_NODISCARD _sender<true> schedule_with_context() const noexcept {
+            return _sender<true>{ pool_ };
+        }
+
+        ATOM_NODISCARD Ctx* query(get_thread_context_t) const noexcept {
+            return pool_->current_context();
+        }
+
+        bool operator==(const scheduler&) const noexcept = default;
+
+    private:
+        friend class static_context_thread_pool;
+        explicit scheduler(static_context_thread_pool* pool) noexcept
+            : pool_(pool) {}
+
+        static_context_thread_pool* pool_;
+    };
+
+    /**
+     * @brief Starts `count` workers, each with a default constructed `Ctx`.
+     */
+    explicit static_context_thread_pool(
+        size_t count = std::thread::hardware_concurrency())
+    requires std::default_initializable<Ctx>
+        : static_context_thread_pool(count, [](size_t) { return Ctx{}; }) {}
+
+    /**
+     * @brief Starts `count` workers, the `i`-th one with the context returned
+     * by `factory(i)` on its own thread.
+     */
+    template <typename Factory>
+    requires std::is_invocable_r_v<Ctx, Factory&, size_t>
+    static_context_thread_pool(size_t count, Factory factory) {
+        count = count != 0 ? count : 1;
+        workers_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            workers_.emplace_back(std::make_unique<_worker>());
+        }
+
+        std::latch built{ static_cast<std::ptrdiff_t>(count) };
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        for (size_t i = 0; i < count; ++i) {
+            workers_[i]->thread = std::thread([&, i, &worker = *workers_[i]] {
+                ATOM_TRY {
+                    worker.context =
+                        std::unique_ptr<Ctx>(new Ctx(std::invoke(factory, i)));
+                }
+                ATOM_CATCH(...) {
+                    std::unique_lock guard{ error_mutex };
+                    error = std::current_exception();
+                }
+                const bool built_context = worker.context != nullptr;
+                built.count_down(); // the locals above die after this
+                if (built_context) {
+                    _work(worker);
+                }
+            });
+        }
+        built.wait();
+        if (error) {
+            _stop();
+            std::rethrow_exception(error);
+        }
+    }
+
+    static_context_thread_pool(const static_context_thread_pool&) = delete;
+    static_context_thread_pool&
+        operator=(const static_context_thread_pool&)             = delete;
+    static_context_thread_pool(static_context_thread_pool&&)      = delete;
+    static_context_thread_pool&
+        operator=(static_context_thread_pool&&)                  = delete;
+
+    ~static_context_thread_pool() { _stop(); }
+
+    ATOM_NODISCARD scheduler get_scheduler() noexcept {
+        return scheduler{ this };
+    }
+
+    ATOM_NODISCARD size_t size() const noexcept { return workers_.size(); }
+
+    /**
+     * @brief The context of the `index`-th worker.
+     * @warning Only safe to use while no work runs on that worker, for
+     * example to gather what the contexts collected once the pool is idle.
+     */
+    ATOM_NODISCARD Ctx& context(size_t index) noexcept {
+        return *workers_[index]->context;
+    }
+
+    /**
+     * @brief The context of the calling worker, `nullptr` when not called
+     * from a worker of this pool.
+     */
+    ATOM_NODISCARD Ctx* current_context() const noexcept {
+        const auto& current = _current();
+        return current.pool == this ? current.worker->context.get() : nullptr;
+    }
+
+    /**
+     * @brief Invokes `fn(Ctx&)` on the context of every worker, on the
+     * calling thread.
+     * @warning Same requirement as `context`.
+     */
+    template <typename Fn>
+    void for_each_context(Fn&& fn) {
+        for (auto& worker : workers_) {
+            std::invoke(fn, *worker->context);
+        }
+    }
+
+private:
+    struct _current_worker {
+        const static_context_thread_pool* pool = nullptr;
+        _worker* worker                        = nullptr;
+    };
+
+    static _current_worker& _current() noexcept {
+        thread_local _current_worker current;
+        return current;
+    }
+
+    void _enqueue(_task_base* task) {
+        const auto& current = _current();
+        if (current.pool == this) {
+            current.worker->queue.push(task);
+        } else {
+            shared_.push(task);
+        }
+        queued_.fetch_add(1);
+        if (sleeping_.load() != 0) {
+            std::unique_lock guard{ mutex_ };
+            cv_.notify_one();
+        }
+    }
+
+    _task_base* _find(_worker& self) {
+        if (auto* const task = self.queue.pop()) {
+            return task;
+        }
+        if (auto* const task = shared_.pop()) {
+            return task;
+        }
+        for (auto& victim : workers_) {
+            if (victim.get() == &self) {
+                continue;
+            }
+            if (auto* const task = victim->queue.pop()) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    void _work(_worker& self) {
+        _current() = { this, &self };
+        while (true) {
+            if (auto* const task = _find(self)) {
+                queued_.fetch_sub(1);
+                task->execute(task);
+                continue;
+            }
+            std::unique_lock guard{ mutex_ };
+            sleeping_.fetch_add(1);
+            cv_.wait(guard, [this] {
+                return queued_.load() != 0 || stopping_.load();
+            });
+            sleeping_.fetch_sub(1);
+            if (queued_.load() == 0 && stopping_.load()) {
+                break;
+            }
+        }
+        _current() = {};
+    }
+
+    void _stop() {
+        {
+            std::unique_lock guard{ mutex_ };
+            stopping_.store(true);
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<_worker>> workers_;
+    _queue shared_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<size_t> queued_{ 0 };
+    std::atomic<uint32_t> sleeping_{ 0 };
+    std::atomic<bool> stopping_{ false };
+};
+
+} // namespace neutron
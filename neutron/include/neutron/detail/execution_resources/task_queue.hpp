@@ -0,0 +1,49 @@
+// IWYU pragma: private, include <neutron/execution_resources.hpp>
+#pragma once
+#include <mutex>
+
+namespace neutron {
+
+/*! @cond TURN_OFF_DOXYGEN */
+namespace _pool {
+
+/// Intrusive node of the operation states queued on a thread pool.
+struct _task_base {
+    _task_base* next                      = nullptr;
+    void (*execute)(_task_base*) noexcept = nullptr;
+};
+
+/// FIFO of intrusive tasks guarded by a mutex, shared by owner and thieves.
+struct _task_queue {
+    std::mutex mutex;
+    _task_base* head = nullptr;
+    _task_base* tail = nullptr;
+
+    void push(_task_base* task) {
+        std::unique_lock guard{ mutex };
+        task->next = nullptr;
+        if (tail != nullptr) {
+            tail->next = task;
+        } else {
+            head = task;
+        }
+        tail = task;
+    }
+
+    _task_base* pop() {
+        std::unique_lock guard{ mutex };
+        auto* const task = head;
+        if (task != nullptr) {
+            head = task->next;
+            if (head == nullptr) {
+                tail = nullptr;
+            }
+        }
+        return task;
+    }
+};
+
+} // namespace _pool
+/*! @endcond */
+
+} // namespace neutron
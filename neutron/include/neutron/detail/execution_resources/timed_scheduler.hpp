@@ -0,0 +1,597 @@
+// IWYU pragma: private, include <neutron/execution_resources.hpp>
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "neutron/detail/execution/inplace_stop_callback.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/execution.hpp" // IWYU pragma: keep
+
+namespace neutron {
+
+/*! @cond TURN_OFF_DOXYGEN */
+namespace _timed_scheduler {
+
+struct _link {
+    _link* next = this;
+    _link* prev = this;
+
+    ATOM_NODISCARD bool empty() const noexcept { return next == this; }
+
+    void push_back(_link* node) noexcept {
+        node->prev = prev;
+        node->next = this;
+        prev->next = node;
+        prev       = node;
+    }
+
+    static void unlink(_link* node) noexcept {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node->next = node->prev = node;
+    }
+};
+
+enum class _state : uint8_t {
+    idle,
+    pending, // linked into a slot of the wheel
+    ready,   // linked into the ready list
+    done     // handed to the driver for completion
+};
+
+struct _timer_base : _link {
+    void (*complete)(_timer_base*) noexcept = nullptr;
+    uint64_t expiry                         = 0;
+    uint16_t slot                           = 0;
+    _state state                            = _state::idle;
+    bool cancelled                          = false;
+};
+
+template <typename Token, typename Fn>
+concept _stoppable_token = requires {
+    typename stop_callback_for_t<Token, Fn>;
+} && !std::is_void_v<stop_callback_for_t<Token, Fn>>;
+
+} // namespace _timed_scheduler
+/*! @endcond */
+
+/**
+ * @brief An execution resource completing senders at points in time.
+ *
+ * Timers are kept in a hierarchical timing wheel of `levels` levels with
+ * `slots` slots each, `tick` wide at the bottom level. Inserting a timer,
+ * cancelling it and expiring it are O(1) regardless of how many are pending;
+ * a timer further away than the top level covers is parked in its farthest
+ * slot and re-inserted when that slot cascades. A timer never fires before its
+ * deadline, and at most one tick after it once the driver is awake.
+ *
+ * A timer stops early, completing with `set_stopped`, when stop is requested
+ * on the stop token of its receiver, for example an `inplace_stop_token`.
+ *
+ * The wheel is advanced by a thread owned by the context, which sleeps until
+ * the next slot holding timers. By default it also completes the expired
+ * timers. Constructed from a `run_loop`, the completions are instead posted to
+ * the loop and run by whichever thread runs it.
+ * @warning Pending timers complete with `set_stopped` when the context is
+ * destroyed. When driven by a `run_loop`, destroy the context only after the
+ * loop ran the work posted to it.
+ */
+class timed_scheduler {
+    using _link       = _timed_scheduler::_link;
+    using _timer_base = _timed_scheduler::_timer_base;
+    using _state      = _timed_scheduler::_state;
+
+public:
+    using clock_type = std::chrono::steady_clock;
+    using time_point = clock_type::time_point;
+    using duration   = clock_type::duration;
+
+    static constexpr uint32_t slot_bits = 8;
+    static constexpr uint32_t slots     = 1U << slot_bits;
+    static constexpr uint32_t levels    = 4;
+
+    class scheduler;
+
+private:
+    struct _on_stop {
+        timed_scheduler* context;
+        _timer_base* timer;
+        void operator()() noexcept { context->_cancel(timer); }
+    };
+
+    template <typename Rcvr>
+    struct _opstate : _timer_base {
+        using operation_state_concept = execution::operation_state_t;
+        using _token = std::remove_cvref_t<decltype(execution::get_stop_token(
+            std::declval<execution::env_of_t<Rcvr>>()))>;
+        static constexpr bool _stoppable =
+            _timed_scheduler::_stoppable_token<_token, _on_stop>;
+        using _callback = decltype([] {
+            if constexpr (_stoppable) {
+                return std::optional<stop_callback_for_t<_token, _on_stop>>{};
+            } else {
+                return std::optional<int>{};
+            }
+        }());
+
+        timed_scheduler* context;
+        time_point deadline;
+        ATOM_NO_UNIQUE_ADDR Rcvr rcvr;
+        _callback on_stop;
+
+        template <typename R>
+        _opstate(timed_scheduler* context, time_point deadline, R&& rcvr)
+            : context(context), deadline(deadline),
+              rcvr(std::forward<R>(rcvr)) {
+            this->complete = &_complete;
+        }
+
+        // not started yet, so there are no links to carry over
+        _opstate(_opstate&& that) noexcept(
+            std::is_nothrow_move_constructible_v<Rcvr>)
+            : context(that.context), deadline(that.deadline),
+              rcvr(std::move(that.rcvr)) {
+            this->complete = &_complete;
+        }
+
+        void start() & noexcept {
+            if constexpr (_stoppable) {
+                auto token =
+                    execution::get_stop_token(execution::get_env(rcvr));
+                if (token.stop_requested()) {
+                    execution::set_stopped(std::move(rcvr));
+                    return;
+                }
+                on_stop.emplace(token, _on_stop{ context, this });
+            }
+            context->_insert(this, deadline);
+        }
+
+        static void _complete(_timer_base* base) noexcept {
+            auto* const self = static_cast<_opstate*>(base);
+            if constexpr (_stoppable) {
+                self->on_stop.reset();
+                self->cancelled |=
+                    execution::get_stop_token(execution::get_env(self->rcvr))
+                        .stop_requested();
+            }
+            if (self->cancelled) {
+                execution::set_stopped(std::move(self->rcvr));
+            } else {
+                execution::set_value(std::move(self->rcvr));
+            }
+        }
+    };
+
+    struct _env {
+        timed_scheduler* context;
+
+        template <typename Completion>
+        auto query(const execution::get_completion_scheduler_t<Completion>&)
+            const noexcept -> scheduler;
+    };
+
+    class _sender {
+    public:
+        using sender_concept = execution::sender_t;
+        using completion_signatures = execution::completion_signatures<
+            execution::set_value_t(), execution::set_stopped_t()>;
+
+        _sender(timed_scheduler* context, time_point deadline) noexcept
+            : context_(context), deadline_(deadline) {}
+
+        ATOM_NODISCARD _env get_env() const noexcept { return { context_ }; }
+
+        template <typename Rcvr>
+        auto connect(Rcvr&& rcvr) const
+            -> _opstate<std::remove_cvref_t<Rcvr>> {
+            return { context_, deadline_, std::forward<Rcvr>(rcvr) };
+        }
+
+    private:
+        timed_scheduler* context_;
+        time_point deadline_;
+    };
+
+    struct _drain_receiver {
+        using receiver_concept = execution::receiver_t;
+        timed_scheduler* context;
+        void set_value() && noexcept { _complete(context); }
+        void set_error(std::exception_ptr) && noexcept { _complete(context); }
+        void set_stopped() && noexcept { _complete(context); }
+
+    private:
+        // `context` is copied out first: the operation state holding this
+        // receiver may be replaced as soon as the drain is marked done
+        static void _complete(timed_scheduler* context) noexcept {
+            context->_drain();
+            context->_drain_done();
+        }
+        ATOM_NODISCARD execution::empty_env get_env() const noexcept {
+            return {};
+        }
+    };
+
+    using _loop_scheduler =
+        decltype(std::declval<execution::run_loop&>().get_scheduler());
+    using _drain_opstate = decltype(execution::connect(
+        execution::schedule(std::declval<_loop_scheduler>()),
+        std::declval<_drain_receiver>()));
+
+public:
+    /**
+     * @brief A scheduler of the context, additionally able to schedule at a
+     * time point or after a duration.
+     */
+    class scheduler {
+    public:
+        using scheduler_concept = execution::scheduler_t;
+
+        ATOM_NODISCARD _sender schedule() const noexcept {
+            return { context_, time_point{} };
+        }
+
+        ATOM_NODISCARD _sender schedule_at(time_point deadline) const noexcept {
+            return { context_, deadline };
+        }
+
+        ATOM_NODISCARD _sender
+            schedule_after(duration delay) const noexcept {
+            return { context_, clock_type::now() + delay };
+        }
+
+        ATOM_NODISCARD static time_point now() noexcept {
+            return clock_type::now();
+        }
+
+        bool operator==(const scheduler&) const noexcept = default;
+
+    private:
+        friend class timed_scheduler;
+        explicit scheduler(timed_scheduler* context) noexcept
+            : context_(context) {}
+
+        timed_scheduler* context_;
+    };
+
+    /**
+     * @brief Constructs a context completing the timers on its own thread.
+     * @param tick Resolution of the wheel.
+     */
+    explicit timed_scheduler(duration tick = std::chrono::milliseconds(1))
+        : tick_(tick), origin_(clock_type::now()),
+          thread_([this] { _run(); }) {}
+
+    /**
+     * @brief Constructs a context completing the timers on `loop`.
+     * @param tick Resolution of the wheel.
+     */
+    explicit timed_scheduler(
+        execution::run_loop& loop,
+        duration tick = std::chrono::milliseconds(1))
+        : tick_(tick), origin_(clock_type::now()), loop_(&loop),
+          thread_([this] { _run(); }) {}
+
+    timed_scheduler(const timed_scheduler&)            = delete;
+    timed_scheduler& operator=(const timed_scheduler&) = delete;
+    timed_scheduler(timed_scheduler&&)                 = delete;
+    timed_scheduler& operator=(timed_scheduler&&)      = delete;
+
+    ~timed_scheduler() {
+        {
+            std::unique_lock guard{ mutex_ };
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+
+        // whatever is left never fires
+        std::unique_lock guard{ mutex_ };
+        for (auto& slot : wheel_) {
+            while (!slot.empty()) {
+                auto* const timer = static_cast<_timer_base*>(slot.next);
+                _link::unlink(timer);
+                timer->cancelled = true;
+                timer->state     = _state::ready;
+                ready_.push_back(timer);
+            }
+        }
+        pending_ = 0;
+        _complete_ready(guard);
+    }
+
+    ATOM_NODISCARD scheduler get_scheduler() noexcept {
+        return scheduler{ this };
+    }
+
+    /**
+     * @brief Sender completing once `deadline` has passed.
+     */
+    ATOM_NODISCARD _sender schedule_at(time_point deadline) noexcept {
+        return { this, deadline };
+    }
+
+    /**
+     * @brief Sender completing once `delay` has elapsed since this call.
+     */
+    ATOM_NODISCARD _sender schedule_after(duration delay) noexcept {
+        return { this, clock_type::now() + delay };
+    }
+
+    ATOM_NODISCARD static time_point now() noexcept {
+        return clock_type::now();
+    }
+
+    ATOM_NODISCARD duration tick() const noexcept { return tick_; }
+
+    /**
+     * @brief Number of timers waiting in the wheel.
+     */
+    ATOM_NODISCARD size_t pending() const {
+        std::unique_lock guard{ mutex_ };
+        return pending_;
+    }
+
+private:
+    static constexpr uint64_t _slot_mask = slots - 1;
+
+    ATOM_NODISCARD uint64_t _tick_of(time_point point) const noexcept {
+        if (point <= origin_) {
+            return 0;
+        }
+        // rounds up, a timer never fires early
+        return static_cast<uint64_t>(
+            (point - origin_ + tick_ - duration{ 1 }) / tick_);
+    }
+
+    ATOM_NODISCARD uint64_t _current_tick() const noexcept {
+        return static_cast<uint64_t>((clock_type::now() - origin_) / tick_);
+    }
+
+    void _insert(_timer_base* timer, time_point deadline) {
+        std::unique_lock guard{ mutex_ };
+        if (timer->cancelled) { // stop requested while starting
+            timer->state = _state::ready;
+            ready_.push_back(timer);
+            cv_.notify_one();
+            return;
+        }
+        const bool idle = pending_ == 0;
+        if (idle) { // nothing to cascade, skip the ticks slept through
+            now_ = std::max(now_, _current_tick());
+        }
+        timer->expiry       = _tick_of(deadline);
+        const auto earliest = _next_tick();
+        _place(timer);
+        if (idle || timer->state == _state::ready ||
+            timer->expiry < earliest) {
+            cv_.notify_one(); // the driver would sleep past it
+        }
+    }
+
+    void _place(_timer_base* timer) noexcept {
+        const auto expiry = timer->expiry;
+        if (expiry <= now_) {
+            timer->state = _state::ready;
+            ready_.push_back(timer);
+            return;
+        }
+        // the level is the highest digit in which expiry differs from now
+        const auto highest = std::bit_width(expiry ^ now_) - 1;
+        auto level         = static_cast<uint32_t>(highest) / slot_bits;
+        uint64_t slot{};
+        if (level < levels) {
+            slot = (expiry >> (level * slot_bits)) & _slot_mask;
+        } else { // beyond the wheel, parked in its farthest slot
+            level = levels - 1;
+            slot  = ((now_ >> (level * slot_bits)) - 1) & _slot_mask;
+        }
+        timer->slot  = static_cast<uint16_t>((level * slots) + slot);
+        timer->state = _state::pending;
+        wheel_[timer->slot].push_back(timer);
+        occupied_[timer->slot / 64] |= uint64_t{ 1 } << (timer->slot % 64);
+        ++pending_;
+    }
+
+    void _unplace(_timer_base* timer) noexcept {
+        _link::unlink(timer);
+        if (wheel_[timer->slot].empty()) {
+            occupied_[timer->slot / 64] &=
+                ~(uint64_t{ 1 } << (timer->slot % 64));
+        }
+        --pending_;
+    }
+
+    void _cancel(_timer_base* timer) noexcept {
+        std::unique_lock guard{ mutex_ };
+        switch (timer->state) {
+        case _state::idle:
+            timer->cancelled = true; // _insert completes it
+            break;
+        case _state::pending:
+            _unplace(timer);
+            timer->cancelled = true;
+            timer->state     = _state::ready;
+            ready_.push_back(timer);
+            cv_.notify_one();
+            break;
+        default: // expired already
+            break;
+        }
+    }
+
+    /// The next tick holding timers at the bottom level, or the next tick
+    /// cascading the levels above.
+    ATOM_NODISCARD uint64_t _next_tick() const noexcept {
+        const auto base  = now_ & ~_slot_mask;
+        const auto index = (now_ & _slot_mask) + 1;
+        for (auto word = index / 64; word < slots / 64; ++word) {
+            auto bits = occupied_[word];
+            if (word == index / 64) {
+                bits &= index % 64 == 0 ? ~uint64_t{}
+                                        : ~uint64_t{} << (index % 64);
+            }
+            if (bits != 0) {
+                return base + (word * 64) + std::countr_zero(bits);
+            }
+        }
+        return base + slots;
+    }
+
+    void _cascade(uint32_t level) {
+        const auto index =
+            static_cast<uint16_t>((level * slots) +
+                                  ((now_ >> (level * slot_bits)) & _slot_mask));
+        auto& slot = wheel_[index];
+        if (slot.empty()) {
+            return;
+        }
+        _link moved;
+        while (!slot.empty()) {
+            auto* const node = slot.next;
+            _link::unlink(node);
+            moved.push_back(node);
+        }
+        occupied_[index / 64] &= ~(uint64_t{ 1 } << (index % 64));
+        while (!moved.empty()) {
+            auto* const timer = static_cast<_timer_base*>(moved.next);
+            _link::unlink(timer);
+            --pending_;
+            _place(timer);
+        }
+    }
+
+    /// Advances the wheel up to `target`, moving the expired timers to the
+    /// ready list.
+    void _advance(uint64_t target) {
+        while (now_ < target) {
+            if (pending_ == 0) {
+                now_ = target;
+                return;
+            }
+            const auto next = _next_tick();
+            if (next > target) {
+                now_ = target;
+                return;
+            }
+            now_ = next;
+            if ((now_ & _slot_mask) == 0) {
+                for (uint32_t level = 1; level < levels; ++level) {
+                    _cascade(level);
+                    if (((now_ >> (level * slot_bits)) & _slot_mask) != 0) {
+                        break;
+                    }
+                }
+            }
+            const auto index = static_cast<uint16_t>(now_ & _slot_mask);
+            auto& slot       = wheel_[index];
+            while (!slot.empty()) {
+                auto* const timer = static_cast<_timer_base*>(slot.next);
+                _link::unlink(timer);
+                --pending_;
+                timer->state = _state::ready;
+                ready_.push_back(timer);
+            }
+            occupied_[index / 64] &= ~(uint64_t{ 1 } << (index % 64));
+        }
+    }
+
+    /// Completes the ready timers, unlocking while doing so.
+    void _complete_ready(std::unique_lock<std::mutex>& guard) {
+        while (!ready_.empty()) {
+            _link batch;
+            while (!ready_.empty()) {
+                auto* const node = ready_.next;
+                _link::unlink(node);
+                static_cast<_timer_base*>(node)->state = _state::done;
+                batch.push_back(node);
+            }
+            guard.unlock();
+            while (!batch.empty()) {
+                auto* const timer = static_cast<_timer_base*>(batch.next);
+                _link::unlink(timer);
+                timer->complete(timer);
+            }
+            guard.lock();
+        }
+    }
+
+    void _run() {
+        std::unique_lock guard{ mutex_ };
+        while (!stopping_) {
+            _advance(_current_tick());
+            if (!ready_.empty()) {
+                if (loop_ == nullptr) {
+                    _complete_ready(guard);
+                    continue;
+                }
+                // the previous drain operation must have completed before
+                // its state is replaced
+                if (!drain_in_flight_) {
+                    drain_in_flight_ = true;
+                    drain_.emplace(execution::connect(
+                        execution::schedule(loop_->get_scheduler()),
+                        _drain_receiver{ this }));
+                    execution::start(*drain_);
+                }
+            }
+            if (pending_ == 0) {
+                cv_.wait(guard);
+            } else {
+                const auto wake = origin_ + (_next_tick() * tick_);
+                cv_.wait_until(guard, wake);
+            }
+        }
+    }
+
+    /// Runs on the loop, completing what the driver found ready.
+    void _drain() {
+        std::unique_lock guard{ mutex_ };
+        _complete_ready(guard);
+    }
+
+    /// The last step of a drain operation, which is not touched afterwards.
+    void _drain_done() noexcept {
+        {
+            std::unique_lock guard{ mutex_ };
+            drain_in_flight_ = false;
+        }
+        // timers that became ready while draining get another drain
+        cv_.notify_one();
+    }
+
+    duration tick_;
+    time_point origin_;
+    uint64_t now_ = 0;
+    size_t pending_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::array<_link, slots * levels> wheel_;
+    std::array<uint64_t, slots * levels / 64> occupied_{};
+    _link ready_;
+    execution::run_loop* loop_ = nullptr;
+    std::optional<_drain_opstate> drain_;
+    bool drain_in_flight_ = false;
+    bool stopping_        = false;
+    std::thread thread_;
+};
+
+template <typename Completion>
+inline auto timed_scheduler::_env::query(
+    const execution::get_completion_scheduler_t<Completion>&) const noexcept
+    -> scheduler {
+    return scheduler{ context };
+}
+
+} // namespace neutron
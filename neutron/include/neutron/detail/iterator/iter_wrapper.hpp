@@ -39,25 +39,23 @@ public:
         return *this;
     }
     constexpr _iter_wrapper operator++(int) noexcept {
-        auto iter = iter_;
-        return _iter_wrapper{ ++iter };
+        return _iter_wrapper{ iter_++ };
     }
     constexpr _iter_wrapper& operator--() noexcept {
         --iter_;
         return *this;
     }
     constexpr _iter_wrapper operator--(int) noexcept {
-        auto iter = iter_;
-        return _iter_wrapper{ --iter };
+        return _iter_wrapper{ iter_-- };
     }
-    constexpr _iter_wrapper operator+(difference_type n) noexcept {
+    constexpr _iter_wrapper operator+(difference_type n) const noexcept {
         return _iter_wrapper{ iter_ + n };
     }
     constexpr _iter_wrapper& operator+=(difference_type n) noexcept {
         iter_ += n;
         return *this;
     }
-    constexpr _iter_wrapper operator-(difference_type n) noexcept {
+    constexpr _iter_wrapper operator-(difference_type n) const noexcept {
         return _iter_wrapper{ iter_ - n };
     }
     constexpr _iter_wrapper& operator-=(difference_type n) noexcept {
@@ -65,6 +63,15 @@ public:
         return *this;
     }
 
+    constexpr reference operator[](difference_type n) const noexcept {
+        return iter_[n];
+    }
+
+    friend constexpr _iter_wrapper
+        operator+(difference_type n, const _iter_wrapper& iter) noexcept {
+        return iter + n;
+    }
+
     constexpr iterator_type base() const noexcept { return iter_; }
 
 private:
@@ -105,6 +112,13 @@ constexpr std::strong_ordering operator<=>(
     }
 }
 
+template <typename It1, typename It2>
+constexpr auto operator-(
+    const _iter_wrapper<It1>& lhs, const _iter_wrapper<It2>& rhs) noexcept
+    -> decltype(lhs.base() - rhs.base()) {
+    return lhs.base() - rhs.base();
+}
+
 template <typename It>
 constexpr bool operator!=(
     const _iter_wrapper<It>& lhs, const _iter_wrapper<It>& rhs) noexcept {
@@ -59,6 +59,18 @@
     #define ATOM_NO_UNIQUE_ADDR [[no_unique_address]]
 #endif
 
+// Prefetch for reading, into every cache level
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define ATOM_PREFETCH(address) __builtin_prefetch((address), 0, 3)
+#elif defined(_MSC_VER) && defined(ATOM_TARGET_X86)
+    #define ATOM_PREFETCH(address)                                             \
+        _mm_prefetch(                                                          \
+            reinterpret_cast<const char*>(address), _MM_HINT_T0) // NOLINT
+#else
+    #define ATOM_PREFETCH(address) static_cast<void>(address)
+#endif
+
 // Debug/Release configuration
 
 #if defined(_DEBUG)
@@ -227,5 +239,5 @@
 #else
     #define ATOM_TRY
     #define ATOM_CATCH(...) if (false)
-    #define ATOM_RETHROE
+    #define ATOM_RETHROW
 #endif
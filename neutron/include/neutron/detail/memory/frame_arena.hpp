@@ -0,0 +1,248 @@
+// IWYU pragma: private, include <neutron/memory.hpp>
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include "neutron/detail/macros.hpp"
+
+namespace neutron {
+
+/**
+ * @brief Bump arena for memory living no longer than a frame.
+ *
+ * Allocating moves a cursor through the current block, deallocating does
+ * nothing unless it releases the last allocation, which is rewound so a
+ * scratch vector growing in place reuses its bytes. `reset()` releases
+ * everything at once. When a frame needed more than one block, they are
+ * replaced by a single one as large as all of them on reset, so a steady
+ * workload settles on one block and never reaches `operator new` again.
+ * @warning Not thread-safe, every thread or system needs its own arena.
+ */
+class frame_arena {
+public:
+    static constexpr size_t default_block_size = size_t{ 64 } * 1024;
+
+    explicit frame_arena(size_t block_size = default_block_size) noexcept
+        : block_size_(std::max(block_size, sizeof(std::max_align_t))) {}
+
+    frame_arena(frame_arena&& that) noexcept
+        : block_size_(that.block_size_),
+          head_(std::exchange(that.head_, nullptr)),
+          current_(std::exchange(that.current_, nullptr)),
+          cursor_(std::exchange(that.cursor_, nullptr)),
+          end_(std::exchange(that.end_, nullptr)) {}
+
+    frame_arena& operator=(frame_arena&& that) noexcept {
+        if (this != &that) [[likely]] {
+            _release(std::exchange(head_, nullptr));
+            block_size_ = that.block_size_;
+            head_       = std::exchange(that.head_, nullptr);
+            current_    = std::exchange(that.current_, nullptr);
+            cursor_     = std::exchange(that.cursor_, nullptr);
+            end_        = std::exchange(that.end_, nullptr);
+        }
+        return *this;
+    }
+
+    frame_arena(const frame_arena&)            = delete;
+    frame_arena& operator=(const frame_arena&) = delete;
+
+    ~frame_arena() noexcept { _release(head_); }
+
+    /**
+     * @throw std::bad_alloc If a block could not be allocated.
+     */
+    ATOM_NODISCARD void* allocate(
+        size_t size, size_t align = alignof(std::max_align_t)) {
+        if (auto* const pointer = _bump(size, align)) [[likely]] {
+            return pointer;
+        }
+        return _allocate_slow(size, align);
+    }
+
+    /**
+     * @brief Rewinds the arena if `pointer` is its last allocation, does
+     * nothing otherwise.
+     */
+    void deallocate(void* pointer, size_t size) noexcept {
+        if (static_cast<std::byte*>(pointer) + size == cursor_) {
+            cursor_ = static_cast<std::byte*>(pointer);
+        }
+    }
+
+    /**
+     * @brief Releases every allocation, keeping the memory for the next frame.
+     */
+    void reset() noexcept {
+        if (head_ == nullptr) {
+            return;
+        }
+        if (head_->next != nullptr) {
+            const auto total = capacity();
+            if (auto* const block = _new_block(total, std::nothrow)) {
+                _release(head_);
+                head_ = block;
+            }
+        }
+        current_ = head_;
+        cursor_  = head_->data();
+        end_     = cursor_ + head_->size;
+    }
+
+    /**
+     * @brief Number of bytes handed out since the last reset, padding and
+     * the unused tails of the blocks left behind included.
+     */
+    ATOM_NODISCARD size_t used() const noexcept {
+        size_t bytes = 0;
+        for (auto* block = head_; block != current_; block = block->next) {
+            bytes += block->size;
+        }
+        return current_ == nullptr
+                   ? 0
+                   : bytes + static_cast<size_t>(cursor_ - current_->data());
+    }
+
+    /**
+     * @brief Number of bytes in the blocks owned by the arena.
+     */
+    ATOM_NODISCARD size_t capacity() const noexcept {
+        size_t bytes = 0;
+        for (auto* block = head_; block != nullptr; block = block->next) {
+            bytes += block->size;
+        }
+        return bytes;
+    }
+
+private:
+    struct alignas(std::max_align_t) _block {
+        _block* next;
+        size_t size;
+
+        ATOM_NODISCARD std::byte* data() noexcept {
+            return reinterpret_cast<std::byte*>(this + 1); // NOLINT
+        }
+    };
+
+    static _block* _new_block(size_t size) {
+        auto* const memory = ::operator new(
+            sizeof(_block) + size,
+            static_cast<std::align_val_t>(alignof(_block)));
+        return ::new (memory) _block{ nullptr, size };
+    }
+
+    static _block* _new_block(size_t size, std::nothrow_t) noexcept {
+        auto* const memory = ::operator new(
+            sizeof(_block) + size,
+            static_cast<std::align_val_t>(alignof(_block)), std::nothrow);
+        return memory == nullptr ? nullptr
+                                 : ::new (memory) _block{ nullptr, size };
+    }
+
+    static void _release(_block* block) noexcept {
+        while (block != nullptr) {
+            auto* const next = block->next;
+            ::operator delete(
+                block, static_cast<std::align_val_t>(alignof(_block)));
+            block = next;
+        }
+    }
+
+    std::byte* _bump(size_t size, size_t align) noexcept {
+        const auto address = reinterpret_cast<uintptr_t>(cursor_); // NOLINT
+        const auto padding = (align - (address & (align - 1))) & (align - 1);
+        if (cursor_ == nullptr ||
+            padding + size > static_cast<size_t>(end_ - cursor_)) {
+            return nullptr;
+        }
+        auto* const pointer = cursor_ + padding;
+        cursor_             = pointer + size;
+        return pointer;
+    }
+
+    void* _allocate_slow(size_t size, size_t align) {
+        if (size > std::numeric_limits<size_t>::max() / 2) [[unlikely]] {
+            throw std::bad_alloc{};
+        }
+        // blocks kept from an earlier frame come first
+        while (current_ != nullptr && current_->next != nullptr) {
+            _enter(current_->next);
+            if (auto* const pointer = _bump(size, align)) {
+                return pointer;
+            }
+        }
+        const auto last = current_ != nullptr ? current_->size : 0;
+        auto* const block =
+            _new_block(std::max({ block_size_, last * 2, size + align }));
+        if (current_ != nullptr) {
+            current_->next = block;
+        } else {
+            head_ = block;
+        }
+        _enter(block);
+        return _bump(size, align);
+    }
+
+    void _enter(_block* block) noexcept {
+        current_ = block;
+        cursor_  = block->data();
+        end_     = cursor_ + block->size;
+    }
+
+    size_t block_size_;
+    _block* head_      = nullptr;
+    _block* current_   = nullptr;
+    std::byte* cursor_ = nullptr;
+    std::byte* end_    = nullptr;
+};
+
+/**
+ * @brief Allocator drawing from a `frame_arena`; freeing is free.
+ *
+ * Systems receive one as a parameter, backed by an arena the world rewinds at
+ * the end of each `call_update`, so their scratch `smvec` or `std::vector`
+ * must not outlive the frame. Allocators are equal when they share an arena.
+ */
+template <typename Ty>
+class arena_allocator {
+    template <typename>
+    friend class arena_allocator;
+
+public:
+    using value_type = Ty;
+
+    constexpr explicit arena_allocator(frame_arena& arena) noexcept
+        : arena_(&arena) {}
+
+    template <typename Other>
+    constexpr arena_allocator(const arena_allocator<Other>& that) noexcept
+        : arena_(that.arena_) {}
+
+    ATOM_NODISCARD Ty* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(Ty)) [[unlikely]] {
+            throw std::bad_array_new_length{};
+        }
+        return static_cast<Ty*>(arena_->allocate(n * sizeof(Ty), alignof(Ty)));
+    }
+
+    void deallocate(Ty* pointer, size_t n) noexcept {
+        arena_->deallocate(pointer, n * sizeof(Ty));
+    }
+
+    ATOM_NODISCARD frame_arena& arena() const noexcept { return *arena_; }
+
+    template <typename Other>
+    constexpr bool
+        operator==(const arena_allocator<Other>& that) const noexcept {
+        return arena_ == that.arena_;
+    }
+
+private:
+    frame_arena* arena_;
+};
+
+} // namespace neutron
@@ -0,0 +1,175 @@
+// IWYU pragma: private, include <neutron/memory.hpp>
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "neutron/detail/macros.hpp"
+
+namespace neutron {
+
+/**
+ * @brief Thread-local cache of short-lived blocks, bucketed by size class.
+ *
+ * Designed for coroutine frames: blocks up to `max_size` bytes are rounded up
+ * to a multiple of `granularity` and recycled through a free list of the
+ * calling thread, so spawning tasks in a loop stops hitting the global
+ * `operator new`. Larger blocks go to `operator new` directly. A block could
+ * be released on a thread other than the one allocating it, it is simply
+ * cached there. Each list keeps at most `max_cached` blocks, the rest are
+ * returned to `operator delete`.
+ */
+class frame_pool {
+public:
+    static constexpr size_t granularity = 64;
+    static constexpr size_t max_size    = 1024;
+    static constexpr size_t max_cached  = 256;
+    static constexpr size_t classes     = max_size / granularity;
+
+    frame_pool() noexcept = default;
+    frame_pool(const frame_pool&)            = delete;
+    frame_pool& operator=(const frame_pool&) = delete;
+
+    ~frame_pool() noexcept {
+        for (size_t i = 0; i < classes; ++i) {
+            while (heads_[i] != nullptr) {
+                ::operator delete(std::exchange(heads_[i], heads_[i]->next));
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the pool of the calling thread.
+     * @warning It must not be called once the pool has been destroyed while
+     * the thread is torn down, e.g. from the destructor of another
+     * `thread_local`. `allocate_local` and `deallocate_local` could be.
+     */
+    ATOM_NODISCARD static frame_pool& local() noexcept {
+        auto* const pool = _try_local();
+        assert(pool != nullptr && "frame_pool: used after thread teardown");
+        return *pool;
+    }
+
+    /**
+     * @brief Allocates from the pool of the calling thread, or from
+     * `operator new` once it has been destroyed.
+     */
+    ATOM_NODISCARD static void* allocate_local(size_t size) {
+        auto* const pool = _try_local();
+        return pool != nullptr ? pool->allocate(size) : ::operator new(size);
+    }
+
+    /**
+     * @brief Releases to the pool of the calling thread, or to
+     * `operator delete` once it has been destroyed.
+     */
+    static void deallocate_local(void* pointer, size_t size) noexcept {
+        if (auto* const pool = _try_local(); pool != nullptr) [[likely]] {
+            pool->deallocate(pointer, size);
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+
+    ATOM_NODISCARD void* allocate(size_t size) {
+        if (size > max_size) [[unlikely]] {
+            return ::operator new(size);
+        }
+        const auto index = _class_of(size);
+        if (auto* const block = heads_[index]; block != nullptr) [[likely]] {
+            heads_[index] = block->next;
+            --counts_[index];
+            return block;
+        }
+        return ::operator new((index + 1) * granularity);
+    }
+
+    void deallocate(void* pointer, size_t size) noexcept {
+        if (size > max_size) [[unlikely]] {
+            ::operator delete(pointer);
+            return;
+        }
+        const auto index = _class_of(size);
+        if (counts_[index] == max_cached) [[unlikely]] {
+            ::operator delete(pointer);
+            return;
+        }
+        auto* const block = ::new (pointer) _block{ heads_[index] };
+        heads_[index]     = block;
+        ++counts_[index];
+    }
+
+    /**
+     * @brief Number of blocks cached for the size class of `size`.
+     */
+    ATOM_NODISCARD size_t cached(size_t size) const noexcept {
+        return size > max_size ? 0 : counts_[_class_of(size)];
+    }
+
+private:
+    struct _block {
+        _block* next;
+    };
+
+    /// Trivially destructible, so that it could still be read after the
+    /// destructors of the other `thread_local`s of the thread have run.
+    ATOM_NODISCARD static bool& _destroyed() noexcept {
+        thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    /// The pool of the calling thread, `nullptr` once it has been destroyed.
+    ATOM_NODISCARD static frame_pool* _try_local() noexcept {
+        struct _owner {
+            frame_pool pool;
+            ~_owner() noexcept { _destroyed() = true; }
+        };
+
+        if (_destroyed()) [[unlikely]] {
+            return nullptr;
+        }
+        thread_local _owner owner;
+        return &owner.pool;
+    }
+
+    ATOM_NODISCARD static constexpr size_t _class_of(size_t size) noexcept {
+        return size == 0 ? 0 : (size - 1) / granularity;
+    }
+
+    std::array<_block*, classes> heads_{};
+    std::array<size_t, classes> counts_{};
+};
+
+/**
+ * @brief Stateless allocator drawing from the `frame_pool` of the calling
+ * thread, which could be used during thread teardown as well.
+ */
+template <typename Ty>
+class frame_allocator {
+public:
+    using value_type = Ty;
+
+    constexpr frame_allocator() noexcept = default;
+
+    template <typename Other>
+    constexpr frame_allocator(const frame_allocator<Other>&) noexcept {}
+
+    ATOM_NODISCARD Ty* allocate(size_t n) {
+        static_assert(
+            alignof(Ty) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+            "over-aligned types are not supported");
+        return static_cast<Ty*>(frame_pool::allocate_local(n * sizeof(Ty)));
+    }
+
+    void deallocate(Ty* pointer, size_t n) noexcept {
+        frame_pool::deallocate_local(pointer, n * sizeof(Ty));
+    }
+
+    template <typename Other>
+    constexpr bool operator==(const frame_allocator<Other>&) const noexcept {
+        return true;
+    }
+};
+
+} // namespace neutron
@@ -0,0 +1,402 @@
+// IWYU pragma: private, include <neutron/polymorphic.hpp>
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <memory_resource> // IWYU pragma: keep
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "neutron/detail/concepts/allocator.hpp"
+#include "neutron/detail/concepts/trivially_relocatable.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/detail/member_function_traits.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
+#include "neutron/detail/memory/uninitialized_move_if_noexcept.hpp"
+#include "neutron/detail/utility/exception_guard.hpp"
+#include "neutron/metafn.hpp"
+#include "./concepts.hpp"
+
+namespace neutron {
+
+/*! @cond TURN_OFF_DOXYGEN */
+namespace _poly_vector {
+
+/// `void(*)(void* first, size_t count, Args...)` for a method of the
+/// interface taking `Args...`.
+template <
+    typename Method,
+    typename = typename member_function_traits<Method>::args_type>
+struct _batch_fn;
+
+template <typename Method, typename... Args>
+struct _batch_fn<Method, type_list<Args...>> {
+    using type = void (*)(void* first, size_t count, Args... args);
+};
+
+template <typename Impl, auto Method, typename Args>
+struct _batch;
+
+template <typename Impl, auto Method, typename... Args>
+struct _batch<Impl, Method, type_list<Args...>> {
+    static void run(void* first, size_t count, Args... args) {
+        auto* const objects = static_cast<Impl*>(first);
+        for (size_t i = 0; i < count; ++i) {
+            std::invoke(Method, objects[i], args...);
+        }
+    }
+};
+
+template <poly_object Object>
+struct _table {
+    using interface = typename Object::template interface<
+        internal::poly_empty_impl>;
+    using methods   = typename Object::template impl<interface>;
+
+    template <auto... Methods>
+    static auto _deduce(value_list<Methods...>)
+        -> std::tuple<typename _batch_fn<decltype(Methods)>::type...>;
+
+    using type = decltype(_deduce(methods{}));
+
+    template <typename Impl, auto... Methods, auto... Interface>
+    static consteval type
+        make(value_list<Methods...>, value_list<Interface...>) noexcept {
+        return type{ &_batch<
+            Impl, Methods,
+            typename member_function_traits<
+                decltype(Interface)>::args_type>::run... };
+    }
+
+    template <typename Impl>
+    static consteval type make() noexcept {
+        return make<Impl>(typename Object::template impl<Impl>{}, methods{});
+    }
+};
+
+} // namespace _poly_vector
+/*! @endcond */
+
+/**
+ * @class poly_vector
+ * @brief A sequence of implementations of `Object` grouped by concrete type.
+ *
+ * Every type has a bucket storing its objects contiguously, the buckets being
+ * sorted by the address of the operations of their type, which is unique
+ * where hashes of type names might collide. `for_each<Index>` calls the method
+ * `Index` of the interface with one indirect call per bucket, the loop over
+ * the objects of a bucket calling the implementation directly, where a
+ * vector of `poly` loads a vtable and calls through it for every object.
+ * Objects could be erased, which moves the last object of their bucket into
+ * their place, so that the order is only kept among objects of a type.
+ * @code
+ * poly_vector<Behaviour> behaviours;
+ * behaviours.push_back(Patrol{});
+ * behaviours.push_back(Chase{});
+ * behaviours.for_each<0>(delta); // behaviour.update(delta) for all of them
+ * @endcode
+ * @tparam Object Polymorphic object type defining the interface.
+ * @tparam Alloc Allocator of the buckets, rebound to each type.
+ */
+template <
+    poly_object Object, std_simple_allocator Alloc = std::allocator<std::byte>>
+class poly_vector {
+    template <typename Ty>
+    using _allocator_t = rebind_alloc_t<Alloc, Ty>;
+
+    using _batch_table = typename _poly_vector::_table<Object>::type;
+
+public:
+    using object_type    = Object;
+    using size_type      = size_t;
+    using allocator_type = Alloc;
+
+private:
+    struct _bucket_ops {
+        void (*destroy)(void* first, size_type count) noexcept;
+        void (*deallocate)(
+            const allocator_type& alloc, void* first,
+            size_type capacity) noexcept;
+        _batch_table batch;
+    };
+
+    struct _bucket {
+        const _bucket_ops* ops;
+        void* data;
+        size_type size;
+        size_type capacity;
+    };
+
+    template <typename Impl>
+    static constexpr _bucket_ops _ops_of{
+        .destroy = [](void* first, size_type count) noexcept {
+            std::destroy_n(static_cast<Impl*>(first), count);
+        },
+        .deallocate =
+            [](const allocator_type& alloc, void* first,
+               size_type capacity) noexcept {
+                _allocator_t<Impl> al{ alloc };
+                std::allocator_traits<_allocator_t<Impl>>::deallocate(
+                    al, static_cast<Impl*>(first), capacity);
+            },
+        .batch = _poly_vector::_table<Object>::template make<Impl>()
+    };
+
+public:
+    template <typename Al = Alloc>
+    explicit poly_vector(const Al& alloc = Alloc{}) : buckets_(alloc) {}
+
+    poly_vector(poly_vector&& that) noexcept
+        : buckets_(std::move(that.buckets_)),
+          size_(std::exchange(that.size_, 0)) {
+        that.buckets_.clear();
+    }
+
+    poly_vector& operator=(poly_vector&& that) noexcept {
+        if (this != &that) [[likely]] {
+            _release();
+            buckets_ = std::move(that.buckets_);
+            size_    = std::exchange(that.size_, 0);
+            that.buckets_.clear();
+        }
+        return *this;
+    }
+
+    poly_vector(const poly_vector&)            = delete;
+    poly_vector& operator=(const poly_vector&) = delete;
+
+    ~poly_vector() noexcept { _release(); }
+
+    /**
+     * @brief Constructs an `Impl` at the end of its bucket.
+     * @return The new object.
+     */
+    template <poly_impl<Object> Impl, typename... Args>
+    requires std::constructible_from<Impl, Args...>
+    Impl& emplace(Args&&... args) {
+        _bucket& bucket = _assure<Impl>();
+        auto* const first = static_cast<Impl*>(bucket.data);
+        Impl* object      = nullptr;
+        if (bucket.size != bucket.capacity) [[likely]] {
+            object = ::new (first + bucket.size)
+                Impl(std::forward<Args>(args)...);
+        } else {
+            object = _emplace_grow<Impl>(bucket, std::forward<Args>(args)...);
+        }
+        ++bucket.size;
+        ++size_;
+        return *object;
+    }
+
+    template <typename Impl>
+    requires poly_impl<std::remove_cvref_t<Impl>, Object>
+    std::remove_cvref_t<Impl>& push_back(Impl&& impl) {
+        return emplace<std::remove_cvref_t<Impl>>(std::forward<Impl>(impl));
+    }
+
+    /**
+     * @brief Calls the method `Index` of the interface on every object, type
+     * by type.
+     *
+     * `args` are passed to every call as lvalues.
+     */
+    template <size_t Index, typename... Args>
+    void for_each(Args&&... args) {
+        for (const _bucket& bucket : buckets_) {
+            if (bucket.size != 0) {
+                std::get<Index>(bucket.ops->batch)(
+                    bucket.data, bucket.size, args...);
+            }
+        }
+    }
+
+    /**
+     * @brief The objects of type `Impl`, in the order they were added unless
+     * some of them have been erased.
+     */
+    template <poly_impl<Object> Impl>
+    ATOM_NODISCARD std::span<Impl> get() noexcept {
+        const auto* const bucket = _find(&_ops_of<Impl>);
+        return bucket != nullptr
+                   ? std::span<Impl>{ static_cast<Impl*>(bucket->data),
+                                      bucket->size }
+                   : std::span<Impl>{};
+    }
+
+    template <poly_impl<Object> Impl>
+    ATOM_NODISCARD std::span<const Impl> get() const noexcept {
+        return const_cast<poly_vector*>(this)->template get<Impl>(); // NOLINT
+    }
+
+    /**
+     * @brief Erases the object of type `Impl` at `index` in its bucket,
+     * moving the last one of the bucket into its place.
+     */
+    template <poly_impl<Object> Impl>
+    void erase(size_type index) {
+        auto objects = get<Impl>();
+        assert(index < objects.size());
+        if (index != objects.size() - 1) {
+            objects[index] = std::move(objects.back());
+        }
+        std::destroy_at(&objects.back());
+        --_find(&_ops_of<Impl>)->size;
+        --size_;
+    }
+
+    /**
+     * @brief Makes room for `n` objects of type `Impl`.
+     */
+    template <poly_impl<Object> Impl>
+    void reserve(size_type n) {
+        _bucket& bucket = _assure<Impl>();
+        if (n > bucket.capacity) {
+            _reallocate<Impl>(bucket, n);
+        }
+    }
+
+    ATOM_NODISCARD size_type size() const noexcept { return size_; }
+
+    template <poly_impl<Object> Impl>
+    ATOM_NODISCARD size_type size() const noexcept {
+        return get<Impl>().size();
+    }
+
+    ATOM_NODISCARD bool empty() const noexcept { return size_ == 0; }
+
+    /**
+     * @brief Number of types having a bucket, empty ones included.
+     */
+    ATOM_NODISCARD size_type type_count() const noexcept {
+        return buckets_.size();
+    }
+
+    /**
+     * @brief Destroys every object, keeping the buckets and their memory.
+     */
+    void clear() noexcept {
+        for (_bucket& bucket : buckets_) {
+            bucket.ops->destroy(bucket.data, bucket.size);
+            bucket.size = 0;
+        }
+        size_ = 0;
+    }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return allocator_type(buckets_.get_allocator());
+    }
+
+private:
+    ATOM_NODISCARD _bucket* _find(const _bucket_ops* ops) noexcept {
+        auto iter = std::ranges::lower_bound(
+            buckets_, ops, std::less<>{}, &_bucket::ops);
+        return iter != buckets_.end() && iter->ops == ops ? &*iter : nullptr;
+    }
+
+    template <typename Impl>
+    _bucket& _assure() {
+        const auto* const ops = &_ops_of<Impl>;
+        auto iter             = std::ranges::lower_bound(
+            buckets_, ops, std::less<>{}, &_bucket::ops);
+        if (iter == buckets_.end() || iter->ops != ops) [[unlikely]] {
+            iter = buckets_.insert(
+                iter, _bucket{ .ops      = ops,
+                               .data     = nullptr,
+                               .size     = 0,
+                               .capacity = 0 });
+        }
+        return *iter;
+    }
+
+    template <typename Impl>
+    static void
+        _relocate(Impl* src, size_type count, Impl* dst) noexcept(
+            trivially_relocatable<Impl> ||
+            std::is_nothrow_move_constructible_v<Impl>) {
+        if constexpr (trivially_relocatable<Impl>) {
+            if (count != 0) {
+                std::memcpy(
+                    static_cast<void*>(dst), static_cast<const void*>(src),
+                    sizeof(Impl) * count);
+            }
+        } else {
+            uninitialized_move_if_noexcept_n(src, count, dst);
+            std::destroy_n(src, count);
+        }
+    }
+
+    template <typename Impl>
+    void _reallocate(_bucket& bucket, size_type capacity) {
+        _allocator_t<Impl> alloc{ get_allocator() };
+        using traits       = std::allocator_traits<_allocator_t<Impl>>;
+        auto* const buffer = traits::allocate(alloc, capacity);
+        auto guard         = make_exception_guard([&]() noexcept {
+            traits::deallocate(alloc, buffer, capacity);
+        });
+        _relocate(static_cast<Impl*>(bucket.data), bucket.size, buffer);
+        guard.mark_complete();
+        if (bucket.data != nullptr) {
+            traits::deallocate(
+                alloc, static_cast<Impl*>(bucket.data), bucket.capacity);
+        }
+        bucket.data     = buffer;
+        bucket.capacity = capacity;
+    }
+
+    /// Constructs the object in a new buffer before moving the others, so
+    /// that `args` could refer to objects of the bucket.
+    template <typename Impl, typename... Args>
+    Impl* _emplace_grow(_bucket& bucket, Args&&... args) {
+        _allocator_t<Impl> alloc{ get_allocator() };
+        using traits        = std::allocator_traits<_allocator_t<Impl>>;
+        const auto capacity = (std::max)(bucket.capacity << 1U, size_type{ 8 });
+        auto* const buffer  = traits::allocate(alloc, capacity);
+        auto guard          = make_exception_guard([&]() noexcept {
+            traits::deallocate(alloc, buffer, capacity);
+        });
+        auto* const object =
+            ::new (buffer + bucket.size) Impl(std::forward<Args>(args)...);
+        auto destroy = make_exception_guard(
+            [object]() noexcept { std::destroy_at(object); });
+        _relocate(static_cast<Impl*>(bucket.data), bucket.size, buffer);
+        destroy.mark_complete();
+        guard.mark_complete();
+        if (bucket.data != nullptr) {
+            traits::deallocate(
+                alloc, static_cast<Impl*>(bucket.data), bucket.capacity);
+        }
+        bucket.data     = buffer;
+        bucket.capacity = capacity;
+        return object;
+    }
+
+    void _release() noexcept {
+        const auto alloc = get_allocator();
+        for (_bucket& bucket : buckets_) {
+            bucket.ops->destroy(bucket.data, bucket.size);
+            if (bucket.data != nullptr) {
+                bucket.ops->deallocate(alloc, bucket.data, bucket.capacity);
+            }
+        }
+        buckets_.clear();
+        size_ = 0;
+    }
+
+    std::vector<_bucket, _allocator_t<_bucket>> buckets_;
+    size_type size_{};
+};
+
+namespace pmr {
+
+template <poly_object Object>
+using poly_vector =
+    ::neutron::poly_vector<Object, std::pmr::polymorphic_allocator<>>;
+
+} // namespace pmr
+
+} // namespace neutron
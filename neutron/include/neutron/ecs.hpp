@@ -2,6 +2,7 @@
 // IWYU pragma: begin_exports
 #include "neutron/detail/ecs/fwd.hpp"
 
+#include "neutron/detail/ecs/arena.hpp"
 #include "neutron/detail/ecs/archetype.hpp"
 #include "neutron/detail/ecs/basic_commands.hpp"
 #include "neutron/detail/ecs/basic_querior.hpp"
@@ -11,9 +12,12 @@
 #include "neutron/detail/ecs/construct_from_world.hpp"
 #include "neutron/detail/ecs/entity.hpp"
 #include "neutron/detail/ecs/local.hpp"
+#include "neutron/detail/ecs/prefab.hpp"
 #include "neutron/detail/ecs/res.hpp"
 #include "neutron/detail/ecs/resource.hpp"
 #include "neutron/detail/ecs/run.hpp"
+#include "neutron/detail/ecs/snapshot.hpp"
+#include "neutron/detail/ecs/spatial_index.hpp"
 #include "neutron/detail/ecs/stage.hpp"
 #include "neutron/detail/ecs/world.hpp"
 #include "neutron/detail/ecs/world_base.hpp"
@@ -0,0 +1,359 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource> // IWYU pragma: keep
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "neutron/detail/concepts/allocator.hpp"
+#include "neutron/detail/macros.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
+#include "neutron/lock.hpp"
+
+namespace neutron {
+
+/**
+ * @class basic_epoch_domain
+ * @brief Epoch-based reclamation, deferring the destruction of objects
+ * unlinked from a concurrent structure until no reader can still see them.
+ * @details Readers `pin()` the domain for as long as they hold pointers into
+ * the structure, which records the global epoch they started in. Writers
+ * unlink an object, then `retire` it with its deleter. The global epoch only
+ * advances once every pinned reader has caught up with it, so an object
+ * retired in epoch `e` is freed once the epoch reaches `e + 2`.
+ *
+ * Retired objects are kept in a few bags, chosen by thread, and freed in
+ * batches: a bag reaching `batch` objects tries to advance the epoch and frees
+ * what became safe. A point where the calling thread holds no guard, such as
+ * the end of an ECS frame where no system runs, should call `quiescent()`;
+ * the world does so for the domain when it is one of its resources.
+ * @warning The epoch cannot advance past a guard held by the thread calling
+ * `quiescent()`, nothing retired after it was pinned is freed then.
+ */
+template <std_simple_allocator Alloc = std::allocator<std::byte>>
+class basic_epoch_domain {
+    static constexpr size_t _cacheline =
+        std::hardware_destructive_interference_size;
+
+    // 0 while free, the pinned epoch shifted left with the low bit set
+    struct alignas(_cacheline) _slot {
+        std::atomic<uint64_t> state{ 0 };
+    };
+
+    struct _retired {
+        void* pointer;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    using _retired_alloc = rebind_alloc_t<Alloc, _retired>;
+
+    struct alignas(_cacheline) _bag {
+        explicit _bag(const _retired_alloc& alloc) : items(alloc) {}
+
+        adaptive_mutex mutex;
+        std::vector<_retired, _retired_alloc> items;
+    };
+
+    using _slot_alloc  = rebind_alloc_t<Alloc, _slot>;
+    using _slot_traits = std::allocator_traits<_slot_alloc>;
+    using _bag_alloc   = rebind_alloc_t<Alloc, _bag>;
+    using _bag_traits  = std::allocator_traits<_bag_alloc>;
+
+    // deleters run outside of the lock of the bag, this many at a time
+    static constexpr size_t _free_chunk = 64;
+
+public:
+    using allocator_type = Alloc;
+
+    /**
+     * @brief Keeps the domain pinned, so nothing retired from now on is freed
+     * while it lives.
+     */
+    class guard {
+    public:
+        guard() noexcept = default;
+
+        guard(guard&& that) noexcept
+            : slot_(std::exchange(that.slot_, nullptr)) {}
+
+        guard& operator=(guard&& that) noexcept {
+            if (this != &that) {
+                reset();
+                slot_ = std::exchange(that.slot_, nullptr);
+            }
+            return *this;
+        }
+
+        guard(const guard&)            = delete;
+        guard& operator=(const guard&) = delete;
+
+        ~guard() { reset(); }
+
+        /**
+         * @brief Unpins the domain before the guard is destroyed.
+         */
+        void reset() noexcept {
+            if (slot_ != nullptr) {
+                slot_->state.store(0, std::memory_order_release);
+                slot_ = nullptr;
+            }
+        }
+
+        ATOM_NODISCARD explicit operator bool() const noexcept {
+            return slot_ != nullptr;
+        }
+
+    private:
+        friend class basic_epoch_domain;
+        explicit guard(_slot* slot) noexcept : slot_(slot) {}
+
+        _slot* slot_ = nullptr;
+    };
+
+    /**
+     * @param slots Number of guards that could be held at once, 2 per
+     * hardware thread by default. `pin` waits for a free one otherwise.
+     * @param batch Number of retired objects in a bag triggering a collection.
+     */
+    explicit basic_epoch_domain(
+        size_t slots = 2 * std::thread::hardware_concurrency(),
+        size_t batch = 64, const Alloc& alloc = Alloc{})
+        : slot_alloc_(alloc), bag_alloc_(alloc),
+          slot_mask_(std::bit_ceil(std::max<size_t>(slots, 1)) - 1),
+          bag_mask_(
+              std::bit_ceil(std::max<size_t>(
+                  std::thread::hardware_concurrency(), 1)) -
+              1),
+          batch_(std::max<size_t>(batch, 1)) {
+        slots_ = _slot_traits::allocate(slot_alloc_, slot_mask_ + 1);
+        for (size_t i = 0; i <= slot_mask_; ++i) {
+            ::new (slots_ + i) _slot{};
+        }
+        bags_ = _bag_traits::allocate(bag_alloc_, bag_mask_ + 1);
+        for (size_t i = 0; i <= bag_mask_; ++i) {
+            ::new (bags_ + i) _bag(_retired_alloc{ alloc });
+        }
+    }
+
+    /**
+     * @warning Only an unused domain, such as a newly constructed one, could
+     * be moved from.
+     */
+    basic_epoch_domain(basic_epoch_domain&& that) noexcept
+        : slot_alloc_(that.slot_alloc_), bag_alloc_(that.bag_alloc_),
+          slot_mask_(that.slot_mask_), bag_mask_(that.bag_mask_),
+          batch_(that.batch_), slots_(std::exchange(that.slots_, nullptr)),
+          bags_(std::exchange(that.bags_, nullptr)),
+          global_(that.global_.load(std::memory_order_relaxed)) {}
+
+    basic_epoch_domain(const basic_epoch_domain&)            = delete;
+    basic_epoch_domain& operator=(const basic_epoch_domain&) = delete;
+    basic_epoch_domain& operator=(basic_epoch_domain&&)      = delete;
+
+    /**
+     * @brief Frees everything retired so far.
+     * @warning No guard may be held any more.
+     */
+    ~basic_epoch_domain() {
+        if (bags_ != nullptr) {
+            for (size_t i = 0; i <= bag_mask_; ++i) {
+                for (const auto& item : bags_[i].items) {
+                    item.deleter(item.pointer);
+                }
+                bags_[i].~_bag();
+            }
+            _bag_traits::deallocate(bag_alloc_, bags_, bag_mask_ + 1);
+        }
+        if (slots_ != nullptr) {
+            for (size_t i = 0; i <= slot_mask_; ++i) {
+                slots_[i].~_slot();
+            }
+            _slot_traits::deallocate(slot_alloc_, slots_, slot_mask_ + 1);
+        }
+    }
+
+    /**
+     * @brief Pins the domain for the calling reader.
+     */
+    ATOM_NODISCARD guard pin() noexcept {
+        const auto start = _thread_index();
+        for (size_t i = 0;; ++i) {
+            auto& slot = slots_[(start + i) & slot_mask_];
+            if (slot.state.load(std::memory_order_relaxed) == 0) {
+                uint64_t expected = 0;
+                const auto epoch  = global_.load(std::memory_order_seq_cst);
+                if (slot.state.compare_exchange_strong(
+                        expected, (epoch << 1U) | 1U,
+                        std::memory_order_seq_cst)) {
+                    return guard{ &slot };
+                }
+            }
+            if ((i & slot_mask_) == slot_mask_) {
+                std::this_thread::yield(); // every slot is in use
+            }
+        }
+    }
+
+    /**
+     * @brief Defers `deleter(pointer)` until no reader pinned before this call
+     * remains. `pointer` must already be unreachable for new readers.
+     */
+    void retire(void* pointer, void (*deleter)(void*)) {
+        auto& bag = bags_[_thread_index() & bag_mask_];
+        size_t count = 0;
+        {
+            std::unique_lock guard{ bag.mutex };
+            bag.items.push_back(
+                { pointer, deleter, global_.load(std::memory_order_seq_cst) });
+            count = bag.items.size();
+        }
+        if (count >= batch_) {
+            try_advance();
+            _collect(bag);
+        }
+    }
+
+    /**
+     * @brief Defers `Deleter{}(pointer)`, `delete pointer` by default.
+     */
+    template <typename Ty, typename Deleter = std::default_delete<Ty>>
+    requires std::is_empty_v<Deleter> &&
+             std::is_default_constructible_v<Deleter>
+    void retire(Ty* pointer, Deleter = Deleter{}) {
+        retire(
+            const_cast<std::remove_cv_t<Ty>*>(pointer), +[](void* erased) {
+                Deleter{}(static_cast<Ty*>(erased));
+            });
+    }
+
+    /**
+     * @brief Advances the global epoch, unless a pinned reader lags behind.
+     * @return Whether the epoch could advance.
+     */
+    bool try_advance() noexcept {
+        auto epoch = global_.load(std::memory_order_seq_cst);
+        for (size_t i = 0; i <= slot_mask_; ++i) {
+            const auto state =
+                slots_[i].state.load(std::memory_order_seq_cst);
+            if (state != 0 && (state >> 1U) != epoch) {
+                return false;
+            }
+        }
+        // losing the race means another thread advanced it
+        global_.compare_exchange_strong(
+            epoch, epoch + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    /**
+     * @brief Frees every retired object no reader could still see.
+     * @return Number of objects freed.
+     */
+    size_t collect() {
+        size_t freed = 0;
+        for (size_t i = 0; i <= bag_mask_; ++i) {
+            freed += _collect(bags_[i]);
+        }
+        return freed;
+    }
+
+    /**
+     * @brief Marks a point where the calling thread holds no guard, such as
+     * the end of a frame: advances the epoch as far as the other readers
+     * allow, then collects.
+     * @return Number of objects freed.
+     */
+    size_t quiescent() {
+        if (try_advance()) {
+            try_advance();
+        }
+        return collect();
+    }
+
+    ATOM_NODISCARD uint64_t epoch() const noexcept {
+        return global_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Number of retired objects not freed yet.
+     */
+    ATOM_NODISCARD size_t pending() const {
+        size_t count = 0;
+        for (size_t i = 0; i <= bag_mask_; ++i) {
+            std::unique_lock guard{ bags_[i].mutex };
+            count += bags_[i].items.size();
+        }
+        return count;
+    }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return allocator_type{ slot_alloc_ };
+    }
+
+private:
+    static size_t _thread_index() noexcept {
+        static std::atomic<size_t> next{ 0 };
+        thread_local const size_t index =
+            next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    size_t _collect(_bag& bag) {
+        const auto epoch = global_.load(std::memory_order_seq_cst);
+        if (epoch < 2) {
+            return 0;
+        }
+        size_t freed = 0;
+        std::array<_retired, _free_chunk> chunk;
+        while (true) {
+            size_t count = 0;
+            {
+                std::unique_lock guard{ bag.mutex };
+                // epochs are increasing in a bag, as read under its lock
+                auto& items = bag.items;
+                while (count < chunk.size() && count < items.size() &&
+                       items[count].epoch + 2 <= epoch) {
+                    chunk[count] = items[count];
+                    ++count;
+                }
+                items.erase(items.begin(), items.begin() + count);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                chunk[i].deleter(chunk[i].pointer);
+            }
+            freed += count;
+            if (count < chunk.size()) {
+                return freed;
+            }
+        }
+    }
+
+    ATOM_NO_UNIQUE_ADDR _slot_alloc slot_alloc_;
+    ATOM_NO_UNIQUE_ADDR _bag_alloc bag_alloc_;
+    size_t slot_mask_;
+    size_t bag_mask_;
+    size_t batch_;
+    _slot* slots_ = nullptr;
+    _bag* bags_   = nullptr;
+    alignas(_cacheline) std::atomic<uint64_t> global_{ 0 };
+};
+
+using epoch_domain = basic_epoch_domain<>;
+
+namespace pmr {
+
+using epoch_domain =
+    basic_epoch_domain<std::pmr::polymorphic_allocator<std::byte>>;
+
+} // namespace pmr
+
+} // namespace neutron
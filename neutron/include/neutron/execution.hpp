@@ -85,3 +85,6 @@ using ::stdexec::sync_wait;
 // #include "neutron/detail/execution/sender_adaptors/when_all.hpp"
 
 #endif
+
+// on top of any of the implementations above
+#include "neutron/detail/execution/counting_scope.hpp"
@@ -1,5 +1,10 @@
 #pragma once
 // IWYU pragma: begin_exports
 #include "neutron/detail/execution_resources/affinity_thread.hpp"
+#include "neutron/detail/execution_resources/io_context.hpp"
 #include "neutron/detail/execution_resources/normthread.hpp"
+#include "neutron/detail/execution_resources/numa_pool.hpp"
+#include "neutron/detail/execution_resources/priority_pool.hpp"
+#include "neutron/detail/execution_resources/static_context_thread_pool.hpp"
+#include "neutron/detail/execution_resources/timed_scheduler.hpp"
 // IWYU pragma: end_exports
\ No newline at end of file
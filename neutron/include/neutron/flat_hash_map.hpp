@@ -76,6 +76,16 @@ struct KeyOrValueHasher : functor_storage<size_t, hasher> {
     size_t operator()(const std::pair<F, S>& value) const {
         return static_cast<const hasher_storage&>(*this)(value.first);
     }
+    template <typename U>
+    requires requires { typename hasher::is_transparent; }
+    size_t operator()(const U& key) {
+        return static_cast<hasher_storage&>(*this)(key);
+    }
+    template <typename U>
+    requires requires { typename hasher::is_transparent; }
+    size_t operator()(const U& key) const {
+        return static_cast<const hasher_storage&>(*this)(key);
+    }
 };
 template <typename key_type, typename value_type, typename key_equal>
 struct KeyOrValueEquality : functor_storage<bool, key_equal> {
@@ -116,7 +126,20 @@ struct KeyOrValueEquality : functor_storage<bool, key_equal> {
         operator()(const std::pair<FL, SL>& lhs, const std::pair<FR, SR>& rhs) {
         return static_cast<equality_storage&>(*this)(lhs.first, rhs.first);
     }
+    template <typename U>
+    requires requires { typename key_equal::is_transparent; }
+    bool operator()(const U& lhs, const value_type& rhs) {
+        return static_cast<equality_storage&>(*this)(lhs, rhs.first);
+    }
+};
+/// Both the hasher and the key equal accept other types than the key, such
+/// as `std::string_view` for `std::string` keys.
+template <typename Hash, typename Equal>
+concept transparent_lookup = requires {
+    typename Hash::is_transparent;
+    typename Equal::is_transparent;
 };
+
 static constexpr int8_t min_lookups = 4;
 template <typename T>
 struct sherwood_v3_entry {
@@ -441,22 +464,61 @@ public:
     const_iterator cend() const { return end(); }
 
     iterator find(const FindKey& key) {
-        size_t index =
-            hash_policy.index_for_hash(hash_object(key), num_slots_minus_one);
-        EntryPointer it = entries + ptrdiff_t(index);
-        for (int8_t distance = 0; it->distance_from_desired >= distance;
-             ++distance, ++it) {
-            if (compares_equal(key, it->value))
-                return { it };
-        }
-        return end();
+        return find_hashed(key, hash_object(key));
     }
     const_iterator find(const FindKey& key) const {
         return const_cast<sherwood_v3_table*>(this)->find(key);
     }
+    // heterogeneous lookup, without materializing a key
+    template <typename K>
+    requires transparent_lookup<ArgumentHash, ArgumentEqual>
+    iterator find(const K& key) {
+        return find_hashed(key, hash_object(key));
+    }
+    template <typename K>
+    requires transparent_lookup<ArgumentHash, ArgumentEqual>
+    const_iterator find(const K& key) const {
+        return const_cast<sherwood_v3_table*>(this)->find(key);
+    }
+    // `hash` must be what `hash_function()` returns for `key`, computed
+    // beforehand, possibly at compile time
+    iterator find(const FindKey& key, size_t hash) {
+        return find_hashed(key, hash);
+    }
+    const_iterator find(const FindKey& key, size_t hash) const {
+        return const_cast<sherwood_v3_table*>(this)->find_hashed(key, hash);
+    }
+    template <typename K>
+    requires transparent_lookup<ArgumentHash, ArgumentEqual>
+    iterator find(const K& key, size_t hash) {
+        return find_hashed(key, hash);
+    }
+    template <typename K>
+    requires transparent_lookup<ArgumentHash, ArgumentEqual>
+    const_iterator find(const K& key, size_t hash) const {
+        return const_cast<sherwood_v3_table*>(this)->find_hashed(key, hash);
+    }
     size_t count(const FindKey& key) const {
         return find(key) == end() ? 0 : 1;
     }
+    template <typename K>
+    requires transparent_lookup<ArgumentHash, ArgumentEqual>
+    size_t count(const K& key) const {
+        return find(key) == end() ? 0 : 1;
+    }
+    bool contains(const FindKey& key) const { return find(key) != end(); }
+    template <typename K>
+    requires transparent_lookup<ArgumentHash, ArgumentEqual>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+    // brings the first slot probed for `hash` into the cache, to be issued
+    // some work ahead of the `find`
+    void prefetch(size_t hash) const noexcept {
+        ATOM_PREFETCH(
+            entries + static_cast<ptrdiff_t>(hash_policy.index_for_hash(
+                          hash, num_slots_minus_one)));
+    }
     std::pair<iterator, iterator> equal_range(const FindKey& key) {
         iterator found = find(key);
         if (found == end())
@@ -770,6 +832,18 @@ private:
         max_lookups = detailv3::min_lookups - 1;
     }
 
+    template <typename K>
+    iterator find_hashed(const K& key, size_t hash) {
+        size_t index = hash_policy.index_for_hash(hash, num_slots_minus_one);
+        EntryPointer it = entries + ptrdiff_t(index);
+        for (int8_t distance = 0; it->distance_from_desired >= distance;
+             ++distance, ++it) {
+            if (compares_equal(key, it->value))
+                return { it };
+        }
+        return end();
+    }
+
     template <typename U>
     size_t hash_object(const U& key) {
         return static_cast<Hasher&>(*this)(key);
@@ -2,6 +2,13 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
 #include "neutron/detail/parallel/cpu_relax.hpp"
 
 namespace neutron {
@@ -65,10 +72,10 @@ public:
 
     /**
      * @brief Try get the lock.
-     *
+     * @return Whether the lock was acquired.
      */
     auto try_lock() noexcept -> bool {
-        return flag_.test_and_set(std::memory_order_acquire);
+        return !flag_.test_and_set(std::memory_order_acquire);
     }
 
     void lock() noexcept {
@@ -88,6 +95,8 @@ private:
     #endif
 };
 
+} // namespace neutron
+
 #endif
 
 #if defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L
@@ -110,13 +119,14 @@ public:
     ~hybrid_spinlock()                                 = default;
 
     auto try_lock() noexcept -> bool {
-        return flag_.test_and_set(std::memory_order_acquire);
+        return !flag_.test_and_set(std::memory_order_acquire);
     }
 
     void lock() noexcept {
-        for (auto i = 0; i < internal::max_spin_time &&
-                         flag_.test_and_set(std::memory_order_acquire);
-             ++i) {
+        for (auto i = 0; i < internal::max_spin_time; ++i) {
+            if (!flag_.test_and_set(std::memory_order_acquire)) {
+                return;
+            }
             internal::cpu_relax();
         }
 
@@ -139,17 +149,222 @@ private:
     #endif
 };
 
+} // namespace neutron
+
 #else
-}
 
     #include <mutex>
 
 namespace neutron {
 
-using hyhybrid_spinlock = std::mutex;
+using hybrid_spinlock = std::mutex;
+
+} // namespace neutron
 
 #endif
 
+namespace neutron {
+
+/**
+ * @class adaptive_mutex
+ * @brief An exclusive lock spinning for a while before parking on
+ * `atomic::wait`, the spin limit adapting to how long the lock is held.
+ * @details The limit follows the average number of spins the recent
+ * acquisitions needed, so short critical sections are taken without a system
+ * call and long ones stop burning cores. Unlocking only wakes a waiter when
+ * one has parked.
+ */
+class adaptive_mutex {
+public:
+    adaptive_mutex()                                 = default;
+    adaptive_mutex(const adaptive_mutex&)            = delete;
+    adaptive_mutex(adaptive_mutex&&)                 = delete;
+    adaptive_mutex& operator=(const adaptive_mutex&) = delete;
+    adaptive_mutex& operator=(adaptive_mutex&&)      = delete;
+    ~adaptive_mutex()                                = default;
+
+    /**
+     * @brief Try get the lock.
+     * @return Whether the lock was acquired.
+     */
+    auto try_lock() noexcept -> bool {
+        auto expected = _unlocked;
+        return state_.compare_exchange_strong(
+            expected, _locked, std::memory_order_acquire,
+            std::memory_order_relaxed);
+    }
+
+    void lock() noexcept {
+        if (!try_lock()) {
+            _lock_slow();
+        }
+    }
+
+    void unlock() noexcept {
+        if (state_.exchange(_unlocked, std::memory_order_release) ==
+            _contended) {
+            state_.notify_one();
+        }
+    }
+
+private:
+    static constexpr uint32_t _unlocked  = 0;
+    static constexpr uint32_t _locked    = 1;
+    static constexpr uint32_t _contended = 2; // locked, maybe with waiters
+
+    void _lock_slow() noexcept {
+        const auto estimate = spins_.load(std::memory_order_relaxed);
+        const auto limit    = std::min<uint32_t>(
+            (estimate * 2) + 16, internal::max_spin_time);
+
+        uint32_t spins = 0;
+        for (; spins < limit; ++spins) {
+            internal::cpu_relax();
+            if (state_.load(std::memory_order_relaxed) == _unlocked &&
+                try_lock()) {
+                break;
+            }
+        }
+        // moving average, as the adaptive mutexes of glibc
+        const auto delta =
+            static_cast<int32_t>(spins) - static_cast<int32_t>(estimate);
+        spins_.store(
+            static_cast<uint32_t>(static_cast<int32_t>(estimate) + (delta / 8)),
+            std::memory_order_relaxed);
+        if (spins != limit) {
+            return;
+        }
+
+        while (state_.exchange(_contended, std::memory_order_acquire) !=
+               _unlocked) {
+            state_.wait(_contended, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint32_t> state_{ _unlocked };
+    std::atomic<uint32_t> spins_{ 0 };
+};
+
+/**
+ * @class per_core_shared_mutex
+ * @brief A reader/writer lock whose readers never write a shared cache line.
+ * @details Readers count themselves in one of several counters, each on its
+ * own cache line, one per hardware thread by default; a thread always uses
+ * the same counter. A writer raises a flag that makes new readers wait, then
+ * waits for every counter to drain, so reading scales with the cores while
+ * writing costs a pass over the counters. Writers are preferred over the
+ * readers arriving after them, and are serialized by an `adaptive_mutex`.
+ * Satisfies the SharedMutex requirements, to be used with `std::shared_lock`
+ * for read-mostly resources such as the ones behind `res<const T&>`.
+ */
+class per_core_shared_mutex {
+    struct alignas(std::hardware_destructive_interference_size) _counter {
+        std::atomic<uint32_t> readers{ 0 };
+    };
+
+public:
+    explicit per_core_shared_mutex(
+        size_t counters = std::thread::hardware_concurrency())
+        : mask_(std::bit_ceil(std::max<size_t>(counters, 1)) - 1),
+          counters_(std::make_unique<_counter[]>(mask_ + 1)) {}
+
+    per_core_shared_mutex(const per_core_shared_mutex&)            = delete;
+    per_core_shared_mutex(per_core_shared_mutex&&)                 = delete;
+    per_core_shared_mutex& operator=(const per_core_shared_mutex&) = delete;
+    per_core_shared_mutex& operator=(per_core_shared_mutex&&)      = delete;
+    ~per_core_shared_mutex()                                       = default;
+
+    void lock() noexcept {
+        writers_.lock();
+        writer_.store(true, std::memory_order_seq_cst);
+        for (size_t i = 0; i <= mask_; ++i) {
+            _drain(counters_[i]);
+        }
+    }
+
+    /**
+     * @brief Try get the lock exclusively.
+     * @return Whether the lock was acquired.
+     */
+    auto try_lock() noexcept -> bool {
+        if (!writers_.try_lock()) {
+            return false;
+        }
+        writer_.store(true, std::memory_order_seq_cst);
+        for (size_t i = 0; i <= mask_; ++i) {
+            if (counters_[i].readers.load(std::memory_order_seq_cst) != 0) {
+                unlock();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void unlock() noexcept {
+        writer_.store(false, std::memory_order_release);
+        writer_.notify_all();
+        writers_.unlock();
+    }
+
+    void lock_shared() noexcept {
+        auto& counter = _own();
+        while (true) {
+            counter.readers.fetch_add(1, std::memory_order_seq_cst);
+            if (!writer_.load(std::memory_order_seq_cst)) {
+                return;
+            }
+            counter.readers.fetch_sub(1, std::memory_order_release);
+            writer_.wait(true, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Try get the lock shared.
+     * @return Whether the lock was acquired.
+     */
+    auto try_lock_shared() noexcept -> bool {
+        auto& counter = _own();
+        counter.readers.fetch_add(1, std::memory_order_seq_cst);
+        if (!writer_.load(std::memory_order_seq_cst)) {
+            return true;
+        }
+        counter.readers.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+
+    void unlock_shared() noexcept {
+        _own().readers.fetch_sub(1, std::memory_order_release);
+    }
+
+private:
+    static size_t _thread_index() noexcept {
+        static std::atomic<size_t> next{ 0 };
+        thread_local const size_t index =
+            next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    _counter& _own() const noexcept {
+        return counters_[_thread_index() & mask_];
+    }
+
+    static void _drain(const _counter& counter) noexcept {
+        for (auto i = 0; counter.readers.load(std::memory_order_seq_cst) != 0;
+             ++i) {
+            if (i < internal::max_spin_time) {
+                internal::cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    size_t mask_;
+    std::unique_ptr<_counter[]> counters_;
+    std::atomic<bool> writer_{ false };
+    adaptive_mutex writers_;
+};
+
 template <size_t Count, typename Mutex, template <typename> typename Lock>
 class lock_keeper {
 public:
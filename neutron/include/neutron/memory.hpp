@@ -1,5 +1,7 @@
 #pragma once
 // IWYU pragma: begin_exports
+#include "neutron/detail/memory/frame_arena.hpp"
+#include "neutron/detail/memory/frame_pool.hpp"
 #include "neutron/detail/memory/freeable_bytes.hpp"
 #include "neutron/detail/memory/rebind_alloc.hpp"
 #include "neutron/detail/memory/uninitialized_move_if_noexcept.hpp"
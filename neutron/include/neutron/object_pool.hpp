@@ -1,10 +1,22 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cstddef>
+#include <cstring>
 #include <memory>
+#include <memory_resource> // IWYU pragma: keep
+#include <mutex>
+#include <new>
+#include <thread>
 #include <utility>
+#include <vector>
+#include "neutron/detail/concepts/allocator.hpp"
 #include "neutron/detail/macros.hpp"
 #include "neutron/detail/mask.hpp"
 #include "neutron/detail/memory/freeable_bytes.hpp"
+#include "neutron/detail/memory/rebind_alloc.hpp"
 
 namespace neutron {
 
@@ -285,4 +297,296 @@ private:
     _pool_proxy<Size> proxy_;
 };
 
+/**
+ * @class slab_pool
+ * @brief A growable, thread-safe pool of `Size`-byte blocks.
+ * @details Memory comes in slabs of `blocks_per_slab` blocks, each carved by
+ * a `_pool_proxy` and chained to the previous ones; a new slab is added
+ * whenever the others are exhausted, so `take` never returns nullptr. Slabs
+ * are only released with the pool.
+ *
+ * Freed blocks are cached in magazines, one per thread index, that exchange
+ * batches of `magazine_size` blocks with a global depot: a thread taking from
+ * an empty magazine receives a batch, a thread putting into a full one hands
+ * half of it over. Taking and putting thus lock the depot once per batch, and
+ * blocks stay warm in the cache of the thread recycling them.
+ * @tparam Align Alignment of the blocks.
+ * @tparam Alloc Allocator of the slabs and of the depot.
+ */
+template <
+    size_t Size, size_t Align = alignof(void*),
+    std_simple_allocator Alloc = std::allocator<std::byte>>
+requires _single_bit<Align>
+class slab_pool {
+    static constexpr size_t _word   = std::max(Align, alignof(void*));
+    static constexpr size_t _stride =
+        (std::max(Size, sizeof(void*)) + _word - 1) / _word * _word;
+
+    using _proxy = _pool_proxy<_stride>;
+
+    struct alignas(Align) _unit {
+        std::byte bytes[_stride]; // NOLINT
+    };
+
+    using _unit_alloc   = rebind_alloc_t<Alloc, _unit>;
+    using _unit_traits  = std::allocator_traits<_unit_alloc>;
+    using _proxy_alloc  = rebind_alloc_t<Alloc, _proxy>;
+    using _block_alloc  = rebind_alloc_t<Alloc, void*>;
+
+public:
+    static constexpr size_t magazine_size = 32;
+    static constexpr size_t block_size    = _stride;
+
+    using allocator_type = Alloc;
+
+    explicit slab_pool(
+        size_t blocks_per_slab = 1024, const Alloc& alloc = Alloc{})
+        : unit_alloc_(alloc),
+          blocks_per_slab_(std::max(blocks_per_slab, magazine_size)),
+          magazine_mask_(
+              std::bit_ceil(std::max<size_t>(
+                  2 * std::thread::hardware_concurrency(), 1)) -
+              1),
+          magazines_(std::make_unique<_magazine[]>(magazine_mask_ + 1)),
+          slabs_(_proxy_alloc{ alloc }), depot_(_block_alloc{ alloc }) {}
+
+    slab_pool(const slab_pool&)            = delete;
+    slab_pool& operator=(const slab_pool&) = delete;
+    slab_pool(slab_pool&&)                 = delete;
+    slab_pool& operator=(slab_pool&&)      = delete;
+
+    /**
+     * @warning Every block must have been put back, or is lost with the pool.
+     */
+    ~slab_pool() noexcept {
+        for (auto& slab : slabs_) {
+            auto* const units = static_cast<void*>(slab.data());
+            _unit_traits::deallocate(
+                unit_alloc_, static_cast<_unit*>(units), slab.capacity());
+        }
+    }
+
+    /**
+     * @brief Acquire a raw memory block suitable for constructing an object of
+     * type `Ty`, adding a slab if needed.
+     * @throw std::bad_alloc If a slab could not be allocated.
+     */
+    template <typename Ty>
+    requires(sizeof(Ty) <= Size && alignof(Ty) <= Align)
+    ATOM_NODISCARD Ty* take() {
+        auto& magazine = _acquire();
+        if (magazine.count == 0) [[unlikely]] {
+            ATOM_TRY { _refill(magazine); }
+            ATOM_CATCH(...) {
+                _release(magazine);
+                ATOM_RETHROW;
+            }
+        }
+        void* const block = magazine.blocks[--magazine.count];
+        _release(magazine);
+        return std::assume_aligned<Align>(static_cast<Ty*>(block));
+    }
+
+    /**
+     * @brief Return a previously acquired block to the pool, on any thread.
+     * @param pointer Pointer to memory obtained via `take`, or nullptr. The
+     * pointed-to object must be already destroyed.
+     */
+    void put(void* pointer) noexcept {
+        if (pointer == nullptr) [[unlikely]] {
+            return;
+        }
+        auto& magazine = _acquire();
+        if (magazine.count == magazine.blocks.size()) [[unlikely]] {
+            _flush(magazine);
+        }
+        magazine.blocks[magazine.count++] = pointer;
+        _release(magazine);
+    }
+
+    /**
+     * @brief Number of slabs allocated so far.
+     */
+    ATOM_NODISCARD size_t slab_count() const {
+        std::unique_lock guard{ depot_mutex_ };
+        return slabs_.size();
+    }
+
+    /**
+     * @brief Number of blocks in the slabs allocated so far.
+     */
+    ATOM_NODISCARD size_t capacity() const {
+        std::unique_lock guard{ depot_mutex_ };
+        return slabs_.size() * blocks_per_slab_;
+    }
+
+    ATOM_NODISCARD allocator_type get_allocator() const noexcept {
+        return allocator_type{ unit_alloc_ };
+    }
+
+private:
+    struct alignas(std::hardware_destructive_interference_size) _magazine {
+        std::atomic<bool> busy{ false };
+        size_t count = 0;
+        std::array<void*, magazine_size * 2> blocks;
+    };
+
+    static size_t _thread_index() noexcept {
+        static std::atomic<size_t> next{ 0 };
+        thread_local const size_t index =
+            next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    // the magazine of the calling thread, or the next free one when another
+    // thread hashed to the same index holds it
+    _magazine& _acquire() noexcept {
+        const auto start = _thread_index();
+        for (size_t i = 0;; ++i) {
+            auto& magazine = magazines_[(start + i) & magazine_mask_];
+            if (!magazine.busy.load(std::memory_order_relaxed) &&
+                !magazine.busy.exchange(true, std::memory_order_acquire)) {
+                return magazine;
+            }
+            if ((i & magazine_mask_) == magazine_mask_) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    static void _release(_magazine& magazine) noexcept {
+        magazine.busy.store(false, std::memory_order_release);
+    }
+
+    void _refill(_magazine& magazine) {
+        std::unique_lock guard{ depot_mutex_ };
+        if (!depot_.empty()) {
+            const auto count = std::min(magazine_size, depot_.size());
+            std::memcpy(
+                magazine.blocks.data(), depot_.data() + depot_.size() - count,
+                count * sizeof(void*));
+            depot_.resize(depot_.size() - count);
+            magazine.count = count;
+            return;
+        }
+        if (slabs_.empty() || current_ == slabs_.back().capacity()) {
+            // the depot never holds more blocks than the slabs, so `_flush`
+            // has room for them whatever the threads put back
+            depot_.reserve((slabs_.size() + 1) * blocks_per_slab_);
+            auto* const units =
+                _unit_traits::allocate(unit_alloc_, blocks_per_slab_);
+            ATOM_TRY { slabs_.emplace_back(units, blocks_per_slab_); }
+            ATOM_CATCH(...) {
+                _unit_traits::deallocate(unit_alloc_, units, blocks_per_slab_);
+                ATOM_RETHROW;
+            }
+            current_ = 0;
+        }
+        auto& slab       = slabs_.back();
+        const auto count = std::min(magazine_size, slab.capacity() - current_);
+        for (size_t i = 0; i < count; ++i) {
+            magazine.blocks[i] = slab.template take<std::byte>();
+        }
+        current_       += count;
+        magazine.count  = count;
+    }
+
+    void _flush(_magazine& magazine) noexcept {
+        std::unique_lock guard{ depot_mutex_ };
+        // within the capacity reserved by `_refill`, does not allocate
+        depot_.insert(
+            depot_.end(), magazine.blocks.begin() + magazine_size,
+            magazine.blocks.end());
+        magazine.count = magazine_size;
+    }
+
+    ATOM_NO_UNIQUE_ADDR _unit_alloc unit_alloc_;
+    size_t blocks_per_slab_;
+    size_t magazine_mask_;
+    std::unique_ptr<_magazine[]> magazines_;
+    mutable std::mutex depot_mutex_;
+    std::vector<_proxy, _proxy_alloc> slabs_;
+    size_t current_ = 0; ///< Blocks carved from the last slab.
+    std::vector<void*, _block_alloc> depot_;
+};
+
+/**
+ * @brief Allocator drawing single objects from a `slab_pool`.
+ *
+ * Allocations of one object fitting a block are served by the pool, the
+ * others, such as the arrays of `smvec` or `std::vector`, by the aligned
+ * `operator new`. Rebinding keeps the pool, so node-based containers
+ * allocating their nodes one at a time are backed by it once the nodes fit.
+ * Allocators are equal when they share a pool.
+ */
+template <
+    typename Ty, size_t Size = sizeof(Ty), size_t Align = alignof(Ty),
+    std_simple_allocator Alloc = std::allocator<std::byte>>
+class pool_allocator {
+    template <typename, size_t, size_t, std_simple_allocator>
+    friend class pool_allocator;
+
+    static constexpr size_t _align = std::max(Align, alignof(void*));
+    static constexpr bool _pooled  =
+        sizeof(Ty) <= Size && alignof(Ty) <= _align;
+
+public:
+    using value_type = Ty;
+    using pool_type  = slab_pool<Size, _align, Alloc>;
+
+    template <typename Other>
+    struct rebind {
+        using other = pool_allocator<Other, Size, Align, Alloc>;
+    };
+
+    constexpr explicit pool_allocator(pool_type& pool) noexcept
+        : pool_(&pool) {}
+
+    template <typename Other>
+    constexpr pool_allocator(
+        const pool_allocator<Other, Size, Align, Alloc>& that) noexcept
+        : pool_(that.pool_) {}
+
+    ATOM_NODISCARD Ty* allocate(size_t n) {
+        if constexpr (_pooled) {
+            if (n == 1) [[likely]] {
+                return pool_->template take<Ty>();
+            }
+        }
+        return static_cast<Ty*>(::operator new(
+            n * sizeof(Ty), static_cast<std::align_val_t>(alignof(Ty))));
+    }
+
+    void deallocate(Ty* pointer, size_t n) noexcept {
+        if constexpr (_pooled) {
+            if (n == 1) [[likely]] {
+                pool_->put(pointer);
+                return;
+            }
+        }
+        ::operator delete(
+            pointer, n * sizeof(Ty),
+            static_cast<std::align_val_t>(alignof(Ty)));
+    }
+
+    ATOM_NODISCARD pool_type& pool() const noexcept { return *pool_; }
+
+    template <typename Other>
+    constexpr bool operator==(
+        const pool_allocator<Other, Size, Align, Alloc>& that) const noexcept {
+        return pool_ == that.pool_;
+    }
+
+private:
+    pool_type* pool_;
+};
+
+namespace pmr {
+
+template <size_t Size, size_t Align = alignof(void*)>
+using slab_pool =
+    slab_pool<Size, Align, std::pmr::polymorphic_allocator<std::byte>>;
+
+} // namespace pmr
+
 } // namespace neutron
@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <new>
 #include <utility>
+#include "neutron/detail/poly/poly_vector.hpp"
 #include "neutron/detail/poly/vtable.hpp"
 #include "neutron/detail/reflection/hash.hpp"
 #include "neutron/detail/reflection/legacy/hash_of.hpp"
@@ -268,14 +269,15 @@ public:
             if (ptr_) {
                 _destroy();
             }
-            _init_ptr<Impl>();
+            ptr_ = _init_ptr<Impl>();
             _construct(std::forward<Impl>(that));
             hash_code_ = hash_code;
-            vtable_    = _vtable_value<Impl>();
+            vtable_    = vtable_t{ spread_type<Impl> };
             ops_       = _operations<Impl>();
         } else {
             *static_cast<Impl*>(ptr_) = std::forward<Impl>(that);
         }
+        return *this;
     }
 
 private:
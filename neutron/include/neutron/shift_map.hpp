@@ -4,19 +4,21 @@
 #include <initializer_list>
 #include <limits>
 #include <memory>
+#include <iterator>
 #include <memory_resource> // IWYU pragma: keep
+#include <span>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
-#include <vector>
+#include "neutron/bare_vector.hpp"
 #include "neutron/detail/concepts/allocator.hpp"
 #include "neutron/detail/concepts/pair.hpp"
 #include "neutron/detail/macros.hpp"
 #include "neutron/detail/mask.hpp"
 #include "neutron/detail/memory/rebind_alloc.hpp"
-#include "neutron/detail/memory/unique_storage.hpp"
 #include "neutron/detail/utility/const_identity.hpp"
+#include "neutron/detail/utility/exception_guard.hpp"
 #include "neutron/detail/utility/packed_uint.hpp"
 
 #if ATOM_HAS_CXX23
@@ -36,8 +38,10 @@ constexpr size_t half_bits = sizeof(Ty) * 4UL;
  *
  * Memory layout:
  *   - dense_:  contiguous vector of (key, value) pairs
- *   - sparse_: vector of unique_storage arrays (pages), each holding compated
+ *   - sparse_: vector of pointers to arrays (pages), each holding compated
  * key halves
+ * Both are `bare_vector`s with 32-bit sizes sharing the allocator of the map,
+ * so an empty map takes 32 bytes with `std::allocator`.
  *
  * @tparam Kty      Unsigned integral type for keys (e.g. uint64_t)
  * @tparam Ty       Value type stored
@@ -63,9 +67,6 @@ public:
     template <typename T>
     using _allocator_t = rebind_alloc_t<Alloc, T>;
 
-    template <typename T>
-    using _vector_t = std::vector<T, _allocator_t<T>>;
-
     // clang-format off
 
     using key_type               = Kty;
@@ -74,7 +75,7 @@ public:
     using value_type             = std::pair<const key_type, mapped_type>;
     using _value_type            = std::pair<const_identity<key_type>, mapped_type>;
 
-    using _dense_type            = _vector_t<_value_type>;
+    using _dense_type            = bare_vector<_value_type>;
     using _dense_alloc_t         = _allocator_t<_value_type>;
     using _dense_alloc_traits_t  = std::allocator_traits<_dense_alloc_t>;
 
@@ -92,10 +93,9 @@ public:
 
     using _kept_type             = packed_uint_t<(1ULL << (total_bits - Shift)) - 1ULL>;
     using _array_t               = std::array<_kept_type, PageSize>;
-    using _storage_t             = unique_storage<_array_t, _allocator_t<_array_t>>;
-    using _sparse_type           = _vector_t<_storage_t>;
-    using _sparse_alloc_t        = _allocator_t<_storage_t>;
-    using _sparse_alloc_traits   = std::allocator_traits<_sparse_alloc_t>;
+    using _page_alloc_t          = _allocator_t<_array_t>;
+    using _page_alloc_traits     = std::allocator_traits<_page_alloc_t>;
+    using _sparse_type           = bare_vector<_array_t*>;
 
     using iterator               = typename _dense_type::iterator;
     using const_iterator         = typename _dense_type::const_iterator;
@@ -106,19 +106,18 @@ public:
 
     constexpr shift_map() = default;
 
-    constexpr shift_map(const allocator_type& alloc)
-        : dense_(alloc), sparse_(alloc) {}
+    constexpr shift_map(const allocator_type& alloc) : alloc_(alloc) {}
 
     constexpr shift_map(
         [[maybe_unused]] std::allocator_arg_t, const allocator_type& alloc)
-        : dense_(alloc), sparse_(alloc) {}
+        : alloc_(alloc) {}
 
     template <std::input_iterator Iter, typename Sentinel>
     constexpr shift_map(
         Iter first, Sentinel last,
         const allocator_type& alloc = allocator_type{})
-        : dense_(first, last, alloc), sparse_(alloc) {
-        _set_sparse(0);
+        : alloc_(alloc), dense_(first, last, alloc_) {
+        _init_sparse();
     }
 
     template <std::input_iterator Iter, typename Sentinel>
@@ -130,15 +129,14 @@ public:
     template <pair Pair = value_type>
     constexpr shift_map(
         std::initializer_list<Pair> il, const allocator_type& alloc)
-        : dense_(il.begin(), il.end(), alloc), sparse_(alloc) {
-        _set_sparse(0);
+        : alloc_(alloc), dense_(il.begin(), il.end(), alloc_) {
+        _init_sparse();
     }
 
     template <pair Pair = value_type>
     constexpr shift_map(std::initializer_list<Pair> il)
-        : dense_(il.begin(), il.end(), allocator_type{}),
-          sparse_(_sparse_alloc_t{}) {
-        _set_sparse(0);
+        : dense_(il.begin(), il.end(), alloc_) {
+        _init_sparse();
     }
 
     template <pair Pair = value_type>
@@ -152,54 +150,68 @@ public:
     constexpr shift_map(
         [[maybe_unused]] std::from_range_t, Rng&& range,
         const allocator_type& alloc = allocator_type{})
-        : dense_(std::from_range, std::forward<Rng>(range), alloc),
-          sparse_(alloc) {
+        : alloc_(alloc),
+          dense_(std::from_range, std::forward<Rng>(range), alloc_) {
+        auto guard = make_exception_guard([this] { _release(); });
         if constexpr (map_like<Rng>) {
             _set_sparse_unique(0);
         } else {
             _set_sparse(0);
         }
+        guard.mark_complete();
     }
 #endif
 
     constexpr shift_map(const shift_map& that)
-        : dense_(that.dense_, that.get_allocator()),
-          sparse_(that.get_allocator()) {
-        _set_sparse(0);
+        : alloc_(alloc_traits::select_on_container_copy_construction(
+              that.alloc_)) {
+        _copy_from(that);
     }
 
     constexpr shift_map(shift_map&& that) noexcept
-        : dense_(std::move(that.dense_)), sparse_(std::move(that.sparse_)) {}
+        : alloc_(std::move(that.alloc_)), dense_(std::move(that.dense_)),
+          sparse_(std::move(that.sparse_)) {}
 
     constexpr shift_map(shift_map&& that, const allocator_type& alloc)
-        : dense_(std::move(that.dense_), alloc),
-          sparse_(std::move(that.sparse_), alloc) {}
+        : alloc_(alloc) {
+        _move_from(that);
+    }
 
     constexpr shift_map(
         [[maybe_unused]] std::allocator_arg_t, const allocator_type& alloc,
         shift_map&& that)
         : shift_map(std::move(that), alloc) {}
 
+    /**
+     * @note Leaves the map empty if copying an element throws.
+     */
     constexpr shift_map& operator=(const shift_map& that) {
-        if (this != &that) [[unlikely]] {
-            dense_ = that.dense_;
-            for (auto& storage : sparse_) {
-                storage = _storage_t{ immediately };
+        if (this != &that) [[likely]] {
+            _release();
+            if constexpr (alloc_traits::
+                              propagate_on_container_copy_assignment::value) {
+                alloc_ = that.alloc_;
             }
-            _set_sparse(0);
+            _copy_from(that);
         }
         return *this;
     }
 
-    constexpr shift_map& operator=(shift_map&& that) noexcept {
-        if (this != &that) [[unlikely]] {
-            dense_  = std::move(that.dense_);
-            sparse_ = std::move(that.sparse_);
+    constexpr shift_map& operator=(shift_map&& that) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value) {
+        if (this != &that) [[likely]] {
+            _release();
+            if constexpr (alloc_traits::
+                              propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(that.alloc_);
+            }
+            _move_from(that);
         }
         return *this;
     }
 
-    constexpr ~shift_map() noexcept = default;
+    constexpr ~shift_map() noexcept { _release(); }
 
     constexpr std::pair<iterator, bool> insert(const value_type& val) {
         return try_emplace(val.first, val.second);
@@ -212,10 +224,11 @@ public:
 #if ATOM_HAS_CXX23
     template <typename Rng>
     constexpr void insert_range(Rng&& range) {
-        const auto size = dense_.size();
-        auto dense_guard =
-            make_exception_guard([this, size] { dense_.resize(size); });
-        dense_.insert_range(std::forward<Rng>(range));
+        const auto size  = dense_.size();
+        auto dense_guard = make_exception_guard([this, size] {
+            dense_.erase(dense_.begin() + size, dense_.end());
+        });
+        dense_.append_range(alloc_, std::forward<Rng>(range));
         _set_sparse(size); // elements may not differs from elements in range
         dense_guard.mark_complete();
     }
@@ -260,7 +273,7 @@ public:
     }
 
     constexpr void reserve(size_type size) {
-        dense_.reserve(size);
+        dense_.reserve(alloc_, size);
         _check_page(_page_of(_kept(size)));
     }
 
@@ -322,6 +335,52 @@ public:
         return _contains(key, page, offset);
     }
 
+    /**
+     * @brief Finds every key of `keys`, writing an iterator to its element, or
+     * `end()`, to `out` for each.
+     *
+     * The lookups are pipelined: the sparse slots of the keys a few steps
+     * ahead and the dense slots of the keys closer ahead are prefetched while
+     * the current key is resolved, so the dependent cache misses of large
+     * batches overlap instead of adding up.
+     * @return `out` past the last iterator written.
+     */
+    template <std::output_iterator<iterator> Out>
+    constexpr Out find_batch(std::span<const key_type> keys, Out out) {
+        _lookup_batch(keys, [this, &out](size_t index) {
+            *out = index != _npos ? dense_.begin() + index : dense_.end();
+            ++out;
+        });
+        return out;
+    }
+
+    template <std::output_iterator<const_iterator> Out>
+    constexpr Out find_batch(std::span<const key_type> keys, Out out) const {
+        _lookup_batch(keys, [this, &out](size_t index) {
+            *out = index != _npos ? dense_.begin() + index : dense_.end();
+            ++out;
+        });
+        return out;
+    }
+
+    /**
+     * @brief Checks every key of `keys` like `find_batch`, writing whether it
+     * is contained to `out` for each.
+     * @return The number of keys contained.
+     */
+    template <std::output_iterator<bool> Out>
+    constexpr size_t
+        contains_batch(std::span<const key_type> keys, Out out) const {
+        size_t found = 0;
+        _lookup_batch(keys, [&out, &found](size_t index) {
+            const bool contained = index != _npos;
+            found               += contained;
+            *out                 = contained;
+            ++out;
+        });
+        return found;
+    }
+
     ATOM_NODISCARD constexpr iterator begin() noexcept {
         return dense_.begin();
     }
@@ -375,18 +434,22 @@ public:
     constexpr void
         clear() noexcept(std::is_nothrow_destructible_v<value_type>) {
         dense_.clear();
-        for (_storage_t& storage : sparse_) {
-            for (auto& index : *storage) {
-                index = 0;
-            }
+        for (auto* const page : sparse_) {
+            page->fill(0);
         }
     }
 
     ATOM_NODISCARD constexpr allocator_type get_allocator() const noexcept {
-        return dense_.get_allocator();
+        return alloc_;
     }
 
 private:
+    static constexpr size_t _npos = (std::numeric_limits<size_t>::max)();
+
+    /// how many keys ahead the dense slots are prefetched, twice that for the
+    /// sparse slots
+    static constexpr size_t _prefetch_distance = 8;
+
     constexpr static _kept_type _kept(key_type key) noexcept {
         return static_cast<_kept_type>(
             key & (std::numeric_limits<_kept_type>::max)());
@@ -411,6 +474,66 @@ private:
         return dense_[index].first == key;
     }
 
+    ATOM_NODISCARD constexpr size_t _index_of(key_type key) const noexcept {
+        const auto kept   = _kept(key);
+        const auto page   = _page_of(kept);
+        const auto offset = _offset_of(kept);
+        return _contains(key, page, offset)
+                   ? static_cast<size_t>(sparse_[page]->at(offset))
+                   : _npos;
+    }
+
+    void _prefetch_sparse(key_type key) const noexcept {
+        const auto kept = _kept(key);
+        const auto page = _page_of(kept);
+        if (page < sparse_.size()) {
+            ATOM_PREFETCH(sparse_[page]->data() + _offset_of(kept));
+        }
+    }
+
+    void _prefetch_dense(key_type key) const noexcept {
+        const auto kept = _kept(key);
+        const auto page = _page_of(kept);
+        if (page < sparse_.size()) {
+            const auto index =
+                static_cast<size_t>(sparse_[page]->at(_offset_of(kept)));
+            if (index < dense_.size()) {
+                ATOM_PREFETCH(dense_.data() + index);
+            }
+        }
+    }
+
+    /// Calls `fn(index)` for each key, `_npos` for the missing ones.
+    template <typename Fn>
+    constexpr void
+        _lookup_batch(std::span<const key_type> keys, Fn&& fn) const {
+        const size_t count = keys.size();
+        if (std::is_constant_evaluated() || dense_.empty()) {
+            for (size_t i = 0; i < count; ++i) {
+                fn(_index_of(keys[i]));
+            }
+            return;
+        }
+
+        constexpr size_t near = _prefetch_distance;
+        constexpr size_t far  = _prefetch_distance * 2;
+        for (size_t i = 0; i < count && i < far; ++i) {
+            _prefetch_sparse(keys[i]);
+        }
+        for (size_t i = 0; i < count && i < near; ++i) {
+            _prefetch_dense(keys[i]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (i + far < count) {
+                _prefetch_sparse(keys[i + far]);
+            }
+            if (i + near < count) {
+                _prefetch_dense(keys[i + near]);
+            }
+            fn(_index_of(keys[i]));
+        }
+    }
+
     template <typename... Args>
     constexpr std::pair<iterator, bool> _emplace_one_at_back(
         key_type key, _kept_type kept, size_type page, size_type offset,
@@ -418,10 +541,10 @@ private:
         auto dense_guard = make_exception_guard([this] { dense_.pop_back(); });
         const auto index = dense_.size();
         if constexpr (std::is_constructible_v<value_type, key_type, Args...>) {
-            dense_.emplace_back(key, std::forward<Args>(args)...);
+            dense_.emplace_back(alloc_, key, std::forward<Args>(args)...);
         } else {
             dense_.emplace_back(
-                std::piecewise_construct, std::forward_as_tuple(key),
+                alloc_, std::piecewise_construct, std::forward_as_tuple(key),
                 std::forward_as_tuple(std::forward<Args>(args)...));
         }
         _set_index(kept, page, offset, index);
@@ -455,14 +578,83 @@ private:
 
     constexpr void _pop_page_to(size_type page) noexcept {
         while (sparse_.size() != page) {
+            _delete_page(sparse_.back());
             sparse_.pop_back();
         }
     }
 
+    /// Allocates every page up to `page`.
     constexpr void _check_page(size_type page) {
+        if (page < sparse_.size()) [[likely]] {
+            return;
+        }
+        if (page >= sparse_.capacity()) {
+            const size_t doubled = size_t{ sparse_.capacity() } * 2;
+            sparse_.reserve(alloc_, (std::max)(size_t{ page } + 1, doubled));
+        }
         while (page >= sparse_.size()) {
-            sparse_.emplace_back(immediately);
+            sparse_.push_back(alloc_, _new_page());
+        }
+    }
+
+    template <typename... Args>
+    constexpr _array_t* _new_page(const Args&... args) {
+        _page_alloc_t alloc{ alloc_ };
+        auto* const page = _page_alloc_traits::allocate(alloc, 1);
+        _page_alloc_traits::construct(alloc, page, args...);
+        return page;
+    }
+
+    constexpr void _delete_page(_array_t* page) noexcept {
+        _page_alloc_t alloc{ alloc_ };
+        _page_alloc_traits::destroy(alloc, page);
+        _page_alloc_traits::deallocate(alloc, page, 1);
+    }
+
+    /// Gives the memory back, leaving the map empty.
+    constexpr void _release() noexcept {
+        for (auto* const page : sparse_) {
+            _delete_page(page);
+        }
+        sparse_.reset(alloc_);
+        dense_.reset(alloc_);
+    }
+
+    /// Indexes the elements of `dense_`, freeing everything if it throws.
+    constexpr void _init_sparse() {
+        auto guard = make_exception_guard([this] { _release(); });
+        _set_sparse(0);
+        guard.mark_complete();
+    }
+
+    /// Copies the pages of `that`, whose elements are already in `dense_`.
+    constexpr void _copy_pages(const shift_map& that) {
+        auto guard = make_exception_guard([this] { _release(); });
+        sparse_.reserve(alloc_, that.sparse_.size());
+        for (const auto* const page : that.sparse_) {
+            sparse_.push_back(alloc_, _new_page(*page));
+        }
+        guard.mark_complete();
+    }
+
+    /// Copies `that` into this empty map.
+    constexpr void _copy_from(const shift_map& that) {
+        dense_ = _dense_type{ that.dense_, alloc_ };
+        _copy_pages(that);
+    }
+
+    /// Moves `that` into this empty map, stealing its memory if the
+    /// allocators are equal.
+    constexpr void _move_from(shift_map& that) {
+        if (alloc_ == that.alloc_) {
+            dense_  = std::move(that.dense_);
+            sparse_ = std::move(that.sparse_);
+            return;
         }
+        dense_ = _dense_type{ std::make_move_iterator(that.dense_.begin()),
+                              std::make_move_iterator(that.dense_.end()),
+                              alloc_ };
+        _copy_pages(that);
     }
 
     constexpr void _set_sparse(size_t begin) {
@@ -485,6 +677,7 @@ private:
         }
     }
 
+    ATOM_NO_UNIQUE_ADDR allocator_type alloc_;
     _dense_type dense_;
     _sparse_type sparse_;
 };
@@ -3,15 +3,18 @@
 #include <cassert>
 #include <concepts>
 #include <cstddef>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <ranges>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include "neutron/detail/concepts/allocator.hpp"
 #include "neutron/detail/concepts/nothrow_conditional_movable.hpp"
+#include "neutron/detail/concepts/trivially_relocatable.hpp"
 #include "neutron/detail/iterator/iter_wrapper.hpp"
 #include "neutron/detail/macros.hpp"
 #include "neutron/detail/memory/using_allocator.hpp"
@@ -314,6 +317,44 @@ public:
         return _insert_with_size(pos, ilist.begin(), ilist.end());
     }
 
+    /**
+     * @brief Appends the elements of `range` at the end.
+     * @details A range knowing its size grows the vector at most once before
+     * copying, others are appended element by element.
+     */
+    template <std::ranges::input_range Range>
+    requires std::constructible_from<Ty, std::ranges::range_reference_t<Range>>
+    void append_range(Range&& range) {
+        if constexpr (
+            std::ranges::forward_range<Range> ||
+            std::ranges::sized_range<Range>) {
+            const auto count =
+                static_cast<size_type>(std::ranges::distance(range));
+            if (size_ + count > capacity_) {
+                _relocate((std::max)(capacity_ << 1, size_ + count));
+            }
+            auto first = std::ranges::begin(range);
+            if constexpr (
+                std::ranges::contiguous_range<Range> &&
+                std::same_as<std::ranges::range_value_t<Range>, Ty> &&
+                std::is_trivially_copyable_v<Ty>) {
+                if (count != 0) {
+                    std::memcpy(
+                        static_cast<void*>(data_ + size_),
+                        std::to_address(first), count * sizeof(Ty));
+                }
+            } else {
+                uninitialized_copy_n_using_allocator(
+                    alloc_, first, count, data_ + size_);
+            }
+            size_ += count;
+        } else {
+            for (auto&& element : range) {
+                emplace_back(std::forward<decltype(element)>(element));
+            }
+        }
+    }
+
     template <typename... Args>
     reference emplace_back(Args&&... args) /* strong grantee */ {
         if (size_ == capacity_) {
@@ -410,9 +451,13 @@ public:
             } else {
                 ptr = alloc_.allocate(size_);
             }
-            uninitialized_move_if_noexcept_n_using_allocator(
-                alloc_, data_, size_, ptr);
-            std::destroy_n(data_, size_);
+            if constexpr (trivially_relocatable<Ty>) {
+                _relocate_n(data_, size_, ptr);
+            } else {
+                uninitialized_move_if_noexcept_n_using_allocator(
+                    alloc_, data_, size_, ptr);
+                std::destroy_n(data_, size_);
+            }
             alloc_.deallocate(data_, capacity_);
             data_     = ptr;
             capacity_ = std::max(size_, Count);
@@ -451,6 +496,21 @@ public:
         size_ = count;
     }
 
+    /**
+     * @brief Resizes the container without initializing the new elements.
+     * @details For buffers about to be overwritten, such as the destination
+     * of a `memcpy` or of a parallel fill, so they are not zeroed first.
+     */
+    void resize_uninitialized(size_type count)
+    requires std::is_trivially_default_constructible_v<Ty> &&
+             std::is_trivially_destructible_v<Ty>
+    {
+        if (count > capacity_) {
+            _relocate(count);
+        }
+        size_ = count;
+    }
+
     // erase API (single and range)
     iterator erase(const_iterator pos) {
         if (pos == end()) [[unlikely]] {
@@ -568,15 +628,32 @@ private:
         size_ = 0;
     }
 
+    /**
+     * @brief Moves `count` trivially relocatable elements to `dst`, ending the
+     * lifetime of the ones in `src`.
+     */
+    static void _relocate_n(Ty* src, size_type count, Ty* dst) noexcept {
+        if (count != 0) {
+            std::memcpy(
+                static_cast<void*>(dst), static_cast<const void*>(src),
+                count * sizeof(Ty));
+        }
+    }
+
     void _relocate(size_type capacity) /* strong grantee */ {
-        auto* ptr  = alloc_.allocate(capacity);
-        auto guard = make_exception_guard([this, ptr, capacity]() noexcept {
-            alloc_.deallocate(ptr, capacity);
-        });
-        uninitialized_move_if_noexcept_n_using_allocator(
-            alloc_, data_, size_, ptr);
-        guard.mark_complete();
-        std::destroy_n(data_, size_);
+        auto* ptr = alloc_.allocate(capacity);
+        if constexpr (trivially_relocatable<Ty>) {
+            _relocate_n(data_, size_, ptr);
+        } else {
+            auto guard =
+                make_exception_guard([this, ptr, capacity]() noexcept {
+                    alloc_.deallocate(ptr, capacity);
+                });
+            uninitialized_move_if_noexcept_n_using_allocator(
+                alloc_, data_, size_, ptr);
+            guard.mark_complete();
+            std::destroy_n(data_, size_);
+        }
         if (!_uses_buffer()) {
             alloc_.deallocate(data_, capacity_);
         }
@@ -704,14 +781,23 @@ private:
         Ty* const ptr            = alloc_.allocate(capacity);
         auto guard               = make_exception_guard(
             [this, ptr, capacity] { alloc_.deallocate(ptr, capacity); });
-        uninitialized_move_if_noexcept_n_using_allocator(
-            alloc_, data_, index, ptr);
-        auto it = uninitialized_copy_using_allocator(
-            alloc_, first, last, ptr + index);
-        uninitialized_move_if_noexcept_n_using_allocator(
-            alloc_, data_ + index, size_ - index, it);
-        guard.mark_complete();
-        std::destroy_n(data_, size_);
+        if constexpr (trivially_relocatable<Ty>) {
+            // the new elements may come from the old ones, copy them first
+            uninitialized_copy_using_allocator(
+                alloc_, first, last, ptr + index);
+            guard.mark_complete();
+            _relocate_n(data_, index, ptr);
+            _relocate_n(data_ + index, size_ - index, ptr + index + count);
+        } else {
+            uninitialized_move_if_noexcept_n_using_allocator(
+                alloc_, data_, index, ptr);
+            auto it = uninitialized_copy_using_allocator(
+                alloc_, first, last, ptr + index);
+            uninitialized_move_if_noexcept_n_using_allocator(
+                alloc_, data_ + index, size_ - index, it);
+            guard.mark_complete();
+            std::destroy_n(data_, size_);
+        }
         if (!_uses_buffer()) {
             alloc_.deallocate(data_, capacity_);
         }
@@ -726,13 +812,22 @@ private:
         Ty* const ptr            = alloc_.allocate(capacity);
         auto guard               = make_exception_guard(
             [this, ptr, capacity] { alloc_.deallocate(ptr, capacity); });
-        uninitialized_move_if_noexcept_n_using_allocator(
-            alloc_, data_, index, ptr);
-        uninitialized_fill_n_using_allocator(alloc_, ptr + index, count, value);
-        uninitialized_move_if_noexcept_n_using_allocator(
-            alloc_, data_ + index, size_ - index, ptr + index + count);
-        guard.mark_complete();
-        std::destroy_n(data_, size_);
+        if constexpr (trivially_relocatable<Ty>) {
+            uninitialized_fill_n_using_allocator(
+                alloc_, ptr + index, count, value);
+            guard.mark_complete();
+            _relocate_n(data_, index, ptr);
+            _relocate_n(data_ + index, size_ - index, ptr + index + count);
+        } else {
+            uninitialized_move_if_noexcept_n_using_allocator(
+                alloc_, data_, index, ptr);
+            uninitialized_fill_n_using_allocator(
+                alloc_, ptr + index, count, value);
+            uninitialized_move_if_noexcept_n_using_allocator(
+                alloc_, data_ + index, size_ - index, ptr + index + count);
+            guard.mark_complete();
+            std::destroy_n(data_, size_);
+        }
         if (!_uses_buffer()) {
             alloc_.deallocate(data_, capacity_);
         }
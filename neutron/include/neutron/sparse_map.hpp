@@ -3,20 +3,22 @@
 #include <concepts>
 #include <initializer_list>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <memory_resource>
+#include <span>
 #include <tuple>
 #include <type_traits>
 #include <utility>
-#include <vector>
+#include "neutron/bare_vector.hpp"
 #include "neutron/detail/concepts/allocator.hpp"
 #include "neutron/detail/concepts/pair.hpp"
 #include "neutron/detail/macros.hpp"
 #include "neutron/detail/mask.hpp"
 #include "neutron/detail/memory/rebind_alloc.hpp"
-#include "neutron/detail/memory/unique_storage.hpp"
 #include "neutron/detail/utility/compressed_pair.hpp"
 #include "neutron/detail/utility/const_identity.hpp"
+#include "neutron/detail/utility/exception_guard.hpp"
 
 #if ATOM_HAS_CXX23
     #include "neutron/detail/concepts/map_like.hpp"
@@ -25,6 +27,13 @@
 
 namespace neutron {
 
+/**
+ * @brief A sparse set mapping unsigned keys to values.
+ * @details The values are kept together with their keys in a dense vector,
+ * indexed by pages of a sparse vector, allocated on first use. Both are
+ * `bare_vector`s with 32-bit sizes sharing the allocator of the map, so an
+ * empty map takes 32 bytes with `std::allocator`.
+ */
 template <
     std::unsigned_integral Kty, typename Ty, std::size_t PageSize = 32UL,
     std_simple_allocator Alloc = std::allocator<std::pair<const Kty, Ty>>>
@@ -35,9 +44,6 @@ public:
     template <typename T>
     using _allocator_t = rebind_alloc_t<Alloc, T>;
 
-    template <typename T>
-    using _vector_t = std::vector<T, _allocator_t<T>>;
-
     // clang-format off
 
     using key_type               = Kty;
@@ -46,7 +52,7 @@ public:
     using value_type             = std::pair<const key_type, mapped_type>;
     using _value_type            = std::pair<const_identity<key_type>, mapped_type>;
 
-    using _dense_type            = _vector_t<_value_type>;
+    using _dense_type            = bare_vector<_value_type>;
     using _dense_alloc_t         = _allocator_t<_value_type>;
     using _dense_alloc_traits_t  = std::allocator_traits<_dense_alloc_t>;
 
@@ -63,10 +69,9 @@ public:
     // the storage is effective when relocating, so we do not store the array directly.
 
     using _array_t               = std::array<key_type, PageSize>;
-    using _storage_t             = unique_storage<_array_t, _allocator_t<_array_t>>;
-    using _sparse_type           = _vector_t<_storage_t>;
-    using _sparse_alloc_t        = _allocator_t<_storage_t>;
-    using _sparse_alloc_traits   = std::allocator_traits<_sparse_alloc_t>;
+    using _page_alloc_t          = _allocator_t<_array_t>;
+    using _page_alloc_traits     = std::allocator_traits<_page_alloc_t>;
+    using _sparse_type           = bare_vector<_array_t*>; // null if unused
 
     using iterator               = typename _dense_type::iterator;
     using const_iterator         = typename _dense_type::const_iterator;
@@ -80,9 +85,7 @@ public:
      *
      */
     constexpr sparse_map() noexcept(
-        std::is_nothrow_default_constructible_v<_dense_type> &&
-        std::is_nothrow_default_constructible_v<_sparse_type>)
-        : dense_(), sparse_() {}
+        std::is_nothrow_default_constructible_v<allocator_type>) = default;
 
     /**
      * @brief Construct with allocator.
@@ -90,9 +93,8 @@ public:
      */
     template <typename Al>
     constexpr sparse_map(const Al& allocator) noexcept(
-        std::is_nothrow_constructible_v<_dense_type, _dense_alloc_t> &&
-        std::is_nothrow_constructible_v<_sparse_type, _sparse_alloc_t>)
-        : dense_(allocator), sparse_(allocator) {}
+        std::is_nothrow_constructible_v<allocator_type, const Al&>)
+        : alloc_(allocator) {}
 
     constexpr sparse_map(std::allocator_arg_t, const Alloc& alloc) noexcept(
         std::is_nothrow_constructible_v<sparse_map, Alloc>)
@@ -103,15 +105,9 @@ public:
      *
      */
     template <std::input_iterator Iter, typename Sentinel>
-    constexpr sparse_map(Iter first, Sentinel last, const Alloc& alloc) noexcept(
-        noexcept(sparse_map(std::allocator_arg, alloc, first, last)))
-        : dense_(first, last, alloc), sparse_(alloc) {
-        for (const auto& [key, val] : dense_) {
-            auto page   = _page_of(key);
-            auto offset = _offset_of(key);
-            _check_page(page);
-            sparse_[page]->at(offset) = dense_.size();
-        }
+    constexpr sparse_map(Iter first, Sentinel last, const Alloc& alloc)
+        : alloc_(alloc), dense_(first, last, alloc_) {
+        _init_sparse();
     }
 
     /**
@@ -139,14 +135,8 @@ public:
     requires std::convertible_to<Pair, value_type>
     constexpr sparse_map(
         std::initializer_list<Pair> list, const Al& allocator = Alloc{})
-        : dense_(list.begin(), list.end(), allocator), sparse_(allocator) {
-        for (auto i = 0; i < list.size(); ++i) {
-            const auto& [key, val] = dense_[i];
-            auto page              = _page_of(key);
-            auto offset            = _offset_of(key);
-            _check_page(page);
-            sparse_[page]->at(offset) = i;
-        }
+        : alloc_(allocator), dense_(list.begin(), list.end(), alloc_) {
+        _init_sparse();
     }
 
     template <typename Al, pair Pair = value_type>
@@ -156,34 +146,45 @@ public:
         : sparse_map(list, alloc) {}
 
     constexpr sparse_map(sparse_map&& that) noexcept
-        : dense_(std::move(that.dense_)), sparse_(std::move(that.sparse_)) {}
+        : alloc_(std::move(that.alloc_)), dense_(std::move(that.dense_)),
+          sparse_(std::move(that.sparse_)) {}
 
-    constexpr sparse_map& operator=(sparse_map&& that) noexcept {
+    constexpr sparse_map& operator=(sparse_map&& that) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value) {
         if (this != &that) {
-            dense_  = std::move(that.dense_);
-            sparse_ = std::move(that.sparse_);
+            _release();
+            if constexpr (alloc_traits::
+                              propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(that.alloc_);
+            }
+            _move_from(that);
         }
         return *this;
     }
 
     constexpr sparse_map(const sparse_map& that)
-        : dense_(that.dense_),
-          sparse_(that.sparse_.size(), that.sparse_.get_allocator()) {
-        for (const auto& page : that.sparse_) {
-            sparse_.emplace_back(*page);
-        }
+        : alloc_(alloc_traits::select_on_container_copy_construction(
+              that.alloc_)) {
+        _copy_from(that);
     }
 
+    /**
+     * @note Leaves the map empty if copying an element throws.
+     */
     constexpr sparse_map& operator=(const sparse_map& that) {
         if (this != &that) {
-            sparse_map temp(that);
-            std::swap(dense_, temp.dense_);
-            std::swap(sparse_, temp.sparse_);
+            _release();
+            if constexpr (alloc_traits::
+                              propagate_on_container_copy_assignment::value) {
+                alloc_ = that.alloc_;
+            }
+            _copy_from(that);
         }
         return *this;
     }
 
-    constexpr ~sparse_map() noexcept = default;
+    constexpr ~sparse_map() noexcept { _release(); }
 
     ATOM_NODISCARD constexpr auto at(const key_type key) -> Ty& {
         auto page   = _page_of(key);
@@ -226,12 +227,10 @@ public:
     template <compatible_range<value_type> Rng>
     constexpr void insert_range(Rng&& range) {
         const auto size = dense_.size();
-        dense_.append_range(std::forward<Rng>(range));
+        dense_.append_range(alloc_, std::forward<Rng>(range));
         for (auto i = size; i < dense_.size(); ++i) {
-            auto page   = _page_of(dense_[i].first);
-            auto offset = _offset_of(dense_[i].first);
-            _check_page(page);
-            sparse_[page]->at(offset) = dense_.size();
+            const auto key = static_cast<key_type>(dense_[i].first);
+            _set_index(_page_of(key), _offset_of(key), i);
         }
     }
 #endif
@@ -287,7 +286,7 @@ public:
     constexpr void reserve(const size_type size) {
         auto page = _page_of(size);
         _check_page(page);
-        dense_.reserve(size);
+        dense_.reserve(alloc_, size);
     }
 
     constexpr auto contains(const key_type key) const -> bool {
@@ -318,6 +317,52 @@ public:
         return dense_.end();
     }
 
+    /**
+     * @brief Finds every key of `keys`, writing an iterator to its element, or
+     * `end()`, to `out` for each.
+     *
+     * The lookups are pipelined: the sparse slots of the keys a few steps
+     * ahead and the dense slots of the keys closer ahead are prefetched while
+     * the current key is resolved, so the dependent cache misses of large
+     * batches overlap instead of adding up.
+     * @return `out` past the last iterator written.
+     */
+    template <std::output_iterator<iterator> Out>
+    constexpr Out find_batch(std::span<const key_type> keys, Out out) {
+        _lookup_batch(keys, [this, &out](size_t index) {
+            *out = index != _npos ? dense_.begin() + index : dense_.end();
+            ++out;
+        });
+        return out;
+    }
+
+    template <std::output_iterator<const_iterator> Out>
+    constexpr Out find_batch(std::span<const key_type> keys, Out out) const {
+        _lookup_batch(keys, [this, &out](size_t index) {
+            *out = index != _npos ? dense_.begin() + index : dense_.end();
+            ++out;
+        });
+        return out;
+    }
+
+    /**
+     * @brief Checks every key of `keys` like `find_batch`, writing whether it
+     * is contained to `out` for each.
+     * @return The number of keys contained.
+     */
+    template <std::output_iterator<bool> Out>
+    constexpr size_t
+        contains_batch(std::span<const key_type> keys, Out out) const {
+        size_t found = 0;
+        _lookup_batch(keys, [&out, &found](size_t index) {
+            const bool contained = index != _npos;
+            found               += contained;
+            *out                 = contained;
+            ++out;
+        });
+        return found;
+    }
+
     ATOM_NODISCARD constexpr bool empty() const noexcept {
         return dense_.empty();
     }
@@ -327,6 +372,9 @@ public:
     }
 
     constexpr void clear() noexcept {
+        for (auto* const page : sparse_) {
+            _delete_page(page);
+        }
         sparse_.clear();
         dense_.clear();
     }
@@ -389,13 +437,25 @@ public:
         return dense_.crend();
     }
 
-    constexpr void swap(sparse_map&) noexcept;
+    constexpr void swap(sparse_map& that) noexcept {
+        if constexpr (alloc_traits::propagate_on_container_swap::value) {
+            std::swap(alloc_, that.alloc_);
+        }
+        dense_.swap(that.dense_);
+        sparse_.swap(that.sparse_);
+    }
 
     ATOM_NODISCARD constexpr auto get_allocator() const noexcept {
-        return dense_.get_allocator();
+        return alloc_;
     }
 
 private:
+    static constexpr size_t _npos = (std::numeric_limits<size_t>::max)();
+
+    /// how many keys ahead the dense slots are prefetched, twice that for the
+    /// sparse slots
+    static constexpr size_t _prefetch_distance = 8;
+
     constexpr static size_type _page_of(const key_type key) noexcept {
         return _uint_dev<PageSize>(key);
     }
@@ -408,30 +468,87 @@ private:
         // page
 
         if (sparse_.size() > page) [[likely]] {
-            if (!static_cast<bool>(sparse_[page])) {
-                sparse_[page] = _storage_t{ immediately };
+            if (sparse_[page] == nullptr) {
+                sparse_[page] = _new_page();
             }
 
             return;
         }
 
-        const auto current_page_count = sparse_.size();
-        auto sparse_guard             = make_exception_guard(
-            [this, current_page_count] { _pop_page_to(current_page_count); });
+        if (page >= sparse_.capacity()) {
+            const size_t doubled = size_t{ sparse_.capacity() } * 2;
+            sparse_.reserve(alloc_, (std::max)(size_t{ page } + 1, doubled));
+        }
+        auto* const created = _new_page();
+        // no longer throws, the capacity is enough
+        sparse_.resize(alloc_, page, nullptr);
+        sparse_.push_back(alloc_, created);
+    }
+
+    template <typename... Args>
+    constexpr _array_t* _new_page(const Args&... args) {
+        _page_alloc_t alloc{ alloc_ };
+        auto* const page = _page_alloc_traits::allocate(alloc, 1);
+        _page_alloc_traits::construct(alloc, page, args...);
+        return page;
+    }
+
+    constexpr void _delete_page(_array_t* page) noexcept {
+        if (page != nullptr) {
+            _page_alloc_t alloc{ alloc_ };
+            _page_alloc_traits::destroy(alloc, page);
+            _page_alloc_traits::deallocate(alloc, page, 1);
+        }
+    }
+
+    /// Gives the memory back, leaving the map empty.
+    constexpr void _release() noexcept {
+        for (auto* const page : sparse_) {
+            _delete_page(page);
+        }
+        sparse_.reset(alloc_);
+        dense_.reset(alloc_);
+    }
 
-        if (sparse_.size() < page) {
-            sparse_.resize(page); // default construct to page
+    /// Indexes the elements of `dense_`, freeing everything if it throws.
+    constexpr void _init_sparse() {
+        auto guard = make_exception_guard([this] { _release(); });
+        for (size_t i = 0; i < dense_.size(); ++i) {
+            const auto key = static_cast<key_type>(dense_[i].first);
+            _set_index(_page_of(key), _offset_of(key), i);
         }
+        guard.mark_complete();
+    }
 
-        sparse_.emplace_back(immediately); // make sure page is accessible
+    /// Copies the pages of `that`, whose elements are already in `dense_`.
+    constexpr void _copy_pages(const sparse_map& that) {
+        auto guard = make_exception_guard([this] { _release(); });
+        sparse_.reserve(alloc_, that.sparse_.size());
+        for (const auto* const page : that.sparse_) {
+            sparse_.push_back(
+                alloc_, page != nullptr ? _new_page(*page) : nullptr);
+        }
+        guard.mark_complete();
+    }
 
-        sparse_guard.mark_complete();
+    /// Copies `that` into this empty map.
+    constexpr void _copy_from(const sparse_map& that) {
+        dense_ = _dense_type{ that.dense_, alloc_ };
+        _copy_pages(that);
     }
 
-    constexpr void _pop_page_to(const size_type page) noexcept {
-        while (sparse_.size() != page) [[likely]] {
-            sparse_.pop_back();
+    /// Moves `that` into this empty map, stealing its memory if the
+    /// allocators are equal.
+    constexpr void _move_from(sparse_map& that) {
+        if (alloc_ == that.alloc_) {
+            dense_  = std::move(that.dense_);
+            sparse_ = std::move(that.sparse_);
+            return;
         }
+        dense_ = _dense_type{ std::make_move_iterator(that.dense_.begin()),
+                              std::make_move_iterator(that.dense_.end()),
+                              alloc_ };
+        _copy_pages(that);
     }
 
     ATOM_NODISCARD constexpr auto _contains_impl(
@@ -444,6 +561,64 @@ private:
         return sparse_[page] && dense_[sparse_[page]->at(offset)].first == key;
     }
 
+    ATOM_NODISCARD constexpr size_t
+        _index_of(const key_type key) const noexcept {
+        const auto page   = _page_of(key);
+        const auto offset = _offset_of(key);
+        return _contains_impl(key, page, offset)
+                   ? static_cast<size_t>(sparse_[page]->at(offset))
+                   : _npos;
+    }
+
+    void _prefetch_sparse(const key_type key) const noexcept {
+        const auto page = _page_of(key);
+        if (page < sparse_.size() && sparse_[page]) {
+            ATOM_PREFETCH(sparse_[page]->data() + _offset_of(key));
+        }
+    }
+
+    void _prefetch_dense(const key_type key) const noexcept {
+        const auto page = _page_of(key);
+        if (page < sparse_.size() && sparse_[page]) {
+            const auto index =
+                static_cast<size_t>(sparse_[page]->at(_offset_of(key)));
+            if (index < dense_.size()) {
+                ATOM_PREFETCH(dense_.data() + index);
+            }
+        }
+    }
+
+    /// Calls `fn(index)` for each key, `_npos` for the missing ones.
+    template <typename Fn>
+    constexpr void
+        _lookup_batch(std::span<const key_type> keys, Fn&& fn) const {
+        const size_t count = keys.size();
+        if (std::is_constant_evaluated() || dense_.empty()) {
+            for (size_t i = 0; i < count; ++i) {
+                fn(_index_of(keys[i]));
+            }
+            return;
+        }
+
+        constexpr size_t near = _prefetch_distance;
+        constexpr size_t far  = _prefetch_distance * 2;
+        for (size_t i = 0; i < count && i < far; ++i) {
+            _prefetch_sparse(keys[i]);
+        }
+        for (size_t i = 0; i < count && i < near; ++i) {
+            _prefetch_dense(keys[i]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (i + far < count) {
+                _prefetch_sparse(keys[i + far]);
+            }
+            if (i + near < count) {
+                _prefetch_dense(keys[i + near]);
+            }
+            fn(_index_of(keys[i]));
+        }
+    }
+
     template <typename... Args>
     constexpr std::pair<iterator, bool> _emplace_one_at_back(
         const key_type key, const size_type page, const size_type offset,
@@ -451,7 +626,7 @@ private:
         auto dense_guard = make_exception_guard([this] { dense_.pop_back(); });
         const auto index = dense_.size();
         dense_.emplace_back(
-            std::piecewise_construct, std::forward_as_tuple(key),
+            alloc_, std::piecewise_construct, std::forward_as_tuple(key),
             std::forward_as_tuple(std::forward<Args>(args)...));
         _set_index(page, offset, index);
         dense_guard.mark_complete();
@@ -481,6 +656,7 @@ private:
         return dense_.begin() + backup;
     }
 
+    ATOM_NO_UNIQUE_ADDR allocator_type alloc_;
     _dense_type dense_;
     _sparse_type sparse_;
 };
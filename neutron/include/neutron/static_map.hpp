@@ -0,0 +1,326 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include "neutron/detail/macros.hpp"
+#include "neutron/detail/reflection/legacy/hash_of.hpp"
+#include "neutron/tstring.hpp"
+
+namespace neutron {
+
+/*! @cond TURN_OFF_DOXYGEN */
+namespace _static_map {
+
+constexpr uint64_t _golden = 0x9e3779b97f4a7c15;
+
+/// splitmix64 finalizer
+constexpr uint64_t _mix(uint64_t value) noexcept {
+    value ^= value >> 30U;
+    value *= 0xbf58476d1ce4e5b9;
+    value ^= value >> 27U;
+    value *= 0x94d049bb133111eb;
+    value ^= value >> 31U;
+    return value;
+}
+
+constexpr uint64_t _hash(std::string_view key, uint64_t seed) noexcept {
+    // fnv1a over a seeded basis, mixed so every bit depends on every byte
+    uint64_t value = 0xcbf29ce484222325 ^ seed;
+    for (const char ch : key) {
+        value ^= static_cast<uint8_t>(ch);
+        value *= 0x100000001b3;
+    }
+    return _mix(value);
+}
+
+constexpr uint64_t _hash(uint64_t key, uint64_t seed) noexcept {
+    return _mix(key ^ seed);
+}
+
+/// `value * count / 2^32`, a division-free `value % count`.
+constexpr size_t _range(uint32_t value, size_t count) noexcept {
+    return static_cast<size_t>((static_cast<uint64_t>(value) * count) >> 32U);
+}
+
+/**
+ * @brief A minimal perfect hash of `Count` keys, in the CHD or PTHash style.
+ * @details Keys are spread over buckets of about four by their hash. Every
+ * bucket has a pilot, chosen at compile time so that rehashing its keys with
+ * the pilot sends each of them to a slot no other key occupies. The slots are
+ * exactly as many as the keys.
+ */
+template <size_t Count>
+struct _layout {
+    static constexpr size_t buckets = (Count / 4) + 1;
+
+    uint64_t seed = 0;
+    std::array<uint16_t, buckets> pilots{};
+    std::array<uint32_t, Count> index{}; ///< Key stored in every slot.
+    bool unique = true;
+    bool built  = false;
+
+    ATOM_NODISCARD constexpr size_t bucket(uint64_t hash) const noexcept {
+        return _range(static_cast<uint32_t>(hash), buckets);
+    }
+
+    ATOM_NODISCARD static constexpr size_t
+        slot(uint64_t hash, uint16_t pilot) noexcept {
+        return _range(
+            static_cast<uint32_t>(_mix(hash ^ (pilot * _golden)) >> 32U),
+            Count);
+    }
+
+    ATOM_NODISCARD constexpr size_t slot(uint64_t hash) const noexcept {
+        return slot(hash, pilots[bucket(hash)]);
+    }
+};
+
+template <typename Key, size_t Count>
+consteval _layout<Count> _build(const std::array<Key, Count>& keys) {
+    using layout_t = _layout<Count>;
+    layout_t layout;
+    for (size_t i = 0; i < Count; ++i) {
+        for (size_t j = i + 1; j < Count; ++j) {
+            if (keys[i] == keys[j]) {
+                layout.unique = false;
+                return layout;
+            }
+        }
+    }
+
+    constexpr uint32_t max_pilot = UINT16_MAX;
+    for (uint64_t attempt = 1; attempt <= 64; ++attempt) {
+        layout.seed = _mix(attempt * _golden);
+        std::array<uint64_t, Count> hashes{};
+        std::array<size_t, layout_t::buckets> sizes{};
+        for (size_t i = 0; i < Count; ++i) {
+            hashes[i] = _hash(keys[i], layout.seed);
+            ++sizes[layout.bucket(hashes[i])];
+        }
+
+        // largest buckets first, while most slots are still free
+        std::array<size_t, layout_t::buckets> order{};
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            return sizes[lhs] != sizes[rhs] ? sizes[lhs] > sizes[rhs]
+                                            : lhs < rhs;
+        });
+
+        std::array<bool, Count> taken{};
+        std::array<size_t, Count> members{};
+        std::array<size_t, Count> slots{};
+        bool placed = true;
+        for (const auto bucket : order) {
+            if (sizes[bucket] == 0) {
+                break;
+            }
+            size_t count = 0;
+            for (size_t i = 0; i < Count; ++i) {
+                if (layout.bucket(hashes[i]) == bucket) {
+                    members[count++] = i;
+                }
+            }
+
+            bool found = false;
+            for (uint32_t pilot = 0; pilot <= max_pilot && !found; ++pilot) {
+                found = true;
+                for (size_t i = 0; i < count && found; ++i) {
+                    slots[i] = layout_t::slot(
+                        hashes[members[i]], static_cast<uint16_t>(pilot));
+                    found = !taken[slots[i]];
+                    for (size_t j = 0; j < i && found; ++j) {
+                        found = slots[j] != slots[i];
+                    }
+                }
+                if (found) {
+                    layout.pilots[bucket] = static_cast<uint16_t>(pilot);
+                }
+            }
+            if (!found) {
+                placed = false;
+                break;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                taken[slots[i]]        = true;
+                layout.index[slots[i]] = static_cast<uint32_t>(members[i]);
+            }
+        }
+        if (placed) {
+            layout.built = true;
+            return layout;
+        }
+        layout.pilots = {};
+    }
+    return layout;
+}
+
+/// Lookup over the keys of `Map`, shared by the string and type maps.
+template <typename Map, typename Key, size_t Count>
+struct _base {
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    ATOM_NODISCARD static constexpr size_t size() noexcept { return Count; }
+
+    ATOM_NODISCARD static constexpr bool empty() noexcept {
+        return Count == 0;
+    }
+
+    /**
+     * @brief Position of `key` among the keys of the map, `npos` if it is
+     * not one of them.
+     * @details One hash, one read of a pilot and one comparison with the
+     * key in the slot it leads to, whether the key is found or not.
+     */
+    ATOM_NODISCARD static constexpr size_t index_of(Key key) noexcept {
+        if constexpr (Count == 0) {
+            return npos;
+        } else {
+            const auto hash = _hash(key, Map::_layout.seed);
+            const auto slot = Map::_layout.slot(hash);
+            return Map::_slot_keys[slot] == key ? Map::_layout.index[slot]
+                                                : npos;
+        }
+    }
+
+    ATOM_NODISCARD static constexpr bool contains(Key key) noexcept {
+        return index_of(key) != npos;
+    }
+
+    /**
+     * @brief Values of type `Value` indexed by the keys of the map, given in
+     * the order of the keys.
+     */
+    template <typename Value>
+    struct table {
+        std::array<Value, Count> values;
+
+        ATOM_NODISCARD constexpr const Value* find(Key key) const noexcept {
+            const auto index = index_of(key);
+            return index != npos ? values.data() + index : nullptr;
+        }
+
+        ATOM_NODISCARD constexpr Value* find(Key key) noexcept {
+            const auto index = index_of(key);
+            return index != npos ? values.data() + index : nullptr;
+        }
+
+        ATOM_NODISCARD constexpr bool contains(Key key) const noexcept {
+            return index_of(key) != npos;
+        }
+
+        ATOM_NODISCARD static constexpr size_t size() noexcept {
+            return Count;
+        }
+    };
+};
+
+} // namespace _static_map
+/*! @endcond */
+
+/**
+ * @class static_map
+ * @brief A set of string keys known at compile time, mapped to their
+ * position in `Keys` through a minimal perfect hash built at compile time.
+ * @details Replaces the `unordered_map` built at runtime for component names
+ * to ids, configuration keys or member names to indices. `table<Value>`
+ * pairs the keys with values.
+ * @code
+ * using fields = static_map<"position", "velocity", "mass">;
+ * static_assert(fields::index_of("velocity") == 1);
+ * constexpr fields::table<float> defaults{ { 0.F, 0.F, 1.F } };
+ * @endcode
+ */
+template <tstring... Keys>
+class static_map :
+    public _static_map::_base<
+        static_map<Keys...>, std::string_view, sizeof...(Keys)> {
+    friend struct _static_map::_base<
+        static_map, std::string_view, sizeof...(Keys)>;
+
+    static constexpr size_t _count = sizeof...(Keys);
+
+    static constexpr std::array<std::string_view, _count> _keys{
+        Keys.view()...
+    };
+
+    static constexpr auto _layout = _static_map::_build(_keys);
+    static_assert(_layout.unique, "the keys of a static_map must be unique");
+    static_assert(_layout.built, "no perfect hash found for these keys");
+
+    static constexpr auto _slot_keys = [] {
+        std::array<std::string_view, _count> keys{};
+        for (size_t slot = 0; slot < _count; ++slot) {
+            keys[slot] = _keys[_layout.index[slot]];
+        }
+        return keys;
+    }();
+
+public:
+    /**
+     * @brief The key at position `index`.
+     */
+    ATOM_NODISCARD static constexpr std::string_view
+        key(size_t index) noexcept {
+        return _keys[index];
+    }
+
+    ATOM_NODISCARD static constexpr const auto& keys() noexcept {
+        return _keys;
+    }
+};
+
+/**
+ * @class static_type_map
+ * @brief The types `Tys` mapped to their position, looked up by `hash_of`.
+ * @details Fits hashes coming back at runtime, such as the ones stored by a
+ * snapshot or sent over the network.
+ */
+template <typename... Tys>
+class static_type_map :
+    public _static_map::_base<
+        static_type_map<Tys...>, uint64_t, sizeof...(Tys)> {
+    friend struct _static_map::_base<
+        static_type_map, uint64_t, sizeof...(Tys)>;
+
+    static constexpr size_t _count = sizeof...(Tys);
+
+    static constexpr std::array<uint64_t, _count> _keys{ static_cast<uint64_t>(
+        hash_of<Tys>())... };
+
+    static constexpr auto _layout = _static_map::_build(_keys);
+    static_assert(_layout.unique, "the types of a static_type_map collide");
+    static_assert(_layout.built, "no perfect hash found for these types");
+
+    static constexpr auto _slot_keys = [] {
+        std::array<uint64_t, _count> keys{};
+        for (size_t slot = 0; slot < _count; ++slot) {
+            keys[slot] = _keys[_layout.index[slot]];
+        }
+        return keys;
+    }();
+
+public:
+    /**
+     * @brief Position of `Ty`, resolved at compile time.
+     */
+    template <typename Ty>
+    ATOM_NODISCARD static consteval size_t index_of() noexcept {
+        return static_type_map::_base::index_of(hash_of<Ty>());
+    }
+
+    using _static_map::_base<static_type_map, uint64_t, _count>::index_of;
+
+    template <typename Ty>
+    ATOM_NODISCARD static consteval bool contains() noexcept {
+        return index_of<Ty>() != static_type_map::npos;
+    }
+
+    using _static_map::_base<static_type_map, uint64_t, _count>::contains;
+};
+
+} // namespace neutron
@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include <neutron/bare_vector.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+void test_bare_vector();
+void test_bare_vector_strings();
+void test_bare_vector_rebind();
+
+int main() {
+    test_bare_vector();
+    test_bare_vector_strings();
+    test_bare_vector_rebind();
+    return 0;
+}
+
+void test_bare_vector() {
+    static_assert(sizeof(bare_vector<int>) == 16);
+
+    constexpr auto result = [] {
+        std::allocator<int> alloc;
+        bare_vector<int> vec;
+        for (int i = 0; i < 100; ++i) {
+            vec.push_back(alloc, i);
+        }
+        vec.erase(vec.begin());
+        vec.insert(alloc, vec.begin(), { -2, -1 });
+        const auto size = vec.size();
+        const auto sum  = vec[0] + vec[1] + vec.back();
+        vec.reset(alloc);
+        return std::make_pair(size, sum);
+    }();
+    static_assert(result.first == 101);
+    static_assert(result.second == 96);
+
+    std::allocator<int> alloc;
+    bare_vector<int> vec{ { 1, 2, 3 }, alloc };
+    require(vec.size() == 3);
+    require_false(vec.empty());
+    vec.resize(alloc, 6, 7);
+    require(vec.size() == 6);
+    require(vec[5] == 7);
+    vec.insert(alloc, vec.begin() + 1, vec.back());
+    require(vec[1] == 7);
+    vec.erase(vec.begin() + 1, vec.begin() + 3);
+    require(vec.size() == 5);
+    require(vec[1] == 3);
+    require(*vec.rbegin() == 7);
+    vec.shrink_to_fit(alloc);
+    require(vec.capacity() == vec.size());
+    vec.clear();
+    require(vec.empty());
+    vec.reset(alloc);
+    require(vec.data() == nullptr);
+}
+
+void test_bare_vector_strings() {
+    std::allocator<std::string> alloc;
+    bare_vector<std::string> vec;
+    for (int i = 0; i < 50; ++i) {
+        vec.emplace_back(alloc, "a long enough string to allocate " +
+                                    std::to_string(i));
+    }
+    // the argument refers to an element moved by the growth
+    while (vec.size() != vec.capacity()) {
+        vec.push_back(alloc, vec.front());
+    }
+    vec.push_back(alloc, vec.front());
+    require(vec.back() == vec.front());
+
+    const std::vector<std::string> more{ "x", "y" };
+    vec.insert_range(alloc, vec.begin(), more);
+    require(vec[0] == "x");
+    require(vec[2] == "a long enough string to allocate 0");
+
+    bare_vector<std::string> copy{ vec, alloc };
+    require(copy.size() == vec.size());
+    bare_vector<std::string> moved{ std::move(copy) };
+    require(copy.data() == nullptr);
+    require(moved[1] == "y");
+    moved.reset(alloc);
+    vec.reset(alloc);
+}
+
+void test_bare_vector_rebind() {
+    // one allocator, of any value type, serves vectors of any element
+    std::pmr::unsynchronized_pool_resource pool;
+    std::pmr::polymorphic_allocator<> alloc{ &pool };
+    bare_vector<uint64_t> keys;
+    bare_vector<std::pmr::string> names;
+    for (uint64_t i = 0; i < 20; ++i) {
+        keys.push_back(alloc, i);
+        names.emplace_back(alloc, "a name longer than the small buffer");
+    }
+    require(names[3].get_allocator().resource() == &pool);
+    require(keys[19] == 19);
+    keys.reset(alloc);
+    names.reset(alloc);
+}
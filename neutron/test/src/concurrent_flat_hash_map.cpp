@@ -0,0 +1,201 @@
+// Tests for concurrent_flat_hash_map: lookups, growth, erasure and readers
+// racing a writer
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <neutron/concurrent_flat_hash_map.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+void test_basic();
+void test_growth();
+void test_erase();
+void test_strings();
+void test_transparent();
+void test_concurrent();
+
+int main() {
+    test_basic();
+    test_growth();
+    test_erase();
+    test_strings();
+    test_transparent();
+    test_concurrent();
+    return 0;
+}
+
+void test_basic() {
+    concurrent_flat_hash_map<uint32_t, uint64_t> map{ 4 };
+    require(map.shard_count() == 4);
+    require(map.empty());
+    require_false(map.find(1).has_value());
+
+    require(map.try_emplace(1, 10U));
+    require_false(map.try_emplace(1, 11U));
+    require(map.find(1) == 10U);
+
+    require_false(map.insert_or_assign(1, 12U));
+    require(map.find(1) == 12U);
+    require(map.insert({ 2, 20 }));
+    require(map.contains(2));
+    require(map.size() == 2);
+
+    uint64_t seen = 0;
+    require(map.visit(2, [&seen](uint64_t value) { seen = value; }));
+    require(seen == 20);
+
+    map.clear();
+    require(map.empty());
+    require_false(map.contains(1));
+    require(map.try_emplace(1, 13U));
+    require(map.find(1) == 13U);
+}
+
+void test_growth() {
+    concurrent_flat_hash_map<uint32_t, uint32_t> map{ 2 };
+    constexpr uint32_t count = 20000;
+    bool migrated            = false;
+    for (uint32_t i = 0; i < count; ++i) {
+        require(map.try_emplace(i, i * 3));
+        migrated = migrated || map.migrating();
+        // every key stays visible while shards move to larger tables
+        if (i % 997 == 0) {
+            for (uint32_t j = 0; j <= i; j += 61) {
+                require(map.find(j) == j * 3);
+            }
+        }
+    }
+    require(migrated);
+    require(map.size() == count);
+    for (uint32_t i = 0; i < count; ++i) {
+        require(map.find(i) == i * 3);
+    }
+
+    size_t visited = 0;
+    uint64_t sum   = 0;
+    map.for_each([&](uint32_t key, uint32_t value) {
+        require(value == key * 3);
+        ++visited;
+        sum += key;
+    });
+    require(visited == count);
+    require(sum == uint64_t{ count } * (count - 1) / 2);
+    map.quiescent();
+}
+
+void test_erase() {
+    concurrent_flat_hash_map<uint32_t, uint32_t> map{ 1 };
+    constexpr uint32_t count = 5000;
+    for (uint32_t i = 0; i < count; ++i) {
+        map.try_emplace(i, i);
+        // erase every third key, also in the middle of a migration
+        if (i % 3 == 0) {
+            require(map.erase(i));
+        }
+    }
+    require_false(map.erase(0));
+    for (uint32_t i = 0; i < count; ++i) {
+        require(map.contains(i) == (i % 3 != 0));
+    }
+    require(map.size() == count - ((count + 2) / 3));
+}
+
+void test_strings() {
+    concurrent_flat_hash_map<std::string, std::string> map{ 8 };
+    for (int i = 0; i < 1000; ++i) {
+        map.try_emplace(
+            "asset/" + std::to_string(i), "a long enough path to allocate " +
+                                              std::to_string(i));
+    }
+    require(map.size() == 1000);
+    require(*map.find("asset/42") == "a long enough path to allocate 42");
+    require(map.erase("asset/42"));
+    require_false(map.contains("asset/42"));
+    require_false(map.insert_or_assign("asset/7", std::string{ "seven" }));
+    require(*map.find("asset/7") == "seven");
+
+    size_t visited = 0;
+    map.for_each([&visited](const std::string& key, const std::string&) {
+        require(key.starts_with("asset/"));
+        ++visited;
+    });
+    require(visited == 999);
+}
+
+struct string_hash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view string) const noexcept {
+        return std::hash<std::string_view>{}(string);
+    }
+};
+
+void test_transparent() {
+    concurrent_flat_hash_map<std::string, int, string_hash, std::equal_to<>>
+        map{ 4 };
+    map.try_emplace("mesh/cube", 1);
+    map.try_emplace("mesh/sphere", 2);
+
+    const std::string_view key = "mesh/sphere";
+    require(map.find(key) == 2);
+    require(map.contains("mesh/cube"));
+    require_false(map.contains(std::string_view{ "mesh/cone" }));
+    int seen = 0;
+    require(map.visit(key, [&seen](int value) { seen = value; }));
+    require(seen == 2);
+}
+
+// readers keep finding the values of a writer inserting and updating keys
+template <typename Key, typename Value, typename Make>
+void run_concurrent(Make make) {
+    concurrent_flat_hash_map<Key, Value> map{ 8 };
+    constexpr int count = 20000;
+    std::atomic<int> published{ 0 };
+    std::atomic<bool> done{};
+    std::atomic<bool> wrong{};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&, t] {
+            uint32_t seed = 12345U + t;
+            while (!done.load()) {
+                const auto limit = published.load(std::memory_order_acquire);
+                if (limit == 0) {
+                    continue;
+                }
+                seed           = seed * 1664525U + 1013904223U;
+                const auto key = static_cast<int>(seed % limit);
+                const auto value = map.find(make(key));
+                // keys are only ever mapped to themselves or their double
+                if (!value.has_value() ||
+                    (*value != make(key) && *value != make(key * 2))) {
+                    wrong = true;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < count; ++i) {
+        map.try_emplace(make(i), make(i));
+        published.store(i + 1, std::memory_order_release);
+        if (i % 4 == 0) {
+            map.insert_or_assign(make(i / 2), make(i));
+        }
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    require_false(wrong.load());
+    require(map.size() == count);
+}
+
+void test_concurrent() {
+    run_concurrent<int64_t, int64_t>([](int value) { return int64_t{ value }; });
+    run_concurrent<std::string, std::string>(
+        [](int value) { return "key-" + std::to_string(value); });
+}
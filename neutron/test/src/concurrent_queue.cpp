@@ -0,0 +1,213 @@
+// Tests for mpmc_queue and spsc_ring
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <neutron/concurrent_queue.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+void test_mpmc_single_thread() {
+    mpmc_queue<std::string> queue{ 3 };
+    require(queue.capacity() == 4);
+    for (int i = 0; i < 4; ++i) {
+        require(queue.try_push(std::string(32, static_cast<char>('a' + i))));
+    }
+    require_false(queue.try_push(std::string{ "full" }));
+    require(queue.size_approx() == 4);
+
+    std::string out;
+    require(queue.try_pop(out));
+    require(out == std::string(32, 'a'));
+    require(queue.try_emplace(8, 'z'));
+    for (int i = 1; i < 4; ++i) {
+        require(queue.try_pop(out));
+        require(out[0] == 'a' + i);
+    }
+    require(queue.try_pop(out));
+    require(out == std::string(8, 'z'));
+    require_false(queue.try_pop(out));
+
+    // leftovers are destroyed with the queue
+    require(queue.try_push(std::string(64, 'x')));
+}
+
+void test_mpmc_threads() {
+    constexpr size_t producers = 4;
+    constexpr size_t count     = 20000;
+    mpmc_queue<size_t> queue{ 64 };
+    std::atomic<size_t> sum{};
+    std::atomic<size_t> popped{};
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p] {
+            for (size_t i = 0; i < count; ++i) {
+                while (!queue.try_push(p * count + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&] {
+            size_t value = 0;
+            while (popped.load() < producers * count) {
+                if (queue.try_pop(value)) {
+                    sum.fetch_add(value);
+                    popped.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const size_t n = producers * count;
+    require(sum.load() == n * (n - 1) / 2);
+}
+
+void test_spsc() {
+    spsc_ring<int> ring{ 8 };
+    require(ring.empty());
+    std::array<int, 12> in{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+    require(ring.push(in) == 8);
+    require_false(ring.try_push(100));
+
+    std::array<int, 5> out{};
+    require(ring.pop(out) == 5);
+    require(out[4] == 4);
+    require(ring.push(std::span<const int>{ in }.subspan(8)) == 4);
+    require(ring.size_approx() == 7);
+
+    int value = 0;
+    for (int expected = 5; expected < 12; ++expected) {
+        require(ring.try_pop(value));
+        require(value == expected);
+    }
+    require_false(ring.try_pop(value));
+}
+
+void test_spsc_threads() {
+    constexpr size_t count = 100000;
+    spsc_ring<size_t> ring{ 128 };
+    std::thread producer([&ring] {
+        std::array<size_t, 16> batch{};
+        size_t next = 0;
+        while (next < count) {
+            size_t filled = 0;
+            for (; filled < batch.size() && next + filled < count; ++filled) {
+                batch[filled] = next + filled;
+            }
+            const auto pushed =
+                ring.push(std::span<const size_t>{ batch.data(), filled });
+            next += pushed;
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::array<size_t, 24> batch{};
+    size_t expected = 0;
+    bool ordered    = true;
+    while (expected < count) {
+        const auto popped = ring.pop(batch);
+        for (size_t i = 0; i < popped; ++i) {
+            ordered = ordered && batch[i] == expected++;
+        }
+        if (popped == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    require(ordered);
+    require(ring.empty());
+}
+
+struct fragile {
+    int value = 0;
+    fragile() = default;
+    fragile(int value) noexcept : value(value) {}
+    fragile(fragile&& that) noexcept : value(that.value) {}
+    fragile& operator=(fragile&& that) {
+        if (that.value < 0) {
+            throw std::runtime_error("fragile");
+        }
+        value = that.value;
+        return *this;
+    }
+};
+
+void test_throwing_pop() {
+    mpmc_queue<fragile> queue{ 2 };
+    require(queue.try_push(fragile{ -1 }));
+    require(queue.try_push(fragile{ 1 }));
+    fragile out;
+    bool thrown = false;
+    try {
+        (void)queue.try_pop(out);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    require(thrown);
+    // the failed cell is released, the queue goes on past it
+    require(queue.try_pop(out));
+    require(out.value == 1);
+    for (int i = 0; i < 2; ++i) {
+        require(queue.try_push(fragile{ i }));
+    }
+    require(queue.try_pop(out));
+    require(out.value == 0);
+
+    spsc_ring<fragile> ring{ 4 };
+    for (const int value : { 1, 2, -1, 3 }) {
+        require(ring.try_push(fragile{ value }));
+    }
+    std::array<fragile, 4> batch{};
+    thrown = false;
+    try {
+        (void)ring.pop(batch);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    require(thrown);
+    require(batch[1].value == 2);
+    // the element that failed stays at the front
+    require(ring.size_approx() == 2);
+    thrown = false;
+    try {
+        (void)ring.try_pop(out);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    require(thrown);
+    require(ring.size_approx() == 2);
+}
+
+void test_pmr() {
+    std::array<std::byte, 8192> buffer{};
+    std::pmr::monotonic_buffer_resource resource{ buffer.data(),
+                                                  buffer.size() };
+    pmr::mpmc_queue<int> queue{ 16, &resource };
+    pmr::spsc_ring<int> ring{ 16, &resource };
+    require(queue.get_allocator().resource() == &resource);
+    require(queue.try_push(1));
+    require(ring.try_push(2));
+}
+
+int main() {
+    test_mpmc_single_thread();
+    test_mpmc_threads();
+    test_spsc();
+    test_spsc_threads();
+    test_throwing_pop();
+    test_pmr();
+    return 0;
+}
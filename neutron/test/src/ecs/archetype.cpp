@@ -1,6 +1,8 @@
 // Basic tests for neutron::archetype: creation, emplace/view, erase, reserve,
 // pmr
+#include <array>
 #include <memory_resource>
+#include <stdexcept>
 #include <neutron/ecs.hpp>
 #include "require.hpp"
 
@@ -97,6 +99,48 @@ void test_erase_and_entities() {
     require(arche.size() == 2);
 }
 
+void test_batched_erase() {
+    archetype<std::allocator<std::byte>> arche{
+        type_spreader<Tracker, Position>{}
+    };
+    for (entity_t entity = 1; entity <= 6; ++entity) {
+        arche.emplace(
+            entity, Tracker{ static_cast<int>(entity) }, Position{});
+    }
+    arche.erase(entity_t{ 2 });
+
+    // batched row lookups agree with row_of
+    const std::array<entity_t, 3> entities{ 1, 2, 3 };
+    std::array<size_t, 3> rows{};
+    arche.rows_of(entities, rows.begin());
+    require(rows[0] == arche.row_of(entity_t{ 1 }));
+    require(rows[1] == decltype(arche)::npos);
+    require(rows[2] == arche.row_of(entity_t{ 3 }));
+
+    // nothing is erased if one of the entities is not stored here
+    bool thrown = false;
+    try {
+        arche.erase(entities);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    require(thrown);
+    require(arche.size() == 5);
+
+    // the last rows, one of them erased too, fill the gaps
+    const std::array<entity_t, 3> erased{ 6, 1, 4 };
+    arche.erase(erased);
+    require(arche.size() == 2);
+    for (const entity_t entity : erased) {
+        require_false(arche.contains(entity));
+    }
+    const auto kept = arche.row_entities();
+    for (size_t row = 0; row < kept.size(); ++row) {
+        require(arche.row_of(kept[row]) == row);
+        require(kept[row] == 3 || kept[row] == 5);
+    }
+}
+
 void test_reserve_and_relocate() {
     archetype<std::allocator<std::byte>> arche{
         type_spreader<Position, Velocity>{}
@@ -131,6 +175,8 @@ int main() {
     neutron::println("archetype test: emplace/view ok");
     test_erase_and_entities();
     neutron::println("archetype test: erase/entities ok");
+    test_batched_erase();
+    neutron::println("archetype test: batched erase ok");
     test_reserve_and_relocate();
     neutron::println("archetype test: reserve/relocate ok");
     test_pmr_archetype();
@@ -0,0 +1,53 @@
+// Tests for the frame arenas handed to systems as arena_allocator
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include <neutron/ecs.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+using enum stage;
+
+void scratch(arena_allocator<int> alloc) {
+    std::vector<int, arena_allocator<int>> values{ alloc };
+    values.assign(64, 1);
+}
+
+void other(arena_allocator<int>) {}
+
+using world_t = basic_world<std::remove_cvref_t<decltype(world_desc)>::
+                                add_system_t<update, &scratch>::
+                                    add_system_t<update, &other>>;
+
+void test_system_arena();
+
+int main() {
+    test_system_arena();
+    return 0;
+}
+
+void test_system_arena() {
+    world_t world;
+    auto& arenas = world_accessor::frame_arenas(world);
+    require(arenas.size() == 2);
+
+    // systems at different positions of a list draw from different arenas
+    auto first  = construct_from_world_t<&scratch, arena_allocator<int>, 0>{}(
+        world);
+    auto second = construct_from_world_t<&other, arena_allocator<int>, 1>{}(
+        world);
+    require(first != second);
+
+    scratch(first);
+    require(arenas[1].used() == 0);
+    auto* const kept = second.allocate(16);
+    kept[15]         = 2;
+    require(arenas[0].used() == 0);
+    require(arenas[1].used() >= 16 * sizeof(int));
+
+    // memory of the frame is given back once it ends
+    world.end_frame();
+    for (const auto& arena : arenas) {
+        require(arena.used() == 0);
+    }
+}
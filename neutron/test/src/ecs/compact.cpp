@@ -0,0 +1,153 @@
+// Tests for archetype shrinking and sorting, and world_base::compact
+#include <functional>
+#include <string>
+#include <vector>
+#include <neutron/ecs.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct Position {
+    using component_concept = neutron::component_t;
+    float x{ 0 }, y{ 0 };
+};
+struct Name {
+    using component_concept = neutron::component_t;
+    std::string value;
+};
+struct Tag {
+    using component_concept = neutron::component_t;
+};
+
+void test_shrink_to_fit() {
+    archetype<std::allocator<std::byte>> arche{
+        type_spreader<Position, Name>{}
+    };
+    const size_t initial = arche.capacity();
+    for (size_t i = 0; i < initial * 4; ++i) {
+        arche.emplace(
+            static_cast<entity_t>(i + 1), Position{ float(i), 0 },
+            Name{ std::to_string(i) });
+    }
+    for (size_t i = 1; i < initial * 4; ++i) {
+        arche.erase(static_cast<entity_t>(i + 1));
+    }
+    require(arche.size() == 1);
+
+    arche.shrink_to_fit();
+    require(arche.capacity() == initial);
+    for (auto [p, n] : view_of<Position, Name>(arche)) {
+        require(p.x == 0);
+        require(n.value == "0");
+    }
+    arche.erase(entity_t{ 1 });
+    require(arche.empty());
+}
+
+void test_sort() {
+    archetype<std::allocator<std::byte>> arche{
+        type_spreader<Position, Name>{}
+    };
+    for (entity_t entity : { 5, 3, 9, 1 }) {
+        arche.emplace(
+            entity, Position{ float(entity), 0 },
+            Name{ std::to_string(entity) });
+    }
+
+    require(arche.sort(std::identity{}));
+    require_false(arche.sort(std::identity{}));
+
+    float last = 0;
+    for (auto [p, n] : view_of<Position, Name>(arche)) {
+        require(p.x > last);
+        require(n.value == std::to_string(static_cast<int>(p.x)));
+        last = p.x;
+    }
+
+    // lookup follows the rows
+    arche.erase(entity_t{ 3 });
+    require(arche.size() == 3);
+
+    require(arche.sort([](entity_t entity) {
+        return -static_cast<int64_t>(entity);
+    }));
+    last = 10;
+    for (auto [p, n] : view_of<Position, Name>(arche)) {
+        require(p.x < last);
+        last = p.x;
+    }
+}
+
+void test_world_compact() {
+    world_base<> world;
+    std::vector<entity_t> entities;
+    for (int i = 0; i < 200; ++i) {
+        entities.push_back(world.spawn(Position{ float(i), 0 }));
+    }
+    const auto tagged = world.spawn(Position{}, Tag{});
+    world.spawn(Name{ "kept" });
+    for (const auto entity : entities) {
+        world.kill(entity);
+    }
+    world.kill(tagged);
+
+    require(world_snapshot<>{ world }.archetypes() == 3);
+
+    // one archetype per call
+    size_t calls = 1;
+    while (!world.compact(1)) {
+        ++calls;
+    }
+    require(calls >= 3);
+    require(world_snapshot<>{ world }.archetypes() == 1);
+    require(world.compact());
+
+    // retired archetypes could be created again
+    const auto entity = world.spawn(Position{ 1, 2 }, Tag{});
+    require(world.is_alive(entity));
+    require(world.compact(8, [](entity_t entity) { return entity; }));
+}
+
+void test_query_after_compact() {
+    basic_world<world_descriptor_t<>> world;
+    std::vector<entity_t> entities;
+    for (int i = 0; i < 400; ++i) {
+        entities.push_back(world.spawn(Position{ float(i), 0 }));
+    }
+    const auto tagged = world.spawn(Position{ -1, 0 }, Tag{});
+
+    basic_querior<std::allocator<std::byte>, 8, with<Position&>> query{
+        world
+    };
+    const auto sum = [&query] {
+        float result = 0;
+        for (auto [position] : query.get()) {
+            result += position.x;
+        }
+        return result;
+    };
+    require(query.size() == 2);
+    require(sum() == (399.F * 400.F / 2) - 1);
+
+    // one archetype is retired, the other one shrinks
+    world.kill(tagged);
+    for (size_t i = 1; i < entities.size(); ++i) {
+        world.kill(entities[i]);
+    }
+    require(world.compact());
+    require(query.size() == 1);
+    require(sum() == 0);
+
+    // nothing to do, and the archetypes are kept
+    require(world.compact());
+    world.spawn(Position{ 2, 0 });
+    require(sum() == 2);
+}
+
+int main() {
+    test_shrink_to_fit();
+    test_sort();
+    test_world_compact();
+    test_query_after_compact();
+    return 0;
+}
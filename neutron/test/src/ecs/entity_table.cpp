@@ -0,0 +1,302 @@
+// Tests for neutron::entity_table and the locations shared by the archetypes
+// of a world
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include <neutron/ecs.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct Position {
+    using component_concept = neutron::component_t;
+    float x{ 0 }, y{ 0 };
+};
+struct Health {
+    using component_concept = neutron::component_t;
+    int value{ 100 };
+};
+
+struct owner {};
+
+void test_generations();
+void test_pages();
+void test_pmr_table();
+void test_archetype_rows();
+void test_rebind();
+void test_standalone_archetype();
+void test_world_locations();
+void test_kill_batch();
+
+int main() {
+    test_generations();
+    test_pages();
+    test_pmr_table();
+    test_archetype_rows();
+    test_rebind();
+    test_standalone_archetype();
+    test_world_locations();
+    test_kill_batch();
+    return 0;
+}
+
+void test_generations() {
+    entity_table<owner> table;
+    require(table.empty());
+    require(table.emplace_back() == 0);
+    const auto entity = table.emplace_back();
+    require(entity == 1);
+    require(table.contains(entity));
+    require(table.entity(1) == entity);
+
+    owner arche;
+    table.bind(entity, &arche, 7);
+    require(table.find(entity)->owner == &arche);
+    require(table.find(entity)->row == 7);
+    table.unbind(entity);
+    require(table[1].owner == nullptr);
+
+    table.kill(1);
+    require(table.is_killed(1));
+    require_false(table.contains(entity));
+    require(table.entity(1) == 0);
+
+    const auto next = table.revive(1);
+    require(next == ((entity_t{ 1 } << 32U) | 1U));
+    require(table.contains(next));
+    // the stale generation is not found anymore
+    require_false(table.contains(entity));
+
+    // binding grows the table up to the index of the entity
+    table.bind(40, &arche, 0);
+    require(table.size() == 41);
+    require(table.find(40)->owner == &arche);
+    require(table.contains(39));
+    require_false(table.contains(41));
+}
+
+void test_pages() {
+    using table_type = entity_table<owner>;
+    table_type table;
+    table.reserve(10);
+    require(table.capacity() < table_type::page_size);
+
+    owner arche;
+    const auto count = (table_type::page_size * 2) + 3;
+    for (size_t i = 0; i < count; ++i) {
+        const auto entity = table.emplace_back();
+        table.bind(entity, &arche, static_cast<index_t>(i));
+    }
+    require(table.size() == count);
+    require(table.capacity() == table_type::page_size * 3);
+    for (size_t i = 0; i < count; i += 997) {
+        require(table.find(i)->row == i);
+    }
+    require(table.find(count - 1)->row == count - 1);
+
+    table.clear();
+    require(table.empty());
+    table.resize(3);
+    require(table.find(2)->owner == nullptr);
+
+    table_type moved{ std::move(table) };
+    require(moved.size() == 3);
+    require(table.empty()); // NOLINT(bugprone-use-after-move)
+}
+
+void test_pmr_table() {
+    std::pmr::unsynchronized_pool_resource pool;
+    pmr::entity_table<owner> table{ std::pmr::polymorphic_allocator<>{
+        &pool } };
+    owner arche;
+    for (index_t i = 0; i < 5000; ++i) {
+        table.bind(table.emplace_back(), &arche, i);
+    }
+    require(table.find(4999)->row == 4999);
+
+    // the locations are copied into pages of the other resource
+    std::pmr::unsynchronized_pool_resource other;
+    pmr::entity_table<owner> moved{ std::pmr::polymorphic_allocator<>{
+        &other } };
+    moved.emplace_back();
+    moved = std::move(table);
+    require(moved.get_allocator().resource() == &other);
+    require(moved.size() == 5000);
+    require(moved.find(4999)->row == 4999);
+    require(moved.find(17)->owner == &arche);
+    require(table.empty()); // NOLINT(bugprone-use-after-move)
+}
+
+void test_archetype_rows() {
+    archetype<std::allocator<std::byte>>::table_type table;
+    archetype<std::allocator<std::byte>> positions{
+        type_spreader<Position>{}
+    };
+    archetype<std::allocator<std::byte>> both{
+        type_spreader<Position, Health>{}
+    };
+    positions.attach(table);
+    both.attach(table);
+
+    for (entity_t entity = 1; entity <= 6; ++entity) {
+        table.emplace_back();
+        if (entity % 2 == 0) {
+            positions.emplace(entity, Position{ float(entity), 0 });
+        } else {
+            both.emplace(entity, Position{ float(entity), 0 }, Health{});
+        }
+    }
+    // indices 0 to 5 were appended, binding entity 6 grew the table
+    require(table.size() == 7);
+    require(positions.contains(2) && !positions.contains(1));
+    require(both.contains(1) && !both.contains(2));
+    require(both.row_of(5) == 2);
+
+    // the last entity takes the row of the erased one
+    positions.erase(2);
+    require_false(positions.contains(2));
+    require(positions.row_of(6) == 0);
+    require(positions.row_entities()[0] == 6);
+
+    // a moved archetype stays the owner of its entities
+    auto moved = std::move(both);
+    require(moved.contains(3));
+    require(moved.row_of(3) == 1);
+
+    moved.clear();
+    require_false(moved.contains(3));
+    require(positions.contains(4));
+}
+
+void test_rebind() {
+    entity_table<owner> table;
+    owner first;
+    owner second;
+    const auto entity = table.emplace_back();
+    table.bind(entity, &first, 3);
+    require(table.find(entity, &first)->row == 3);
+    require(table.find(entity, &second) == nullptr);
+
+    // handed over without being stored nowhere in between
+    table.rebind(entity, &first, &second, 0);
+    require(table.find(entity, &first) == nullptr);
+    require(table.find(entity, &second)->row == 0);
+    require(table.contains(entity));
+
+    // a stale generation is stored by no one
+    table.unbind(entity);
+    table.kill(static_cast<index_t>(entity));
+    const auto next = table.revive(static_cast<index_t>(entity));
+    table.bind(next, &second, 1);
+    require(table.find(entity, &second) == nullptr);
+    require(table.find(next, &second)->row == 1);
+}
+
+void test_standalone_archetype() {
+    // an archetype standing alone records its rows in a table of its own
+    archetype<std::allocator<std::byte>> alone{ type_spreader<Position>{} };
+    require_false(alone.contains(1));
+    require(alone.row_of(1) == decltype(alone)::npos);
+    for (entity_t entity = 1; entity <= 3; ++entity) {
+        alone.emplace(entity, Position{ float(entity), 0 });
+    }
+    require(alone.row_of(3) == 2);
+
+    // and takes it along when moved
+    auto moved = std::move(alone);
+    require(moved.row_of(2) == 1);
+    moved.erase(1);
+    require(moved.row_of(3) == 0);
+    require_false(moved.contains(1));
+
+    // an attached one records them in the shared table only
+    archetype<std::allocator<std::byte>>::table_type table;
+    archetype<std::allocator<std::byte>> attached{ type_spreader<Health>{} };
+    attached.attach(table);
+    table.resize(5);
+    attached.emplace(4, Health{});
+    require(table.find(4, &attached)->row == 0);
+    require_false(moved.contains(4));
+}
+
+void test_world_locations() {
+    world_base<> world;
+    std::vector<entity_t> entities;
+    for (int i = 0; i < 1000; ++i) {
+        entities.push_back(
+            i % 3 == 0 ? world.spawn(Position{ float(i), 0 })
+                       : world.spawn(Position{ float(i), 0 }, Health{ i }));
+    }
+    for (size_t i = 0; i < entities.size(); i += 2) {
+        world.kill(entities[i]);
+    }
+    for (size_t i = 0; i < entities.size(); ++i) {
+        require(world.is_alive(entities[i]) == (i % 2 == 1));
+    }
+
+    // a killed index comes back with the next generation
+    const auto respawned = world.spawn(Health{ 1 });
+    const auto reused    = std::ranges::find_if(entities, [&](entity_t old) {
+        return static_cast<index_t>(old) == static_cast<index_t>(respawned);
+    });
+    require(reused != entities.end());
+    require((reused - entities.begin()) % 2 == 0);
+    require((respawned >> 32U) == (*reused >> 32U) + 1);
+    require(world.is_alive(respawned));
+    require_false(world.is_alive(*reused));
+
+    world_base<> moved{ std::move(world) };
+    moved.kill(entities[1]);
+    require_false(moved.is_alive(entities[1]));
+    require(moved.is_alive(entities[3]));
+    moved.spawn(Position{});
+    require(moved.is_alive(entities[999]));
+}
+
+void test_kill_batch() {
+    world_base<> world;
+    std::vector<entity_t> entities;
+    for (int i = 0; i < 300; ++i) {
+        entities.push_back(
+            i < 100   ? world.spawn(Position{ float(i), 0 })
+            : i < 200 ? world.spawn(Health{ i })
+                      : world.spawn());
+    }
+
+    // runs in each archetype, and entities stored in none
+    std::vector<entity_t> killed;
+    for (size_t i = 0; i < entities.size(); i += 3) {
+        killed.push_back(entities[i]);
+    }
+    world.kill(killed);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        require(world.is_alive(entities[i]) == (i % 3 != 0));
+    }
+
+    // recorded by a command buffer, in any archetype order
+    command_buffer<> cmdbuf;
+    const std::vector<entity_t> later{ entities[1], entities[101],
+                                       entities[2], entities[299] };
+    cmdbuf.kill(later);
+    cmdbuf.apply(world);
+    for (const entity_t entity : later) {
+        require_false(world.is_alive(entity));
+    }
+    require(world.is_alive(entities[4]));
+    require(world.is_alive(entities[104]));
+
+    // stale entities are skipped, even when their index was reused
+    const auto reused = world.spawn(Position{});
+    const auto stale  = std::ranges::find_if(entities, [&](entity_t old) {
+        return static_cast<index_t>(old) == static_cast<index_t>(reused);
+    });
+    require(stale != entities.end());
+    const std::vector<entity_t> mixed{ entities[5], *stale, entities[0],
+                                       entities[7] };
+    world.kill(mixed);
+    require(world.is_alive(reused));
+    require_false(world.is_alive(entities[5]));
+    require_false(world.is_alive(entities[7]));
+    require(world.is_alive(entities[8]));
+}
@@ -0,0 +1,163 @@
+// Tests for neutron::prefab: bulk row cloning into archetypes, world and
+// command buffer instancing
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <neutron/ecs.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct Position {
+    using component_concept = neutron::component_t;
+    float x{ 0 }, y{ 0 };
+};
+struct Name {
+    using component_concept = neutron::component_t;
+    std::string value;
+};
+struct Tag {
+    using component_concept = neutron::component_t;
+};
+
+void test_prefab_rows() {
+    prefab<Position, Name> pf;
+    require(pf.empty());
+    pf.emplace_back(Position{ 1, 2 }, Name{ "head" });
+    pf.emplace_back(Name{ "tail" }, Position{ 3, 4 });
+    require(pf.size() == 2);
+    require(pf.get<Position>()[1].x == 3);
+    require(pf.get<Name>()[0].value == "head");
+
+    const prefab<Position, Tag> single{ Tag{}, Position{ 5, 6 } };
+    require(single.size() == 1);
+}
+
+void test_archetype_copies() {
+    archetype<std::allocator<std::byte>> arche{
+        type_spreader<Position, Name>{}
+    };
+    arche.emplace(entity_t{ 1 }, Position{ 0, 0 }, Name{ "existing" });
+
+    const Position positions[] = { { 1, 2 }, { 3, 4 } };
+    const Name names[]         = { { "a" }, { "b" } };
+    const size_t copies        = arche.capacity(); // forces a relocation
+    entity_t next              = 2;
+    arche.emplace_copies(
+        copies, 2, [&next] { return next++; }, positions, names);
+    require(arche.size() == 1 + (copies * 2));
+
+    size_t i = 0;
+    for (auto [p, n] : view_of<Position, Name>(arche)) {
+        if (i != 0) {
+            const auto row = (i - 1) % 2;
+            require(p.x == positions[row].x && p.y == positions[row].y);
+            require(n.value == names[row].value);
+        }
+        ++i;
+    }
+    require(i == arche.size());
+}
+
+void test_world_instantiate() {
+    world_base<> world;
+    const prefab<Position, Tag> bullet{ Position{ 1, 1 }, Tag{} };
+
+    world.instantiate(bullet, 100);
+
+    std::vector<entity_t> entities;
+    world.instantiate(bullet, 3, std::back_inserter(entities));
+    require(entities.size() == 3);
+    for (const auto entity : entities) {
+        require(world.is_alive(entity));
+    }
+
+    world.kill(entities[1]);
+    entities.clear();
+    world.instantiate(bullet, 2, std::back_inserter(entities));
+    require(entities.size() == 2);
+    require(entities[0] != entities[1]);
+}
+
+/// Records the entities it is given and throws once it holds `limit` of them.
+struct throwing_output {
+    using difference_type = std::ptrdiff_t;
+
+    std::vector<entity_t>* entities;
+    size_t limit;
+
+    throwing_output& operator*() { return *this; }
+    throwing_output& operator++() { return *this; }
+    throwing_output& operator++(int) { return *this; }
+    throwing_output& operator=(entity_t entity) {
+        entities->push_back(entity);
+        if (entities->size() == limit) {
+            throw std::runtime_error("full");
+        }
+        return *this;
+    }
+};
+
+void test_instantiate_rollback() {
+    world_base<> world;
+    const prefab<Position, Name> named{ Position{}, Name{ "copy" } };
+    const auto first = world.spawn(Position{});
+
+    std::vector<entity_t> spawned;
+    bool thrown = false;
+    try {
+        world.instantiate(named, 8, throwing_output{ &spawned, 5 });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    require(thrown);
+    require(spawned.size() == 5);
+    // the entities of the failed batch are released instead of staying alive
+    // with no component
+    for (const auto entity : spawned) {
+        require_false(world.is_alive(entity));
+    }
+    require(world.is_alive(first));
+
+    // their indices are reused, in the order the free list hands them out
+    std::vector<entity_t> again;
+    world.instantiate(named, 5, std::back_inserter(again));
+    const auto indices = [](const std::vector<entity_t>& entities) {
+        std::vector<index_t> result;
+        for (const auto entity : entities) {
+            result.push_back(static_cast<index_t>(entity));
+        }
+        std::ranges::sort(result);
+        return result;
+    };
+    require(indices(again) == indices(spawned));
+    for (const auto entity : again) {
+        require(world.is_alive(entity));
+        require(std::ranges::find(spawned, entity) == spawned.end());
+    }
+}
+
+void test_command_buffer_instantiate() {
+    world_base<> world;
+    command_buffer<> cmdbuf;
+    prefab<Position, Name> group;
+    group.emplace_back(Position{ 1, 2 }, Name{ "parent" });
+    group.emplace_back(Position{ 3, 4 }, Name{ "child" });
+
+    const auto first = cmdbuf.instantiate(group, 4);
+    const auto after = cmdbuf.spawn(Position{});
+    require(first.get() == 0);
+    require(after.get() == 8);
+    cmdbuf.apply(world);
+}
+
+int main() {
+    test_prefab_rows();
+    test_archetype_copies();
+    test_world_instantiate();
+    test_instantiate_rollback();
+    test_command_buffer_instantiate();
+    return 0;
+}
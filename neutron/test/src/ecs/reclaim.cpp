@@ -0,0 +1,74 @@
+// Tests for the epoch domain of a world, reclaimed between system lists
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include <neutron/ecs.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+using enum stage;
+
+struct Position {
+    using component_concept = neutron::component_t;
+    float x{ 0 }, y{ 0 };
+};
+
+void reader(res<epoch_domain&>) {}
+
+using world_t = basic_world<std::remove_cvref_t<decltype(world_desc)>::
+                                add_system_t<update, &reader>>;
+
+/// A slot of a side table indexed by entity, e.g. a cache readers look up
+/// without locking, which could only be handed out again once retired.
+struct slot {
+    static inline std::vector<index_t> reusable;
+    index_t index;
+
+    ~slot() { reusable.push_back(index); }
+};
+
+void test_kill_in_read_epoch();
+
+int main() {
+    test_kill_in_read_epoch();
+    return 0;
+}
+
+void test_kill_in_read_epoch() {
+    world_t world;
+    auto& domain = std::get<0>(
+        construct_from_world_t<&reader, res<epoch_domain&>, 0>{}(world));
+
+    std::vector<entity_t> entities;
+    for (int i = 0; i < 8; ++i) {
+        entities.push_back(world.spawn(Position{ float(i), 0 }));
+    }
+
+    {
+        // a reader is still looking at the slots of the killed entities
+        auto guard = domain.pin();
+        for (size_t i = 0; i < entities.size(); i += 2) {
+            world.kill(entities[i]);
+            domain.retire(new slot{ static_cast<index_t>(entities[i]) });
+        }
+        world.end_frame();
+        world.end_frame();
+        require(domain.pending() == 4);
+        require(slot::reusable.empty());
+    }
+
+    // retired once the reader is gone and the world reached quiescent points
+    world.end_frame();
+    world.end_frame();
+    require(domain.pending() == 0);
+    std::vector<index_t> killed;
+    for (size_t i = 0; i < entities.size(); i += 2) {
+        killed.push_back(static_cast<index_t>(entities[i]));
+    }
+    std::ranges::sort(slot::reusable);
+    require(slot::reusable == killed);
+    for (size_t i = 1; i < entities.size(); i += 2) {
+        require(world.is_alive(entities[i]));
+    }
+}
@@ -0,0 +1,98 @@
+// Tests for neutron::world_snapshot and neutron::world_delta: capture/restore,
+// delta encoding, apply and revert
+#include <vector>
+#include <neutron/ecs.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct Position {
+    using component_concept = neutron::component_t;
+    float x{ 0 }, y{ 0 };
+};
+struct Health {
+    using component_concept = neutron::component_t;
+    int value{ 100 };
+};
+
+void test_capture_and_restore() {
+    world_base<> world;
+    const auto e1 = world.spawn(Position{ 1, 2 });
+    const auto e2 = world.spawn(Position{ 3, 4 }, Health{ 5 });
+
+    world_snapshot<> snapshot{ world };
+    require(snapshot.archetypes() == 2);
+    require(snapshot.entities() == 3);
+
+    world.kill(e1);
+    world.spawn(Health{ 7 });
+    snapshot.restore(world);
+
+    const auto delta = make_delta(snapshot, world);
+    require(delta.empty());
+    require(world.is_alive(e2));
+}
+
+void test_identical_worlds_have_empty_delta() {
+    world_base<> world;
+    world.spawn(Position{ 1, 2 });
+    world.spawn(Position{ 3, 4 });
+
+    world_snapshot<> snapshot{ world };
+    require(make_delta(snapshot, world).empty());
+    require(make_delta(world, snapshot).empty());
+}
+
+void test_apply_and_revert() {
+    world_base<> world;
+    const auto e1 = world.spawn(Position{ 1, 2 });
+    world.spawn(Position{ 3, 4 }, Health{ 5 });
+
+    const world_snapshot<> before{ world };
+    world.kill(e1);
+    world.spawn(Position{ 5, 6 }, Health{ 7 });
+    world.spawn(Health{ 8 });
+    const world_snapshot<> after{ world };
+
+    const auto delta = make_delta(before, world);
+    require_false(delta.empty());
+    require(delta.spawned().size() == 2);
+    require(delta.size_bytes() != 0);
+
+    revert_delta(world, delta);
+    require(make_delta(before, world).empty());
+
+    apply_delta(world, delta);
+    require(make_delta(after, world).empty());
+
+    world_snapshot<> replica{ before };
+    apply_delta(replica, delta);
+    require(make_delta(after, replica).empty());
+}
+
+void test_rollback_chain() {
+    world_base<> world;
+    world.spawn(Position{ 0, 0 });
+    const world_snapshot<> origin{ world };
+
+    world_snapshot<> previous{ world };
+    std::vector<world_delta<>> frames;
+    for (int i = 0; i < 4; ++i) {
+        world.spawn(Position{ static_cast<float>(i), 1 });
+        frames.push_back(make_delta(previous, world));
+        previous.capture(world);
+    }
+
+    for (auto iter = frames.rbegin(); iter != frames.rend(); ++iter) {
+        revert_delta(world, *iter);
+    }
+    require(make_delta(origin, world).empty());
+}
+
+int main() {
+    test_capture_and_restore();
+    test_identical_worlds_have_empty_delta();
+    test_apply_and_revert();
+    test_rollback_chain();
+    return 0;
+}
@@ -0,0 +1,149 @@
+// Tests for archetype::sort_by: incremental ordering by a component key
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <neutron/ecs.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct SpatialCell {
+    using component_concept = neutron::component_t;
+    uint32_t index{};
+};
+struct Name {
+    using component_concept = neutron::component_t;
+    std::string value;
+};
+struct Tag {
+    using component_concept = neutron::component_t;
+};
+
+using archetype_t = archetype<std::allocator<std::byte>>;
+
+template <typename Comp = std::ranges::less>
+bool rows_ordered(archetype_t& arche, Comp comp = {}) {
+    bool first    = true;
+    uint32_t last = 0;
+    for (auto [cell, name] : view_of<SpatialCell, Name>(arche)) {
+        if (name.value != std::to_string(cell.index)) {
+            return false;
+        }
+        if (!first && comp(cell.index, last)) {
+            return false;
+        }
+        first = false;
+        last  = cell.index;
+    }
+    return true;
+}
+
+void test_sort_by() {
+    archetype_t arche{ type_spreader<SpatialCell, Name, Tag>{} };
+    const uint32_t cells[] = { 7, 3, 3, 9, 1, 4, 0, 8 };
+    entity_t entity        = 1;
+    for (const auto cell : cells) {
+        arche.emplace(
+            entity++, SpatialCell{ cell }, Name{ std::to_string(cell) },
+            Tag{});
+    }
+
+    require(arche.sort_by<SpatialCell>({}, &SpatialCell::index));
+    require(rows_ordered(arche));
+    require_false(arche.sort_by<SpatialCell>({}, &SpatialCell::index));
+
+    // append unsorted rows, only the tail is sorted and merged
+    for (const auto cell : { 5U, 2U, 10U }) {
+        arche.emplace(
+            entity++, SpatialCell{ cell }, Name{ std::to_string(cell) },
+            Tag{});
+    }
+    require(arche.sort_by<SpatialCell>({}, &SpatialCell::index));
+    require(rows_ordered(arche));
+    require(arche.size() == 11);
+
+    // lookup follows the rows
+    arche.erase(entity_t{ 4 });
+    arche.erase(entity_t{ 1 });
+    require(arche.size() == 9);
+    arche.sort_by<SpatialCell>(std::ranges::greater{}, &SpatialCell::index);
+    require(rows_ordered(arche, std::ranges::greater{}));
+}
+
+void test_sort_large() {
+    archetype_t arche{ type_spreader<SpatialCell, Name, Tag>{} };
+    for (uint32_t i = 0; i < 1000; ++i) {
+        const uint32_t cell = (i * 7919U) % 1000U;
+        arche.emplace(
+            entity_t{ i + 1 }, SpatialCell{ cell },
+            Name{ std::to_string(cell) }, Tag{});
+    }
+    arche.sort_by<SpatialCell>({}, &SpatialCell::index);
+    require(rows_ordered(arche));
+    for (uint32_t i = 0; i < 1000; i += 2) {
+        arche.erase(entity_t{ i + 1 });
+    }
+    arche.sort_by<SpatialCell>({}, &SpatialCell::index);
+    require(rows_ordered(arche));
+}
+
+void test_order_by_pass() {
+    using query_t = basic_querior<
+        std::allocator<std::byte>, 8, with<SpatialCell, Name>,
+        order_by<SpatialCell, std::ranges::less, decltype(&SpatialCell::index)>>;
+
+    basic_world<world_descriptor_t<>> world;
+    world.spawn(SpatialCell{ 4 }, Name{ "4" });
+    world.spawn(SpatialCell{ 1 }, Name{ "1" });
+    world.spawn(SpatialCell{ 3 }, Name{ "3" }, Tag{});
+    world.spawn(SpatialCell{ 2 }, Name{ "2" }, Tag{});
+    world.spawn(Name{ "unsorted" });
+
+    const auto cells = [&world] {
+        std::vector<uint32_t> result;
+        query_t query{ world };
+        for (auto [cell, name] : query.get()) {
+            result.push_back(cell.index);
+        }
+        return result;
+    };
+    // the rows of the archetype of the untagged cells, looked up directly
+    // since archetypes are iterated in no particular order
+    const auto untagged = [&world] {
+        std::vector<uint32_t> result;
+        for (auto& [_, arche] : world_accessor::archetypes(world)) {
+            if (arche.has<SpatialCell>() && !arche.has<Tag>()) {
+                for (auto [cell] : view_of<SpatialCell>(arche)) {
+                    result.push_back(cell.index);
+                }
+            }
+        }
+        return result;
+    };
+    // constructing a querior does not touch the rows
+    require(cells().size() == 4);
+    require(untagged() == std::vector<uint32_t>{ 4, 1 });
+
+    command_buffer<> cmdbuf;
+    basic_commands<std::allocator<std::byte>> commands{ cmdbuf };
+    commands.sort_by<SpatialCell>({}, &SpatialCell::index);
+    require(untagged() == std::vector<uint32_t>{ 4, 1 });
+    cmdbuf.apply(world);
+    require(untagged() == std::vector<uint32_t>{ 1, 4 });
+
+    const auto sorted = cells();
+    require(sorted.size() == 4);
+    for (size_t i = 0; i + 1 < sorted.size(); i += 2) {
+        // each archetype is ordered on its own
+        require(sorted[i] < sorted[i + 1]);
+    }
+    require(world.sort_by<SpatialCell>({}, &SpatialCell::index) == 0);
+}
+
+int main() {
+    test_sort_by();
+    test_sort_large();
+    test_order_by_pass();
+    return 0;
+}
@@ -0,0 +1,218 @@
+// Tests for spatial_grid: neighbour queries, world sync and query filters
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <neutron/ecs.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct Position {
+    using component_concept = neutron::component_t;
+    float x{ 0 }, y{ 0 };
+};
+struct Tag {
+    using component_concept = neutron::component_t;
+};
+
+using grid_t  = spatial_grid<Position>;
+using world_t = basic_world<world_descriptor_t<>>;
+
+void test_grid_queries() {
+    grid_t grid{ 4.0F };
+    std::vector<Position> points;
+    uint32_t seed = 12345;
+    auto next     = [&seed] {
+        seed = (seed * 1103515245U) + 12345U;
+        return static_cast<float>((seed >> 8U) % 2000U) / 10.0F - 100.0F;
+    };
+    for (entity_t entity = 0; entity < 500; ++entity) {
+        points.push_back(Position{ next(), next() });
+        grid.update(entity, points.back().x, points.back().y);
+    }
+    require(grid.size() == 500);
+
+    // matches brute force
+    for (const auto radius : { 0.5F, 3.0F, 17.0F, 500.0F }) {
+        std::vector<entity_t> found;
+        grid.for_each_in_radius(
+            1.0F, -2.0F, radius, [&found](entity_t e) { found.push_back(e); });
+        std::vector<entity_t> expected;
+        for (entity_t entity = 0; entity < points.size(); ++entity) {
+            const auto dx = points[entity].x - 1.0F;
+            const auto dy = points[entity].y + 2.0F;
+            if ((dx * dx) + (dy * dy) <= radius * radius) {
+                expected.push_back(entity);
+            }
+        }
+        std::ranges::sort(found);
+        require(found == expected);
+    }
+
+    // moving across cells and erasing keep the cells consistent
+    for (entity_t entity = 0; entity < 500; entity += 3) {
+        points[entity] = Position{ points[entity].y, -points[entity].x };
+        grid.update(entity, points[entity].x, points[entity].y);
+    }
+    for (entity_t entity = 1; entity < 500; entity += 7) {
+        grid.erase(entity);
+    }
+    size_t count = 0;
+    grid.for_each_in_region(
+        -100.0F, -100.0F, 100.0F, 100.0F,
+        [&](entity_t entity, float x, float y) {
+            require(entity % 7 != 1);
+            require(x == points[entity].x && y == points[entity].y);
+            ++count;
+        });
+    require(count == grid.size());
+
+    grid.set_cell_size(10.0F);
+    count = 0;
+    grid.for_each_in_radius(0, 0, 1000.0F, [&count](entity_t) { ++count; });
+    require(count == grid.size());
+}
+
+void test_grid_sync() {
+    world_t world;
+    const auto first  = world.spawn(Position{ 1, 1 });
+    const auto second = world.spawn(Position{ 2, 2 }, Tag{});
+    const auto third  = world.spawn(Position{ 50, 50 });
+    world.spawn(Tag{});
+
+    grid_t grid{ 8.0F };
+    grid.sync(world);
+    require(grid.size() == 3);
+    require(grid.contains(first) && grid.contains(second));
+
+    world.kill(first);
+    world.kill(third);
+    grid.sync(world);
+    require(grid.size() == 1);
+    require(!grid.contains(first));
+    require(!grid.contains(third));
+    require(grid.contains(second));
+
+    // a system would pass the archetypes of its querior
+    const auto fourth = world.spawn(Position{ 9, 9 });
+    basic_querior<std::allocator<std::byte>, 8, with<Position&>> query{ world };
+    grid.sync(query.raw());
+    require(grid.size() == 2);
+    require(grid.contains(fourth));
+}
+
+void test_query_filters() {
+    world_t world;
+    std::vector<entity_t> entities;
+    for (int i = 0; i < 20; ++i) {
+        entities.push_back(world.spawn(Position{ float(i), 0 }));
+        world.spawn(Position{ float(i), 100 }, Tag{});
+    }
+    grid_t grid{ 2.0F };
+    grid.sync(world);
+
+    using region_query = basic_querior<
+        std::allocator<std::byte>, 8, with<Position>, in_region<grid_t>>;
+    region_query region{ world, {}, in_region<grid_t>{ &grid, 3, -1, 6, 1 } };
+    size_t count = 0;
+    for (auto [position] : region.get()) {
+        require(position.x >= 3 && position.x <= 6 && position.y == 0);
+        ++count;
+    }
+    require(count == 4);
+
+    using radius_query = basic_querior<
+        std::allocator<std::byte>, 8, with<Position, Tag>, in_radius<grid_t>,
+        in_region<grid_t>>;
+    radius_query near{ world,
+                       {},
+                       in_radius<grid_t>{ &grid, 10, 100, 2.5F },
+                       in_region<grid_t>{ &grid, 0, 0, 10, 200 } };
+    std::vector<entity_t> found;
+    for (const auto entity : near.entities()) {
+        found.push_back(entity);
+    }
+    require(found.size() == 3); // x in 8..10 of the tagged row
+    for (auto [position] : near.get()) {
+        require(position.y == 100 && position.x >= 8 && position.x <= 10);
+    }
+
+    region_query none{ world };
+    require(std::ranges::empty(none.get()));
+}
+
+void test_non_finite() {
+    constexpr auto inf = std::numeric_limits<float>::infinity();
+    constexpr auto nan = std::numeric_limits<float>::quiet_NaN();
+    grid_t grid{ 1.0F };
+    grid.update(1, 0, 0);
+    grid.update(2, 1e30F, -1e30F);
+    grid.update(3, nan, 0);
+    grid.update(4, 0, inf);
+    require(grid.size() == 2);
+    require_false(grid.contains(3) || grid.contains(4));
+
+    // moving to a non-finite position erases the entity
+    grid.update(1, nan, nan);
+    require_false(grid.contains(1));
+    grid.update(1, -5, 5);
+
+    size_t count = 0;
+    grid.for_each_in_region(-inf, -inf, inf, inf, [&count](entity_t) {
+        ++count;
+    });
+    require(count == 2);
+    count = 0;
+    grid.for_each_in_region(nan, 0, 10, 10, [&count](entity_t) { ++count; });
+    grid.for_each_in_radius(0, 0, nan, [&count](entity_t) { ++count; });
+    require(count == 0);
+}
+
+void test_grid_refresh() {
+    world_t world;
+    std::vector<entity_t> entities;
+    for (int i = 0; i < 10; ++i) {
+        entities.push_back(world.spawn(Position{ float(i), 0 }));
+    }
+    grid_t grid{ 1.0F };
+    grid.sync(world);
+
+    // move every entity, but only the marked ones are refreshed
+    basic_querior<std::allocator<std::byte>, 8, with<Position&>> query{ world };
+    for (auto [position] : query.get()) {
+        position.y = 50;
+    }
+    grid.mark(entities[2]);
+    grid.refresh(world);
+    size_t count = 0;
+    grid.for_each_in_region(0, 49, 10, 51, [&](entity_t entity) {
+        require(entity == entities[2]);
+        ++count;
+    });
+    require(count == 1);
+
+    // recorded refreshes run after the commands recorded before them
+    command_buffer<> cmdbuf;
+    basic_commands<std::allocator<std::byte>> commands{ cmdbuf };
+    commands.kill(entities[3]);
+    grid.mark(entities[3]);
+    grid.mark(entities[4]);
+    commands.refresh(grid);
+    require(grid.contains(entities[3]));
+    cmdbuf.apply(world);
+    require_false(grid.contains(entities[3]));
+    require(grid.size() == 9);
+    count = 0;
+    grid.for_each_in_region(0, 49, 10, 51, [&count](entity_t) { ++count; });
+    require(count == 2);
+}
+
+int main() {
+    test_grid_queries();
+    test_grid_sync();
+    test_query_filters();
+    test_non_finite();
+    test_grid_refresh();
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Tests for epoch_domain: guards, retire, batched and quiescent collection
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <neutron/epoch.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct tracked {
+    static inline std::atomic<size_t> alive{};
+    int value;
+
+    explicit tracked(int value) : value(value) { ++alive; }
+    ~tracked() { --alive; }
+};
+
+void test_guarded() {
+    epoch_domain domain{ 4, 1000 };
+    auto* const first = new tracked{ 1 };
+    {
+        auto guard = domain.pin();
+        require(static_cast<bool>(guard));
+        domain.retire(first);
+        require(domain.pending() == 1);
+
+        // the guard holds the epoch back
+        domain.quiescent();
+        domain.quiescent();
+        require(domain.pending() == 1);
+        require(first->value == 1);
+    }
+    domain.quiescent();
+    require(domain.pending() == 0);
+    require(tracked::alive.load() == 0);
+
+    // retired at the current epoch, freed only two epochs later
+    domain.retire(new tracked{ 2 });
+    require(domain.try_advance());
+    require(domain.collect() == 0);
+    require(domain.try_advance());
+    require(domain.collect() == 1);
+}
+
+void test_function_deleter() {
+    static int deleted = 0;
+    epoch_domain domain{ 2, 1000 };
+    int value = 0;
+    domain.retire(&value, [](void* pointer) {
+        require(pointer != nullptr);
+        ++deleted;
+    });
+    domain.quiescent();
+    require(deleted == 1);
+
+    // leftovers are freed with the domain
+    domain.retire(new tracked{ 3 });
+}
+
+// readers walk a shared pointer while a writer keeps replacing it
+void test_concurrent() {
+    epoch_domain domain{ 16, 32 };
+    std::atomic<tracked*> current{ new tracked{ 0 } };
+    std::atomic<bool> done{};
+    std::atomic<bool> torn{};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto guard      = domain.pin();
+                auto* const obj = current.load(std::memory_order_acquire);
+                if (obj->value < 0) {
+                    torn = true;
+                }
+            }
+        });
+    }
+    for (int i = 1; i < 5000; ++i) {
+        auto* const old =
+            current.exchange(new tracked{ i }, std::memory_order_acq_rel);
+        domain.retire(old, [](void* pointer) {
+            auto* const obj = static_cast<tracked*>(pointer);
+            obj->value      = -1;
+            delete obj;
+        });
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    require_false(torn.load());
+    domain.retire(current.load());
+    domain.quiescent();
+    domain.quiescent();
+    require(domain.pending() == 0);
+    require(tracked::alive.load() == 0);
+}
+
+int main() {
+    test_guarded();
+    test_function_deleter();
+    require(tracked::alive.load() == 0);
+    test_concurrent();
+    return 0;
+}
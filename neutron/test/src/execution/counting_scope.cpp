@@ -0,0 +1,101 @@
+// Tests for counting_scope: slab-backed spawn, backpressure, join and stop
+#define ATOM_EXECUTION
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <neutron/execution.hpp>
+#include <neutron/execution_resources.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+using namespace neutron::execution;
+using namespace std::chrono_literals;
+
+void test_join_frames() {
+    static_context_thread_pool<int> pool{ 3 };
+    counting_scope scope{ 16 };
+    require(scope.capacity() == 16);
+
+    // an empty scope joins inline
+    this_thread::sync_wait(scope.join());
+
+    std::atomic<size_t> sum{};
+    for (size_t frame = 0; frame < 20; ++frame) {
+        for (size_t i = 0; i < 100; ++i) {
+            require(scope.spawn(
+                schedule(pool.get_scheduler()) |
+                then([&sum, i] { sum.fetch_add(i); })));
+        }
+        this_thread::sync_wait(scope.join());
+        require(scope.in_flight() == 0);
+        require(sum.load() == (frame + 1) * 4950);
+    }
+
+    scope.close();
+    require_false(scope.try_spawn(just()));
+}
+
+void test_backpressure_and_stop() {
+    timed_scheduler timers;
+    counting_scope scope{ 8 };
+    for (int i = 0; i < 8; ++i) {
+        require(scope.try_spawn(timers.schedule_after(1h)));
+    }
+    require(scope.in_flight() == 8);
+    require_false(scope.try_spawn(timers.schedule_after(1h)));
+
+    // the timers see the stop token of the scope
+    scope.request_stop();
+    this_thread::sync_wait(scope.join());
+    require(scope.in_flight() == 0);
+    require(scope.get_stop_token().stop_requested());
+}
+
+void test_spawn_waits_for_slot() {
+    static_context_thread_pool<int> pool{ 2 };
+    counting_scope scope{ 1 };
+    std::atomic<size_t> done{};
+    std::atomic<size_t> running{};
+    std::atomic<bool> overlapped{};
+    for (int i = 0; i < 50; ++i) {
+        scope.spawn(schedule(pool.get_scheduler()) | then([&] {
+                        if (running.fetch_add(1) != 0) {
+                            overlapped = true;
+                        }
+                        std::this_thread::sleep_for(10us);
+                        running.fetch_sub(1);
+                        done.fetch_add(1);
+                    }));
+    }
+    this_thread::sync_wait(scope.join());
+    require(done.load() == 50);
+    require_false(overlapped.load());
+}
+
+void test_full_last_slot() {
+    // an odd number of slots, all in flight, whose operation states fill them
+    timed_scheduler timers;
+    basic_counting_scope<512> scope{ 3 };
+    std::atomic<size_t> sum{};
+    for (size_t i = 0; i < 3; ++i) {
+        std::array<std::byte, 352> payload{};
+        payload.back() = std::byte(i + 1);
+        require(scope.try_spawn(
+            timers.schedule_after(1ms) | then([&sum, payload] {
+                sum.fetch_add(size_t(payload.back()));
+            })));
+    }
+    require(scope.in_flight() == 3);
+    this_thread::sync_wait(scope.join());
+    require(sum.load() == 6);
+}
+
+int main() {
+    test_join_frames();
+    test_backpressure_and_stop();
+    test_spawn_waits_for_slot();
+    test_full_last_slot();
+    return 0;
+}
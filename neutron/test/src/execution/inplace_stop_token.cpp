@@ -0,0 +1,75 @@
+// Tests for inplace_stop_source, inplace_stop_token and inplace_stop_callback
+#define ATOM_EXECUTION
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <neutron/detail/execution/inplace_stop_callback.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct counter {
+    int* count;
+    void operator()() noexcept { ++*count; }
+};
+
+void test_request_stop() {
+    inplace_stop_source source;
+    const auto token = source.get_token();
+    require(token.stop_possible());
+    require_false(token.stop_requested());
+    require_false(inplace_stop_token{}.stop_possible());
+
+    int count = 0;
+    inplace_stop_callback first{ token, counter{ &count } };
+    std::optional<inplace_stop_callback<counter>> second;
+    second.emplace(token, counter{ &count });
+    {
+        inplace_stop_callback removed{ token, counter{ &count } };
+    }
+    second.reset();
+
+    require(source.request_stop());
+    require(token.stop_requested());
+    require(count == 1);
+    require_false(source.request_stop());
+
+    // registered after the request, invoked right away
+    inplace_stop_callback late{ token, counter{ &count } };
+    require(count == 2);
+}
+
+void test_remove_during_callback() {
+    inplace_stop_source source;
+    struct self_destroying {
+        std::optional<inplace_stop_callback<self_destroying>>* self;
+        void operator()() noexcept { self->reset(); }
+    };
+    std::optional<inplace_stop_callback<self_destroying>> callback;
+    callback.emplace(source.get_token(), self_destroying{ &callback });
+    source.request_stop();
+    require_false(callback.has_value());
+}
+
+void test_concurrent() {
+    for (int round = 0; round < 100; ++round) {
+        inplace_stop_source source;
+        std::atomic<int> count{};
+        auto fn = [&count] { count.fetch_add(1); };
+        std::thread requester([&source] { source.request_stop(); });
+        for (int i = 0; i < 16; ++i) {
+            inplace_stop_callback callback{ source.get_token(), fn };
+        }
+        inplace_stop_callback kept{ source.get_token(), fn };
+        requester.join();
+        require(source.stop_requested());
+        require(count.load() >= 1);
+    }
+}
+
+int main() {
+    test_request_stop();
+    test_remove_during_callback();
+    test_concurrent();
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Tests for the allocation of task coroutine frames
+#define ATOM_EXECUTION
+#include <cstddef>
+#include <memory>
+#include <neutron/detail/execution/task.hpp>
+#include <neutron/execution.hpp>
+#include <neutron/memory.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+using namespace neutron::execution;
+
+static size_t allocated   = 0;
+static size_t deallocated = 0;
+
+template <typename Ty>
+struct counting_allocator {
+    using value_type = Ty;
+
+    int id = 0;
+
+    counting_allocator() = default;
+    explicit counting_allocator(int id) : id(id) {}
+    template <typename Other>
+    counting_allocator(const counting_allocator<Other>& that) : id(that.id) {}
+
+    Ty* allocate(size_t n) {
+        ++allocated;
+        return std::allocator<Ty>{}.allocate(n);
+    }
+    void deallocate(Ty* pointer, size_t n) noexcept {
+        ++deallocated;
+        std::allocator<Ty>{}.deallocate(pointer, n);
+    }
+
+    template <typename Other>
+    bool operator==(const counting_allocator<Other>& that) const noexcept {
+        return id == that.id;
+    }
+};
+
+struct counting_env {
+    using allocator_type = counting_allocator<std::byte>;
+};
+
+task<int> pooled(int value) { co_return value; }
+
+task<void, counting_env>
+    with_allocator(std::allocator_arg_t, counting_allocator<int>, int) {
+    co_return;
+}
+
+task<void, counting_env> without_allocator(int) { co_return; }
+
+void test_default_pool() {
+    auto& pool = frame_pool::local();
+    { auto first = pooled(1); }
+    size_t cached = 0;
+    for (size_t size = 1; size <= frame_pool::max_size; ++size) {
+        cached += pool.cached(size) != 0 ? 1 : 0;
+    }
+    require(cached != 0);
+
+    // the cached frame is reused
+    for (int i = 0; i < 100; ++i) {
+        auto task = pooled(i);
+        require(static_cast<bool>(task));
+    }
+}
+
+void test_allocator_arg() {
+    {
+        auto task = with_allocator(
+            std::allocator_arg, counting_allocator<int>{ 7 }, 1);
+        require(allocated == 1);
+        require(deallocated == 0);
+    }
+    require(deallocated == 1);
+
+    // default constructed allocator_type of the environment
+    { auto task = without_allocator(2); }
+    require(allocated == 2);
+    require(deallocated == 2);
+}
+
+int main() {
+    test_default_pool();
+    test_allocator_arg();
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Tests for io_context: reads and writes as senders on io_uring and threads
+#define ATOM_EXECUTION
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <neutron/execution.hpp>
+#include <neutron/execution_resources.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+using namespace neutron::execution;
+
+struct counting_receiver {
+    using receiver_concept = receiver_t;
+
+    std::atomic<size_t>* bytes;
+    std::atomic<size_t>* done;
+
+    void set_value(size_t n) && noexcept {
+        bytes->fetch_add(n);
+        done->fetch_add(1);
+    }
+    void set_error(std::error_code) && noexcept { done->fetch_add(1); }
+    void set_stopped() && noexcept { done->fetch_add(1); }
+    ATOM_NODISCARD empty_env get_env() const noexcept { return {}; }
+};
+
+int make_file() {
+    char path[] = "/tmp/neutron_io_XXXXXX";
+    const int fd = ::mkstemp(path);
+    ::unlink(path);
+    return fd;
+}
+
+void test_read_write(io_context& context) {
+    const int fd = make_file();
+    require(fd >= 0);
+
+    std::array<std::byte, 64> out{};
+    for (size_t i = 0; i < out.size(); ++i) {
+        out[i] = static_cast<std::byte>(i);
+    }
+    auto [written] =
+        this_thread::sync_wait(context.async_write(fd, out, 16)).value();
+    require(written == out.size());
+
+    std::array<std::byte, 32> in{};
+    auto [sum] = this_thread::sync_wait(
+                     context.async_read(fd, in, 32) | then([&in](size_t n) {
+                         size_t sum = 0;
+                         for (size_t i = 0; i < n; ++i) {
+                             sum += static_cast<size_t>(in[i]);
+                         }
+                         return sum;
+                     }))
+                     .value();
+    require(sum == (16 + 47) * 16); // bytes 16..47 of out
+
+    // short read at the end of the file
+    auto [tail] =
+        this_thread::sync_wait(context.async_read(fd, in, 72)).value();
+    require(tail == 8);
+
+    bool failed = false;
+    try {
+        this_thread::sync_wait(context.async_read(-1, in, 0));
+    } catch (const std::system_error&) {
+        failed = true;
+    }
+    require(failed);
+
+    ::close(fd);
+}
+
+void test_many_in_flight(io_context& context) {
+    const int fd = make_file();
+    std::vector<std::byte> data(4096, std::byte{ 1 });
+    this_thread::sync_wait(context.async_write(fd, data, 0));
+
+    std::atomic<size_t> bytes{};
+    std::atomic<size_t> done{};
+    constexpr size_t count = 64;
+    std::vector<std::array<std::byte, 64>> buffers(count);
+    using op_t = decltype(connect(
+        context.async_read(fd, buffers[0], 0),
+        counting_receiver{ &bytes, &done }));
+    std::vector<std::unique_ptr<op_t>> ops;
+    for (size_t i = 0; i < count; ++i) {
+        ops.push_back(std::make_unique<op_t>(connect(
+            context.async_read(fd, buffers[i], i * 64),
+            counting_receiver{ &bytes, &done })));
+        start(*ops.back());
+    }
+    while (done.load() != count) {
+        std::this_thread::yield();
+    }
+    require(bytes.load() == 4096);
+    ::close(fd);
+}
+
+void test_burst_from_threads(io_context& context) {
+    const int fd = make_file();
+    std::vector<std::byte> data(4096, std::byte{ 1 });
+    this_thread::sync_wait(context.async_write(fd, data, 0));
+
+    std::atomic<size_t> bytes{};
+    std::atomic<size_t> done{};
+    constexpr size_t threads = 4;
+    constexpr size_t count   = 256;
+    std::vector<std::array<std::byte, 16>> buffers(threads * count);
+    using op_t = decltype(connect(
+        context.async_read(fd, buffers[0], 0),
+        counting_receiver{ &bytes, &done }));
+    std::vector<std::unique_ptr<op_t>> ops(threads * count);
+    std::vector<std::thread> starters;
+    for (size_t t = 0; t < threads; ++t) {
+        starters.emplace_back([&, t] {
+            // starts far more operations than the submission queue holds
+            for (size_t i = t * count; i < (t + 1) * count; ++i) {
+                ops[i] = std::make_unique<op_t>(connect(
+                    context.async_read(fd, buffers[i], (i % 256) * 16),
+                    counting_receiver{ &bytes, &done }));
+                start(*ops[i]);
+            }
+        });
+    }
+    for (auto& starter : starters) {
+        starter.join();
+    }
+    while (done.load() != threads * count) {
+        std::this_thread::yield();
+    }
+    require(bytes.load() == threads * 4096);
+    ::close(fd);
+}
+
+int main() {
+    {
+        io_context context{ 4 }; // fewer entries than operations in flight
+        test_read_write(context);
+        test_many_in_flight(context);
+        test_burst_from_threads(context);
+    }
+    {
+        io_context context{ blocking_io };
+        require_false(context.uses_io_uring());
+        test_read_write(context);
+        test_many_in_flight(context);
+        test_burst_from_threads(context);
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Tests for numa_pool: topology, node placement and stealing
+#define ATOM_EXECUTION
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <neutron/execution.hpp>
+#include <neutron/execution_resources.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+using namespace neutron::execution;
+
+struct counting_receiver {
+    using receiver_concept = receiver_t;
+
+    std::atomic<size_t>* done;
+    std::atomic<size_t>* on_node;
+    uint32_t node;
+
+    void set_value() && noexcept {
+        if (numa_pool::current_node() == node) {
+            on_node->fetch_add(1);
+        }
+        done->fetch_add(1);
+    }
+    void set_stopped() && noexcept { done->fetch_add(1); }
+    ATOM_NODISCARD empty_env get_env() const noexcept { return {}; }
+};
+
+void test_topology() {
+    const auto list = numa_topology::parse_list("0-3,8,10-11\n");
+    require(list == std::vector<uint32_t>{ 0, 1, 2, 3, 8, 10, 11 });
+    require(numa_topology::parse_list("").empty());
+
+    const auto topology = numa_topology::discover();
+    require(!topology.nodes.empty());
+    require(topology.cores() >= 1);
+}
+
+// two nodes of two cores, whether or not the machine has them
+numa_topology fake_topology() {
+    return numa_topology{ { { 0, { 0, 1 } }, { 1, { 2, 3 } } } };
+}
+
+void test_schedule_on_node() {
+    numa_pool pool{ fake_topology() };
+    require(pool.size() == 4);
+    require(pool.node_count() == 2);
+    require(numa_pool::current_node() == numa_pool::any_node);
+
+    auto sch = pool.get_scheduler(1);
+    require(get_numa_node(sch) == 1);
+    require(get_numa_node(pool.get_scheduler()) == numa_pool::any_node);
+    require(get_numa_node(get_env(sch.schedule())) == 1);
+
+    auto [node] = this_thread::sync_wait(
+                      schedule(sch) | then([] {
+                          return numa_pool::current_node();
+                      }))
+                      .value();
+    require(node == 1);
+}
+
+void test_many_tasks() {
+    numa_pool pool{ fake_topology() };
+    std::atomic<size_t> done{};
+    std::atomic<size_t> on_node{};
+    constexpr size_t count = 2000;
+    using op_t = decltype(connect(
+        pool.get_scheduler(0).schedule(),
+        counting_receiver{ &done, &on_node, 0 }));
+    std::vector<std::unique_ptr<op_t>> ops;
+    for (size_t i = 0; i < count; ++i) {
+        const auto node = static_cast<uint32_t>(i % 2);
+        ops.push_back(std::make_unique<op_t>(connect(
+            pool.get_scheduler(node).schedule(),
+            counting_receiver{ &done, &on_node, node })));
+        start(*ops.back());
+    }
+    while (done.load() != count) {
+        std::this_thread::yield();
+    }
+    require(on_node.load() == count); // bound work never leaves its node
+}
+
+void test_unbound_from_worker() {
+    numa_pool pool{ fake_topology() };
+    std::atomic<size_t> done{};
+    std::atomic<size_t> on_node{};
+    using op_t = decltype(connect(
+        pool.get_scheduler().schedule(),
+        counting_receiver{ &done, &on_node, 0 }));
+    std::vector<std::unique_ptr<op_t>> ops(500);
+    // started on a worker, queued there and stolen by idle workers
+    this_thread::sync_wait(
+        schedule(pool.get_scheduler(0)) | then([&] {
+            for (auto& op : ops) {
+                op = std::make_unique<op_t>(connect(
+                    pool.get_scheduler().schedule(),
+                    counting_receiver{ &done, &on_node, 0 }));
+                start(*op);
+            }
+        }));
+    while (done.load() != ops.size()) {
+        std::this_thread::yield();
+    }
+}
+
+void test_destroy_runs_queued() {
+    std::atomic<size_t> done{};
+    std::atomic<size_t> on_node{};
+    using op_t = decltype(connect(
+        std::declval<numa_pool&>().get_scheduler().schedule(),
+        counting_receiver{ &done, &on_node, 0 }));
+    std::vector<std::unique_ptr<op_t>> ops;
+    {
+        numa_pool pool{ fake_topology() };
+        for (size_t i = 0; i < 100; ++i) {
+            ops.push_back(std::make_unique<op_t>(connect(
+                pool.get_scheduler().schedule(),
+                counting_receiver{ &done, &on_node, 0 })));
+            start(*ops.back());
+        }
+    }
+    require(done.load() == 100);
+}
+
+int main() {
+    test_topology();
+    test_schedule_on_node();
+    test_many_tasks();
+    test_unbound_from_worker();
+    test_destroy_runs_queued();
+    return 0;
+}
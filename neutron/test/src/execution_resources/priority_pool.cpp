@@ -0,0 +1,151 @@
+// Tests for priority_pool: strict and weighted lanes, get_priority
+#define ATOM_EXECUTION
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <neutron/execution.hpp>
+#include <neutron/execution_resources.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+using namespace neutron::execution;
+
+struct lane_receiver {
+    using receiver_concept = receiver_t;
+
+    struct env {
+        size_t priority;
+        size_t query(get_priority_t) const noexcept { return priority; }
+    };
+
+    std::atomic<size_t>* done;
+    size_t priority;
+
+    void set_value() && noexcept { done->fetch_add(1); }
+    void set_stopped() && noexcept {}
+    ATOM_NODISCARD env get_env() const noexcept { return { priority }; }
+};
+
+// keeps the only worker busy until released
+struct gate {
+    std::atomic<bool> entered{};
+    std::atomic<bool> open{};
+
+    void hold(counting_scope& scope, priority_pool& pool) {
+        scope.spawn(schedule(pool.get_scheduler(0)) | then([this] {
+                        entered = true;
+                        while (!open.load()) {
+                            std::this_thread::yield();
+                        }
+                    }));
+        while (!entered.load()) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+void test_schedule() {
+    priority_pool pool{ 4 };
+    require(pool.lane_count() == 3);
+    auto sch = pool.get_scheduler();
+    require(get_priority(sch) == 2);
+    require(get_priority(sch.with_priority(0)) == 0);
+    require(get_priority(get_env(schedule(sch.with_priority(1)))) == 1);
+
+    std::atomic<size_t> count{};
+    for (size_t i = 0; i < 100; ++i) {
+        this_thread::sync_wait(
+            schedule(sch.with_priority(i % 4)) | then([&count] { ++count; }));
+    }
+    require(count.load() == 100);
+}
+
+void test_strict_first() {
+    priority_pool pool{ 1 };
+    counting_scope scope{ 64 };
+    gate gate;
+    gate.hold(scope, pool);
+
+    std::mutex mutex;
+    std::vector<size_t> order;
+    auto record = [&](size_t lane) {
+        scope.spawn(
+            schedule(pool.get_scheduler(lane)) | then([&mutex, &order, lane] {
+                std::unique_lock guard{ mutex };
+                order.push_back(lane);
+            }));
+    };
+    for (size_t i = 0; i < 10; ++i) {
+        record(2);
+        record(1);
+    }
+    record(0);
+    require(pool.pending(0) == 1);
+    require(pool.pending(2) == 10);
+
+    gate.open = true;
+    this_thread::sync_wait(scope.join());
+    require(order.size() == 21);
+    require(order.front() == 0);
+}
+
+void test_weighted_share() {
+    priority_pool pool{ 1, { priority_lane::strict(),
+                             priority_lane::weighted(4),
+                             priority_lane::weighted(1) } };
+    counting_scope scope{ 64 };
+    gate gate;
+    gate.hold(scope, pool);
+
+    std::mutex mutex;
+    std::vector<size_t> order;
+    for (size_t i = 0; i < 20; ++i) {
+        for (size_t lane : { 1, 2 }) {
+            scope.spawn(
+                schedule(pool.get_scheduler(lane)) |
+                then([&mutex, &order, lane] {
+                    std::unique_lock guard{ mutex };
+                    order.push_back(lane);
+                }));
+        }
+    }
+
+    gate.open = true;
+    this_thread::sync_wait(scope.join());
+    require(order.size() == 40);
+    size_t urgent = 0;
+    for (size_t i = 0; i < 10; ++i) {
+        urgent += order[i] == 1 ? 1 : 0;
+    }
+    require(urgent == 8);
+}
+
+void test_env_priority() {
+    priority_pool pool{ 1 };
+    counting_scope scope{ 4 };
+    gate gate;
+    gate.hold(scope, pool);
+
+    std::atomic<size_t> done{};
+    auto op = connect(
+        schedule(pool.get_scheduler(2)), lane_receiver{ &done, 0 });
+    start(op);
+    require(pool.pending(0) == 1);
+    require(pool.pending(2) == 0);
+
+    gate.open = true;
+    this_thread::sync_wait(scope.join());
+    while (done.load() != 1) {
+        std::this_thread::yield();
+    }
+}
+
+int main() {
+    test_schedule();
+    test_strict_first();
+    test_weighted_share();
+    test_env_priority();
+    return 0;
+}
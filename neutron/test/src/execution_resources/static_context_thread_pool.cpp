@@ -0,0 +1,122 @@
+// Tests for static_context_thread_pool: per-worker contexts and stealing
+#define ATOM_EXECUTION
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <neutron/execution.hpp>
+#include <neutron/execution_resources.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+using namespace neutron::execution;
+
+struct worker_context {
+    size_t index;
+    std::thread::id owner = std::this_thread::get_id();
+    std::vector<int> scratch;
+    size_t executed = 0;
+};
+
+using pool_t = static_context_thread_pool<worker_context>;
+
+struct context_receiver {
+    using receiver_concept = receiver_t;
+
+    std::atomic<size_t>* done;
+    std::atomic<size_t>* wrong;
+
+    void set_value(worker_context& context) && noexcept {
+        if (context.owner != std::this_thread::get_id()) {
+            wrong->fetch_add(1);
+        }
+        context.scratch.push_back(1); // no lock, the worker owns it
+        ++context.executed;
+        done->fetch_add(1);
+    }
+    void set_stopped() && noexcept { done->fetch_add(1); }
+    ATOM_NODISCARD empty_env get_env() const noexcept { return {}; }
+};
+
+void test_contexts() {
+    pool_t pool{ 4, [](size_t index) { return worker_context{ index }; } };
+    require(pool.size() == 4);
+    for (size_t i = 0; i < pool.size(); ++i) {
+        require(pool.context(i).index == i);
+        require(pool.context(i).owner != std::this_thread::get_id());
+    }
+    require(pool.current_context() == nullptr);
+
+    auto sch = pool.get_scheduler();
+    require(get_thread_context(sch) == nullptr);
+
+    auto [on_worker] = this_thread::sync_wait(
+                           schedule(sch) | then([&pool, sch] {
+                               return pool.current_context() != nullptr &&
+                                      get_thread_context(sch) ==
+                                          pool.current_context();
+                           }))
+                           .value();
+    require(on_worker);
+
+    auto [index] =
+        this_thread::sync_wait(
+            sch.schedule_with_context() |
+            then([](worker_context& context) { return context.index; }))
+            .value();
+    require(index < 4);
+}
+
+void test_many_tasks() {
+    pool_t pool{ 3, [](size_t index) { return worker_context{ index }; } };
+    std::atomic<size_t> done{};
+    std::atomic<size_t> wrong{};
+    constexpr size_t count = 3000;
+    using op_t = decltype(connect(
+        pool.get_scheduler().schedule_with_context(),
+        context_receiver{ &done, &wrong }));
+    std::vector<std::unique_ptr<op_t>> ops;
+    for (size_t i = 0; i < count; ++i) {
+        ops.push_back(std::make_unique<op_t>(connect(
+            pool.get_scheduler().schedule_with_context(),
+            context_receiver{ &done, &wrong })));
+        start(*ops.back());
+    }
+    while (done.load() != count) {
+        std::this_thread::yield();
+    }
+    require(wrong.load() == 0);
+
+    size_t executed = 0;
+    size_t scratch  = 0;
+    pool.for_each_context([&](worker_context& context) {
+        executed += context.executed;
+        scratch += context.scratch.size();
+    });
+    require(executed == count);
+    require(scratch == count);
+}
+
+void test_failed_context() {
+    bool thrown = false;
+    try {
+        pool_t pool{ 4, [](size_t index) {
+                        if (index == 2) {
+                            throw std::runtime_error("no context");
+                        }
+                        return worker_context{ index };
+                    } };
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    require(thrown);
+}
+
+int main() {
+    test_contexts();
+    test_many_tasks();
+    test_failed_context();
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Tests for timed_scheduler: deadlines, cascading levels, stop and run_loop
+#define ATOM_EXECUTION
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <neutron/detail/execution/inplace_stop_callback.hpp>
+#include <neutron/execution.hpp>
+#include <neutron/execution_resources.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+using namespace neutron::execution;
+using namespace std::chrono_literals;
+using clock_type = timed_scheduler::clock_type;
+
+struct stop_env {
+    const inplace_stop_source* source;
+    ATOM_NODISCARD auto query(execution::get_stop_token_t) const noexcept {
+        return source->get_token();
+    }
+};
+
+struct timer_receiver {
+    using receiver_concept = receiver_t;
+
+    const inplace_stop_source* source;
+    clock_type::time_point deadline;
+    std::atomic<size_t>* fired;
+    std::atomic<size_t>* stopped;
+    std::atomic<size_t>* early;
+    std::thread::id* thread = nullptr;
+
+    void set_value() && noexcept {
+        if (clock_type::now() < deadline) {
+            early->fetch_add(1);
+        }
+        if (thread != nullptr) {
+            *thread = std::this_thread::get_id();
+        }
+        fired->fetch_add(1);
+    }
+    void set_stopped() && noexcept { stopped->fetch_add(1); }
+    ATOM_NODISCARD stop_env get_env() const noexcept { return { source }; }
+};
+
+using op_t = decltype(connect(
+    std::declval<timed_scheduler&>().schedule_at({}),
+    std::declval<timer_receiver>()));
+
+void wait_for(const std::atomic<size_t>& count, size_t expected) {
+    while (count.load() != expected) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+void test_sync_wait() {
+    timed_scheduler context;
+    const auto begin = clock_type::now();
+    this_thread::sync_wait(context.schedule_after(5ms));
+    require(clock_type::now() - begin >= 5ms);
+
+    auto sch = context.get_scheduler();
+    auto [value] =
+        this_thread::sync_wait(sch.schedule() | then([] { return 42; }))
+            .value();
+    require(value == 42);
+}
+
+void test_levels() {
+    // a tick of 1us makes 200ms cross three levels of the wheel
+    timed_scheduler context{ 1us };
+    inplace_stop_source source;
+    std::atomic<size_t> fired{};
+    std::atomic<size_t> stopped{};
+    std::atomic<size_t> early{};
+    std::vector<std::unique_ptr<op_t>> ops;
+    const auto now   = clock_type::now();
+    constexpr size_t count = 400;
+    for (size_t i = 0; i < count; ++i) {
+        const auto deadline = now + (i * 500us);
+        ops.push_back(std::make_unique<op_t>(connect(
+            context.schedule_at(deadline),
+            timer_receiver{ &source, deadline, &fired, &stopped, &early })));
+        start(*ops.back());
+    }
+    wait_for(fired, count);
+    require(early.load() == 0);
+    require(stopped.load() == 0);
+    require(context.pending() == 0);
+}
+
+void test_stop() {
+    timed_scheduler context;
+    inplace_stop_source source;
+    std::atomic<size_t> fired{};
+    std::atomic<size_t> stopped{};
+    std::atomic<size_t> early{};
+    std::vector<std::unique_ptr<op_t>> ops;
+    const auto deadline = clock_type::now() + 1h;
+    for (int i = 0; i < 1000; ++i) {
+        ops.push_back(std::make_unique<op_t>(connect(
+            context.schedule_at(deadline),
+            timer_receiver{ &source, deadline, &fired, &stopped, &early })));
+        start(*ops.back());
+    }
+    require(context.pending() == 1000);
+    source.request_stop();
+    wait_for(stopped, 1000);
+    require(context.pending() == 0);
+    require(fired.load() == 0);
+
+    // stop requested before start
+    auto op = connect(
+        context.schedule_after(1ms),
+        timer_receiver{ &source, deadline, &fired, &stopped, &early });
+    start(op);
+    require(stopped.load() == 1001);
+}
+
+void test_destroy_pending() {
+    inplace_stop_source source;
+    std::atomic<size_t> fired{};
+    std::atomic<size_t> stopped{};
+    std::atomic<size_t> early{};
+    const auto deadline = clock_type::now() + (24h * 365); // beyond the wheel
+    {
+        timed_scheduler context;
+        auto op = connect(
+            context.schedule_at(deadline),
+            timer_receiver{ &source, deadline, &fired, &stopped, &early });
+        start(op);
+        require(context.pending() == 1);
+    }
+    require(stopped.load() == 1);
+}
+
+void test_run_loop() {
+    run_loop loop;
+    timed_scheduler context{ loop };
+    inplace_stop_source source;
+    std::atomic<size_t> fired{};
+    std::atomic<size_t> stopped{};
+    std::atomic<size_t> early{};
+    std::thread::id thread;
+    const auto deadline = clock_type::now() + 3ms;
+    auto op             = connect(
+        context.schedule_at(deadline),
+        timer_receiver{ &source, deadline, &fired, &stopped, &early, &thread });
+    start(op);
+    std::thread finisher([&] {
+        wait_for(fired, 1);
+        loop.finish();
+    });
+    loop.run();
+    finisher.join();
+    require(thread == std::this_thread::get_id());
+    require(early.load() == 0);
+}
+
+int main() {
+    test_sync_wait();
+    test_levels();
+    test_stop();
+    test_destroy_pending();
+    test_run_loop();
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Tests for flat_hash_map: heterogeneous and precomputed-hash lookup
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <neutron/flat_hash_map.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct string_hash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view string) const noexcept {
+        return std::hash<std::string_view>{}(string);
+    }
+};
+
+// counts the keys materialized by lookups
+struct counted_hash {
+    static inline size_t calls = 0;
+
+    size_t operator()(uint64_t key) const noexcept {
+        ++calls;
+        return static_cast<size_t>(key);
+    }
+};
+
+void test_transparent();
+void test_precomputed();
+void test_set();
+
+int main() {
+    test_transparent();
+    test_precomputed();
+    test_set();
+    return 0;
+}
+
+void test_transparent() {
+    flat_hash_map<std::string, int, string_hash, std::equal_to<>> map;
+    for (int i = 0; i < 100; ++i) {
+        map.emplace("texture/" + std::to_string(i), i);
+    }
+
+    const std::string_view key = "texture/42";
+    auto found                 = map.find(key);
+    require(found != map.end());
+    require(found->second == 42);
+    require(map.contains("texture/7"));
+    require(map.count(std::string_view{ "texture/100" }) == 0);
+    require_false(map.contains("mesh/1"));
+
+    const auto& cmap = map;
+    require(cmap.find("texture/0")->second == 0);
+
+    // the hash of a view equals the one of the string it views
+    const auto hash = map.hash_function()(key);
+    require(map.find(key, hash) == found);
+    require(map.find(std::string{ key }, hash) == found);
+}
+
+void test_precomputed() {
+    flat_hash_map<uint64_t, int, counted_hash> map;
+    for (uint64_t i = 0; i < 64; ++i) {
+        map.emplace(i * 977, static_cast<int>(i));
+    }
+
+    counted_hash::calls = 0;
+    for (uint64_t i = 0; i < 64; ++i) {
+        const auto key = i * 977;
+        map.prefetch(key);
+        const auto found = map.find(key, key);
+        require(found != map.end());
+        require(found->second == static_cast<int>(i));
+    }
+    require(map.find(1, 1) == map.end());
+    require(counted_hash::calls == 0);
+
+    const auto& cmap = map;
+    require(cmap.find(977, 977)->second == 1);
+    require(map.contains(977));
+    require(counted_hash::calls == 1);
+}
+
+void test_set() {
+    flat_hash_set<std::string, string_hash, std::equal_to<>> set;
+    set.emplace("shader");
+    require(set.contains(std::string_view{ "shader" }));
+    require(set.find("shader") != set.end());
+    require_false(set.contains("sound"));
+}
@@ -0,0 +1,90 @@
+// Tests for the locks: try_lock results, exclusion, reader/writer
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include <neutron/lock.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+template <typename Mutex>
+void test_try_lock() {
+    Mutex mutex;
+    require(mutex.try_lock());
+    require_false(mutex.try_lock());
+    mutex.unlock();
+    require(mutex.try_lock());
+    mutex.unlock();
+}
+
+template <typename Mutex>
+void test_exclusive() {
+    Mutex mutex;
+    size_t count = 0;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 10000; ++j) {
+                std::unique_lock guard{ mutex };
+                ++count;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    require(count == 80000);
+}
+
+void test_shared() {
+    per_core_shared_mutex mutex{ 4 };
+    require(mutex.try_lock_shared());
+    require(mutex.try_lock_shared());
+    require_false(mutex.try_lock());
+    mutex.unlock_shared();
+    mutex.unlock_shared();
+    require(mutex.try_lock());
+    require_false(mutex.try_lock_shared());
+    mutex.unlock();
+
+    // writers keep the two halves equal, readers must never see them differ
+    size_t first  = 0;
+    size_t second = 0;
+    std::atomic<bool> torn{};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < 5000; ++j) {
+                if (i % 4 == 0) {
+                    std::unique_lock guard{ mutex };
+                    ++first;
+                    ++second;
+                } else {
+                    std::shared_lock guard{ mutex };
+                    if (first != second) {
+                        torn = true;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    require_false(torn.load());
+    require(first == 10000);
+}
+
+int main() {
+    test_try_lock<spinlock>();
+    test_try_lock<hybrid_spinlock>();
+    test_try_lock<adaptive_mutex>();
+    test_try_lock<per_core_shared_mutex>();
+    test_exclusive<hybrid_spinlock>();
+    test_exclusive<adaptive_mutex>();
+    test_exclusive<per_core_shared_mutex>();
+    test_shared();
+    return 0;
+}
@@ -1,6 +1,11 @@
+#include <cstdint>
+#include <list>
 #include <memory>
 #include <memory_resource>
+#include <new>
 #include <string>
+#include <thread>
+#include <vector>
 #include <neutron/memory.hpp>
 #include <neutron/object_pool.hpp>
 #include "require.hpp"
@@ -10,11 +15,17 @@ using namespace neutron;
 void test_unique_storage();
 void test_unique_storage_pmr();
 void test_pools();
+void test_frame_pool();
+void test_frame_pool_teardown();
+void test_frame_arena();
 
 int main() {
     test_unique_storage();
     test_unique_storage_pmr();
     test_pools();
+    test_frame_pool();
+    test_frame_pool_teardown();
+    test_frame_arena();
 
     return 0;
 }
@@ -188,10 +199,14 @@ void test_unique_storage_pmr() {
 void test_pool_proxy();
 void test_constcapacity_pool();
 void test_runtime_pool();
+void test_slab_pool();
+void test_pool_allocator();
 void test_pools() {
     test_pool_proxy();
     test_constcapacity_pool();
     test_runtime_pool();
+    test_slab_pool();
+    test_pool_allocator();
 }
 template <typename Val>
 void use_pool(auto& pool) {
@@ -233,3 +248,253 @@ void test_runtime_pool() {
     runtime_pool<size, alignof(value_type)> pool{ count };
     use_pool<value_type>(pool);
 }
+// counts the allocations, and fails them on demand
+struct counting_resource : std::pmr::memory_resource {
+    size_t allocations = 0;
+    bool fail          = false;
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override {
+        if (fail) {
+            throw std::bad_alloc{};
+        }
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void* pointer, size_t bytes, size_t align) override {
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, align);
+    }
+
+    bool do_is_equal(const memory_resource& that) const noexcept override {
+        return this == &that;
+    }
+};
+
+void test_slab_pool() {
+    using value_type    = std::string;
+    constexpr auto size = sizeof(value_type);
+
+    {
+        slab_pool<size, alignof(value_type)> pool{ 4 };
+        use_pool<value_type>(pool);
+    }
+
+    // grows past the first slab, blocks stay distinct
+    {
+        slab_pool<sizeof(int)> pool{ 64 };
+        std::vector<int*> blocks;
+        for (int i = 0; i < 1000; ++i) {
+            blocks.push_back(std::construct_at(pool.take<int>(), i));
+        }
+        require(pool.slab_count() >= 1000 / 64);
+        require(pool.capacity() >= 1000);
+        for (int i = 0; i < 1000; ++i) {
+            require(*blocks[i] == i);
+        }
+        const auto slabs = pool.slab_count();
+        for (auto* block : blocks) {
+            pool.put(block);
+        }
+        // recycled rather than grown
+        for (auto*& block : blocks) {
+            block = pool.take<int>();
+        }
+        require(pool.slab_count() == slabs);
+        for (auto* block : blocks) {
+            pool.put(block);
+        }
+    }
+
+    // blocks taken on a thread and put on another
+    {
+        slab_pool<sizeof(size_t)> pool{ 256 };
+        constexpr size_t count = 4;
+        constexpr size_t times = 5000;
+        std::vector<std::thread> threads;
+        std::vector<std::vector<size_t*>> kept(count);
+        for (size_t t = 0; t < count; ++t) {
+            threads.emplace_back([&, t] {
+                std::vector<size_t*> live;
+                for (size_t i = 0; i < times; ++i) {
+                    live.push_back(std::construct_at(pool.take<size_t>(), i));
+                    if (i % 3 == 0) {
+                        require(*live.back() == i);
+                        pool.put(live.back());
+                        live.pop_back();
+                    }
+                }
+                kept[t] = std::move(live);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        threads.clear();
+        for (size_t t = 0; t < count; ++t) {
+            threads.emplace_back([&, t] {
+                for (auto* block : kept[(t + 1) % count]) {
+                    pool.put(block);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // putting back never allocates, so it cannot fail and lose a block
+    {
+        counting_resource resource;
+        pmr::slab_pool<sizeof(int)> pool{ 64, &resource };
+        std::vector<int*> blocks;
+        for (int i = 0; i < 200; ++i) {
+            blocks.push_back(pool.take<int>());
+        }
+        const auto slabs       = pool.slab_count();
+        const auto allocations = resource.allocations;
+        resource.fail          = true;
+        for (auto* block : blocks) {
+            pool.put(block);
+        }
+        require(resource.allocations == allocations);
+        for (auto*& block : blocks) {
+            block = pool.take<int>();
+        }
+        require(pool.slab_count() == slabs);
+        resource.fail = false;
+        for (auto* block : blocks) {
+            pool.put(block);
+        }
+    }
+
+    // pmr
+    {
+        std::pmr::monotonic_buffer_resource resource;
+        pmr::slab_pool<sizeof(double)> pool{ 32, &resource };
+        auto* const block = pool.take<double>();
+        pool.put(block);
+        require(pool.get_allocator().resource() == &resource);
+    }
+}
+void test_pool_allocator() {
+    using allocator = pool_allocator<int, 32>;
+
+    allocator::pool_type pool{ 64 };
+    {
+        // nodes come from the pool, one at a time
+        std::list<int, allocator> list{ allocator{ pool } };
+        for (int i = 0; i < 200; ++i) {
+            list.push_back(i);
+        }
+        require(pool.slab_count() >= 1);
+        int expected = 0;
+        for (const int value : list) {
+            require(value == expected++);
+        }
+    }
+    {
+        // arrays fall back to operator new
+        std::vector<int, allocator> vector{ allocator{ pool } };
+        vector.assign(100, 1);
+        require(vector.size() == 100);
+    }
+
+    const allocator alloc{ pool };
+    const std::allocator_traits<allocator>::rebind_alloc<long> rebound{ alloc };
+    require(alloc == rebound);
+    require(&rebound.pool() == &pool);
+    allocator::pool_type other{ 64 };
+    require(alloc != allocator{ other });
+}
+
+void test_frame_pool() {
+    frame_pool pool;
+    void* const first = pool.allocate(100);
+    pool.deallocate(first, 100);
+    require(pool.cached(100) == 1);
+    require(pool.cached(128) == 1); // same size class
+
+    // blocks of a size class are recycled
+    void* const second = pool.allocate(120);
+    require(second == first);
+    require(pool.cached(100) == 0);
+    pool.deallocate(second, 120);
+
+    // large blocks are not cached
+    void* const large = pool.allocate(frame_pool::max_size + 1);
+    pool.deallocate(large, frame_pool::max_size + 1);
+    require(pool.cached(frame_pool::max_size + 1) == 0);
+
+    frame_allocator<int> alloc;
+    int* const ints = alloc.allocate(8);
+    alloc.deallocate(ints, 8);
+    require(frame_pool::local().cached(sizeof(int) * 8) == 1);
+}
+
+/// Allocates from frame_allocator in its destructor, which runs after the
+/// frame_pool of the thread has been destroyed if it is constructed first.
+struct late_user {
+    std::vector<int, frame_allocator<int>>* ints;
+
+    ~late_user() {
+        ints->assign(16, 1);
+        require(ints->size() == 16);
+        delete ints;
+    }
+};
+
+void test_frame_pool_teardown() {
+    std::thread thread{ [] {
+        thread_local late_user user{
+            new std::vector<int, frame_allocator<int>>{}
+        };
+        frame_allocator<int> alloc;
+        alloc.deallocate(alloc.allocate(4), 4);
+        require(frame_pool::local().cached(sizeof(int) * 4) == 1);
+    } };
+    thread.join();
+}
+
+void test_frame_arena() {
+    frame_arena arena{ 256 };
+    require(arena.capacity() == 0);
+
+    // alignment is honoured
+    auto* const byte = arena.allocate(1, 1);
+    auto* const aligned = arena.allocate(8, 64);
+    require(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+    require(byte != aligned);
+
+    // the last allocation is rewound
+    auto* const top = arena.allocate(16);
+    arena.deallocate(top, 16);
+    require(arena.allocate(16) == top);
+
+    // grows past the first block, then settles on one block
+    arena_allocator<int> alloc{ arena };
+    {
+        std::vector<int, arena_allocator<int>> vector{ alloc };
+        for (int i = 0; i < 1000; ++i) {
+            vector.push_back(i);
+        }
+        require(vector[999] == 999);
+        require(arena.capacity() > 256);
+    }
+    const auto capacity = arena.capacity();
+    arena.reset();
+    require(arena.used() == 0);
+    require(arena.capacity() == capacity);
+    {
+        std::vector<int, arena_allocator<int>> vector{ alloc };
+        vector.reserve(1000);
+        require(arena.capacity() == capacity);
+    }
+
+    // rebinding keeps the arena
+    const arena_allocator<double> rebound{ alloc };
+    require(rebound == alloc);
+    require(&rebound.arena() == &arena);
+    frame_arena other;
+    require(alloc != arena_allocator<int>{ other });
+}
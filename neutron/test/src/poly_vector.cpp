@@ -0,0 +1,157 @@
+// Tests for neutron::poly_vector: buckets per type, batched calls, erasure
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <neutron/metafn.hpp>
+#include <neutron/polymorphic.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct Behaviour {
+    template <typename Base>
+    struct interface : Base {
+        void update(int delta) { this->template invoke<0, Behaviour>(delta); }
+        void count(size_t& total) const {
+            this->template invoke<1, Behaviour>(total);
+        }
+    };
+
+    template <typename Impl>
+    using impl = value_list<&Impl::update, &Impl::count>;
+};
+
+struct Patrol {
+    int position = 0;
+    void update(int delta) { position += delta; }
+    void count(size_t& total) const { ++total; }
+};
+
+struct Chase {
+    int speed = 1;
+    int travelled = 0;
+    void update(int delta) { travelled += speed * delta; }
+    void count(size_t& total) const { total += 10; }
+};
+
+struct Named {
+    std::string name;
+    void update(int) { name += '!'; }
+    void count(size_t& total) const { total += name.size(); }
+};
+
+void test_buckets();
+void test_for_each();
+void test_erase_and_clear();
+void test_growth();
+void test_pmr_poly_vector();
+
+int main() {
+    test_buckets();
+    test_for_each();
+    test_erase_and_clear();
+    test_growth();
+    test_pmr_poly_vector();
+    return 0;
+}
+
+void test_buckets() {
+    poly_vector<Behaviour> behaviours;
+    require(behaviours.empty());
+    require(behaviours.get<Patrol>().empty());
+
+    behaviours.push_back(Patrol{ 1 });
+    behaviours.push_back(Chase{ 2, 0 });
+    behaviours.push_back(Patrol{ 3 });
+    auto& chase = behaviours.emplace<Chase>(4, 0);
+    require(chase.speed == 4);
+
+    require(behaviours.size() == 4);
+    require(behaviours.type_count() == 2);
+    require(behaviours.size<Patrol>() == 2);
+    require(behaviours.get<Patrol>()[1].position == 3);
+    require(behaviours.get<Chase>()[0].speed == 2);
+    require_false(behaviours.size<Named>() != 0);
+}
+
+void test_for_each() {
+    poly_vector<Behaviour> behaviours;
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 3 == 0) {
+            behaviours.push_back(Chase{ i, 0 });
+        } else {
+            behaviours.push_back(Patrol{ i });
+        }
+    }
+    behaviours.push_back(Named{ "named" });
+
+    behaviours.for_each<0>(2);
+    for (const auto& chase : behaviours.get<Chase>()) {
+        require(chase.travelled == chase.speed * 2);
+    }
+    int expected = 1;
+    for (const auto& patrol : behaviours.get<Patrol>()) {
+        require(patrol.position == expected + 2);
+        expected += expected % 3 == 1 ? 1 : 2;
+    }
+    require(behaviours.get<Named>()[0].name == "named!");
+
+    size_t total = 0;
+    behaviours.for_each<1>(total);
+    require(total == 666 + (334 * 10) + 6);
+}
+
+void test_erase_and_clear() {
+    poly_vector<Behaviour> behaviours;
+    for (int i = 0; i < 4; ++i) {
+        behaviours.push_back(Named{ std::string(20, char('a' + i)) });
+    }
+    behaviours.push_back(Patrol{});
+
+    // the last object of the bucket takes the place of the erased one
+    behaviours.erase<Named>(1);
+    require(behaviours.size() == 4);
+    require(behaviours.size<Named>() == 3);
+    require(behaviours.get<Named>()[1].name == std::string(20, 'd'));
+    behaviours.erase<Named>(2);
+    require(behaviours.get<Named>().back().name == std::string(20, 'd'));
+
+    behaviours.clear();
+    require(behaviours.empty());
+    require(behaviours.type_count() == 2);
+    behaviours.push_back(Named{ "again" });
+    require(behaviours.size() == 1);
+}
+
+void test_growth() {
+    poly_vector<Behaviour> behaviours;
+    behaviours.reserve<Named>(2);
+    for (int i = 0; i < 100; ++i) {
+        behaviours.push_back(
+            Named{ std::string(32, 'x') + std::to_string(i) });
+        // an object of the bucket could be copied into it while it grows
+        behaviours.push_back(behaviours.get<Named>()[0]);
+    }
+    require(behaviours.size<Named>() == 200);
+    const auto named = behaviours.get<Named>();
+    require(named[199].name == named[0].name);
+
+    poly_vector<Behaviour> moved{ std::move(behaviours) };
+    require(moved.size() == 200);
+    require(behaviours.empty()); // NOLINT(bugprone-use-after-move)
+    moved.for_each<0>(0);
+    require(moved.get<Named>()[1].name.ends_with("!"));
+}
+
+void test_pmr_poly_vector() {
+    std::pmr::unsynchronized_pool_resource pool;
+    pmr::poly_vector<Behaviour> behaviours{ std::pmr::polymorphic_allocator<>{
+        &pool } };
+    for (int i = 0; i < 100; ++i) {
+        behaviours.push_back(Patrol{ i });
+        behaviours.push_back(Named{ "pooled" });
+    }
+    size_t total = 0;
+    behaviours.for_each<1>(total);
+    require(total == 100 + (100 * 6));
+}
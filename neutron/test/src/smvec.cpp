@@ -1,5 +1,8 @@
 // Basic coverage for neutron::smvec
+#include <list>
 #include <memory>
+#include <ranges>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <neutron/print.hpp>
@@ -229,6 +232,87 @@ static void test_iterators_and_emplace() {
     require(count == v.size());
 }
 
+struct tracked {
+    static inline int alive = 0;
+
+    int value;
+
+    tracked(int value) : value(value) { ++alive; } // NOLINT
+    tracked(const tracked& that) : value(that.value) { ++alive; }
+    tracked(tracked&& that) noexcept : value(that.value) { ++alive; }
+    tracked& operator=(const tracked&) = default;
+    tracked& operator=(tracked&&)      = default;
+    ~tracked() { --alive; }
+};
+
+static void test_relocation_and_bulk() {
+    // trivially relocatable elements keep their values across growth
+    {
+        smvec<int, 4> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(i);
+        }
+        v.insert(v.begin() + 1, v[0]);
+        v.insert(v.begin(), static_cast<size_t>(v.capacity()), -1);
+        require(v[v.size() - 1001] == 0);
+        require(v[v.size() - 1000] == 0);
+        require(v.back() == 999);
+        v.shrink_to_fit();
+        require(v.capacity() == v.size());
+    }
+
+    // element-wise moves remain for the others
+    {
+        smvec<tracked, 2> v;
+        for (int i = 0; i < 100; ++i) {
+            v.emplace_back(i);
+        }
+        v.insert(v.begin() + 1, static_cast<size_t>(v.capacity()), v[0]);
+        require(v.back().value == 99);
+        v.clear();
+        v.shrink_to_fit();
+        require(tracked::alive == 0);
+    }
+
+    // append_range from sized, forward and input ranges
+    {
+        smvec<int, 4> v{ 1, 2 };
+        const std::vector<int> more{ 3, 4, 5, 6, 7 };
+        v.append_range(more);
+        require(v.size() == 7);
+        require(v[6] == 7);
+
+        const std::list<int> list{ 8, 9 };
+        v.append_range(list);
+        require(v.size() == 9);
+        require(v[8] == 9);
+
+        std::istringstream stream{ "10 11 12" };
+        v.append_range(std::views::istream<int>(stream));
+        require(v.size() == 12);
+        require(v.back() == 12);
+
+        smvec<std::string, 2> strings;
+        strings.append_range(std::vector<std::string>{ "a", "b", "c" });
+        require(strings.size() == 3);
+        require(strings[2] == "c");
+    }
+
+    // resize_uninitialized leaves the new elements for the caller to write
+    {
+        smvec<float, 4> v;
+        v.resize_uninitialized(64);
+        require(v.size() == 64);
+        require(v.capacity() >= 64);
+        for (size_t i = 0; i < v.size(); ++i) {
+            v[i] = static_cast<float>(i);
+        }
+        v.resize_uninitialized(8);
+        require(v.size() == 8);
+        require(v[7] == 7.F);
+    }
+}
+
 int main() {
     test_constructors();
     println("constructors ok");
@@ -240,5 +324,7 @@ int main() {
     println("copy move swap shrink ok");
     test_iterators_and_emplace();
     println("iterator emplace ok");
+    test_relocation_and_bulk();
+    println("relocation and bulk ok");
     return 0;
 }
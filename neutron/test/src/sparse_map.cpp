@@ -1,14 +1,21 @@
+#include <array>
+#include <cstdint>
 #include <memory_resource>
+#include <vector>
 #include <neutron/sparse_map.hpp>
 #include <neutron/utility.hpp>
 #include "require.hpp"
 
 void test_sparse_map();
 void test_sparse_map_pmr();
+void test_sparse_map_batch();
+void test_sparse_map_copy_move();
 
 int main() {
     test_sparse_map();
     test_sparse_map_pmr();
+    test_sparse_map_batch();
+    test_sparse_map_copy_move();
     return 0;
 }
 
@@ -143,3 +150,91 @@ void test_sparse_map_pmr() {
         }
     }
 }
+
+void test_sparse_map_batch() {
+    sparse_map<uint32_t, uint32_t> map;
+    for (uint32_t i = 0; i < 1000; i += 2) {
+        map.try_emplace(i, i * 3);
+    }
+
+    std::vector<uint32_t> keys;
+    for (uint32_t i = 0; i < 1200; i += 3) {
+        keys.push_back(i);
+    }
+
+    std::vector<decltype(map)::iterator> found;
+    map.find_batch(keys, std::back_inserter(found));
+    require(found.size() == keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        require(found[i] == map.find(keys[i]));
+        if (found[i] != map.end()) {
+            require(found[i]->second == keys[i] * 3);
+        }
+    }
+
+    std::vector<bool> contained;
+    const auto& cmap = map;
+    const auto count = cmap.contains_batch(keys, std::back_inserter(contained));
+    size_t expected  = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        require(contained[i] == map.contains(keys[i]));
+        expected += contained[i];
+    }
+    require(count == expected);
+
+    std::array<decltype(map)::const_iterator, 3> few;
+    const std::array<uint32_t, 3> some{ 4, 5, 998 };
+    cmap.find_batch(some, few.begin());
+    require(few[0]->second == 12);
+    require(few[1] == cmap.end());
+    require(few[2]->second == 998 * 3);
+
+    // empty map and empty batch
+    sparse_map<uint32_t, uint32_t> empty;
+    require(empty.contains_batch(keys, std::back_inserter(contained)) == 0);
+    require(map.find_batch({}, found.begin()) == found.begin());
+}
+
+void test_sparse_map_copy_move() {
+    // the dense and the sparse vectors share the allocator of the map
+    static_assert(sizeof(sparse_map<uint32_t, uint32_t>) == 32);
+
+    sparse_map<uint32_t, uint32_t> map;
+    for (uint32_t i = 0; i < 300; i += 3) {
+        map.try_emplace(i, i + 1);
+    }
+    auto copy = map;
+    require(copy.size() == map.size());
+    require(copy.at(297) == 298);
+    copy.erase(297U);
+    require(map.contains(297));
+
+    auto moved = std::move(copy);
+    require(moved.size() == map.size() - 1);
+    require_false(moved.contains(297));
+    moved = map;
+    require(moved.at(297) == 298);
+
+    // moving between unequal allocators moves the elements
+    std::pmr::unsynchronized_pool_resource first;
+    std::pmr::unsynchronized_pool_resource second;
+    pmr::sparse_map<uint32_t, uint32_t> source{
+        std::pmr::polymorphic_allocator<>{ &first }
+    };
+    for (uint32_t i = 0; i < 100; ++i) {
+        source.try_emplace(i * 7, i);
+    }
+    pmr::sparse_map<uint32_t, uint32_t> target{
+        std::pmr::polymorphic_allocator<>{ &second }
+    };
+    target = std::move(source);
+    require(target.size() == 100);
+    require(target.at(693) == 99);
+    require(target.get_allocator().resource() == &second);
+
+    map.clear();
+    require(map.empty());
+    require_false(map.contains(3));
+    map.try_emplace(3, 4);
+    require(map.at(3) == 4);
+}
@@ -0,0 +1,83 @@
+// Tests for static_map and static_type_map: compile-time perfect hashing
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <neutron/static_map.hpp>
+#include "require.hpp"
+
+using namespace neutron;
+
+struct transform {};
+struct rigid_body {};
+struct hp {};
+
+void test_string_keys();
+void test_many_keys();
+void test_table();
+void test_type_keys();
+
+int main() {
+    test_string_keys();
+    test_many_keys();
+    test_table();
+    test_type_keys();
+    return 0;
+}
+
+void test_string_keys() {
+    using fields = static_map<"position", "velocity", "mass">;
+    static_assert(fields::size() == 3);
+    static_assert(fields::index_of("position") == 0);
+    static_assert(fields::index_of("velocity") == 1);
+    static_assert(fields::index_of("mass") == 2);
+    static_assert(fields::index_of("inertia") == fields::npos);
+    static_assert(fields::key(1) == "velocity");
+
+    // runtime strings, never materialized as keys
+    const std::string name = "mass";
+    require(fields::index_of(name) == 2);
+    require_false(fields::contains(std::string{ "pos" }));
+    require_false(fields::contains(""));
+
+    using none = static_map<>;
+    static_assert(none::empty());
+    require(none::index_of("position") == none::npos);
+}
+
+void test_many_keys() {
+    using keys = static_map<
+        "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n",
+        "o", "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z", "aa", "ab",
+        "ac", "ad", "ae", "af", "ag", "ah", "ai", "aj", "ak", "al", "am", "an">;
+    static_assert(keys::size() == 40);
+    for (size_t i = 0; i < keys::size(); ++i) {
+        require(keys::index_of(keys::key(i)) == i);
+    }
+    require(keys::index_of("ao") == keys::npos);
+    require(keys::index_of("A") == keys::npos);
+}
+
+void test_table() {
+    using settings = static_map<"width", "height", "vsync">;
+    constexpr settings::table<int> defaults{ { 1280, 720, 1 } };
+    static_assert(*defaults.find("height") == 720);
+    static_assert(defaults.find("depth") == nullptr);
+
+    settings::table<int> current = defaults;
+    *current.find("width") = 1920;
+    require(current.values[0] == 1920);
+    require(current.contains("vsync"));
+}
+
+void test_type_keys() {
+    using components = static_type_map<transform, rigid_body, hp>;
+    static_assert(components::index_of<transform>() == 0);
+    static_assert(components::index_of<hp>() == 2);
+    static_assert(components::contains<rigid_body>());
+    static_assert(!components::contains<int>());
+
+    // hashes coming back at runtime
+    const uint64_t hash = hash_of<rigid_body>();
+    require(components::index_of(hash) == 1);
+    require(components::index_of(hash + 1) == components::npos);
+}